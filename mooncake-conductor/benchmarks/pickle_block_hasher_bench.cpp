@@ -0,0 +1,43 @@
+#include "pickle_block_hasher.h"
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace mooncake_conductor;
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+
+    const size_t kNumTokens = 32 * 1024;
+    const size_t kBlockSize = 16;
+    const int kIterations = 20;
+
+    std::vector<int64_t> token_ids(kNumTokens);
+    for (size_t i = 0; i < kNumTokens; ++i) {
+        token_ids[i] = static_cast<int64_t>((i * 2654435761ULL) % 151643);
+    }
+
+    PickleBlockHasher hasher;
+    std::vector<PickleBlockHasher::BlockHash> hashes;
+    hashes.reserve(kNumTokens / kBlockSize);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        hashes.clear();
+        hasher.hash_blocks(token_ids, kBlockSize, hashes);
+    }
+    double elapsed_us = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+    size_t num_blocks = kIterations * hashes.size();
+    LOG(INFO) << "[BENCH] PickleBlockHasher: " << kNumTokens
+              << "-token prompt, block size " << kBlockSize << ": "
+              << elapsed_us / kIterations << " us per prompt, "
+              << num_blocks / elapsed_us << " M blocks/s";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "prefix_hash_cache.h"
+#include "pickle_block_hasher.h"
+
+#include <gflags/gflags.h>
+#include <nlohmann/json.hpp>
+#include <glog/logging.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+DEFINE_string(trace_path, "FAST25-release/traces/conversation_trace.jsonl",
+              "Mooncake trace whose prompts are replayed");
+DEFINE_uint64(max_requests, 2000, "Number of requests replayed");
+
+using namespace mooncake_conductor;
+
+namespace {
+
+// Mooncake traces identify every 512-token block of a prompt by a hash id,
+// the actual tokens are derived from it.
+constexpr size_t kTraceBlockTokens = 512;
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+std::vector<int64_t> tokens_of(const std::vector<int64_t>& hash_ids,
+                               size_t input_length) {
+    std::vector<int64_t> tokens;
+    tokens.reserve(input_length);
+    for (size_t i = 0; i < input_length; ++i) {
+        size_t block = std::min(i / kTraceBlockTokens, hash_ids.size() - 1);
+        uint64_t seed = static_cast<uint64_t>(hash_ids[block]) *
+                            kTraceBlockTokens + i % kTraceBlockTokens;
+        tokens.push_back(static_cast<int64_t>(splitmix64(seed) % 151643));
+    }
+    return tokens;
+}
+
+double thread_cpu_us() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+double percentile(std::vector<double> samples, double quantile) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1,
+                            static_cast<size_t>(quantile * samples.size()))];
+}
+
+}
+
+// Replays the prompts of a Mooncake trace and reports the hashing CPU time
+// per request with and without the prefix hash cache.
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+
+    const std::string& trace_path = FLAGS_trace_path;
+    const size_t max_requests = FLAGS_max_requests;
+    std::ifstream trace(trace_path);
+    if (!trace) {
+        LOG(ERROR) << "[BENCH] Trace " << trace_path << " not found";
+        return 1;
+    }
+
+    const size_t kBlockSize = 16;
+    PickleBlockHasher hasher;
+    PrefixHashCache cache(4 * 1024 * 1024);
+    std::vector<PickleBlockHasher::BlockHash> hashes;
+    std::vector<double> uncached_us, cached_us;
+
+    std::string line;
+    while (uncached_us.size() < max_requests && std::getline(trace, line)) {
+        auto request = nlohmann::json::parse(line);
+        auto hash_ids = request["hash_ids"].get<std::vector<int64_t>>();
+        size_t input_length = request["input_length"].get<size_t>();
+        if (hash_ids.empty() || input_length == 0) continue;
+        auto tokens = tokens_of(hash_ids, input_length);
+
+        hashes.clear();
+        double start = thread_cpu_us();
+        hasher.hash_blocks(tokens, kBlockSize, hashes);
+        uncached_us.push_back(thread_cpu_us() - start);
+
+        hashes.clear();
+        start = thread_cpu_us();
+        cache.hash_blocks(tokens, kBlockSize, hashes);
+        cached_us.push_back(thread_cpu_us() - start);
+    }
+
+    auto mean = [](const std::vector<double>& samples) {
+        double sum = 0;
+        for (auto sample : samples) sum += sample;
+        return samples.empty() ? 0 : sum / samples.size();
+    };
+    auto stats = cache.stats();
+    LOG(INFO) << "[BENCH] Prefix hash cache replay of " << uncached_us.size()
+              << " requests from " << trace_path << ", block size "
+              << kBlockSize;
+    LOG(INFO) << "  uncached: mean " << mean(uncached_us) << " us, p50 "
+              << percentile(uncached_us, 0.5) << " us, p99 "
+              << percentile(uncached_us, 0.99) << " us per request";
+    LOG(INFO) << "  cached:   mean " << mean(cached_us) << " us, p50 "
+              << percentile(cached_us, 0.5) << " us, p99 "
+              << percentile(cached_us, 0.99) << " us per request";
+    LOG(INFO) << "  block hit ratio "
+              << (stats.hits + stats.misses
+                      ? 100.0 * stats.hits / (stats.hits + stats.misses)
+                      : 0)
+              << "%, " << stats.size << " cached blocks, " << stats.evictions
+              << " evictions";
+    return 0;
+}
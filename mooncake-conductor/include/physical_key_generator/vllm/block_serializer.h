@@ -1,21 +1,26 @@
 #pragma once
 
-#include "python_pickle_serializer.h"
+#include "pickle_block_hasher.h"
+#include "prefix_hash_cache.h"
 
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <optional>
 
 namespace mooncake_conductor {
 
 class BlockSerializer {
 private:
-    BoostPythonPickleSerializer serializer;
-    std::vector<uint8_t> none_hash;
+    PickleBlockHasher hasher;
+    std::shared_ptr<PrefixHashCache> cache;
     
 public:
-    BlockSerializer() : none_hash(32, 0) {}
-    
+    // With a cache, hash_blocks() only hashes the blocks after the longest
+    // prefix seen before. The cache may be shared between serializers.
+    explicit BlockSerializer(std::shared_ptr<PrefixHashCache> cache = nullptr)
+        : cache(std::move(cache)) {}
+
     static std::string to_hex(const std::vector<uint8_t>& data);
 
     std::vector<uint8_t> serialize_block(
@@ -25,6 +30,12 @@ public:
     std::vector<std::vector<uint8_t>> serialize_blocks(
         const std::vector<int64_t>& all_token_ids,
         size_t block_size);
+
+    // Chained block hashes of all full blocks, without materializing the
+    // serialized blocks.
+    std::vector<PickleBlockHasher::BlockHash> hash_blocks(
+        const std::vector<int64_t>& all_token_ids,
+        size_t block_size);
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mooncake_conductor {
+
+// Native implementation of vLLM's prefix caching block hash:
+//
+//     sha256(pickle.dumps((parent_hash, tuple(token_ids), extra_keys),
+//                         protocol=5))
+//
+// The pickle stream is byte-identical to CPython's, including framing, so the
+// keys match the ones computed by vLLM workers. One hasher reuses its encode
+// buffer, hashing a prompt does not allocate per block. Not thread-safe, use
+// one instance per thread.
+class PickleBlockHasher {
+public:
+    static constexpr size_t kHashSize = 32;
+    using BlockHash = std::array<uint8_t, kHashSize>;
+
+    PickleBlockHasher();
+
+    // Pickles one block. `parent_hash` may be nullptr for the first block, in
+    // which case NONE_HASH is used. `extra_keys` nullptr is pickled as None.
+    // The returned buffer is valid until the next call on this hasher.
+    const std::vector<uint8_t>& serialize_block(
+        const BlockHash* parent_hash,
+        const int64_t* token_ids, size_t num_tokens,
+        const std::vector<int64_t>* extra_keys = nullptr);
+
+    BlockHash hash_block(
+        const BlockHash* parent_hash,
+        const int64_t* token_ids, size_t num_tokens,
+        const std::vector<int64_t>* extra_keys = nullptr);
+
+    // Appends the hash of every full block of `token_ids` to `hashes`,
+    // chaining from `parent_hash` (nullptr for the start of a prompt).
+    void hash_blocks(const int64_t* token_ids, size_t num_tokens,
+                     size_t block_size, const BlockHash* parent_hash,
+                     std::vector<BlockHash>& hashes);
+
+    void hash_blocks(const std::vector<int64_t>& token_ids, size_t block_size,
+                     std::vector<BlockHash>& hashes) {
+        hash_blocks(token_ids.data(), token_ids.size(), block_size, nullptr,
+                    hashes);
+    }
+
+    static std::string to_hex(const BlockHash& hash);
+
+private:
+    void put(uint8_t opcode) { buffer_.push_back(opcode); }
+    void put(const uint8_t* data, size_t size) {
+        buffer_.insert(buffer_.end(), data, data + size);
+    }
+
+    void begin_frame();
+    void commit_frame();
+    // Called before every pickled object, where CPython ends a frame once it
+    // reaches 64KB.
+    void opcode_boundary();
+
+    void save_int(int64_t value);
+    void save_int_tuple(const int64_t* values, size_t count);
+
+    std::vector<uint8_t> buffer_;
+    size_t frame_start_;
+};
+
+}
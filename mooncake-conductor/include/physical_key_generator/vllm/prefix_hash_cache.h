@@ -0,0 +1,105 @@
+#pragma once
+
+#include "pickle_block_hasher.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace mooncake_conductor {
+
+// Bounded cache of block hashes keyed by the parent hash and block tokens.
+//
+// Requests of a multi-turn conversation share the prefix of the previous
+// turn, so looking the blocks up before hashing them leaves only the new
+// suffix to be pickled and SHA-256'd. Hashes are cached in runs of
+// kBlocksPerRun consecutive blocks, which amortizes the cost of a lookup or
+// insert (mostly a cache miss) over many blocks, a run is identified by two
+// independent 64-bit hashes of its parent hash and tokens. A trailing
+// partial run is hashed and not cached.
+//
+// The cache is a fixed-size set-associative table without allocations after
+// construction, every set evicts its least recently used run. Sets are
+// grouped into independently locked shards, so concurrent requests do not
+// contend on a global lock.
+class PrefixHashCache {
+public:
+    using BlockHash = PickleBlockHasher::BlockHash;
+
+    static constexpr size_t kBlocksPerRun = 16;
+
+    struct Stats {
+        uint64_t hits;    // blocks
+        uint64_t misses;  // blocks
+        uint64_t evictions;  // runs
+        size_t size;         // blocks
+    };
+
+    // `capacity` is the total number of cached blocks.
+    explicit PrefixHashCache(size_t capacity, size_t num_shards = 64);
+
+    // Appends the hash of every full block of `token_ids` to `hashes`, like
+    // PickleBlockHasher::hash_blocks(). Returns the number of blocks that
+    // were not cached and had to be hashed.
+    size_t hash_blocks(const int64_t* token_ids, size_t num_tokens,
+                       size_t block_size, std::vector<BlockHash>& hashes);
+
+    size_t hash_blocks(const std::vector<int64_t>& token_ids,
+                       size_t block_size, std::vector<BlockHash>& hashes) {
+        return hash_blocks(token_ids.data(), token_ids.size(), block_size,
+                           hashes);
+    }
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t kWays = 8;
+    static constexpr size_t kPositionBits = 24;
+    static constexpr size_t kMaxPosition = (size_t(1) << kPositionBits) - 1;
+
+    using Run = std::array<BlockHash, kBlocksPerRun>;
+
+    struct Set {
+        uint64_t keys[kWays] = {};  // 0 for empty ways
+        uint64_t fingerprints[kWays] = {};
+        uint64_t last_use[kWays] = {};
+        Run runs[kWays];
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Set> sets;
+        size_t size = 0;
+    };
+
+    struct RunId {
+        uint64_t key;
+        uint64_t fingerprint;
+    };
+
+    static RunId run_id(const BlockHash& parent_hash, const int64_t* token_ids,
+                        size_t num_tokens, size_t block_size);
+
+    Shard& shard_of(uint64_t key) { return shards_[key % shards_.size()]; }
+
+    Set& set_of(Shard& shard, uint64_t key) {
+        return shard.sets[(key / shards_.size()) % shard.sets.size()];
+    }
+
+    // Appends the cached run to `hashes` if there is one.
+    bool lookup(const RunId& id, uint64_t stamp,
+                std::vector<BlockHash>& hashes);
+
+    void insert(const RunId& id, uint64_t stamp, const BlockHash* run);
+
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> request_clock_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+}
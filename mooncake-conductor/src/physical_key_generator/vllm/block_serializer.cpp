@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <optional>
 #include <functional>
+#include <stdexcept>
 
 
 namespace mooncake_conductor {
@@ -28,10 +29,17 @@ std::vector<uint8_t> BlockSerializer::serialize_block(
     const std::optional<std::vector<uint8_t>>& parent_block_hash,
     const std::vector<int64_t>& curr_block_token_ids) {
     
-    const auto& parent_hash = parent_block_hash ? 
-        *parent_block_hash : none_hash;
+    PickleBlockHasher::BlockHash parent_hash{};
+    if (parent_block_hash) {
+        if (parent_block_hash->size() != parent_hash.size()) {
+            throw std::invalid_argument("Parent block hash must be 32 bytes");
+        }
+        std::copy(parent_block_hash->begin(), parent_block_hash->end(),
+                  parent_hash.begin());
+    }
         
-    return serializer.serialize(parent_hash, curr_block_token_ids);
+    return hasher.serialize_block(&parent_hash, curr_block_token_ids.data(),
+                                  curr_block_token_ids.size());
 }
     
 std::vector<std::vector<uint8_t>> BlockSerializer::serialize_blocks(
@@ -39,21 +47,30 @@ std::vector<std::vector<uint8_t>> BlockSerializer::serialize_blocks(
     size_t block_size) {
     
     std::vector<std::vector<uint8_t>> serialized_blocks;
-    std::optional<std::vector<uint8_t>> prev_hash;
+    PickleBlockHasher::BlockHash prev_hash{};
     
     for (size_t start = 0; start + block_size <= all_token_ids.size(); start += block_size) {
-        std::vector<int64_t> block_tokens(
-            all_token_ids.begin() + start,
-            all_token_ids.begin() + start + block_size
-        );
-        
-        auto serialized = serialize_block(prev_hash, block_tokens);
-        serialized_blocks.push_back(serialized);
-        prev_hash = sha256(serialized);
+        serialized_blocks.push_back(hasher.serialize_block(
+            &prev_hash, all_token_ids.data() + start, block_size));
+        auto hash = sha256(serialized_blocks.back());
+        std::copy(hash.begin(), hash.end(), prev_hash.begin());
     }
     
     return serialized_blocks;
 }
 
+std::vector<PickleBlockHasher::BlockHash> BlockSerializer::hash_blocks(
+    const std::vector<int64_t>& all_token_ids,
+    size_t block_size) {
+    
+    std::vector<PickleBlockHasher::BlockHash> hashes;
+    if (cache) {
+        cache->hash_blocks(all_token_ids, block_size, hashes);
+    } else {
+        hasher.hash_blocks(all_token_ids, block_size, hashes);
+    }
+    return hashes;
+}
+
 
 }
\ No newline at end of file
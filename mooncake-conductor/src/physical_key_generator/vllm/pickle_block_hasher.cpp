@@ -0,0 +1,197 @@
+#include "pickle_block_hasher.h"
+
+#include <openssl/sha.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace mooncake_conductor {
+
+namespace {
+
+// Opcodes of pickle protocol 5, see Lib/pickle.py
+constexpr uint8_t PROTO = 0x80;
+constexpr uint8_t FRAME = 0x95;
+constexpr uint8_t SHORT_BINBYTES = 'C';
+constexpr uint8_t MEMOIZE = 0x94;
+constexpr uint8_t MARK = '(';
+constexpr uint8_t TUPLE = 't';
+constexpr uint8_t EMPTY_TUPLE = ')';
+constexpr uint8_t TUPLE1 = 0x85;
+constexpr uint8_t TUPLE2 = 0x86;
+constexpr uint8_t TUPLE3 = 0x87;
+constexpr uint8_t NONE = 'N';
+constexpr uint8_t BININT = 'J';
+constexpr uint8_t BININT1 = 'K';
+constexpr uint8_t BININT2 = 'M';
+constexpr uint8_t LONG1 = 0x8a;
+constexpr uint8_t STOP = '.';
+
+constexpr uint8_t kProtocol = 5;
+constexpr size_t kFrameHeaderSize = 9;
+constexpr size_t kFrameSizeMin = 4;
+constexpr size_t kFrameSizeTarget = 64 * 1024;
+
+const PickleBlockHasher::BlockHash kNoneHash{};
+
+}
+
+PickleBlockHasher::PickleBlockHasher() : frame_start_(0) {
+    buffer_.reserve(4096);
+}
+
+void PickleBlockHasher::begin_frame() {
+    frame_start_ = buffer_.size();
+    buffer_.resize(buffer_.size() + kFrameHeaderSize);
+}
+
+void PickleBlockHasher::commit_frame() {
+    size_t frame_len = buffer_.size() - frame_start_ - kFrameHeaderSize;
+    uint8_t* header = buffer_.data() + frame_start_;
+    if (frame_len >= kFrameSizeMin) {
+        header[0] = FRAME;
+        for (size_t i = 0; i < 8; ++i) {
+            header[1 + i] = static_cast<uint8_t>(uint64_t(frame_len) >> (8 * i));
+        }
+    } else {
+        std::memmove(header, header + kFrameHeaderSize, frame_len);
+        buffer_.resize(buffer_.size() - kFrameHeaderSize);
+    }
+}
+
+void PickleBlockHasher::opcode_boundary() {
+    if (buffer_.size() - frame_start_ - kFrameHeaderSize >= kFrameSizeTarget) {
+        commit_frame();
+        begin_frame();
+    }
+}
+
+void PickleBlockHasher::save_int(int64_t value) {
+    opcode_boundary();
+    if (value >= 0 && value <= 0xff) {
+        uint8_t op[2] = {BININT1, static_cast<uint8_t>(value)};
+        put(op, sizeof(op));
+    } else if (value >= 0 && value <= 0xffff) {
+        uint8_t op[3] = {BININT2, static_cast<uint8_t>(value),
+                         static_cast<uint8_t>(value >> 8)};
+        put(op, sizeof(op));
+    } else if (value >= INT32_MIN && value <= INT32_MAX) {
+        uint32_t bits = static_cast<uint32_t>(value);
+        uint8_t op[5] = {BININT, static_cast<uint8_t>(bits),
+                         static_cast<uint8_t>(bits >> 8),
+                         static_cast<uint8_t>(bits >> 16),
+                         static_cast<uint8_t>(bits >> 24)};
+        put(op, sizeof(op));
+    } else {
+        // Minimal little-endian two's complement, as encode_long() does.
+        uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value)
+                                       : static_cast<uint64_t>(value);
+        size_t nbytes = (64 - __builtin_clzll(magnitude)) / 8 + 1;
+        uint8_t op[2 + 9] = {LONG1};
+        for (size_t i = 0; i < nbytes; ++i) {
+            op[2 + i] = i < 8 ? static_cast<uint8_t>(uint64_t(value) >> (8 * i))
+                              : (value < 0 ? 0xff : 0x00);
+        }
+        if (value < 0 && nbytes > 1 && op[2 + nbytes - 1] == 0xff &&
+            (op[2 + nbytes - 2] & 0x80)) {
+            --nbytes;
+        }
+        op[1] = static_cast<uint8_t>(nbytes);
+        put(op, 2 + nbytes);
+    }
+}
+
+void PickleBlockHasher::save_int_tuple(const int64_t* values, size_t count) {
+    opcode_boundary();
+    if (count == 0) {
+        put(EMPTY_TUPLE);
+        return;
+    }
+    if (count > 3) put(MARK);
+    for (size_t i = 0; i < count; ++i) save_int(values[i]);
+    static constexpr uint8_t kSmallTuple[] = {0, TUPLE1, TUPLE2, TUPLE3};
+    put(count > 3 ? TUPLE : kSmallTuple[count]);
+    put(MEMOIZE);
+}
+
+const std::vector<uint8_t>& PickleBlockHasher::serialize_block(
+    const BlockHash* parent_hash,
+    const int64_t* token_ids, size_t num_tokens,
+    const std::vector<int64_t>* extra_keys) {
+    if (!parent_hash) parent_hash = &kNoneHash;
+
+    buffer_.clear();
+    put(PROTO);
+    put(kProtocol);
+    begin_frame();
+
+    // The outer tuple is too small to end the frame, the boundaries before
+    // its elements are the only ones that matter.
+    opcode_boundary();
+    put(SHORT_BINBYTES);
+    put(static_cast<uint8_t>(kHashSize));
+    put(parent_hash->data(), kHashSize);
+    put(MEMOIZE);
+
+    save_int_tuple(token_ids, num_tokens);
+
+    if (extra_keys) {
+        save_int_tuple(extra_keys->data(), extra_keys->size());
+    } else {
+        opcode_boundary();
+        put(NONE);
+    }
+
+    put(TUPLE3);
+    put(MEMOIZE);
+
+    put(STOP);
+    commit_frame();
+    return buffer_;
+}
+
+PickleBlockHasher::BlockHash PickleBlockHasher::hash_block(
+    const BlockHash* parent_hash,
+    const int64_t* token_ids, size_t num_tokens,
+    const std::vector<int64_t>* extra_keys) {
+    const auto& data =
+        serialize_block(parent_hash, token_ids, num_tokens, extra_keys);
+    BlockHash hash;
+    SHA256_CTX sha256_ctx;
+    if (!SHA256_Init(&sha256_ctx) ||
+        !SHA256_Update(&sha256_ctx, data.data(), data.size()) ||
+        !SHA256_Final(hash.data(), &sha256_ctx)) {
+        throw std::runtime_error("SHA256 calculation failed");
+    }
+    return hash;
+}
+
+void PickleBlockHasher::hash_blocks(const int64_t* token_ids,
+                                    size_t num_tokens, size_t block_size,
+                                    const BlockHash* parent_hash,
+                                    std::vector<BlockHash>& hashes) {
+    if (block_size == 0) {
+        throw std::invalid_argument("block_size must be positive");
+    }
+    hashes.reserve(hashes.size() + num_tokens / block_size);
+    BlockHash parent = parent_hash ? *parent_hash : kNoneHash;
+    for (size_t start = 0; start + block_size <= num_tokens;
+         start += block_size) {
+        parent = hash_block(&parent, token_ids + start, block_size);
+        hashes.push_back(parent);
+    }
+}
+
+std::string PickleBlockHasher::to_hex(const BlockHash& hash) {
+    static constexpr char hex_chars[] = "0123456789abcdef";
+    std::string result;
+    result.reserve(hash.size() * 2);
+    for (auto byte : hash) {
+        result.push_back(hex_chars[byte >> 4]);
+        result.push_back(hex_chars[byte & 0x0F]);
+    }
+    return result;
+}
+
+}
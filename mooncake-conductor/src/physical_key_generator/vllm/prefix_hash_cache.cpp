@@ -0,0 +1,161 @@
+#include "prefix_hash_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mooncake_conductor {
+
+namespace {
+
+// 64x64 -> 128 bit multiply folded to 64 bits, as in wyhash.
+inline uint64_t fold_mul(uint64_t a, uint64_t b) {
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^
+           static_cast<uint64_t>(product >> 64);
+}
+
+constexpr uint64_t kKeySeed = 0xa0761d6478bd642fULL;
+constexpr uint64_t kFingerprintSeed = 0xe7037ed1a0b428dbULL;
+
+}
+
+PrefixHashCache::PrefixHashCache(size_t capacity, size_t num_shards)
+    : shards_(std::max<size_t>(num_shards, 1)) {
+    size_t sets_per_shard = std::max<size_t>(
+        capacity / kBlocksPerRun / shards_.size() / kWays, 1);
+    for (auto& shard : shards_) {
+        shard.sets.resize(sets_per_shard);
+    }
+}
+
+PrefixHashCache::RunId PrefixHashCache::run_id(const BlockHash& parent_hash,
+                                               const int64_t* token_ids,
+                                               size_t num_tokens,
+                                               size_t block_size) {
+    // The parent is a SHA-256 digest, every word of it is well mixed.
+    uint64_t parent_words[4];
+    std::memcpy(parent_words, parent_hash.data(), sizeof(parent_words));
+    uint64_t key = fold_mul(parent_words[0] ^ kKeySeed, block_size + 1);
+    uint64_t fingerprint =
+        fold_mul(parent_words[1] ^ kFingerprintSeed,
+                 parent_words[2] ^ parent_words[3] ^ block_size);
+    // Two tokens per multiply, as wyhash consumes its input.
+    size_t i = 0;
+    for (; i + 2 <= num_tokens; i += 2) {
+        uint64_t first = static_cast<uint64_t>(token_ids[i]);
+        uint64_t second = static_cast<uint64_t>(token_ids[i + 1]);
+        key = fold_mul(first ^ kKeySeed, second ^ key);
+        fingerprint =
+            fold_mul(first ^ kFingerprintSeed, ~second ^ fingerprint);
+    }
+    if (i < num_tokens) {
+        uint64_t last = static_cast<uint64_t>(token_ids[i]);
+        key = fold_mul(last ^ kKeySeed, key);
+        fingerprint = fold_mul(last ^ kFingerprintSeed, fingerprint);
+    }
+    return {key ? key : 1, fingerprint};
+}
+
+bool PrefixHashCache::lookup(const RunId& id, uint64_t stamp,
+                             std::vector<BlockHash>& hashes) {
+    auto& shard = shard_of(id.key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& set = set_of(shard, id.key);
+    for (size_t way = 0; way < kWays; ++way) {
+        if (set.keys[way] == id.key &&
+            set.fingerprints[way] == id.fingerprint) {
+            set.last_use[way] = std::max(set.last_use[way], stamp);
+            hashes.insert(hashes.end(), set.runs[way].begin(),
+                          set.runs[way].end());
+            return true;
+        }
+    }
+    return false;
+}
+
+void PrefixHashCache::insert(const RunId& id, uint64_t stamp,
+                             const BlockHash* run) {
+    auto& shard = shard_of(id.key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& set = set_of(shard, id.key);
+    size_t victim = 0;
+    for (size_t way = 0; way < kWays; ++way) {
+        // Another request may have inserted the same run meanwhile.
+        if (set.keys[way] == id.key &&
+            set.fingerprints[way] == id.fingerprint) {
+            return;
+        }
+        if (set.last_use[way] < set.last_use[victim]) victim = way;
+    }
+    if (set.keys[victim]) {
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        ++shard.size;
+    }
+    set.keys[victim] = id.key;
+    set.fingerprints[victim] = id.fingerprint;
+    set.last_use[victim] = stamp;
+    std::copy(run, run + kBlocksPerRun, set.runs[victim].begin());
+}
+
+size_t PrefixHashCache::hash_blocks(const int64_t* token_ids,
+                                    size_t num_tokens, size_t block_size,
+                                    std::vector<BlockHash>& hashes) {
+    if (block_size == 0) {
+        throw std::invalid_argument("block_size must be positive");
+    }
+    thread_local PickleBlockHasher hasher;
+
+    // A cached chain is only usable up to its first missing run, so the runs
+    // of a request are ranked by recency first and by position second:
+    // eviction drops the tail of a chain before its head.
+    uint64_t request_stamp =
+        request_clock_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    size_t num_blocks = num_tokens / block_size;
+    size_t run_tokens = kBlocksPerRun * block_size;
+    hashes.reserve(hashes.size() + num_blocks);
+    BlockHash parent{};
+    size_t hashed = 0;
+    size_t block = 0;
+    for (size_t index = 0; block + kBlocksPerRun <= num_blocks;
+         block += kBlocksPerRun, ++index) {
+        const int64_t* run = token_ids + block * block_size;
+        RunId id = run_id(parent, run, run_tokens, block_size);
+        uint64_t stamp = (request_stamp << kPositionBits) |
+                         (kMaxPosition - std::min(index, kMaxPosition));
+        // Past the first miss the prefix is new, so are the runs after it.
+        if (!hashed && lookup(id, stamp, hashes)) {
+            hits_.fetch_add(kBlocksPerRun, std::memory_order_relaxed);
+        } else {
+            __builtin_prefetch(&set_of(shard_of(id.key), id.key), 1);
+            size_t run_start = hashes.size();
+            hasher.hash_blocks(run, run_tokens, block_size, &parent, hashes);
+            insert(id, stamp, hashes.data() + run_start);
+            hashed += kBlocksPerRun;
+        }
+        parent = hashes.back();
+    }
+    if (block < num_blocks) {
+        size_t tail_tokens = (num_blocks - block) * block_size;
+        hasher.hash_blocks(token_ids + block * block_size, tail_tokens,
+                           block_size, &parent, hashes);
+        hashed += num_blocks - block;
+    }
+    misses_.fetch_add(hashed, std::memory_order_relaxed);
+    return hashed;
+}
+
+PrefixHashCache::Stats PrefixHashCache::stats() const {
+    Stats stats{hits_.load(std::memory_order_relaxed),
+                misses_.load(std::memory_order_relaxed),
+                evictions_.load(std::memory_order_relaxed), 0};
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.size += shard.size * kBlocksPerRun;
+    }
+    return stats;
+}
+
+}
@@ -0,0 +1,140 @@
+#include "pickle_block_hasher.h"
+#include "block_serializer.h"
+#include "hash.h"
+
+#include <glog/logging.h>
+
+#include <cassert>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mooncake_conductor::test {
+
+namespace {
+
+struct GoldenCase {
+    std::string description;
+    std::string parent_hash_hex;  // empty for the first block
+    std::vector<int64_t> token_ids;
+    std::optional<std::vector<int64_t>> extra_keys;
+    std::string serialized_hex;  // empty to compare the hash only
+    std::string expected_hash;
+};
+
+// Generated by
+//   pickle.dumps((parent_hash or b'\0' * 32, tuple(token_ids), extra_keys),
+//                protocol=5)
+// and hashlib.sha256() on CPython 3.11.
+std::vector<GoldenCase> golden_cases() {
+    return {
+        {
+            "first block, small token ids", "",
+            {1, 2, 3, 4, 5}, std::nullopt,
+            "80059534000000000000004320000000000000000000000000000000000000000000000000000000000000000094284b014b024b034b044b0574944e87942e",
+            "62a05fac03f5470c9e1e66b43447b1cb321ec98e3afb509f531d0781dde12d52"
+        },
+        {
+            "one-, two- and four-byte token ids",
+            "62a05fac03f5470c9e1e66b43447b1cb321ec98e3afb509f531d0781dde12d52",
+            {0, 255, 256, 65535, 65536, 151643}, std::nullopt,
+            "8005953e00000000000000432062a05fac03f5470c9e1e66b43447b1cb321ec98e3afb509f531d0781dde12d5294284b004bff4d00014dffff4a000001004a5b50020074944e87942e",
+            "9f909a6f3b132c257b4457d47eb54c25fa7fddd0c6e9b00e332c4cacadb440fc"
+        },
+        {
+            "64-bit and negative values", "",
+            {-1, INT32_MIN, 2147483648LL, -2147483649LL, INT64_MAX, INT64_MIN},
+            std::nullopt,
+            "80059556000000000000004320000000000000000000000000000000000000000000000000000000000000000094284affffffff4a000000808a0500000080008a05ffffff7fff8a08ffffffffffffff7f8a08000000000000008074944e87942e",
+            "c278bed8df9383accf2515b9356d62187324e092ae9b951b615edcd2879f3703"
+        },
+        {
+            "short tuples and extra keys", "",
+            {7, 8}, std::vector<int64_t>{42},
+            "800595300000000000000043200000000000000000000000000000000000000000000000000000000000000000944b074b0886944b2a859487942e",
+            "0e49abae13ef9e19935e853de6f4fb2fb58ced74e4fbc2a12e7bf149e07c3fa6"
+        },
+        {
+            "empty extra keys", "",
+            {7, 8, 9}, std::vector<int64_t>{},
+            "8005952f0000000000000043200000000000000000000000000000000000000000000000000000000000000000944b074b084b0987942987942e",
+            "2abf80cfbaf7e73e4b59963d1fb6efb760b66b808e0680e1c426df7ab62bb036"
+        },
+        {
+            "block spanning two pickle frames", "",
+            std::vector<int64_t>(13100, 70000), std::nullopt, "",
+            "fc1336b03d88ae40913d6855ca8705ce0d2f66aad43e1eaa73434ac58b7de1b4"
+        },
+        {
+            "block spanning three pickle frames", "",
+            std::vector<int64_t>(70000, 1), std::vector<int64_t>{3}, "",
+            "dd9dbfc1bbb4d3dd2000fc0afab19fe29fbb82f16932d30425b02078c926e481"
+        },
+    };
+}
+
+}
+
+bool test_pickle_block_hasher() {
+    LOG(INFO) << "[TEST] PickleBlockHasher golden compatibility with pickle";
+
+    PickleBlockHasher hasher;
+    bool all_passed = true;
+    for (const auto& test_case : golden_cases()) {
+        PickleBlockHasher::BlockHash parent_hash{};
+        if (!test_case.parent_hash_hex.empty()) {
+            auto bytes = hex_to_bytes(test_case.parent_hash_hex);
+            std::copy(bytes.begin(), bytes.end(), parent_hash.begin());
+        }
+        const auto* extra_keys =
+            test_case.extra_keys ? &*test_case.extra_keys : nullptr;
+
+        const auto& serialized = hasher.serialize_block(
+            &parent_hash, test_case.token_ids.data(),
+            test_case.token_ids.size(), extra_keys);
+        bool passed = test_case.serialized_hex.empty() ||
+                      bytes_to_hex(serialized) == test_case.serialized_hex;
+
+        auto hash_hex = PickleBlockHasher::to_hex(hasher.hash_block(
+            &parent_hash, test_case.token_ids.data(),
+            test_case.token_ids.size(), extra_keys));
+        passed = passed && hash_hex == test_case.expected_hash;
+
+        LOG(INFO) << "  " << test_case.description << ": "
+                  << (passed ? "PASSED" : "FAILED");
+        if (!passed) {
+            LOG(ERROR) << "  got " << hash_hex << ", expected "
+                       << test_case.expected_hash;
+            all_passed = false;
+        }
+    }
+
+    // Chained hashes must agree with hashing the serialized blocks.
+    std::vector<int64_t> token_ids = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    BlockSerializer serializer;
+    auto serialized_blocks = serializer.serialize_blocks(token_ids, 5);
+    auto hashes = serializer.hash_blocks(token_ids, 5);
+    assert(serialized_blocks.size() == 2 && hashes.size() == 2);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        auto expected = sha256(serialized_blocks[i]);
+        if (!std::equal(expected.begin(), expected.end(), hashes[i].begin())) {
+            LOG(ERROR) << "  chained hash of block " << i << " mismatch";
+            all_passed = false;
+        }
+    }
+    all_passed = all_passed &&
+                 PickleBlockHasher::to_hex(hashes[1]) ==
+                     "3b3f53cad691850fca841706606c71b1320e0515cca38dec3b48f3e3722052be";
+
+    LOG(INFO) << "[TEST] PickleBlockHasher golden compatibility "
+              << (all_passed ? "PASSED" : "FAILED");
+    return all_passed;
+}
+
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+    return mooncake_conductor::test::test_pickle_block_hasher() ? 0 : 1;
+}
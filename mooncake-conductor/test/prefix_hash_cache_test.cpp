@@ -0,0 +1,92 @@
+#include "prefix_hash_cache.h"
+#include "pickle_block_hasher.h"
+
+#include <glog/logging.h>
+
+#include <thread>
+#include <vector>
+
+namespace mooncake_conductor::test {
+
+void test_prefix_hash_cache() {
+    LOG(INFO) << "[TEST] PrefixHashCache";
+
+    const size_t kBlockSize = 4;
+    const size_t kRun = PrefixHashCache::kBlocksPerRun;
+    // Two full runs and a partial one, which is not cached.
+    std::vector<int64_t> turn1(kBlockSize * (kRun * 2 + kRun / 2));
+    for (size_t i = 0; i < turn1.size(); ++i) turn1[i] = i;
+    auto turn2 = turn1;
+    turn2.resize(kBlockSize * kRun * 4, 1000);
+
+    PickleBlockHasher hasher;
+    PrefixHashCache cache(4 * 1024 * 1024);
+
+    std::vector<PickleBlockHasher::BlockHash> expected, hashes;
+    hasher.hash_blocks(turn1, kBlockSize, expected);
+    size_t hashed = cache.hash_blocks(turn1, kBlockSize, hashes);
+    CHECK(hashed == kRun * 2 + kRun / 2 && hashes == expected);
+
+    // Only the suffix of the second turn is hashed.
+    expected.clear();
+    hashes.clear();
+    hasher.hash_blocks(turn2, kBlockSize, expected);
+    hashed = cache.hash_blocks(turn2, kBlockSize, hashes);
+    CHECK(hashed == kRun * 2 && hashes == expected);
+
+    // Same tokens under a different parent must not hit.
+    std::vector<int64_t> shifted(turn2.begin() + kBlockSize * kRun,
+                                 turn2.end());
+    expected.clear();
+    hashes.clear();
+    hasher.hash_blocks(shifted, kBlockSize, expected);
+    hashed = cache.hash_blocks(shifted, kBlockSize, hashes);
+    CHECK(hashed == kRun * 3 && hashes == expected);
+
+    // Same tokens with another block size must not hit either.
+    expected.clear();
+    hashes.clear();
+    hasher.hash_blocks(turn2, kBlockSize * 2, expected);
+    hashed = cache.hash_blocks(turn2, kBlockSize * 2, hashes);
+    CHECK(hashed == kRun * 2 && hashes == expected);
+
+    // Concurrent requests share the cache.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &turn2]() {
+            PickleBlockHasher local_hasher;
+            std::vector<PickleBlockHasher::BlockHash> local_expected,
+                local_hashes;
+            local_hasher.hash_blocks(turn2, kBlockSize, local_expected);
+            for (int i = 0; i < 100; ++i) {
+                local_hashes.clear();
+                cache.hash_blocks(turn2, kBlockSize, local_hashes);
+                CHECK(local_hashes == local_expected);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // The cache stays bounded.
+    PrefixHashCache small_cache(kRun * 16, 2);
+    for (int64_t offset = 0; offset < 8; ++offset) {
+        std::vector<int64_t> tokens(turn2);
+        tokens[0] += offset;
+        hashes.clear();
+        small_cache.hash_blocks(tokens, kBlockSize, hashes);
+    }
+    auto stats = small_cache.stats();
+    CHECK(stats.misses == kRun * 32 && stats.size <= kRun * 16 &&
+           stats.size / kRun + stats.evictions == 32);
+
+    LOG(INFO) << "[TEST] PrefixHashCache PASSED";
+}
+
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = true;
+    mooncake_conductor::test::test_prefix_hash_cache();
+    return 0;
+}
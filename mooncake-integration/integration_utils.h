@@ -34,16 +34,15 @@ enum class TensorDtype : int32_t {
     UNKNOWN = -1
 };
 
+// Views `length` bytes at `data` as a 1-D array without copying, `base` owns
+// the memory and is kept alive by the array.
 template <typename T>
-py::array create_typed_array(char *exported_data, size_t offset,
-                             size_t total_length) {
-    py::capsule free_when_done(
-        exported_data, [](void *p) { delete[] static_cast<char *>(p); });
-    return py::array_t<T>({static_cast<ssize_t>(total_length / sizeof(T))},
-                          (T *)(exported_data + offset), free_when_done);
+py::array create_typed_array(char *data, size_t length, py::handle base) {
+    return py::array_t<T>({static_cast<ssize_t>(length / sizeof(T))},
+                          reinterpret_cast<T *>(data), base);
 }
 
-using ArrayCreatorFunc = std::function<py::array(char *, size_t, size_t)>;
+using ArrayCreatorFunc = std::function<py::array(char *, size_t, py::handle)>;
 
 static const std::array<ArrayCreatorFunc, 16> array_creators = {{
     create_typed_array<float>,     // FLOAT32 = 0
@@ -64,6 +63,23 @@ static const std::array<ArrayCreatorFunc, 16> array_creators = {{
     create_typed_array<int8_t>    // W8A8 = 15 (using int8_t as storage)
 }};
 
+// Name of the torch dtype that a tensor created from the numpy storage array
+// of `dtype` has to be viewed as, nullptr if none is needed.
+inline const char *storage_viewed_dtype(TensorDtype dtype) {
+    switch (dtype) {
+        case TensorDtype::FLOAT16:
+            return "float16";
+        case TensorDtype::BFLOAT16:
+            return "bfloat16";
+        case TensorDtype::FLOAT8_E4M3:
+            return "float8_e4m3fn";
+        case TensorDtype::FLOAT8_E5M2:
+            return "float8_e5m2";
+        default:
+            return nullptr;
+    }
+}
+
 inline TensorDtype get_tensor_dtype(py::object dtype_obj) {
     if (dtype_obj.is_none()) {
         return TensorDtype::UNKNOWN;
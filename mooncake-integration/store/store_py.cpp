@@ -7,6 +7,8 @@
 #include "pybind_client.h"
 
 #include <cstdlib>  // for atexit
+#include <limits>
+#include <optional>
 
 #include "integration_utils.h"
 
@@ -28,6 +30,222 @@ std::vector<std::vector<void *>> CastAddrs2Ptrs(
     }
     return all_buffers;
 }
+
+// Self-describing tensor envelope written by put_tensor_parts(). Slice 0 of
+// the object holds a TensorEnvelopeHeader followed by one TensorPartHeader,
+// shape and strides per part. Every part starts a new slice at an aligned
+// offset, so a subset of the parts can be read by selecting their slices.
+// Objects written by put_tensor() for contiguous tensors of rank <= 4 keep
+// the legacy TensorMetadata layout, whose first field is a small dtype enum
+// that never equals the magic.
+constexpr uint32_t kTensorEnvelopeMagic = 0x4554434d;  // "MCTE"
+constexpr uint16_t kTensorEnvelopeVersion = 1;
+constexpr size_t kTensorEnvelopeAlignment = 64;
+constexpr uint32_t kMaxTensorPartRank = 64;
+
+struct TensorEnvelopeHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t num_parts;
+    uint32_t header_size;  // size of slice 0, a multiple of the alignment
+    uint32_t reserved;
+};
+static_assert(sizeof(TensorEnvelopeHeader) == 16);
+
+struct TensorPartHeader {
+    char dtype[16];  // torch dtype name, e.g. "bfloat16", NUL padded
+    uint32_t element_size;
+    uint32_t ndim;
+    uint64_t data_offset;    // of the part storage in the object
+    uint64_t data_size;      // bytes of the part storage
+    int64_t storage_offset;  // elements before the first element
+    // Followed by int64_t shape[ndim] and int64_t strides[ndim] (elements)
+};
+static_assert(sizeof(TensorPartHeader) == 48);
+
+struct TensorPart {
+    std::string dtype;
+    uint32_t element_size = 0;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides;
+    uint64_t data_offset = 0;
+    uint64_t data_size = 0;
+    int64_t storage_offset = 0;
+    const char *data = nullptr;  // storage to put, unused when reading
+    // Contiguous copy of the tensor `data` points into, if one was made
+    pybind11::object owner;
+};
+
+size_t align_envelope(size_t size) {
+    return (size + kTensorEnvelopeAlignment - 1) /
+           kTensorEnvelopeAlignment * kTensorEnvelopeAlignment;
+}
+
+bool is_tensor_envelope(const void *data, size_t size) {
+    uint32_t magic;
+    if (size < sizeof(magic)) return false;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == kTensorEnvelopeMagic;
+}
+
+// Assigns the data offsets of `parts` and returns the header size.
+size_t layout_tensor_envelope(std::vector<TensorPart> &parts) {
+    size_t header_size = sizeof(TensorEnvelopeHeader);
+    for (const auto &part : parts) {
+        header_size +=
+            sizeof(TensorPartHeader) + 2 * part.shape.size() * sizeof(int64_t);
+    }
+    header_size = align_envelope(header_size);
+    uint64_t offset = header_size;
+    for (auto &part : parts) {
+        part.data_offset = offset;
+        offset += align_envelope(part.data_size);
+    }
+    return header_size;
+}
+
+void write_tensor_envelope_header(const std::vector<TensorPart> &parts,
+                                  size_t header_size, char *out) {
+    memset(out, 0, header_size);
+    TensorEnvelopeHeader header{kTensorEnvelopeMagic, kTensorEnvelopeVersion,
+                                static_cast<uint16_t>(parts.size()),
+                                static_cast<uint32_t>(header_size), 0};
+    memcpy(out, &header, sizeof(header));
+    char *cursor = out + sizeof(header);
+    for (const auto &part : parts) {
+        TensorPartHeader part_header{};
+        memcpy(part_header.dtype, part.dtype.data(),
+               std::min(part.dtype.size(), sizeof(part_header.dtype) - 1));
+        part_header.element_size = part.element_size;
+        part_header.ndim = static_cast<uint32_t>(part.shape.size());
+        part_header.data_offset = part.data_offset;
+        part_header.data_size = part.data_size;
+        part_header.storage_offset = part.storage_offset;
+        memcpy(cursor, &part_header, sizeof(part_header));
+        cursor += sizeof(part_header);
+        size_t dims_size = part.shape.size() * sizeof(int64_t);
+        memcpy(cursor, part.shape.data(), dims_size);
+        cursor += dims_size;
+        memcpy(cursor, part.strides.data(), dims_size);
+        cursor += dims_size;
+    }
+}
+
+// Parses and validates the header of an envelope of `object_size` bytes,
+// `size` bytes of which are available at `data`. Every part is checked to
+// only view its own storage.
+bool parse_tensor_envelope_header(const char *data, size_t size,
+                                  uint64_t object_size,
+                                  std::vector<TensorPart> &parts,
+                                  size_t &header_size) {
+    TensorEnvelopeHeader header;
+    if (size < sizeof(header)) {
+        LOG(ERROR) << "Tensor envelope too small: " << size;
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kTensorEnvelopeMagic ||
+        header.version != kTensorEnvelopeVersion) {
+        LOG(ERROR) << "Unsupported tensor envelope version " << header.version;
+        return false;
+    }
+    if (header.header_size > size || header.header_size > object_size) {
+        LOG(ERROR) << "Truncated tensor envelope header: " << header.header_size
+                   << " bytes, " << size << " available";
+        return false;
+    }
+    header_size = header.header_size;
+
+    parts.clear();
+    parts.reserve(header.num_parts);
+    const char *cursor = data + sizeof(header);
+    const char *end = data + header.header_size;
+    for (uint16_t i = 0; i < header.num_parts; ++i) {
+        TensorPartHeader part_header;
+        if (end - cursor < static_cast<ptrdiff_t>(sizeof(part_header))) {
+            LOG(ERROR) << "Truncated tensor envelope part table";
+            return false;
+        }
+        memcpy(&part_header, cursor, sizeof(part_header));
+        cursor += sizeof(part_header);
+        size_t dims_size = part_header.ndim * sizeof(int64_t);
+        if (part_header.ndim > kMaxTensorPartRank ||
+            end - cursor < static_cast<ptrdiff_t>(2 * dims_size)) {
+            LOG(ERROR) << "Invalid rank of tensor part " << i << ": "
+                       << part_header.ndim;
+            return false;
+        }
+
+        TensorPart part;
+        part.dtype.assign(part_header.dtype,
+                          strnlen(part_header.dtype, sizeof(part_header.dtype)));
+        part.element_size = part_header.element_size;
+        part.data_offset = part_header.data_offset;
+        part.data_size = part_header.data_size;
+        part.storage_offset = part_header.storage_offset;
+        part.shape.resize(part_header.ndim);
+        part.strides.resize(part_header.ndim);
+        memcpy(part.shape.data(), cursor, dims_size);
+        cursor += dims_size;
+        memcpy(part.strides.data(), cursor, dims_size);
+        cursor += dims_size;
+
+        // The highest element viewed must lie within the part storage
+        bool valid = part.element_size > 0 && part.storage_offset >= 0 &&
+                     part.data_offset >= header_size &&
+                     part.data_offset <= object_size &&
+                     part.data_size <= object_size - part.data_offset &&
+                     part.data_size % part.element_size == 0;
+        bool empty = false;
+        uint64_t last = static_cast<uint64_t>(part.storage_offset);
+        for (uint32_t d = 0; valid && d < part_header.ndim; ++d) {
+            valid = part.shape[d] >= 0 && part.strides[d] >= 0;
+            if (part.shape[d] == 0) empty = true;
+            uint64_t extent;
+            valid = valid &&
+                    !__builtin_mul_overflow(
+                        static_cast<uint64_t>(std::max<int64_t>(
+                            part.shape[d] - 1, 0)),
+                        static_cast<uint64_t>(part.strides[d]), &extent) &&
+                    !__builtin_add_overflow(last, extent, &last);
+        }
+        valid = valid &&
+                (empty || last < part.data_size / part.element_size);
+        if (!valid) {
+            LOG(ERROR) << "Invalid layout of tensor part " << i;
+            return false;
+        }
+        parts.push_back(std::move(part));
+    }
+    return true;
+}
+
+// Keeps the parts listed in `indices`, in that order.
+bool select_tensor_parts(std::vector<TensorPart> &parts,
+                         const std::vector<int64_t> &indices) {
+    std::vector<bool> seen(parts.size());
+    std::vector<TensorPart> selected;
+    selected.reserve(indices.size());
+    for (int64_t index : indices) {
+        if (index < 0 || static_cast<size_t>(index) >= parts.size() ||
+            seen[index]) {
+            LOG(ERROR) << "Invalid or duplicate tensor part index " << index
+                       << " of " << parts.size() << " parts";
+            return false;
+        }
+        seen[index] = true;
+        selected.push_back(parts[index]);
+    }
+    parts = std::move(selected);
+    return true;
+}
+
+// Parts of an envelope read from the store, their data offsets are relative
+// to the start of `buffer`.
+struct TensorEnvelope {
+    std::shared_ptr<BufferHandle> buffer;
+    std::vector<TensorPart> parts;
+};
 }  // namespace
 // Python-specific wrapper functions that handle GIL and return pybind11 types
 class MooncakeStorePyWrapper {
@@ -95,80 +313,166 @@ class MooncakeStorePyWrapper {
             return pybind11::none();
         }
 
-        try {
-            // Section with GIL released
+        std::shared_ptr<BufferHandle> buffer_handle;
+        {
             py::gil_scoped_release release_gil;
-            auto buffer_handle = store_->get_buffer(key);
-            if (!buffer_handle) {
-                py::gil_scoped_acquire acquire_gil;
-                return pybind11::none();
-            }
-            // Create contiguous buffer and copy data
-            auto total_length = buffer_handle->size();
-            char *exported_data = new char[total_length];
-            if (!exported_data) {
-                py::gil_scoped_acquire acquire_gil;
-                LOG(ERROR) << "Invalid data format: insufficient data for "
-                              "metadata";
-                return pybind11::none();
-            }
-            TensorMetadata metadata;
-            // Copy data from buffer to contiguous memory
-            memcpy(exported_data, buffer_handle->ptr(), total_length);
-            memcpy(&metadata, exported_data, sizeof(TensorMetadata));
+            buffer_handle = store_->get_buffer(key);
+        }
+        if (!buffer_handle) {
+            return pybind11::none();
+        }
+        return buffer_to_tensor(std::move(buffer_handle));
+    }
 
-            if (metadata.ndim < 0 || metadata.ndim > 4) {
-                delete[] exported_data;
-                py::gil_scoped_acquire acquire_gil;
-                LOG(ERROR) << "Invalid tensor metadata: ndim=" << metadata.ndim;
-                return pybind11::none();
-            }
+    std::vector<pybind11::object> batch_get_tensor(
+        const std::vector<std::string> &keys) {
+        if (!store_ || !store_->client_) {
+            LOG(ERROR) << "Client is not initialized";
+            return std::vector<pybind11::object>(keys.size(),
+                                                 pybind11::none());
+        }
 
-            TensorDtype dtype_enum = static_cast<TensorDtype>(metadata.dtype);
-            if (dtype_enum == TensorDtype::UNKNOWN) {
-                delete[] exported_data;
-                py::gil_scoped_acquire acquire_gil;
-                LOG(ERROR) << "Unknown tensor dtype!";
-                return pybind11::none();
-            }
+        std::vector<std::shared_ptr<BufferHandle>> buffer_handles;
+        {
+            py::gil_scoped_release release_gil;
+            buffer_handles = store_->batch_get_buffer(keys);
+        }
 
-            size_t tensor_size = total_length - sizeof(TensorMetadata);
-            if (tensor_size == 0) {
-                delete[] exported_data;
-                py::gil_scoped_acquire acquire_gil;
-                LOG(ERROR) << "Invalid data format: no tensor data found";
-                return pybind11::none();
+        std::vector<pybind11::object> tensors;
+        tensors.reserve(keys.size());
+        for (auto &buffer_handle : buffer_handles) {
+            if (buffer_handle) {
+                tensors.push_back(buffer_to_tensor(std::move(buffer_handle)));
+            } else {
+                tensors.push_back(pybind11::none());
             }
+        }
+        return tensors;
+    }
 
-            py::gil_scoped_acquire acquire_gil;
-            // Convert bytes to tensor using torch.from_numpy
-            pybind11::object np_array;
-            int dtype_index = static_cast<int>(dtype_enum);
-            if (dtype_index >= 0 &&
-                dtype_index < static_cast<int>(array_creators.size())) {
-                np_array = array_creators[dtype_index](
-                    exported_data, sizeof(TensorMetadata), tensor_size);
-            } else {
-                LOG(ERROR) << "Unsupported dtype enum: " << dtype_index;
-                return pybind11::none();
+    int64_t get_tensor_into(const std::string &key, pybind11::object tensor) {
+        if (!store_ || !store_->client_) {
+            LOG(ERROR) << "Client is not initialized";
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+
+        TensorMetadata expected;
+        uintptr_t data_ptr;
+        size_t tensor_size;
+        if (!describe_tensor(tensor, data_ptr, tensor_size, expected)) {
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+
+        py::gil_scoped_release release_gil;
+        auto query_result = store_->client_->Query(key);
+        if (!query_result) {
+            return toInt(query_result.error());
+        }
+        const Replica::Descriptor *replica = nullptr;
+        for (const auto &candidate : query_result->replicas) {
+            if (candidate.status == ReplicaStatus::COMPLETE &&
+                candidate.is_memory_replica()) {
+                replica = &candidate;
+                break;
+            }
+        }
+        char *data = reinterpret_cast<char *>(data_ptr);
+        if (!replica) {
+            // Disk replicas are read whole into a staging buffer
+            auto buffer = store_->get_buffer(key);
+            if (!buffer) {
+                return toInt(ErrorCode::OBJECT_NOT_FOUND);
+            }
+            if (!matches_stored_tensor(key, buffer->ptr(), buffer->size(),
+                                       tensor_size, expected)) {
+                return toInt(ErrorCode::INVALID_PARAMS);
             }
+            memcpy(data,
+                   static_cast<char *>(buffer->ptr()) + sizeof(TensorMetadata),
+                   tensor_size);
+            return static_cast<int64_t>(tensor_size);
+        }
 
-            if (metadata.ndim > 0) {
-                std::vector<int> shape_vec;
-                for (int i = 0; i < metadata.ndim; i++) {
-                    shape_vec.push_back(metadata.shape[i]);
-                }
-                py::tuple shape_tuple = py::cast(shape_vec);
-                np_array = np_array.attr("reshape")(shape_tuple);
+        const auto &descriptors =
+            replica->get_memory_descriptor().buffer_descriptors;
+        uint64_t object_size = 0;
+        for (const auto &descriptor : descriptors) {
+            object_size += descriptor.size_;
+        }
+        if (descriptors.empty() ||
+            descriptors[0].size_ < sizeof(TensorMetadata)) {
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+        // Reads from this replica only, the slices match its buffers
+        QueryResult replica_query({*replica}, query_result->lease_timeout);
+
+        // The first buffer holds the metadata header, it is checked before
+        // anything is written into the destination tensor.
+        auto header = store_->client_buffer_allocator_->allocate(
+            descriptors[0].size_);
+        if (!header) {
+            LOG(ERROR) << "Failed to allocate tensor metadata buffer for key: "
+                       << key;
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+        std::vector<Slice> slices;
+        for (const auto &descriptor : descriptors) {
+            slices.push_back({slices.empty() ? header->ptr() : nullptr,
+                              descriptor.size_});
+        }
+        auto get_result = store_->client_->Get(key, replica_query, slices);
+        if (!get_result) {
+            return toInt(get_result.error());
+        }
+        if (!matches_stored_tensor(key, header->ptr(), object_size,
+                                   tensor_size, expected)) {
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+
+        // The rest of the payload lands directly in the tensor
+        uint64_t head_size = descriptors[0].size_ - sizeof(TensorMetadata);
+        memcpy(data,
+               static_cast<char *>(header->ptr()) + sizeof(TensorMetadata),
+               head_size);
+        if (descriptors.size() > 1) {
+            uint64_t offset = head_size;
+            slices[0].ptr = nullptr;
+            for (size_t i = 1; i < descriptors.size(); ++i) {
+                slices[i].ptr = data + offset;
+                offset += descriptors[i].size_;
             }
-            pybind11::object tensor =
-                torch_module().attr("from_numpy")(np_array);
-            return tensor;
+            get_result = store_->client_->Get(key, replica_query, slices);
+            if (!get_result) {
+                return toInt(get_result.error());
+            }
+        }
+        return static_cast<int64_t>(tensor_size);
+    }
 
-        } catch (const pybind11::error_already_set &e) {
-            LOG(ERROR) << "Failed to get tensor data: " << e.what();
-            return pybind11::none();
+    // Checks that an object of `object_size` bytes starting with `header`
+    // holds a legacy tensor of the destination's dtype and size.
+    static bool matches_stored_tensor(const std::string &key,
+                                      const void *header, size_t object_size,
+                                      size_t tensor_size,
+                                      const TensorMetadata &expected) {
+        if (object_size < sizeof(TensorMetadata) ||
+            is_tensor_envelope(header, object_size)) {
+            LOG(ERROR) << "Object stored under key " << key
+                       << " is not a single tensor";
+            return false;
         }
+        TensorMetadata metadata;
+        memcpy(&metadata, header, sizeof(TensorMetadata));
+        size_t stored_size = object_size - sizeof(TensorMetadata);
+        if (stored_size != tensor_size || metadata.dtype != expected.dtype) {
+            LOG(ERROR) << "Tensor stored under key " << key
+                       << " does not match the destination tensor: "
+                       << stored_size << " bytes of dtype " << metadata.dtype
+                       << ", expected " << tensor_size << " bytes of dtype "
+                       << expected.dtype;
+            return false;
+        }
+        return true;
     }
 
     int put_tensor(const std::string &key, pybind11::object tensor) {
@@ -176,19 +480,192 @@ class MooncakeStorePyWrapper {
             LOG(ERROR) << "Client is not initialized";
             return -static_cast<int>(ErrorCode::INVALID_PARAMS);
         }
+
+        // Tensors the legacy metadata cannot describe are stored as a single
+        // part envelope.
+        if (!fits_tensor_metadata(tensor)) {
+            std::vector<TensorPart> parts(1);
+            if (!describe_tensor_part(tensor, parts[0])) {
+                return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+            }
+            py::gil_scoped_release release_gil;
+            auto put_result =
+                put_tensor_envelope(key, parts, ReplicateConfig{});
+            return put_result ? 0 : -static_cast<int>(put_result.error());
+        }
+
+        TensorMetadata metadata;
+        uintptr_t data_ptr;
+        size_t tensor_size;
+        if (!describe_tensor(tensor, data_ptr, tensor_size, metadata)) {
+            return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+        }
+
+        // Section with GIL released
+        py::gil_scoped_release release_gil;
+        char *buffer = reinterpret_cast<char *>(data_ptr);
+        char *metadata_buffer = reinterpret_cast<char *>(&metadata);
+        std::vector<std::span<const char>> values;
+        values.emplace_back(
+            std::span<const char>(metadata_buffer, sizeof(TensorMetadata)));
+        values.emplace_back(std::span<const char>(buffer, tensor_size));
+
+        // Use put_parts to put metadata and tensor together
+        auto put_result = store_->put_parts_internal(key, values);
+        if (!put_result) {
+            return -static_cast<int>(put_result.error());
+        }
+
+        return 0;
+    }
+
+    std::vector<int> batch_put_tensor(
+        const std::vector<std::string> &keys,
+        const std::vector<pybind11::object> &tensors,
+        const ReplicateConfig &config) {
+        if (!store_ || !store_->client_) {
+            LOG(ERROR) << "Client is not initialized";
+            return std::vector<int>(keys.size(),
+                                    toInt(ErrorCode::INVALID_PARAMS));
+        }
+        if (keys.size() != tensors.size()) {
+            LOG(ERROR) << "Key and tensor size mismatch";
+            return std::vector<int>(keys.size(),
+                                    toInt(ErrorCode::INVALID_PARAMS));
+        }
+
+        std::vector<TensorMetadata> metadatas(tensors.size());
+        std::vector<std::vector<std::span<const char>>> all_values(
+            tensors.size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            uintptr_t data_ptr;
+            size_t tensor_size;
+            if (!describe_tensor(tensors[i], data_ptr, tensor_size,
+                                 metadatas[i])) {
+                return std::vector<int>(keys.size(),
+                                        toInt(ErrorCode::INVALID_PARAMS));
+            }
+            all_values[i] = {
+                std::span<const char>(reinterpret_cast<char *>(&metadatas[i]),
+                                      sizeof(TensorMetadata)),
+                std::span<const char>(reinterpret_cast<char *>(data_ptr),
+                                      tensor_size)};
+        }
+
+        py::gil_scoped_release release_gil;
+        return store_->batch_put_parts(keys, all_values, config);
+    }
+
+    int put_tensor_parts(const std::string &key,
+                         const std::vector<pybind11::object> &tensors,
+                         const ReplicateConfig &config) {
+        if (!store_ || !store_->client_) {
+            LOG(ERROR) << "Client is not initialized";
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+        if (tensors.empty() ||
+            tensors.size() > std::numeric_limits<uint16_t>::max()) {
+            LOG(ERROR) << "Invalid number of tensor parts: " << tensors.size();
+            return toInt(ErrorCode::INVALID_PARAMS);
+        }
+
+        std::vector<TensorPart> parts(tensors.size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            if (!describe_tensor_part(tensors[i], parts[i])) {
+                return toInt(ErrorCode::INVALID_PARAMS);
+            }
+        }
+
+        py::gil_scoped_release release_gil;
+        return to_py_ret(put_tensor_envelope(key, parts, config));
+    }
+
+    pybind11::object get_tensor_parts(
+        const std::string &key,
+        const std::optional<std::vector<int64_t>> &indices) {
+        if (!store_ || !store_->client_) {
+            LOG(ERROR) << "Client is not initialized";
+            return pybind11::none();
+        }
+
+        std::shared_ptr<BufferHandle> legacy_buffer;
+        TensorEnvelope envelope;
+        bool ok = true;
+        {
+            py::gil_scoped_release release_gil;
+            if (!indices || !get_tensor_envelope_parts(key, *indices,
+                                                        envelope)) {
+                // Read the whole object, for all parts or if the selected
+                // ones could not be read on their own
+                envelope.buffer = store_->get_buffer(key);
+                size_t header_size;
+                if (!envelope.buffer) {
+                    ok = false;
+                } else if (!is_tensor_envelope(envelope.buffer->ptr(),
+                                               envelope.buffer->size())) {
+                    legacy_buffer = std::move(envelope.buffer);
+                } else {
+                    ok = parse_tensor_envelope_header(
+                             static_cast<char *>(envelope.buffer->ptr()),
+                             envelope.buffer->size(), envelope.buffer->size(),
+                             envelope.parts, header_size) &&
+                         (!indices ||
+                          select_tensor_parts(envelope.parts, *indices));
+                }
+            }
+        }
+        if (!ok) {
+            return pybind11::none();
+        }
+
+        // A put_tensor() object has a single part
+        if (legacy_buffer) {
+            pybind11::list tensors;
+            if (indices && (indices->size() != 1 || indices->at(0) != 0)) {
+                LOG(ERROR) << "Key " << key << " holds a single tensor";
+                return pybind11::none();
+            }
+            pybind11::object tensor =
+                buffer_to_tensor(std::move(legacy_buffer));
+            if (tensor.is_none()) {
+                return pybind11::none();
+            }
+            tensors.append(tensor);
+            return std::move(tensors);
+        }
+        return envelope_to_tensors(envelope);
+    }
+
+   private:
+    // Fills in the data pointer, payload size and stored metadata of a
+    // contiguous tensor. Must be called with the GIL held.
+    static bool describe_tensor(const pybind11::object &tensor,
+                                uintptr_t &data_ptr, size_t &tensor_size,
+                                TensorMetadata &metadata) {
         try {
             if (!(tensor.attr("__class__")
                       .attr("__name__")
                       .cast<std::string>()
                       .find("Tensor") != std::string::npos)) {
                 LOG(ERROR) << "Input is not a PyTorch tensor";
-                return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+                return false;
+            }
+            // The data is copied with memcpy, which needs host memory
+            std::string device =
+                tensor.attr("device").attr("type").cast<std::string>();
+            if (device != "cpu") {
+                LOG(ERROR) << "Tensor is not on the CPU: " << device;
+                return false;
+            }
+            if (!tensor.attr("is_contiguous")().cast<bool>()) {
+                LOG(ERROR) << "Tensor is not contiguous";
+                return false;
             }
 
-            uintptr_t data_ptr = tensor.attr("data_ptr")().cast<uintptr_t>();
+            data_ptr = tensor.attr("data_ptr")().cast<uintptr_t>();
             size_t numel = tensor.attr("numel")().cast<size_t>();
             size_t element_size = tensor.attr("element_size")().cast<size_t>();
-            size_t tensor_size = numel * element_size;
+            tensor_size = numel * element_size;
 
             pybind11::object shape_obj = tensor.attr("shape");
             pybind11::object dtype_obj = tensor.attr("dtype");
@@ -196,7 +673,7 @@ class MooncakeStorePyWrapper {
             TensorDtype dtype_enum = get_tensor_dtype(dtype_obj);
             if (dtype_enum == TensorDtype::UNKNOWN) {
                 LOG(ERROR) << "Unsupported tensor dtype!";
-                return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+                return false;
             }
 
             pybind11::tuple shape_tuple =
@@ -204,10 +681,9 @@ class MooncakeStorePyWrapper {
             int32_t ndim = static_cast<int32_t>(shape_tuple.size());
             if (ndim > 4) {
                 LOG(ERROR) << "Tensor has more than 4 dimensions: " << ndim;
-                return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+                return false;
             }
 
-            TensorMetadata metadata;
             metadata.dtype = static_cast<int32_t>(dtype_enum);
             metadata.ndim = ndim;
 
@@ -218,26 +694,399 @@ class MooncakeStorePyWrapper {
                     metadata.shape[i] = -1;
                 }
             }
+            return true;
+        } catch (const pybind11::error_already_set &e) {
+            LOG(ERROR) << "Failed to access tensor data: " << e.what();
+            return false;
+        }
+    }
 
-            // Section with GIL released
-            py::gil_scoped_release release_gil;
-            char *buffer = reinterpret_cast<char *>(data_ptr);
-            char *metadata_buffer = reinterpret_cast<char *>(&metadata);
-            std::vector<std::span<const char>> values;
-            values.emplace_back(
-                std::span<const char>(metadata_buffer, sizeof(TensorMetadata)));
-            values.emplace_back(std::span<const char>(buffer, tensor_size));
+    // Whether put_tensor() can store the tensor with the legacy
+    // TensorMetadata header. Must be called with the GIL held.
+    static bool fits_tensor_metadata(const pybind11::object &tensor) {
+        try {
+            if (!tensor.attr("is_contiguous")().cast<bool>() ||
+                get_tensor_dtype(tensor.attr("dtype")) ==
+                    TensorDtype::UNKNOWN) {
+                return false;
+            }
+            pybind11::tuple shape = tensor.attr("shape");
+            if (shape.size() > 4) {
+                return false;
+            }
+            for (auto dim : shape) {
+                if (dim.cast<int64_t>() > std::numeric_limits<int32_t>::max())
+                    return false;
+            }
+            return true;
+        } catch (const pybind11::error_already_set &e) {
+            // Not a tensor, describe_tensor() reports it
+            return true;
+        }
+    }
 
-            // Use put_parts to put metadata and tensor together
-            auto put_result = store_->put_parts_internal(key, values);
-            if (!put_result) {
-                return -static_cast<int>(put_result.error());
+    // Describes a tensor of any layout as an envelope part. The stored
+    // storage spans the elements the tensor views, so dense non-contiguous
+    // tensors, e.g. transposed ones, are stored without being made
+    // contiguous first. Views skipping elements of their storage, e.g.
+    // slices, are made contiguous so that only their own elements are
+    // stored. Must be called with the GIL held.
+    static bool describe_tensor_part(const pybind11::object &tensor,
+                                     TensorPart &part) {
+        try {
+            if (tensor.attr("__class__")
+                    .attr("__name__")
+                    .cast<std::string>()
+                    .find("Tensor") == std::string::npos) {
+                LOG(ERROR) << "Input is not a PyTorch tensor";
+                return false;
+            }
+            std::string device =
+                tensor.attr("device").attr("type").cast<std::string>();
+            if (device != "cpu") {
+                LOG(ERROR) << "Tensor is not on the CPU: " << device;
+                return false;
             }
 
-            return 0;
+            part.dtype = pybind11::str(tensor.attr("dtype")).cast<std::string>();
+            const std::string kPrefix = "torch.";
+            if (part.dtype.compare(0, kPrefix.size(), kPrefix) == 0) {
+                part.dtype.erase(0, kPrefix.size());
+            }
+            if (part.dtype.size() >= sizeof(TensorPartHeader::dtype)) {
+                LOG(ERROR) << "Unsupported tensor dtype: " << part.dtype;
+                return false;
+            }
+            part.element_size = tensor.attr("element_size")().cast<uint32_t>();
+            part.shape = tensor.attr("shape").cast<std::vector<int64_t>>();
+            part.strides = tensor.attr("stride")().cast<std::vector<int64_t>>();
+            if (part.shape.size() > kMaxTensorPartRank) {
+                LOG(ERROR) << "Tensor has too many dimensions: "
+                           << part.shape.size();
+                return false;
+            }
+
+            // data_ptr() is the first element, the storage offset is only
+            // needed to read elements before it.
+            uint64_t extent = 1;
+            for (size_t d = 0; d < part.shape.size(); ++d) {
+                if (part.shape[d] == 0) {
+                    extent = 0;
+                    break;
+                }
+                extent += (part.shape[d] - 1) * part.strides[d];
+            }
+            uint64_t numel = tensor.attr("numel")().cast<uint64_t>();
+            if (extent > numel) {
+                part.owner = tensor.attr("contiguous")();
+                return describe_tensor_part(part.owner, part);
+            }
+            part.storage_offset = 0;
+            part.data_size = extent * part.element_size;
+            part.data = reinterpret_cast<const char *>(
+                tensor.attr("data_ptr")().cast<uintptr_t>());
+            return true;
         } catch (const pybind11::error_already_set &e) {
             LOG(ERROR) << "Failed to access tensor data: " << e.what();
-            return -static_cast<int>(ErrorCode::INVALID_PARAMS);
+            return false;
+        }
+    }
+
+    // Stores `parts` as one envelope object. Slice 0 holds the header and
+    // every part gets slices of its own, so that it can be read alone.
+    tl::expected<void, ErrorCode> put_tensor_envelope(
+        const std::string &key, std::vector<TensorPart> &parts,
+        const ReplicateConfig &config) {
+        if (config.prefer_alloc_in_same_node) {
+            LOG(ERROR) << "prefer_alloc_in_same_node is not supported.";
+            return tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        size_t header_size = layout_tensor_envelope(parts);
+        if (header_size > kMaxSliceSize) {
+            LOG(ERROR) << "Tensor envelope header too large: " << header_size;
+            return tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        size_t total_size = parts.back().data_offset +
+                            align_envelope(parts.back().data_size);
+
+        auto alloc_result =
+            store_->client_buffer_allocator_->allocate(total_size);
+        if (!alloc_result) {
+            LOG(ERROR) << "Failed to allocate buffer for tensor envelope, key: "
+                       << key << ", total size: " << total_size;
+            return tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        char *buffer = static_cast<char *>(alloc_result->ptr());
+
+        std::vector<Slice> slices;
+        write_tensor_envelope_header(parts, header_size, buffer);
+        slices.push_back({buffer, header_size});
+        for (const auto &part : parts) {
+            char *data = buffer + part.data_offset;
+            size_t aligned_size = align_envelope(part.data_size);
+            memcpy(data, part.data, part.data_size);
+            memset(data + part.data_size, 0, aligned_size - part.data_size);
+            for (size_t offset = 0; offset < aligned_size;) {
+                size_t chunk_size =
+                    std::min<size_t>(aligned_size - offset, kMaxSliceSize);
+                slices.push_back({data + offset, chunk_size});
+                offset += chunk_size;
+            }
+        }
+
+        auto put_result = store_->client_->Put(key, slices, config);
+        if (!put_result) {
+            LOG(ERROR) << "Put operation failed with error: "
+                       << toString(put_result.error());
+            return tl::unexpected(put_result.error());
+        }
+        return {};
+    }
+
+    // Reads the header and the `indices` parts of an envelope into a
+    // compact buffer, leaving out the slices of the other parts. Returns
+    // false if the parts cannot be read on their own, e.g. from a disk
+    // replica, in which case the whole object has to be read.
+    bool get_tensor_envelope_parts(const std::string &key,
+                                   const std::vector<int64_t> &indices,
+                                   TensorEnvelope &envelope) {
+        auto query_result = store_->client_->Query(key);
+        if (!query_result) {
+            return false;
+        }
+        const Replica::Descriptor *replica = nullptr;
+        for (const auto &candidate : query_result->replicas) {
+            if (candidate.status == ReplicaStatus::COMPLETE &&
+                candidate.is_memory_replica()) {
+                replica = &candidate;
+                break;
+            }
+        }
+        if (!replica) {
+            return false;
+        }
+        const auto &descriptors =
+            replica->get_memory_descriptor().buffer_descriptors;
+        if (descriptors.empty()) {
+            return false;
+        }
+        // Reads from this replica only, the slices match its buffers
+        QueryResult replica_query({*replica}, query_result->lease_timeout);
+
+        auto header = store_->client_buffer_allocator_->allocate(
+            descriptors[0].size_);
+        if (!header) {
+            LOG(ERROR) << "Failed to allocate tensor envelope header buffer "
+                          "for key: "
+                       << key;
+            return false;
+        }
+        uint64_t object_size = 0;
+        std::vector<Slice> slices;
+        for (const auto &descriptor : descriptors) {
+            slices.push_back({slices.empty() ? header->ptr() : nullptr,
+                              descriptor.size_});
+            object_size += descriptor.size_;
+        }
+        if (!store_->client_->Get(key, replica_query, slices)) {
+            return false;
+        }
+
+        size_t header_size;
+        std::vector<TensorPart> parts;
+        if (!is_tensor_envelope(header->ptr(), header->size()) ||
+            !parse_tensor_envelope_header(static_cast<char *>(header->ptr()),
+                                          header->size(), object_size, parts,
+                                          header_size) ||
+            !select_tensor_parts(parts, indices)) {
+            return false;
+        }
+
+        // Pack the selected parts, aligned as in the object
+        std::vector<uint64_t> compact_offsets;
+        uint64_t compact_size = 0;
+        for (const auto &part : parts) {
+            compact_offsets.push_back(compact_size);
+            compact_size += align_envelope(part.data_size);
+        }
+        std::shared_ptr<BufferHandle> buffer;
+        if (compact_size == 0) {
+            buffer = std::make_shared<BufferHandle>(std::move(*header));
+        } else {
+            auto alloc_result =
+                store_->client_buffer_allocator_->allocate(compact_size);
+            if (!alloc_result) {
+                LOG(ERROR) << "Failed to allocate buffer for tensor parts, "
+                              "key: "
+                           << key << ", total size: " << compact_size;
+                return false;
+            }
+            buffer = std::make_shared<BufferHandle>(std::move(*alloc_result));
+        }
+
+        // Every buffer of the replica lies within a single part
+        std::vector<uint64_t> covered(parts.size());
+        uint64_t offset = 0;
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            uint64_t size = descriptors[i].size_;
+            slices[i].ptr = nullptr;
+            for (size_t p = 0; p < parts.size(); ++p) {
+                uint64_t begin = parts[p].data_offset;
+                uint64_t end = begin + align_envelope(parts[p].data_size);
+                if (offset >= begin && offset + size <= end) {
+                    slices[i].ptr = static_cast<char *>(buffer->ptr()) +
+                                    compact_offsets[p] + (offset - begin);
+                    covered[p] += size;
+                    break;
+                }
+            }
+            offset += size;
+        }
+        for (size_t p = 0; p < parts.size(); ++p) {
+            if (covered[p] != align_envelope(parts[p].data_size)) {
+                LOG(WARNING) << "Tensor part " << indices[p] << " of key "
+                             << key << " is not stored in slices of its own";
+                return false;
+            }
+            parts[p].data_offset = compact_offsets[p];
+        }
+        if (compact_size > 0 &&
+            !store_->client_->Get(key, replica_query, slices)) {
+            return false;
+        }
+
+        envelope.buffer = std::move(buffer);
+        envelope.parts = std::move(parts);
+        return true;
+    }
+
+    // Creates a tensor per envelope part, viewing the envelope buffer
+    // without copying. Must be called with the GIL held.
+    static pybind11::object envelope_to_tensors(
+        const TensorEnvelope &envelope) {
+        try {
+            auto torch = torch_module();
+            py::capsule owner(
+                new std::shared_ptr<BufferHandle>(envelope.buffer),
+                [](void *p) {
+                    delete static_cast<std::shared_ptr<BufferHandle> *>(p);
+                });
+            pybind11::list tensors;
+            for (const auto &part : envelope.parts) {
+                if (!py::hasattr(torch, part.dtype.c_str())) {
+                    LOG(ERROR) << "Unsupported tensor dtype: " << part.dtype;
+                    return pybind11::none();
+                }
+                pybind11::object dtype = torch.attr(part.dtype.c_str());
+                if (!py::isinstance(dtype, torch.attr("dtype")) ||
+                    torch.attr("empty")(0, py::arg("dtype") = dtype)
+                            .attr("element_size")()
+                            .cast<uint32_t>() != part.element_size) {
+                    LOG(ERROR) << "Tensor dtype " << part.dtype
+                               << " does not match its element size "
+                               << part.element_size;
+                    return pybind11::none();
+                }
+
+                char *data =
+                    static_cast<char *>(envelope.buffer->ptr()) +
+                    part.data_offset;
+                pybind11::object storage = torch.attr("from_numpy")(
+                    create_typed_array<uint8_t>(data, part.data_size, owner));
+                tensors.append(storage.attr("view")(dtype).attr("as_strided")(
+                    py::cast(part.shape), py::cast(part.strides),
+                    part.storage_offset));
+            }
+            return std::move(tensors);
+        } catch (const pybind11::error_already_set &e) {
+            LOG(ERROR) << "Failed to get tensor data: " << e.what();
+            return pybind11::none();
+        }
+    }
+
+    // Wraps a stored tensor into a tensor that views the buffer handle
+    // memory without copying, the handle is released along with the last
+    // view. Must be called with the GIL held.
+    static pybind11::object buffer_to_tensor(
+        std::shared_ptr<BufferHandle> buffer_handle) {
+        auto total_length = buffer_handle->size();
+        if (is_tensor_envelope(buffer_handle->ptr(), total_length)) {
+            TensorEnvelope envelope{std::move(buffer_handle), {}};
+            size_t header_size;
+            if (!parse_tensor_envelope_header(
+                    static_cast<char *>(envelope.buffer->ptr()),
+                    total_length, total_length, envelope.parts,
+                    header_size)) {
+                return pybind11::none();
+            }
+            if (envelope.parts.size() != 1) {
+                LOG(ERROR) << "Object holds " << envelope.parts.size()
+                           << " tensors, use get_tensor_parts";
+                return pybind11::none();
+            }
+            pybind11::object tensors = envelope_to_tensors(envelope);
+            if (tensors.is_none()) {
+                return tensors;
+            }
+            return tensors[py::int_(0)];
+        }
+        if (total_length < sizeof(TensorMetadata)) {
+            LOG(ERROR) << "Invalid data format: insufficient data for "
+                          "metadata";
+            return pybind11::none();
+        }
+        TensorMetadata metadata;
+        memcpy(&metadata, buffer_handle->ptr(), sizeof(TensorMetadata));
+
+        if (metadata.ndim < 0 || metadata.ndim > 4) {
+            LOG(ERROR) << "Invalid tensor metadata: ndim=" << metadata.ndim;
+            return pybind11::none();
+        }
+
+        TensorDtype dtype_enum = static_cast<TensorDtype>(metadata.dtype);
+        int dtype_index = static_cast<int>(dtype_enum);
+        if (dtype_index < 0 ||
+            dtype_index >= static_cast<int>(array_creators.size())) {
+            LOG(ERROR) << "Unsupported dtype enum: " << dtype_index;
+            return pybind11::none();
+        }
+
+        size_t tensor_size = total_length - sizeof(TensorMetadata);
+        if (tensor_size == 0) {
+            LOG(ERROR) << "Invalid data format: no tensor data found";
+            return pybind11::none();
+        }
+
+        try {
+            char *data = static_cast<char *>(buffer_handle->ptr()) +
+                         sizeof(TensorMetadata);
+            py::capsule owner(
+                new std::shared_ptr<BufferHandle>(std::move(buffer_handle)),
+                [](void *p) {
+                    delete static_cast<std::shared_ptr<BufferHandle> *>(p);
+                });
+            pybind11::object np_array =
+                array_creators[dtype_index](data, tensor_size, owner);
+
+            if (metadata.ndim > 0) {
+                std::vector<int> shape_vec;
+                for (int i = 0; i < metadata.ndim; i++) {
+                    shape_vec.push_back(metadata.shape[i]);
+                }
+                py::tuple shape_tuple = py::cast(shape_vec);
+                np_array = np_array.attr("reshape")(shape_tuple);
+            }
+            pybind11::object tensor =
+                torch_module().attr("from_numpy")(np_array);
+            // numpy has no such types, they are stored as integers of the
+            // same width
+            if (const char *name = storage_viewed_dtype(dtype_enum)) {
+                tensor = tensor.attr("view")(torch_module().attr(name));
+            }
+            return tensor;
+        } catch (const pybind11::error_already_set &e) {
+            LOG(ERROR) << "Failed to get tensor data: " << e.what();
+            return pybind11::none();
         }
     }
 };
@@ -251,6 +1100,8 @@ PYBIND11_MODULE(store, m) {
         .def_readwrite("preferred_segment", &ReplicateConfig::preferred_segment)
         .def_readwrite("prefer_alloc_in_same_node",
                        &ReplicateConfig::prefer_alloc_in_same_node)
+        .def_readwrite("namespace_name", &ReplicateConfig::namespace_name)
+        .def_readwrite("content_hash", &ReplicateConfig::content_hash)
         .def("__str__", [](const ReplicateConfig &config) {
             std::ostringstream oss;
             oss << config;
@@ -333,6 +1184,21 @@ PYBIND11_MODULE(store, m) {
                  return self.store_->initAll(protocol, device_name,
                                              mount_segment_size);
              })
+        .def(
+            "mount_segments",
+            [](MooncakeStorePyWrapper &self, size_t size_per_node,
+               size_t page_size, const std::vector<int> &numa_nodes,
+               size_t prefault_threads) {
+                py::gil_scoped_release release;
+                return self.store_->mount_segments(
+                    size_per_node, page_size, numa_nodes, prefault_threads);
+            },
+            py::arg("size_per_node"), py::arg("page_size") = 0,
+            py::arg("numa_nodes") = std::vector<int>{},
+            py::arg("prefault_threads") = 8,
+            "Mount a segment of size_per_node bytes on each NUMA node, "
+            "backed by huge pages of page_size bytes (2MB or 1GB, 0 for "
+            "regular pages) and faulted in by prefault_threads threads")
         .def("get", &MooncakeStorePyWrapper::get)
         .def("get_batch", &MooncakeStorePyWrapper::get_batch)
         .def(
@@ -364,11 +1230,36 @@ PYBIND11_MODULE(store, m) {
             py::arg("regex_pattern"),
             "Removes objects from the store whose keys match the given "
             "regular expression.")
+        .def(
+            "remove_by_prefix",
+            [](MooncakeStorePyWrapper &self, const std::string &prefix) {
+                py::gil_scoped_release release;
+                return self.store_->removeByPrefix(prefix);
+            },
+            py::arg("prefix"),
+            "Removes objects from the store whose keys start with the given "
+            "prefix.")
         .def("remove_all",
              [](MooncakeStorePyWrapper &self) {
                  py::gil_scoped_release release;
                  return self.store_->removeAll();
              })
+        .def(
+            "set_namespace_quota",
+            [](MooncakeStorePyWrapper &self, const std::string &name,
+               uint64_t quota) {
+                py::gil_scoped_release release;
+                return self.store_->setNamespaceQuota(name, quota);
+            },
+            py::arg("name"), py::arg("quota"),
+            "Sets the memory quota in bytes of a namespace, 0 for no quota.")
+        .def(
+            "drop_namespace",
+            [](MooncakeStorePyWrapper &self, const std::string &name) {
+                py::gil_scoped_release release;
+                return self.store_->dropNamespace(name);
+            },
+            py::arg("name"), "Drops all objects of a namespace.")
         .def("is_exist",
              [](MooncakeStorePyWrapper &self, const std::string &key) {
                  py::gil_scoped_release release;
@@ -397,9 +1288,41 @@ PYBIND11_MODULE(store, m) {
                  return self.store_->getSize(key);
              })
         .def("get_tensor", &MooncakeStorePyWrapper::get_tensor, py::arg("key"),
-             "Get a PyTorch tensor from the store")
+             "Get a PyTorch tensor from the store. The tensor views the "
+             "client's local buffer without copying, which is held until the "
+             "tensor is freed")
+        .def("batch_get_tensor", &MooncakeStorePyWrapper::batch_get_tensor,
+             py::arg("keys"),
+             "Get PyTorch tensors for multiple keys with one batch transfer, "
+             "None for each key that could not be read")
+        .def("get_tensor_into", &MooncakeStorePyWrapper::get_tensor_into,
+             py::arg("key"), py::arg("tensor"),
+             "Get a PyTorch tensor directly into a pre-allocated contiguous "
+             "CPU tensor of the same dtype and size (must be registered with "
+             "register_buffer for RDMA). Returns the number of bytes read, or "
+             "a negative value on error")
         .def("put_tensor", &MooncakeStorePyWrapper::put_tensor, py::arg("key"),
-             py::arg("tensor"), "Put a PyTorch tensor into the store")
+             py::arg("tensor"),
+             "Put a PyTorch tensor into the store. Tensors of any layout are "
+             "supported, non-contiguous ones are stored without a copy to a "
+             "contiguous tensor")
+        .def("batch_put_tensor", &MooncakeStorePyWrapper::batch_put_tensor,
+             py::arg("keys"), py::arg("tensors"),
+             py::arg("config") = ReplicateConfig{},
+             "Put PyTorch tensors for multiple keys with one batch transfer. "
+             "Returns a list of 0 on success or a negative value on error")
+        .def("put_tensor_parts", &MooncakeStorePyWrapper::put_tensor_parts,
+             py::arg("key"), py::arg("tensors"),
+             py::arg("config") = ReplicateConfig{},
+             "Put a list of PyTorch tensors of any shape, strides and dtype, "
+             "e.g. the layers or tensor parallel shards of a KV cache block, "
+             "as one object whose parts can be read individually. Returns 0 "
+             "on success or a negative value on error")
+        .def("get_tensor_parts", &MooncakeStorePyWrapper::get_tensor_parts,
+             py::arg("key"), py::arg("parts") = py::none(),
+             "Get the tensors of an object written by put_tensor_parts as a "
+             "list, or only those at the indices in `parts`, in that order. "
+             "Only the selected parts are transferred. None on error")
         .def(
             "register_buffer",
             [](MooncakeStorePyWrapper &self, uintptr_t buffer_ptr,
@@ -451,6 +1374,67 @@ PYBIND11_MODULE(store, m) {
             "Get object data directly into pre-allocated buffers for "
             "multiple "
             "keys")
+        .def(
+            "get_range",
+            [](MooncakeStorePyWrapper &self, const std::string &key,
+               uint64_t offset, size_t size) -> py::object {
+                std::optional<BufferHandle> buffer;
+                int64_t ret = toInt(ErrorCode::INVALID_PARAMS);
+                {
+                    py::gil_scoped_release release;
+                    buffer =
+                        self.store_->client_buffer_allocator_->allocate(size);
+                    if (buffer) {
+                        ret = self.store_->get_range_into(key, buffer->ptr(),
+                                                          offset, size);
+                    } else {
+                        LOG(ERROR) << "Failed to allocate buffer for "
+                                      "get_range, key: "
+                                   << key;
+                    }
+                }
+                if (ret < 0) {
+                    return py::none();
+                }
+                return py::bytes(static_cast<char *>(buffer->ptr()), size);
+            },
+            py::arg("key"), py::arg("offset"), py::arg("size"),
+            "Get bytes [offset, offset + size) of an object, None on error. "
+            "Only the parts of the object overlapping the range are "
+            "transferred")
+        .def(
+            "get_range_into",
+            [](MooncakeStorePyWrapper &self, const std::string &key,
+               uintptr_t buffer_ptr, uint64_t offset, size_t size) {
+                void *buffer = reinterpret_cast<void *>(buffer_ptr);
+                py::gil_scoped_release release;
+                return self.store_->get_range_into(key, buffer, offset, size);
+            },
+            py::arg("key"), py::arg("buffer_ptr"), py::arg("offset"),
+            py::arg("size"),
+            "Get bytes [offset, offset + size) of an object directly into a "
+            "pre-allocated buffer. Returns the number of bytes read, or a "
+            "negative value on error")
+        .def(
+            "batch_get_range_into",
+            [](MooncakeStorePyWrapper &self,
+               const std::vector<std::string> &keys,
+               const std::vector<uintptr_t> &buffer_ptrs,
+               const std::vector<uint64_t> &offsets,
+               const std::vector<size_t> &sizes) {
+                std::vector<void *> buffers;
+                buffers.reserve(buffer_ptrs.size());
+                for (uintptr_t ptr : buffer_ptrs) {
+                    buffers.push_back(reinterpret_cast<void *>(ptr));
+                }
+                py::gil_scoped_release release;
+                return self.store_->batch_get_range_into(keys, buffers,
+                                                         offsets, sizes);
+            },
+            py::arg("keys"), py::arg("buffer_ptrs"), py::arg("offsets"),
+            py::arg("sizes"),
+            "Get a byte range of multiple objects directly into pre-allocated "
+            "buffers, a key may appear several times")
         .def(
             "put_from",
             [](MooncakeStorePyWrapper &self, const std::string &key,
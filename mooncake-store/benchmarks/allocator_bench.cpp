@@ -1,5 +1,7 @@
 #include <iostream>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 #include <chrono>
 #include <algorithm>
@@ -10,13 +12,34 @@
 
 using namespace mooncake::offset_allocator;
 
-class OffsetAllocatorBenchHelper {
+template <typename Allocator>
+std::shared_ptr<Allocator> create_bench_allocator(uint64_t baseAddress,
+                                                  uint64_t poolSize,
+                                                  uint32_t maxAllocs);
+
+template <>
+std::shared_ptr<OffsetAllocator> create_bench_allocator(uint64_t baseAddress,
+                                                        uint64_t poolSize,
+                                                        uint32_t maxAllocs) {
+    return OffsetAllocator::create(baseAddress, poolSize, maxAllocs);
+}
+
+template <>
+std::shared_ptr<ShardedOffsetAllocator> create_bench_allocator(
+    uint64_t baseAddress, uint64_t poolSize, uint32_t maxAllocs) {
+    return ShardedOffsetAllocator::create(baseAddress, poolSize, 0, maxAllocs,
+                                          maxAllocs);
+}
+
+template <typename Allocator>
+class AllocatorBenchHelper {
    public:
-    OffsetAllocatorBenchHelper(uint64_t baseAddress, uint32_t poolSize,
-                               uint32_t maxAllocs)
+    AllocatorBenchHelper(uint64_t baseAddress, uint64_t poolSize,
+                         uint32_t maxAllocs)
         : pool_size_(poolSize),
           allocated_size_(0),
-          allocator_(OffsetAllocator::create(baseAddress, poolSize, maxAllocs)),
+          allocator_(create_bench_allocator<Allocator>(baseAddress, poolSize,
+                                                       maxAllocs)),
           rd_(),
           gen_(rd_()) {}
 
@@ -50,13 +73,17 @@ class OffsetAllocatorBenchHelper {
    private:
     uint64_t pool_size_;
     uint64_t allocated_size_;
-    std::shared_ptr<OffsetAllocator> allocator_;
+    std::shared_ptr<Allocator> allocator_;
     std::vector<OffsetAllocationHandle> allocated_;
     std::vector<uint32_t> allocated_sizes_;
     std::random_device rd_;
     std::mt19937 gen_;
 };
 
+using OffsetAllocatorBenchHelper = AllocatorBenchHelper<OffsetAllocator>;
+using ShardedOffsetAllocatorBenchHelper =
+    AllocatorBenchHelper<ShardedOffsetAllocator>;
+
 template <typename BenchHelper>
 void uniform_size_allocation_benchmark() {
     std::cout << std::endl
@@ -178,8 +205,187 @@ void random_size_allocation_benchmark() {
     std::cout << "avg alloc time: " << avg_time_ns << " ns/op" << std::endl;
 }
 
+// Allocation throughput of 1 to 64 threads allocating 4KB to 4MB objects on
+// one large segment and freeing them in random order
+template <typename Allocator>
+void multi_thread_throughput_benchmark() {
+    std::cout << std::endl
+              << "=== Multi-thread Throughput Benchmark ===" << std::endl;
+    const uint64_t pool_size = 64ull * 1024 * 1024 * 1024;
+    const int ops_per_thread = 200000;
+    const size_t live_per_thread = 64;
+
+    for (int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+        auto allocator = create_bench_allocator<Allocator>(
+            0x1000, pool_size, num_threads * live_per_thread * 2);
+        std::vector<std::thread> threads;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 gen(t);
+                std::uniform_int_distribution<size_t> dist(4096, 4 << 20);
+                std::vector<OffsetAllocationHandle> live;
+                for (int i = 0; i < ops_per_thread; i++) {
+                    if (live.size() == live_per_thread) {
+                        std::swap(live[gen() % live.size()], live.back());
+                        live.pop_back();
+                    }
+                    auto handle = allocator->allocate(dist(gen));
+                    if (handle.has_value()) {
+                        live.push_back(std::move(*handle));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double seconds =
+            std::chrono::duration<double>(end_time - start_time).count();
+        std::cout << "threads: " << std::setw(2) << num_threads
+                  << ", throughput: " << std::fixed << std::setprecision(2)
+                  << num_threads * ops_per_thread / seconds / 1e6
+                  << " Mops/s" << std::endl;
+    }
+}
+
+// Space taken by many small objects on a 1TB segment, relative to their size
+template <typename Allocator>
+void large_segment_small_object_benchmark() {
+    std::cout << std::endl
+              << "=== Large Segment Small Object Benchmark ===" << std::endl;
+    const uint64_t pool_size = 1ull << 40;
+    // Few enough to stay within the node capacity of one arena, which reports
+    // no free space once its nodes run out
+    const uint32_t num_allocs = 4000;
+
+    for (uint32_t alloc_size : {100u, 1000u, 4000u, 10000u, 100000u}) {
+        auto allocator =
+            create_bench_allocator<Allocator>(0x1000, pool_size, num_allocs);
+        std::vector<OffsetAllocationHandle> handles;
+        handles.reserve(num_allocs);
+        for (uint32_t i = 0; i < num_allocs; i++) {
+            auto handle = allocator->allocate(alloc_size);
+            if (!handle.has_value()) {
+                break;
+            }
+            handles.push_back(std::move(*handle));
+        }
+        uint64_t used = pool_size - allocator->storageReport().totalFreeSpace;
+        std::cout << "Alloc size: " << alloc_size
+                  << ", allocs: " << handles.size() << ", space overhead: "
+                  << std::fixed << std::setprecision(3)
+                  << static_cast<double>(used) /
+                         (static_cast<double>(alloc_size) * handles.size())
+                  << "x" << std::endl;
+    }
+}
+
+// Contiguity of the free space while objects of 64KB to 16MB come and go on a
+// 1GB segment, without and with the master's compaction: once less than half
+// of the free space is in its largest region, the 64 smallest objects slide
+// into free regions below them.
+template <typename Allocator>
+void fragmentation_over_time_benchmark() {
+    std::cout << std::endl
+              << "=== Fragmentation Over Time Benchmark ===" << std::endl;
+    const uint64_t pool_size = 1ull << 30;
+    const uint64_t target_size = pool_size * 9 / 10;
+    const int num_rounds = 2000;
+    const int report_interval = 400;
+    const size_t max_moves = 64;
+
+    for (bool compaction : {false, true}) {
+        std::cout << (compaction ? "with compaction:" : "without compaction:")
+                  << std::endl;
+        auto allocator =
+            create_bench_allocator<Allocator>(0x1000, pool_size, 1 << 16);
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<uint32_t> log_size(16, 24);
+        std::vector<OffsetAllocationHandle> live;
+        uint64_t live_size = 0;
+        uint64_t moved_size = 0;
+        double util_sum = 0;
+        double contiguity_sum = 0;
+        for (int round = 1; round <= num_rounds; round++) {
+            // Replace a tenth of the objects with new ones of other sizes
+            for (size_t i = live.size() / 10; i > 0; i--) {
+                std::swap(live[gen() % live.size()], live.back());
+                live_size -= live.back().size();
+                live.pop_back();
+            }
+            while (live_size < target_size) {
+                uint32_t size = 1u << log_size(gen);
+                size += gen() % size;
+                auto handle = allocator->allocate(size);
+                if (!handle.has_value()) {
+                    break;
+                }
+                live_size += size;
+                live.push_back(std::move(*handle));
+            }
+
+            // Utilization once an allocation fails, holes too small for
+            // the next object are wasted
+            auto report = allocator->storageReport();
+            util_sum += static_cast<double>(live_size) / pool_size;
+            contiguity_sum +=
+                static_cast<double>(report.largestFreeRegion) /
+                std::max<uint64_t>(report.totalFreeSpace, 1);
+            if (compaction && report.totalFreeSpace > 0 &&
+                report.largestFreeRegion * 2 < report.totalFreeSpace) {
+                std::sort(live.begin(), live.end(),
+                          [](const auto& a, const auto& b) {
+                              return a.size() < b.size();
+                          });
+                std::vector<OffsetAllocationHandle> skipped_holes;
+                for (size_t i = 0; i < std::min(max_moves, live.size());
+                     i++) {
+                    auto target = allocator->allocate(live[i].size());
+                    while (target.has_value() &&
+                           target->address() > live[i].address()) {
+                        skipped_holes.push_back(std::move(*target));
+                        target = allocator->allocate(live[i].size());
+                    }
+                    if (target.has_value()) {
+                        moved_size += live[i].size();
+                        live[i] = std::move(*target);
+                    }
+                }
+            }
+
+            if (round % report_interval == 0) {
+                std::cout << "rounds: " << std::setw(4) << round
+                          << ", avg util: " << std::fixed
+                          << std::setprecision(3)
+                          << util_sum / report_interval
+                          << ", avg largest free / free: "
+                          << contiguity_sum / report_interval
+                          << ", moved: " << moved_size / (1 << 20) << " MB"
+                          << std::endl;
+                util_sum = 0;
+                contiguity_sum = 0;
+            }
+        }
+    }
+}
+
 int main() {
     std::cout << "=== OffsetAllocator Benchmark ===" << std::endl;
     uniform_size_allocation_benchmark<OffsetAllocatorBenchHelper>();
     random_size_allocation_benchmark<OffsetAllocatorBenchHelper>();
-}
\ No newline at end of file
+    multi_thread_throughput_benchmark<OffsetAllocator>();
+    large_segment_small_object_benchmark<OffsetAllocator>();
+    fragmentation_over_time_benchmark<OffsetAllocator>();
+
+    // The arenas cannot merge free regions across their boundaries, the
+    // utilization ratios show what that costs
+    std::cout << std::endl
+              << "=== ShardedOffsetAllocator Benchmark ===" << std::endl;
+    uniform_size_allocation_benchmark<ShardedOffsetAllocatorBenchHelper>();
+    random_size_allocation_benchmark<ShardedOffsetAllocatorBenchHelper>();
+    multi_thread_throughput_benchmark<ShardedOffsetAllocator>();
+    large_segment_small_object_benchmark<ShardedOffsetAllocator>();
+    fragmentation_over_time_benchmark<ShardedOffsetAllocator>();
+}
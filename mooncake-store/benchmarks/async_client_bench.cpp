@@ -0,0 +1,157 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "allocator.h"
+#include "client.h"
+#include "completion_queue.h"
+#include "utils.h"
+
+DEFINE_string(protocol, "tcp", "Transfer protocol: rdma|tcp");
+DEFINE_string(device_name, "", "Device name to use, valid if protocol=rdma");
+DEFINE_string(master_address, "localhost:50051", "Address of master server");
+DEFINE_string(local_hostname, "localhost:12355", "Local hostname for client");
+DEFINE_string(metadata_connection_string, "P2PHANDSHAKE",
+              "Metadata connection string");
+DEFINE_uint64(outstanding, 1000, "Operations kept in flight by the loop");
+DEFINE_uint64(operations, 100000, "Puts, then as many gets, to run");
+DEFINE_uint64(value_size, 4096, "Size of values in bytes");
+DEFINE_uint64(segment_size_mb, 4096, "Size of the segment mounted to master");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Slot {
+    void* buffer;
+    Clock::time_point start_time;
+};
+
+std::string make_key(uint64_t i) { return "async_bench_" + std::to_string(i); }
+
+// Drives FLAGS_operations puts or gets from a single thread, keeping
+// FLAGS_outstanding of them in flight and reaping them from the queue
+void run_phase(Client& client, std::vector<Slot>& slots, bool is_put) {
+    CompletionQueue queue;
+    ReplicateConfig config;
+    config.replica_num = 1;
+    std::unordered_map<AsyncHandle, size_t> in_flight;
+    std::vector<size_t> free_slots(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        free_slots[i] = i;
+    }
+    std::vector<double> latencies_us;
+    latencies_us.reserve(FLAGS_operations);
+    std::vector<AsyncCompletion> completions;
+    uint64_t issued = 0, failed = 0;
+
+    auto start_time = Clock::now();
+    while (latencies_us.size() < FLAGS_operations) {
+        while (issued < FLAGS_operations && !free_slots.empty()) {
+            size_t slot = free_slots.back();
+            free_slots.pop_back();
+            slots[slot].start_time = Clock::now();
+            std::vector<Slice> slices{{slots[slot].buffer, FLAGS_value_size}};
+            AsyncHandle handle =
+                is_put ? client.AsyncPut(queue, make_key(issued),
+                                         std::move(slices), config)
+                       : client.AsyncGet(queue, make_key(issued),
+                                         std::move(slices));
+            in_flight.emplace(handle, slot);
+            ++issued;
+        }
+
+        completions.clear();
+        queue.Wait(completions, std::chrono::milliseconds(100));
+        auto now = Clock::now();
+        for (auto& completion : completions) {
+            auto it = in_flight.find(completion.handle);
+            size_t slot = it->second;
+            in_flight.erase(it);
+            free_slots.push_back(slot);
+            if (!completion.results[0]) {
+                ++failed;
+            }
+            latencies_us.push_back(
+                std::chrono::duration<double, std::micro>(
+                    now - slots[slot].start_time)
+                    .count());
+        }
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto percentile = [&](double p) {
+        return latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))];
+    };
+    std::cout << (is_put ? "put" : "get") << ": " << std::fixed
+              << std::setprecision(1) << FLAGS_operations / seconds / 1e3
+              << " Kops/s, "
+              << FLAGS_operations * FLAGS_value_size / seconds / 1e6
+              << " MB/s, latency p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, " << failed << " failed"
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    auto client_opt = Client::Create(
+        FLAGS_local_hostname, FLAGS_metadata_connection_string, FLAGS_protocol,
+        FLAGS_device_name.empty() ? std::nullopt
+                                  : std::optional<std::string>(
+                                        FLAGS_device_name),
+        FLAGS_master_address);
+    if (!client_opt) {
+        LOG(ERROR) << "Failed to create client";
+        return 1;
+    }
+    auto client = *client_opt;
+
+    const size_t segment_size = FLAGS_segment_size_mb << 20;
+    void* segment = allocate_buffer_allocator_memory(segment_size);
+    if (!segment || !client->MountSegment(segment, segment_size)) {
+        LOG(ERROR) << "Failed to mount segment";
+        return 1;
+    }
+
+    // One buffer per in-flight operation, with room for the slab headers
+    const size_t allocator_size =
+        FLAGS_outstanding * FLAGS_value_size + (64 << 20);
+    SimpleAllocator allocator(allocator_size);
+    if (!client->RegisterLocalMemory(allocator.getBase(), allocator_size,
+                                     "cpu:0", false, false)) {
+        LOG(ERROR) << "Failed to register local memory";
+        return 1;
+    }
+    std::vector<Slot> slots(FLAGS_outstanding);
+    for (auto& slot : slots) {
+        slot.buffer = allocator.allocate(FLAGS_value_size);
+        memset(slot.buffer, 'x', FLAGS_value_size);
+    }
+
+    std::cout << "=== Async Client Benchmark ===" << std::endl
+              << "protocol: " << FLAGS_protocol
+              << ", outstanding: " << FLAGS_outstanding
+              << ", value size: " << FLAGS_value_size << " bytes" << std::endl;
+    run_phase(*client, slots, true);
+    run_phase(*client, slots, false);
+
+    client->RemoveByRegex("^async_bench_");
+    client->UnmountSegment(segment, segment_size);
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_string(trace_file, "",
+              "File with one key per line, each line a read of the key "
+              "which puts it on a miss. Empty to generate a trace.");
+DEFINE_uint64(num_requests, 1000000, "Number of requests of a generated trace");
+DEFINE_uint64(num_keys, 100000,
+              "Number of reused keys of a generated trace, read with Zipf "
+              "popularity");
+DEFINE_double(zipf_exponent, 0.99, "Exponent of the Zipf popularity");
+DEFINE_double(one_hit_ratio, 0.3,
+              "Ratio of the requests of a generated trace to keys read only "
+              "once");
+DEFINE_uint64(cache_objects, 10000, "Number of objects the segment holds");
+DEFINE_uint64(value_size, 4096, "Size of the objects in bytes");
+DEFINE_uint64(kv_lease_ttl, 1, "Lease TTL of the reads in milliseconds");
+DEFINE_uint64(threads, std::thread::hardware_concurrency(),
+              "Number of threads replaying the trace");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<std::string> load_trace(const std::string& path) {
+    std::vector<std::string> trace;
+    std::ifstream file(path);
+    std::string key;
+    while (std::getline(file, key)) {
+        if (!key.empty()) {
+            trace.push_back(key);
+        }
+    }
+    return trace;
+}
+
+// Reads of reused keys with Zipf popularity, mixed with reads of keys seen
+// once, e.g. prompts which are not shared
+std::vector<std::string> generate_trace() {
+    std::vector<double> cdf(FLAGS_num_keys);
+    double sum = 0;
+    for (uint64_t i = 0; i < FLAGS_num_keys; ++i) {
+        sum += 1.0 / std::pow(i + 1, FLAGS_zipf_exponent);
+        cdf[i] = sum;
+    }
+    std::mt19937_64 gen(0);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<std::string> trace;
+    trace.reserve(FLAGS_num_requests);
+    for (uint64_t i = 0; i < FLAGS_num_requests; ++i) {
+        if (uniform(gen) < FLAGS_one_hit_ratio) {
+            trace.push_back("once_" + std::to_string(i));
+            continue;
+        }
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(),
+                                       uniform(gen) * sum) -
+                      cdf.begin();
+        trace.push_back("key_" + std::to_string(rank));
+    }
+    return trace;
+}
+
+struct Result {
+    uint64_t hits = 0;
+    uint64_t puts = 0;
+    uint64_t failed_puts = 0;
+    double seconds = 0;
+};
+
+Result replay(const std::vector<std::string>& trace, bool inline_eviction,
+              PutAdmissionPolicy policy) {
+    // The clients do not ping, keep their segments mounted for the run
+    MasterService service(MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(FLAGS_kv_lease_ttl)
+                              .set_enable_inline_eviction(inline_eviction)
+                              .set_put_admission_policy(policy)
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = FLAGS_cache_objects * FLAGS_value_size;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return {};
+    }
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> puts{0};
+    std::atomic<uint64_t> failed_puts{0};
+    std::vector<std::thread> threads;
+    auto start_time = Clock::now();
+    for (size_t t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([&, t] {
+            ReplicateConfig config;
+            config.replica_num = 1;
+            for (size_t i = t; i < trace.size(); i += FLAGS_threads) {
+                if (service.GetReplicaList(trace[i])) {
+                    ++hits;
+                    continue;
+                }
+                ++puts;
+                if (!service.PutStart(trace[i], {FLAGS_value_size}, config)) {
+                    ++failed_puts;
+                    continue;
+                }
+                service.PutEnd(trace[i], ReplicaType::MEMORY);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return {hits, puts, failed_puts,
+            std::chrono::duration<double>(Clock::now() - start_time).count()};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    auto trace = FLAGS_trace_file.empty() ? generate_trace()
+                                          : load_trace(FLAGS_trace_file);
+    std::cout << "=== Master Admission Benchmark ===" << std::endl
+              << "requests: " << trace.size()
+              << ", cache objects: " << FLAGS_cache_objects
+              << ", threads: " << FLAGS_threads << std::endl;
+
+    struct Setup {
+        const char* name;
+        bool inline_eviction;
+        PutAdmissionPolicy policy;
+    };
+    for (const auto& setup :
+         {Setup{"eviction thread", false, PutAdmissionPolicy::ALWAYS},
+          Setup{"inline, always", true, PutAdmissionPolicy::ALWAYS},
+          Setup{"inline, tinylfu", true, PutAdmissionPolicy::TINY_LFU}}) {
+        Result result = replay(trace, setup.inline_eviction, setup.policy);
+        std::cout << std::setw(16) << setup.name << ": " << std::fixed
+                  << std::setprecision(2) << "hit ratio "
+                  << 100.0 * result.hits / trace.size()
+                  << "%, put success rate "
+                  << 100.0 * (result.puts - result.failed_puts) /
+                         std::max<uint64_t>(result.puts, 1)
+                  << "%, " << trace.size() / result.seconds / 1e3
+                  << " Kreq/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_requests, 10000, "Number of requests of the trace");
+DEFINE_uint64(blocks_per_request, 16, "Number of KV cache blocks per request");
+DEFINE_uint64(num_prefixes, 16,
+              "Number of distinct prefixes, e.g. system prompts, shared by "
+              "the requests");
+DEFINE_uint64(prefix_blocks, 12,
+              "Number of leading blocks of a request which are its prefix");
+DEFINE_uint64(block_size, 65536, "Size of a KV cache block in bytes");
+DEFINE_uint64(threads, std::thread::hardware_concurrency(),
+              "Number of threads putting the blocks");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Block {
+    std::string key;
+    std::string content_hash;
+};
+
+// Blocks of requests starting with one of a few prefixes. The keys are per
+// request, while the content of a block is determined by the tokens up to
+// it, so the blocks of the same prefix have the same content.
+std::vector<Block> generate_trace() {
+    std::mt19937_64 gen(0);
+    std::uniform_int_distribution<uint64_t> prefix(0,
+                                                   FLAGS_num_prefixes - 1);
+    std::vector<Block> trace;
+    trace.reserve(FLAGS_num_requests * FLAGS_blocks_per_request);
+    for (uint64_t i = 0; i < FLAGS_num_requests; ++i) {
+        std::string request = "req_" + std::to_string(i);
+        std::string tokens = "prefix_" + std::to_string(prefix(gen));
+        for (uint64_t j = 0; j < FLAGS_blocks_per_request; ++j) {
+            if (j == FLAGS_prefix_blocks) {
+                tokens += "/" + request;
+            }
+            tokens += "/" + std::to_string(j);
+            trace.push_back({request + "_block_" + std::to_string(j),
+                             std::to_string(std::hash<std::string>{}(tokens))});
+        }
+    }
+    return trace;
+}
+
+struct Result {
+    uint64_t stored = 0;
+    uint64_t deduplicated = 0;
+    uint64_t allocated_size = 0;
+    double seconds = 0;
+};
+
+Result replay(const std::vector<Block>& trace, bool with_content_hash) {
+    // The clients do not ping, keep their segments mounted for the run
+    MasterService service(MasterServiceConfig::builder()
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = trace.size() * FLAGS_block_size * 2;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return {};
+    }
+
+    std::atomic<uint64_t> stored{0};
+    std::atomic<uint64_t> deduplicated{0};
+    std::vector<std::thread> threads;
+    auto start_time = Clock::now();
+    for (size_t t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([&, t] {
+            ReplicateConfig config;
+            config.replica_num = 1;
+            for (size_t i = t; i < trace.size(); i += FLAGS_threads) {
+                if (with_content_hash) {
+                    config.content_hash = trace[i].content_hash;
+                }
+                auto result =
+                    service.PutStart(trace[i].key, {FLAGS_block_size}, config);
+                if (!result.has_value()) {
+                    if (result.error() == ErrorCode::CONTENT_ALREADY_EXISTS) {
+                        ++stored;
+                        ++deduplicated;
+                    }
+                    continue;
+                }
+                // The data transfer of the client would take place here
+                if (service.PutEnd(trace[i].key, ReplicaType::MEMORY)) {
+                    ++stored;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+    auto query_result = service.QuerySegments(segment.name);
+    return {stored, deduplicated,
+            query_result ? query_result.value().first : 0, seconds};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    auto trace = generate_trace();
+    uint64_t logical_size = trace.size() * FLAGS_block_size;
+    std::cout << "=== Master Dedup Benchmark ===" << std::endl
+              << "blocks: " << trace.size() << ", prefixes: "
+              << FLAGS_num_prefixes << ", prefix blocks: "
+              << FLAGS_prefix_blocks << "/" << FLAGS_blocks_per_request
+              << ", threads: " << FLAGS_threads << std::endl;
+
+    for (bool with_content_hash : {false, true}) {
+        Result result = replay(trace, with_content_hash);
+        std::cout << std::setw(18)
+                  << (with_content_hash ? "content hash" : "no content hash")
+                  << ": " << std::fixed << std::setprecision(2) << "stored "
+                  << result.stored << ", deduplicated " << result.deduplicated
+                  << ", allocated " << result.allocated_size / (1 << 20)
+                  << " MiB of " << logical_size / (1 << 20) << " MiB ("
+                  << 100.0 * (logical_size - result.allocated_size) /
+                         logical_size
+                  << "% saved), " << result.stored / result.seconds / 1e3
+                  << " Kputs/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_metric_manager.h"
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_segments, 4, "Number of segments, each of its own client");
+DEFINE_uint64(num_keys, 10000, "Number of keys, read with Zipf popularity");
+DEFINE_double(zipf_exponent, 1.2, "Exponent of the Zipf popularity");
+DEFINE_uint64(value_size, 65536, "Size of the objects in bytes");
+DEFINE_uint64(duration_sec, 10, "Seconds of reads of each run");
+DEFINE_uint64(read_threshold, 2000,
+              "Hot key read threshold of the run with hot key replication");
+DEFINE_uint64(extra_replicas, 3, "Extra replicas of the hot keys");
+DEFINE_uint64(threads, 2, "Number of threads reading");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    uint64_t reads = 0;
+    // Reads served by the busiest segment over the mean of the segments,
+    // counted after the first half of the run
+    double max_segment_load = 0;
+    uint64_t replicas_added = 0;
+};
+
+Result run(uint64_t read_threshold) {
+    // The clients ping below, keep their segments mounted for the run
+    MasterService service(MasterServiceConfig::builder()
+                              .set_hot_key_read_threshold(read_threshold)
+                              .set_hot_key_extra_replicas(FLAGS_extra_replicas)
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    std::vector<UUID> clients;
+    for (uint64_t i = 0; i < FLAGS_num_segments; ++i) {
+        Segment segment;
+        segment.id = generate_uuid();
+        segment.name = "segment_" + std::to_string(i);
+        segment.base = 0x100000000000 + (i << 36);
+        segment.size = 4 * FLAGS_num_keys * FLAGS_value_size;
+        segment.te_endpoint = segment.name;
+        clients.push_back(generate_uuid());
+        if (!service.MountSegment(segment, clients.back())) {
+            LOG(ERROR) << "Failed to mount segment " << segment.name;
+            return {};
+        }
+    }
+    for (uint64_t i = 0; i < FLAGS_num_keys; ++i) {
+        std::string key = "key_" + std::to_string(i);
+        if (!service.PutStart(key, {FLAGS_value_size}, {.replica_num = 1}) ||
+            !service.PutEnd(key, ReplicaType::MEMORY)) {
+            LOG(ERROR) << "Failed to put " << key;
+            return {};
+        }
+    }
+    uint64_t added_before =
+        MasterMetricManager::instance().get_hot_key_replicas_added();
+
+    std::vector<double> cdf(FLAGS_num_keys);
+    double sum = 0;
+    for (uint64_t i = 0; i < FLAGS_num_keys; ++i) {
+        sum += 1.0 / std::pow(i + 1, FLAGS_zipf_exponent);
+        cdf[i] = sum;
+    }
+
+    // The clients copy the hot keys as soon as they are asked to
+    std::atomic<bool> running{true};
+    std::thread pinger([&] {
+        while (running) {
+            for (const auto& client_id : clients) {
+                auto response = service.Ping(client_id);
+                if (!response) {
+                    continue;
+                }
+                for (const auto& task : response->compaction_tasks) {
+                    service.MoveEnd(client_id, task.task_id, true);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    });
+
+    std::mutex mutex;
+    std::map<std::string, uint64_t> segment_reads;
+    std::atomic<uint64_t> reads{0};
+    auto start_time = Clock::now();
+    auto half_time = start_time + std::chrono::seconds(FLAGS_duration_sec) / 2;
+    auto end_time = start_time + std::chrono::seconds(FLAGS_duration_sec);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 gen(t);
+            std::uniform_real_distribution<double> uniform(0, sum);
+            std::map<std::string, uint64_t> local_reads;
+            uint64_t local_count = 0;
+            for (auto now = Clock::now(); now < end_time;
+                 now = Clock::now()) {
+                for (int i = 0; i < 100; ++i) {
+                    size_t rank =
+                        std::lower_bound(cdf.begin(), cdf.end(),
+                                         uniform(gen)) -
+                        cdf.begin();
+                    auto result =
+                        service.GetReplicaList("key_" + std::to_string(rank));
+                    ++local_count;
+                    if (result && now >= half_time) {
+                        // Clients read the first replica
+                        ++local_reads[result->replicas[0]
+                                          .get_memory_descriptor()
+                                          .buffer_descriptors[0]
+                                          .transport_endpoint_];
+                    }
+                }
+            }
+            reads += local_count;
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& [segment, count] : local_reads) {
+                segment_reads[segment] += count;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    running = false;
+    pinger.join();
+
+    uint64_t total = 0;
+    uint64_t busiest = 0;
+    for (const auto& [segment, count] : segment_reads) {
+        total += count;
+        busiest = std::max(busiest, count);
+    }
+    return {reads,
+            total == 0 ? 0.0
+                       : static_cast<double>(busiest) * FLAGS_num_segments /
+                             total,
+            MasterMetricManager::instance().get_hot_key_replicas_added() -
+                added_before};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    std::cout << "=== Master Hot Key Benchmark ===" << std::endl
+              << "segments: " << FLAGS_num_segments
+              << ", keys: " << FLAGS_num_keys
+              << ", zipf exponent: " << FLAGS_zipf_exponent
+              << ", threads: " << FLAGS_threads << std::endl;
+    for (uint64_t threshold : {uint64_t{0}, FLAGS_read_threshold}) {
+        Result result = run(threshold);
+        std::cout << std::setw(14)
+                  << (threshold == 0 ? "no replication" : "hot key replicas")
+                  << ": " << std::fixed << std::setprecision(2)
+                  << "busiest segment " << result.max_segment_load
+                  << "x the mean load, "
+                  << result.reads / FLAGS_duration_sec / 1e3
+                  << " Kreads/s, replicas added " << result.replicas_added
+                  << std::endl;
+    }
+    return 0;
+}
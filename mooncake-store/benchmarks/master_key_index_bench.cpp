@@ -0,0 +1,134 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_keys, 10000000, "Number of objects stored in the master");
+DEFINE_uint64(keys_per_prefix, 64,
+              "Number of objects sharing a prefix, e.g. the layers of a "
+              "request");
+DEFINE_uint64(value_size, 1024, "Size of the objects in bytes");
+DEFINE_uint64(load_threads, std::thread::hardware_concurrency(),
+              "Number of threads putting the objects");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string make_prefix(uint64_t i) { return "req_" + std::to_string(i) + "/"; }
+
+std::string make_key(uint64_t i) {
+    return make_prefix(i / FLAGS_keys_per_prefix) + "layer_" +
+           std::to_string(i % FLAGS_keys_per_prefix);
+}
+
+void report(const char* name, const std::function<size_t()>& op) {
+    auto start_time = Clock::now();
+    size_t count = op();
+    std::cout << std::setw(24) << name << ": " << std::fixed
+              << std::setprecision(3)
+              << std::chrono::duration<double, std::milli>(Clock::now() -
+                                                           start_time)
+                     .count()
+              << " ms, " << count << " keys" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    // Short leases, so that the objects can be removed right after a read
+    MasterService service(MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(1)
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    // Half full segment, so that no object is evicted
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = FLAGS_num_keys * FLAGS_value_size * 2;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return 1;
+    }
+
+    std::cout << "=== Master Key Index Benchmark ===" << std::endl
+              << "keys: " << FLAGS_num_keys
+              << ", keys per prefix: " << FLAGS_keys_per_prefix << std::endl;
+
+    auto load_start = Clock::now();
+    std::atomic<uint64_t> next_key{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < FLAGS_load_threads; ++t) {
+        threads.emplace_back([&] {
+            ReplicateConfig config;
+            config.replica_num = 1;
+            for (uint64_t i = next_key++; i < FLAGS_num_keys;
+                 i = next_key++) {
+                std::string key = make_key(i);
+                if (service.PutStart(key, {FLAGS_value_size}, config)) {
+                    service.PutEnd(key, ReplicaType::MEMORY);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::cout << "load: " << service.GetKeyCount() << " keys in "
+              << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double>(Clock::now() - load_start)
+                     .count()
+              << " s" << std::endl;
+
+    const uint64_t num_prefixes = FLAGS_num_keys / FLAGS_keys_per_prefix;
+    // A group hides the literal prefix of the pattern, so that the regex
+    // scans all keys, which is what every regex did before the ordered index
+    const std::string scanned = "^(" + make_prefix(num_prefixes / 2) + ")";
+    const std::string indexed = make_prefix(num_prefixes / 3);
+    const std::string removed = make_prefix(num_prefixes / 4);
+    const std::string removed_by_regex = make_prefix(num_prefixes / 5);
+    auto size_of = [](const auto& result) {
+        return result ? result->size() : size_t{0};
+    };
+
+    report("query, scanning regex", [&] {
+        return size_of(service.GetReplicaListByRegex(scanned));
+    });
+    report("query, anchored regex", [&] {
+        return size_of(service.GetReplicaListByRegex("^" + indexed));
+    });
+    report("query, prefix", [&] {
+        return size_of(service.GetReplicaListByPrefix(indexed));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    report("remove, scanning regex", [&] {
+        return static_cast<size_t>(
+            service.RemoveByRegex(scanned).value_or(0));
+    });
+    report("remove, anchored regex", [&] {
+        return static_cast<size_t>(
+            service.RemoveByRegex("^" + removed_by_regex).value_or(0));
+    });
+    report("remove, prefix", [&] {
+        return static_cast<size_t>(
+            service.RemoveByPrefix(removed).value_or(0));
+    });
+    return 0;
+}
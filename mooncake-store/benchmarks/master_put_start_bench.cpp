@@ -0,0 +1,106 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_clients, 64, "Number of threads issuing PutStart");
+DEFINE_uint64(puts_per_client, 20000, "Number of objects put by each thread");
+DEFINE_uint64(num_segments, 16, "Number of segments, one per client");
+DEFINE_uint64(value_size, 4096, "Size of the objects in bytes");
+DEFINE_uint64(replica_num, 1, "Number of replicas of each object");
+
+using namespace mooncake;
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    // The clients do not ping, keep their segments mounted for the run
+    MasterService service(
+        MasterServiceConfig::builder().set_client_live_ttl_sec(3600).build());
+    // Half full segments, so that no object is evicted
+    const size_t num_objects = FLAGS_num_clients * FLAGS_puts_per_client;
+    const size_t segment_size = num_objects / FLAGS_num_segments *
+                                FLAGS_value_size * FLAGS_replica_num * 2;
+    for (size_t i = 0; i < FLAGS_num_segments; ++i) {
+        Segment segment;
+        segment.id = generate_uuid();
+        segment.name = "segment_" + std::to_string(i);
+        segment.base = 0x100000000000 + i * segment_size;
+        segment.size = segment_size;
+        segment.te_endpoint = segment.name;
+        if (!service.MountSegment(segment, generate_uuid())) {
+            LOG(ERROR) << "Failed to mount segment " << segment.name;
+            return 1;
+        }
+    }
+
+    std::cout << "=== Master PutStart Benchmark ===" << std::endl
+              << "clients: " << FLAGS_num_clients
+              << ", segments: " << FLAGS_num_segments
+              << ", value size: " << FLAGS_value_size << " bytes"
+              << ", replicas: " << FLAGS_replica_num << std::endl;
+
+    std::atomic<uint64_t> failed{0};
+    std::vector<std::vector<double>> latencies_us(FLAGS_num_clients);
+    std::vector<std::thread> threads;
+    auto start_time = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < FLAGS_num_clients; ++t) {
+        threads.emplace_back([&, t] {
+            ReplicateConfig config;
+            config.replica_num = FLAGS_replica_num;
+            latencies_us[t].reserve(FLAGS_puts_per_client);
+            for (uint64_t i = 0; i < FLAGS_puts_per_client; ++i) {
+                std::string key = "put_start_bench_" + std::to_string(t) +
+                                  "_" + std::to_string(i);
+                auto put_start = std::chrono::steady_clock::now();
+                auto result =
+                    service.PutStart(key, {FLAGS_value_size}, config);
+                latencies_us[t].push_back(
+                    std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - put_start)
+                        .count());
+                if (!result) {
+                    ++failed;
+                    continue;
+                }
+                service.PutEnd(key, ReplicaType::MEMORY);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start_time)
+                         .count();
+
+    std::vector<double> all_latencies_us;
+    all_latencies_us.reserve(num_objects);
+    for (const auto& thread_latencies_us : latencies_us) {
+        all_latencies_us.insert(all_latencies_us.end(),
+                                thread_latencies_us.begin(),
+                                thread_latencies_us.end());
+    }
+    std::sort(all_latencies_us.begin(), all_latencies_us.end());
+    auto percentile = [&](double p) {
+        return all_latencies_us[static_cast<size_t>(
+            p * (all_latencies_us.size() - 1))];
+    };
+    std::cout << "put: " << std::fixed << std::setprecision(1)
+              << num_objects / seconds / 1e3 << " Kops/s, PutStart p50 "
+              << percentile(0.5) << " us, p99 " << percentile(0.99)
+              << " us, max " << all_latencies_us.back() << " us, " << failed
+              << " failed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_keys, 100000, "Number of objects stored in the master");
+DEFINE_uint64(hot_keys, 64,
+              "Number of keys the reads go to, few keys make the reads "
+              "renew the leases of the same objects");
+DEFINE_uint64(threads, std::thread::hardware_concurrency(),
+              "Number of threads reading");
+DEFINE_uint64(reads_per_thread, 1000000, "Number of reads of each thread");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string make_key(uint64_t i) { return "read_bench_" + std::to_string(i); }
+
+// Runs FLAGS_reads_per_thread reads on every thread, returning Mreads/s
+template <typename Read>
+double run(Read read) {
+    std::vector<std::thread> threads;
+    auto start_time = Clock::now();
+    for (size_t t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 gen(t);
+            for (uint64_t i = 0; i < FLAGS_reads_per_thread; ++i) {
+                read(make_key(gen() % FLAGS_hot_keys));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+    return FLAGS_threads * FLAGS_reads_per_thread / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    // The clients do not ping, keep their segments mounted for the run
+    MasterService service(
+        MasterServiceConfig::builder().set_client_live_ttl_sec(3600).build());
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = FLAGS_num_keys * 1024 * 2;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return 1;
+    }
+    ReplicateConfig config;
+    config.replica_num = 1;
+    for (uint64_t i = 0; i < FLAGS_num_keys; ++i) {
+        if (service.PutStart(make_key(i), {1024}, config)) {
+            service.PutEnd(make_key(i), ReplicaType::MEMORY);
+        }
+    }
+
+    std::cout << "=== Master Read Benchmark ===" << std::endl
+              << "keys: " << FLAGS_num_keys << ", hot keys: " << FLAGS_hot_keys
+              << ", threads: " << FLAGS_threads << std::endl;
+    double exist = run([&](const std::string& key) { service.ExistKey(key); });
+    double get =
+        run([&](const std::string& key) { service.GetReplicaList(key); });
+    std::cout << std::fixed << std::setprecision(2) << "ExistKey: " << exist
+              << " Mreads/s, GetReplicaList: " << get << " Mreads/s"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_keys, 10000000, "Number of keys stored in the master");
+DEFINE_uint64(key_size, 64, "Size of the keys in bytes");
+DEFINE_uint64(page_size, 1000, "Keys per ScanKeys page");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Field of /proc/self/status in KiB, e.g. VmRSS or VmHWM
+uint64_t read_status_kb(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with(field + ":")) {
+            return std::stoull(line.substr(field.size() + 1));
+        }
+    }
+    return 0;
+}
+
+// Reset the peak RSS to the current RSS
+void reset_peak_rss() { std::ofstream("/proc/self/clear_refs") << "5"; }
+
+struct Result {
+    uint64_t keys = 0;
+    double seconds = 0;
+    double max_call_ms = 0;
+    uint64_t peak_rss_growth_kb = 0;
+};
+
+template <typename Fn>
+Result measure(Fn&& fn) {
+    reset_peak_rss();
+    uint64_t rss_kb = read_status_kb("VmRSS");
+    auto start_time = Clock::now();
+    Result result = fn();
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+    result.peak_rss_growth_kb = read_status_kb("VmHWM") - rss_kb;
+    return result;
+}
+
+void print(const char* name, const Result& result) {
+    std::cout << std::setw(12) << name << ": " << result.keys << " keys in "
+              << std::fixed << std::setprecision(2) << result.seconds
+              << " s, longest call " << result.max_call_ms
+              << " ms, peak RSS +" << result.peak_rss_growth_kb / 1024
+              << " MiB" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    // The client does not ping, keep its segment mounted for the run
+    MasterService service(MasterServiceConfig::builder()
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = FLAGS_num_keys * 1024 * 2;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return 1;
+    }
+    ReplicateConfig config;
+    config.replica_num = 1;
+    for (uint64_t i = 0; i < FLAGS_num_keys; ++i) {
+        std::string key = std::to_string(i);
+        key.insert(0, FLAGS_key_size - std::min(FLAGS_key_size, key.size()),
+                   'k');
+        if (!service.PutStart(key, {1024}, config) ||
+            !service.PutEnd(key, ReplicaType::MEMORY)) {
+            LOG(ERROR) << "Failed to put key " << key;
+            return 1;
+        }
+    }
+    std::cout << "=== Master Scan Benchmark ===" << std::endl
+              << "keys: " << FLAGS_num_keys << ", key size: " << FLAGS_key_size
+              << ", page size: " << FLAGS_page_size << ", master RSS: "
+              << read_status_kb("VmRSS") / 1024 << " MiB" << std::endl;
+
+    // The HTTP endpoint used to also copy the keys into its response
+    print("GetAllKeys", measure([&] {
+              Result result;
+              auto call_start = Clock::now();
+              auto keys = service.GetAllKeys();
+              result.max_call_ms = std::chrono::duration<double, std::milli>(
+                                       Clock::now() - call_start)
+                                       .count();
+              result.keys = keys ? keys->size() : 0;
+              return result;
+          }));
+    print("ScanKeys", measure([&] {
+              Result result;
+              std::string cursor;
+              do {
+                  auto call_start = Clock::now();
+                  auto page =
+                      service.ScanKeys(cursor, FLAGS_page_size, "");
+                  result.max_call_ms = std::max(
+                      result.max_call_ms,
+                      std::chrono::duration<double, std::milli>(Clock::now() -
+                                                                call_start)
+                          .count());
+                  if (!page) {
+                      break;
+                  }
+                  result.keys += page->keys.size();
+                  cursor = std::move(page->next_cursor);
+              } while (!cursor.empty());
+              return result;
+          }));
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_keys, 1000000, "Number of objects stored in the master");
+DEFINE_uint64(lookups_per_thread, 1000000,
+              "Number of ExistKey calls issued by each thread");
+DEFINE_uint64(threads, std::thread::hardware_concurrency(),
+              "Number of threads looking up keys");
+DEFINE_string(shard_counts, "16,64,256,1024,4096",
+              "Comma separated numbers of metadata shards to compare");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keys shaped like SHA-256 hex digests, e.g. the hashes of token prefixes
+std::vector<std::string> make_keys(uint64_t num_keys) {
+    std::mt19937_64 gen(0);
+    std::vector<std::string> keys;
+    keys.reserve(num_keys);
+    char digest[65];
+    for (uint64_t i = 0; i < num_keys; ++i) {
+        for (int word = 0; word < 4; ++word) {
+            snprintf(digest + word * 16, 17, "%016llx",
+                     static_cast<unsigned long long>(gen()));
+        }
+        keys.emplace_back(digest, 64);
+    }
+    return keys;
+}
+
+double run(const std::vector<std::string>& keys, uint64_t num_shards,
+           bool hex_key_shard_hash) {
+    MasterService service(MasterServiceConfig::builder()
+                              .set_num_metadata_shards(num_shards)
+                              .set_hex_key_shard_hash(hex_key_shard_hash)
+                              .set_client_live_ttl_sec(3600)
+                              .build());
+    Segment segment;
+    segment.id = generate_uuid();
+    segment.name = "segment_0";
+    segment.base = 0x100000000000;
+    segment.size = keys.size() * 1024 * 2;
+    segment.te_endpoint = segment.name;
+    if (!service.MountSegment(segment, generate_uuid())) {
+        LOG(ERROR) << "Failed to mount segment " << segment.name;
+        return 0;
+    }
+    ReplicateConfig config;
+    config.replica_num = 1;
+    for (const auto& key : keys) {
+        if (service.PutStart(key, {1024}, config)) {
+            service.PutEnd(key, ReplicaType::MEMORY);
+        }
+    }
+
+    std::atomic<uint64_t> found{0};
+    std::vector<std::thread> threads;
+    auto start_time = Clock::now();
+    for (size_t t = 0; t < FLAGS_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 gen(t);
+            uint64_t thread_found = 0;
+            for (uint64_t i = 0; i < FLAGS_lookups_per_thread; ++i) {
+                thread_found +=
+                    service.ExistKey(keys[gen() % keys.size()]).value_or(false);
+            }
+            found += thread_found;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start_time).count();
+    if (found != FLAGS_threads * FLAGS_lookups_per_thread) {
+        LOG(WARNING) << "Only " << found << " lookups found their key";
+    }
+    return FLAGS_threads * FLAGS_lookups_per_thread / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    std::cout << "=== Master Shard Benchmark ===" << std::endl
+              << "keys: " << FLAGS_num_keys << ", threads: " << FLAGS_threads
+              << std::endl;
+    auto keys = make_keys(FLAGS_num_keys);
+
+    std::stringstream shard_counts(FLAGS_shard_counts);
+    std::string shard_count;
+    while (std::getline(shard_counts, shard_count, ',')) {
+        uint64_t num_shards = std::stoull(shard_count);
+        double std_hash = run(keys, num_shards, false);
+        double hex_hash = run(keys, num_shards, true);
+        std::cout << std::setw(6) << num_shards << " shards: " << std::fixed
+                  << std::setprecision(2) << std_hash
+                  << " Mlookups/s with std::hash, " << hex_hash
+                  << " Mlookups/s with hex key hash" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "master_service.h"
+#include "types.h"
+
+DEFINE_uint64(num_keys, 10000000, "Number of objects stored in the master");
+DEFINE_uint64(num_segments, 8, "Number of segments, one per client");
+DEFINE_uint64(value_size, 1024, "Size of the objects in bytes");
+DEFINE_uint64(load_threads, std::thread::hardware_concurrency(),
+              "Number of threads putting the objects");
+DEFINE_uint64(foreground_threads, 4,
+              "Number of threads getting random objects during the unmount");
+DEFINE_uint64(baseline_ms, 2000,
+              "Duration of the foreground gets measured before the unmount");
+
+using namespace mooncake;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    Clock::time_point start_time;
+    double latency_us;
+};
+
+std::string make_key(uint64_t i) {
+    return "unmount_bench_" + std::to_string(i);
+}
+
+void print_latencies(const char* name, std::vector<double> latencies_us) {
+    if (latencies_us.empty()) {
+        std::cout << name << ": no requests" << std::endl;
+        return;
+    }
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto percentile = [&](double p) {
+        return latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))];
+    };
+    std::cout << name << ": " << latencies_us.size() << " gets, p50 "
+              << std::fixed << std::setprecision(1) << percentile(0.5)
+              << " us, p99 " << percentile(0.99) << " us, max "
+              << latencies_us.back() << " us" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    // The clients do not ping, keep their segments mounted for the run
+    MasterService service(
+        MasterServiceConfig::builder().set_client_live_ttl_sec(3600).build());
+    // Half full segments, so that no object is evicted
+    const size_t segment_size =
+        FLAGS_num_keys / FLAGS_num_segments * FLAGS_value_size * 2;
+    std::vector<Segment> segments(FLAGS_num_segments);
+    std::vector<UUID> client_ids(FLAGS_num_segments);
+    for (size_t i = 0; i < FLAGS_num_segments; ++i) {
+        segments[i].id = generate_uuid();
+        segments[i].name = "segment_" + std::to_string(i);
+        segments[i].base = 0x100000000000 + i * segment_size;
+        segments[i].size = segment_size;
+        segments[i].te_endpoint = segments[i].name;
+        client_ids[i] = generate_uuid();
+        if (!service.MountSegment(segments[i], client_ids[i])) {
+            LOG(ERROR) << "Failed to mount segment " << segments[i].name;
+            return 1;
+        }
+    }
+
+    std::cout << "=== Master Unmount Benchmark ===" << std::endl
+              << "keys: " << FLAGS_num_keys
+              << ", segments: " << FLAGS_num_segments
+              << ", value size: " << FLAGS_value_size << " bytes"
+              << std::endl;
+
+    auto load_start = Clock::now();
+    std::atomic<uint64_t> next_key{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < FLAGS_load_threads; ++t) {
+        threads.emplace_back([&] {
+            ReplicateConfig config;
+            config.replica_num = 1;
+            for (uint64_t i = next_key++; i < FLAGS_num_keys;
+                 i = next_key++) {
+                std::string key = make_key(i);
+                if (service.PutStart(key, {FLAGS_value_size}, config)) {
+                    service.PutEnd(key, ReplicaType::MEMORY);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    std::cout << "load: " << service.GetKeyCount() << " keys in "
+              << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double>(Clock::now() - load_start)
+                     .count()
+              << " s" << std::endl;
+
+    // Gets of random keys until the unmount is done, including the keys of
+    // the unmounted segment
+    std::atomic<bool> running{true};
+    std::vector<std::vector<Sample>> samples(FLAGS_foreground_threads);
+    for (size_t t = 0; t < FLAGS_foreground_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 gen(t);
+            while (running) {
+                std::string key = make_key(gen() % FLAGS_num_keys);
+                auto start_time = Clock::now();
+                auto result = service.GetReplicaList(key);
+                samples[t].push_back(
+                    {start_time, std::chrono::duration<double, std::micro>(
+                                     Clock::now() - start_time)
+                                     .count()});
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_baseline_ms));
+    auto unmount_start = Clock::now();
+    if (!service.UnmountSegment(segments[0].id, client_ids[0])) {
+        LOG(ERROR) << "Failed to unmount segment " << segments[0].name;
+    }
+    auto unmount_end = Clock::now();
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "unmount: " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(unmount_end -
+                                                           unmount_start)
+                     .count()
+              << " ms, " << service.GetKeyCount() << " keys left"
+              << std::endl;
+    std::vector<double> before_us, during_us;
+    for (const auto& thread_samples : samples) {
+        for (const auto& sample : thread_samples) {
+            if (sample.start_time < unmount_start) {
+                before_us.push_back(sample.latency_us);
+            } else if (sample.start_time < unmount_end) {
+                during_us.push_back(sample.latency_us);
+            }
+        }
+    }
+    print_latencies("before unmount", std::move(before_us));
+    print_latencies("during unmount", std::move(during_us));
+    return 0;
+}
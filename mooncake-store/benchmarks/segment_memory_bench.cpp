@@ -0,0 +1,118 @@
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "utils.h"
+
+DEFINE_uint64(segment_size_gb, 16,
+              "Size of the segment to provision, e.g. 256 for a full store "
+              "server");
+DEFINE_int32(numa_node, -1, "NUMA node to bind the segment to, -1 for none");
+DEFINE_uint64(prefault_threads, std::thread::hardware_concurrency(),
+              "Number of threads faulting in the segment");
+DEFINE_uint64(copy_block_size, 64 * 1024,
+              "Size of the memcpy blocks at random segment offsets");
+DEFINE_uint64(copy_total_gb, 16, "Bytes copied per memcpy benchmark");
+
+using namespace mooncake;
+
+namespace {
+
+const char* page_size_name(size_t page_size) {
+    switch (page_size) {
+        case 0:
+            return "4KB";
+        case size_t{2} << 20:
+            return "2MB";
+        default:
+            return "1GB";
+    }
+}
+
+// Time to map and fault in the segment with one and with all threads
+bool startup_benchmark(size_t segment_size, size_t page_size) {
+    for (size_t threads : {size_t{1}, size_t{FLAGS_prefault_threads}}) {
+        auto start_time = std::chrono::steady_clock::now();
+        void* ptr = map_segment_memory(segment_size, page_size,
+                                       FLAGS_numa_node, threads);
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+        if (!ptr) {
+            std::cout << "pages: " << page_size_name(page_size)
+                      << ", unavailable" << std::endl;
+            return false;
+        }
+        unmap_segment_memory(ptr, segment_size);
+        std::cout << "pages: " << page_size_name(page_size)
+                  << ", prefault threads: " << std::setw(3) << threads
+                  << ", startup: " << std::fixed << std::setprecision(2)
+                  << seconds << " s" << std::endl;
+    }
+    return true;
+}
+
+// memcpy of blocks at random segment offsets into and out of a small buffer,
+// which misses the TLB on most blocks with small pages
+void memcpy_benchmark(size_t segment_size, size_t page_size) {
+    void* ptr = map_segment_memory(segment_size, page_size, FLAGS_numa_node,
+                                   FLAGS_prefault_threads);
+    if (!ptr) {
+        return;
+    }
+    auto* segment = static_cast<char*>(ptr);
+    const size_t block_size = FLAGS_copy_block_size;
+    const size_t num_blocks = segment_size / block_size;
+    const size_t num_copies = (FLAGS_copy_total_gb << 30) / block_size;
+    std::vector<char> buffer(block_size, 1);
+    std::mt19937_64 gen(42);
+    std::vector<size_t> offsets(num_copies);
+    for (auto& offset : offsets) {
+        offset = gen() % num_blocks * block_size;
+    }
+
+    for (bool to_segment : {true, false}) {
+        auto start_time = std::chrono::steady_clock::now();
+        for (size_t offset : offsets) {
+            if (to_segment) {
+                memcpy(segment + offset, buffer.data(), block_size);
+            } else {
+                memcpy(buffer.data(), segment + offset, block_size);
+            }
+        }
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+        std::cout << "pages: " << page_size_name(page_size) << ", memcpy "
+                  << (to_segment ? "to" : "from") << " segment: "
+                  << std::fixed << std::setprecision(2)
+                  << num_copies * block_size / seconds / 1e9 << " GB/s"
+                  << std::endl;
+    }
+    unmap_segment_memory(ptr, segment_size);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    const size_t segment_size = FLAGS_segment_size_gb << 30;
+    std::cout << "=== Segment Memory Benchmark ===" << std::endl
+              << "segment: " << FLAGS_segment_size_gb
+              << " GB, numa node: " << FLAGS_numa_node << std::endl;
+
+    // Huge pages have to be reserved beforehand, e.g. through
+    // /sys/kernel/mm/hugepages/hugepages-2048kB/nr_hugepages
+    for (size_t page_size : {size_t{0}, size_t{2} << 20, size_t{1} << 30}) {
+        if (startup_benchmark(segment_size, page_size)) {
+            memcpy_benchmark(segment_size, page_size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace mooncake {
+
+/**
+ * @brief Abstract interface for put admission policy, responsible for
+ *        deciding whether a put under memory pressure may evict an object to
+ *        make room for itself. Implementations are thread safe.
+ */
+class AdmissionPolicy {
+   public:
+    virtual ~AdmissionPolicy() = default;
+    // Record a put or a read of the object with the key, existing or not
+    virtual void RecordAccess(std::string_view key) = 0;
+    // Whether the put of the candidate may evict the victim
+    virtual bool Admit(std::string_view candidate, std::string_view victim) = 0;
+};
+
+class AlwaysAdmissionPolicy : public AdmissionPolicy {
+   public:
+    virtual void RecordAccess(std::string_view key) override {}
+
+    virtual bool Admit(std::string_view candidate,
+                       std::string_view victim) override {
+        return true;
+    }
+};
+
+/**
+ * @brief TinyLFU admission: the accesses of the keys are counted in a
+ *        count-min sketch of saturating 4-bit counters, which are halved
+ *        every kSampleFactor * width accesses so that old popularity fades.
+ *        A put may only evict objects accessed at most as often as itself,
+ *        so blocks written once and never read do not push out the blocks
+ *        being reused. Ties go to the put, the newer object.
+ */
+class TinyLFUAdmissionPolicy : public AdmissionPolicy {
+   public:
+    static constexpr size_t kDefaultWidth = 1 << 20;
+
+    // `width` counters per row, rounded up to a power of two
+    explicit TinyLFUAdmissionPolicy(size_t width = kDefaultWidth)
+        : width_(std::bit_ceil(std::max<size_t>(width, 64))),
+          counters_(new std::atomic<uint8_t>[kDepth * width_]),
+          sample_size_(kSampleFactor * width_) {
+        for (size_t i = 0; i < kDepth * width_; ++i) {
+            counters_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    virtual void RecordAccess(std::string_view key) override {
+        uint64_t hash = Hash(key);
+        for (size_t row = 0; row < kDepth; ++row) {
+            auto& counter = counters_[Index(hash, row)];
+            uint8_t count = counter.load(std::memory_order_relaxed);
+            // Racing increments may lose a count, which the sketch tolerates
+            if (count < kMaxCount) {
+                counter.store(count + 1, std::memory_order_relaxed);
+            }
+        }
+        if (accesses_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+            sample_size_) {
+            Age();
+        }
+    }
+
+    virtual bool Admit(std::string_view candidate,
+                       std::string_view victim) override {
+        return Estimate(candidate) >= Estimate(victim);
+    }
+
+    // The estimated number of recent accesses of the key, at most kMaxCount
+    uint8_t Estimate(std::string_view key) const {
+        uint64_t hash = Hash(key);
+        uint8_t count = kMaxCount;
+        for (size_t row = 0; row < kDepth; ++row) {
+            count = std::min(count, counters_[Index(hash, row)].load(
+                                        std::memory_order_relaxed));
+        }
+        return count;
+    }
+
+   private:
+    static constexpr size_t kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+    static constexpr uint64_t kSampleFactor = 10;
+
+    static uint64_t Hash(std::string_view key) {
+        // Spread the bits, std::hash may be the identity on some platforms
+        return std::hash<std::string_view>{}(key) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    // Double hashing, one counter per row
+    size_t Index(uint64_t hash, size_t row) const {
+        uint64_t step = (hash >> 32) | 1;
+        return row * width_ + ((hash + row * step) & (width_ - 1));
+    }
+
+    // Halve all counters. Accesses during the aging may be halved or not.
+    void Age() {
+        for (size_t i = 0; i < kDepth * width_; ++i) {
+            uint8_t count = counters_[i].load(std::memory_order_relaxed);
+            counters_[i].store(count / 2, std::memory_order_relaxed);
+        }
+        accesses_.fetch_sub(sample_size_ / 2, std::memory_order_relaxed);
+    }
+
+    const size_t width_;
+    std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+    const uint64_t sample_size_;
+    std::atomic<uint64_t> accesses_{0};
+};
+
+}  // namespace mooncake
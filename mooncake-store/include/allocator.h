@@ -26,17 +26,14 @@ class AllocatedBuffer {
    public:
     friend class CachelibBufferAllocator;
     friend class OffsetBufferAllocator;
+    friend class ShardedOffsetBufferAllocator;
     // Forward declaration of the descriptor struct
     struct Descriptor;
 
     AllocatedBuffer(std::shared_ptr<BufferAllocatorBase> allocator,
                     void* buffer_ptr, std::size_t size,
                     std::optional<offset_allocator::OffsetAllocationHandle>&&
-                        offset_handle = std::nullopt)
-        : allocator_(std::move(allocator)),
-          buffer_ptr_(buffer_ptr),
-          size_(size),
-          offset_handle_(std::move(offset_handle)) {}
+                        offset_handle = std::nullopt);
 
     ~AllocatedBuffer();
 
@@ -53,11 +50,21 @@ class AllocatedBuffer {
         return !allocator_.expired();
     }
 
+    [[nodiscard]] bool isAllocatedBy(
+        const BufferAllocatorBase* allocator) const {
+        return allocator_.lock().get() == allocator;
+    }
+
     // Serialize the buffer into a descriptor for transfer
     [[nodiscard]] Descriptor get_descriptor() const;
 
     [[nodiscard]] std::string getSegmentName() const noexcept;
 
+    // Id of the segment of the buffer, still known once it is unmounted
+    [[nodiscard]] const UUID& getSegmentId() const noexcept {
+        return segment_id_;
+    }
+
     // Friend declaration for operator<<
     friend std::ostream& operator<<(std::ostream& os,
                                     const AllocatedBuffer& buffer);
@@ -72,6 +79,7 @@ class AllocatedBuffer {
 
    private:
     std::weak_ptr<BufferAllocatorBase> allocator_;
+    UUID segment_id_{0, 0};
     void* buffer_ptr_{nullptr};
     std::size_t size_{0};
     // RAII handle for buffer allocated by offset allocator
@@ -104,6 +112,13 @@ class BufferAllocatorBase {
      * allocation may still fail due to race conditions or fragmentation.
      */
     virtual size_t getLargestFreeRegion() const = 0;
+
+    // Id of the segment managed by the allocator, set when it is mounted
+    void setSegmentId(const UUID& segment_id) { segment_id_ = segment_id; }
+    const UUID& getSegmentId() const { return segment_id_; }
+
+   private:
+    UUID segment_id_{0, 0};
 };
 
 /**
@@ -216,6 +231,52 @@ class OffsetBufferAllocator
     std::shared_ptr<offset_allocator::OffsetAllocator> offset_allocator_;
 };
 
+/**
+ * ShardedOffsetBufferAllocator is an OffsetBufferAllocator whose segment is
+ * split into independently locked arenas (see ShardedOffsetAllocator), so
+ * concurrent allocations on a large segment do not serialize on one mutex
+ * and small objects are sized exactly however large the segment is.
+ */
+class ShardedOffsetBufferAllocator
+    : public BufferAllocatorBase,
+      public std::enable_shared_from_this<ShardedOffsetBufferAllocator> {
+   public:
+    ShardedOffsetBufferAllocator(std::string segment_name, size_t base,
+                                 size_t size, std::string transport_endpoint,
+                                 uint32_t num_shards = 0);
+
+    ~ShardedOffsetBufferAllocator() override;
+
+    std::unique_ptr<AllocatedBuffer> allocate(size_t size) override;
+
+    void deallocate(AllocatedBuffer* handle) override;
+
+    size_t capacity() const override { return total_size_; }
+    size_t size() const override { return cur_size_.load(); }
+    std::string getSegmentName() const override { return segment_name_; }
+    std::string getTransportEndpoint() const override {
+        return transport_endpoint_;
+    }
+
+    /**
+     * Returns the largest free region of any arena.
+     */
+    size_t getLargestFreeRegion() const override;
+
+    size_t numShards() const { return offset_allocator_->num_shards(); }
+
+   private:
+    // metadata
+    const std::string segment_name_;
+    const size_t base_;
+    const size_t total_size_;
+    std::atomic_size_t cur_size_;
+    const std::string transport_endpoint_;
+
+    // sharded offset allocator implementation
+    std::shared_ptr<offset_allocator::ShardedOffsetAllocator> offset_allocator_;
+};
+
 // The main difference is that it allocates real memory and returns it, while
 // BufferAllocator allocates an address
 class SimpleAllocator {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <async_simple/coro/Lazy.h>
+#include <atomic>
 #include <boost/functional/hash.hpp>
 #include <memory>
 #include <mutex>
@@ -9,8 +11,10 @@
 #include <vector>
 #include <ylt/util/tl/expected.hpp>
 #include <chrono>
+#include <tuple>
 
 #include "client_metric.h"
+#include "completion_queue.h"
 #include "ha_helper.h"
 #include "master_client.h"
 #include "storage_backend.h"
@@ -114,6 +118,17 @@ class Client {
         ErrorCode>
     QueryByRegex(const std::string& str);
 
+    /**
+     * @brief Queries replica lists for object keys that start with a prefix.
+     * @param prefix The prefix of the object keys.
+     * @return An expected object containing a map from object keys to their
+     * replica descriptors on success, or an ErrorCode on failure.
+     */
+    tl::expected<
+        std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+        ErrorCode>
+    QueryByPrefix(const std::string& prefix);
+
     /**
      * @brief Batch query object metadata without transferring data
      * @param object_keys Keys to query
@@ -147,6 +162,37 @@ class Client {
         std::unordered_map<std::string, std::vector<Slice>>& slices,
         bool prefer_same_node = false);
 
+    /**
+     * @brief Retrieves bytes [offset, offset + length) of an object, where
+     * length is the total size of the slices. Only the replica buffers
+     * overlapping the range are transferred.
+     * @param object_key Key of the object
+     * @param query_result Previously queried object metadata
+     * @param offset Offset of the range in the object
+     * @param slices Vector of slices to store the range
+     * @return ErrorCode indicating success/failure, INVALID_PARAMS if the
+     * range exceeds the object
+     */
+    tl::expected<void, ErrorCode> GetRange(const std::string& object_key,
+                                           const QueryResult& query_result,
+                                           uint64_t offset,
+                                           std::vector<Slice>& slices);
+
+    /**
+     * @brief Retrieves a byte range of each object, see GetRange(). The same
+     * key may appear several times with different ranges.
+     * @param object_keys Keys of the objects
+     * @param query_results Previously queried object metadata for each key
+     * @param offsets Offset of the range in each object
+     * @param slices Slices to store the range of each object
+     * @return Vector of ErrorCode results for each range
+     */
+    std::vector<tl::expected<void, ErrorCode>> BatchGetRange(
+        const std::vector<std::string>& object_keys,
+        const std::vector<QueryResult>& query_results,
+        const std::vector<uint64_t>& offsets,
+        std::vector<std::vector<Slice>>& slices);
+
     /**
      * @brief Stores data with replication
      * @param key Object key
@@ -170,6 +216,51 @@ class Client {
         std::vector<std::vector<Slice>>& batched_slices,
         const ReplicateConfig& config);
 
+    /**
+     * @brief Non-blocking versions of Get, BatchGet, Put and BatchPut. They
+     * return at once, and the operation, master RPCs and data transfers
+     * alike, proceeds without holding a caller thread. Its completion, with
+     * one result per key, is pushed into the queue under the returned handle.
+     * @note The slice buffers must stay valid until the operation completes.
+     * prefer_alloc_in_same_node is not supported.
+     */
+    AsyncHandle AsyncGet(CompletionQueue& queue, const std::string& object_key,
+                         std::vector<Slice> slices);
+
+    AsyncHandle AsyncBatchGet(
+        CompletionQueue& queue, const std::vector<std::string>& object_keys,
+        std::unordered_map<std::string, std::vector<Slice>> slices);
+
+    AsyncHandle AsyncPut(CompletionQueue& queue, const ObjectKey& key,
+                         std::vector<Slice> slices,
+                         const ReplicateConfig& config);
+
+    AsyncHandle AsyncBatchPut(CompletionQueue& queue,
+                              const std::vector<ObjectKey>& keys,
+                              std::vector<std::vector<Slice>> batched_slices,
+                              const ReplicateConfig& config);
+
+    /**
+     * @brief Coroutine versions of Get, BatchGet, Put and BatchPut for callers
+     * running on async_simple executors, which the Async* calls are built on.
+     * @note The arguments must stay valid until the returned Lazy completes.
+     */
+    async_simple::coro::Lazy<tl::expected<void, ErrorCode>> CoGet(
+        const std::string& object_key, std::vector<Slice>& slices);
+
+    async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+    CoBatchGet(const std::vector<std::string>& object_keys,
+               std::unordered_map<std::string, std::vector<Slice>>& slices);
+
+    async_simple::coro::Lazy<tl::expected<void, ErrorCode>> CoPut(
+        const ObjectKey& key, std::vector<Slice>& slices,
+        const ReplicateConfig& config);
+
+    async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+    CoBatchPut(const std::vector<ObjectKey>& keys,
+               std::vector<std::vector<Slice>>& batched_slices,
+               const ReplicateConfig& config);
+
     /**
      * @brief Removes an object and all its replicas
      * @param key Key to remove
@@ -185,17 +276,48 @@ class Client {
      */
     tl::expected<long, ErrorCode> RemoveByRegex(const ObjectKey& str);
 
+    /**
+     * @brief Removes objects from the store whose keys start with a prefix.
+     * @param prefix The prefix of the object keys.
+     * @return An expected object containing the number of removed objects on
+     * success, or an ErrorCode on failure.
+     */
+    tl::expected<long, ErrorCode> RemoveByPrefix(const std::string& prefix);
+
     /**
      * @brief Removes all objects and all its replicas
      * @return tl::expected<long, ErrorCode> number of removed objects or error
      */
     tl::expected<long, ErrorCode> RemoveAll();
 
+    /**
+     * @brief Sets the capacity quota of a namespace, see
+     * ReplicateConfig::namespace_name
+     * @param name Name of the namespace
+     * @param quota Size in bytes of the memory replicas, 0 for no quota
+     * @return tl::expected<void, ErrorCode> indicating success/failure
+     */
+    tl::expected<void, ErrorCode> SetNamespaceQuota(const std::string& name,
+                                                    uint64_t quota);
+
+    /**
+     * @brief Drops all objects of a namespace
+     * @param name Name of the namespace
+     * @return tl::expected<void, ErrorCode> indicating success/failure
+     */
+    tl::expected<void, ErrorCode> DropNamespace(const std::string& name);
+
     /**
      * @brief Registers a memory segment to master for allocation
      * @param buffer Memory buffer to register
      * @param size Size of the buffer in bytes
      * @return ErrorCode indicating success/failure
+     * @note Segments larger than MC_STORE_MOUNT_CHUNK_SIZE (16GB by default,
+     * 0 disables chunking) are registered in chunks, several in parallel,
+     * and each chunk is mounted to master once registered. If any chunk
+     * fails, the chunks already done are unmounted and unregistered. The
+     * chunks are master segments sharing the name of this host, so
+     * unmounting one of them visits the objects of all of them on master.
      */
     tl::expected<void, ErrorCode> MountSegment(const void* buffer, size_t size);
 
@@ -268,6 +390,15 @@ class Client {
         return transfer_engine_->getLocalIpAndPort();
     }
 
+    /**
+     * @brief How long to wait before retrying puts that failed with
+     * NO_AVAILABLE_HANDLE, as last reported by the master through Ping
+     * @return The hint in milliseconds, 0 if the master had space
+     */
+    [[nodiscard]] uint64_t GetPutRetryAfterMs() const {
+        return put_retry_after_ms_.load(std::memory_order_relaxed);
+    }
+
    private:
     /**
      * @brief Private constructor to enforce creation through Create() method
@@ -291,6 +422,19 @@ class Client {
                             std::vector<Slice>& slices);
     ErrorCode TransferRead(const Replica::Descriptor& replica_descriptor,
                            std::vector<Slice>& slices);
+    ErrorCode TransferReadRange(const Replica::Descriptor& replica_descriptor,
+                                uint64_t offset, std::vector<Slice>& slices);
+    // Like TransferData, suspending the coroutine instead of blocking
+    async_simple::coro::Lazy<ErrorCode> CoTransferData(
+        const Replica::Descriptor& replica_descriptor,
+        std::vector<Slice>& slices, TransferRequest::OpCode op_code);
+
+    // Runs an asynchronous operation and pushes its results into the queue
+    AsyncHandle StartAsync(
+        CompletionQueue& queue,
+        async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+            operation,
+        size_t num_results);
 
     /**
      * @brief Prepare and use the storage backend for persisting data
@@ -319,14 +463,20 @@ class Client {
     std::vector<PutOperation> CreatePutOperations(
         const std::vector<ObjectKey>& keys,
         const std::vector<std::vector<Slice>>& batched_slices);
-    void StartBatchPut(std::vector<PutOperation>& ops,
-                       const ReplicateConfig& config);
+    async_simple::coro::Lazy<void> StartBatchPut(
+        std::vector<PutOperation>& ops, const ReplicateConfig& config);
     void SubmitTransfers(std::vector<PutOperation>& ops);
     void WaitForTransfers(std::vector<PutOperation>& ops);
-    void FinalizeBatchPut(std::vector<PutOperation>& ops);
+    async_simple::coro::Lazy<void> FinalizeBatchPut(
+        std::vector<PutOperation>& ops);
     std::vector<tl::expected<void, ErrorCode>> CollectResults(
         const std::vector<PutOperation>& ops);
 
+    // Mounts registered memory to master and returns the id of the new
+    // segment, requires mounted_segments_mutex_
+    tl::expected<UUID, ErrorCode> MountRegisteredSegment(const void* buffer,
+                                                         size_t size);
+
     std::vector<tl::expected<void, ErrorCode>> BatchPutWhenPreferSameNode(
         std::vector<PutOperation>& ops);
     std::vector<tl::expected<void, ErrorCode>> BatchGetWhenPreferSameNode(
@@ -334,6 +484,22 @@ class Client {
         const std::vector<QueryResult>& query_results,
         std::unordered_map<std::string, std::vector<Slice>>& slices);
 
+    /**
+     * @brief BatchGet helpers: submits the reads, recording failures in
+     * results, and collects the submitted reads and checks their leases
+     */
+    using PendingGetTransfer = std::tuple<size_t, std::string, TransferFuture>;
+    std::vector<PendingGetTransfer> SubmitBatchGetTransfers(
+        const std::vector<std::string>& object_keys,
+        const std::vector<QueryResult>& query_results,
+        std::unordered_map<std::string, std::vector<Slice>>& slices,
+        std::vector<tl::expected<void, ErrorCode>>& results);
+    void CollectBatchGetTransfers(
+        const std::vector<std::string>& object_keys,
+        const std::vector<QueryResult>& query_results,
+        std::vector<PendingGetTransfer>& pending_transfers,
+        std::vector<tl::expected<void, ErrorCode>>& results);
+
     // Client-side metrics
     std::unique_ptr<ClientMetric> metrics_;
 
@@ -341,6 +507,11 @@ class Client {
     std::shared_ptr<TransferEngine> transfer_engine_;
     MasterClient master_client_;
     std::unique_ptr<TransferSubmitter> transfer_submitter_;
+    std::unique_ptr<TransferPoller> transfer_poller_;
+
+    // Asynchronous operations
+    std::atomic<AsyncHandle> next_async_handle_{1};
+    std::atomic<size_t> async_operations_{0};
 
     // Mutex to protect mounted_segments_
     std::mutex mounted_segments_mutex_;
@@ -358,7 +529,12 @@ class Client {
     MasterViewHelper master_view_helper_;
     std::thread ping_thread_;
     std::atomic<bool> ping_running_{false};
+    // Put retry hint of the last ping, see GetPutRetryAfterMs
+    std::atomic<uint64_t> put_retry_after_ms_{0};
     void PingThreadMain(bool is_ha_mode, std::string current_master_address);
+    // Copy the objects relocated by compaction tasks within the local
+    // segments and report the results to the master
+    void MoveObjects(const std::vector<CompactionTask>& tasks);
 
     // Client identification
     UUID client_id_;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "offset_allocator/offset_allocator.hpp"
@@ -10,6 +13,7 @@
 namespace mooncake {
 
 class BufferHandle;
+class BufferMagazine;
 
 /**
  * ClientBufferAllocator manages a contiguous memory buffer using an
@@ -20,14 +24,26 @@ class BufferHandle;
  * - Efficient sub-allocation within a larger buffer
  * - Automatic memory cleanup via RAII
  * - Thread-safe allocation operations
+ *
+ * Allocations between kMinCachedSize and kMaxCachedSize are served from a
+ * per-thread magazine of freed chunks of the same size class, so concurrent
+ * readers rarely contend on the lock of the offset allocator. A chunk freed
+ * by another thread returns to the magazine of the thread that allocated
+ * it. Chunks are carved from the buffer like any other allocation, so they
+ * stay within the registered memory. Magazines are trimmed when the buffer
+ * runs out of space.
  */
 class ClientBufferAllocator
     : public std::enable_shared_from_this<ClientBufferAllocator> {
    public:
+    static constexpr size_t kMinCachedSize = 64 * 1024;
+    static constexpr size_t kMaxCachedSize = 4 * 1024 * 1024;
+
     static std::shared_ptr<ClientBufferAllocator> create(
-        size_t size, const std::string& protocol = "") {
+        size_t size, const std::string& protocol = "",
+        bool use_thread_cache = true) {
         return std::shared_ptr<ClientBufferAllocator>(
-            new ClientBufferAllocator(size, protocol));
+            new ClientBufferAllocator(size, protocol, use_thread_cache));
     }
 
     ~ClientBufferAllocator();
@@ -46,13 +62,29 @@ class ClientBufferAllocator
 
     [[nodiscard]] std::optional<BufferHandle> allocate(size_t size);
 
+    // Returns the chunks cached in all magazines to the buffer
+    void trimThreadCaches();
+
    private:
-    ClientBufferAllocator(size_t size, const std::string& protocol);
+    ClientBufferAllocator(size_t size, const std::string& protocol,
+                          bool use_thread_cache);
+
+    std::shared_ptr<BufferMagazine> localMagazine();
+
     std::shared_ptr<offset_allocator::OffsetAllocator> allocator_;
 
     std::string protocol;
     void* buffer_;
     size_t buffer_size_;
+
+    // Unique across allocators, thread-local magazines are looked up by it
+    const uint64_t id_;
+    const bool use_thread_cache_;
+    // Bytes a magazine may keep cached
+    const size_t max_cached_bytes_;
+
+    std::mutex magazines_mutex_;
+    std::vector<std::weak_ptr<BufferMagazine>> magazines_;
 };
 
 /**
@@ -67,10 +99,14 @@ class BufferHandle {
    public:
     BufferHandle(std::shared_ptr<ClientBufferAllocator> allocator,
                  offset_allocator::OffsetAllocationHandle handle);
+    // A size class chunk of `magazine` holding `size` bytes
+    BufferHandle(std::shared_ptr<ClientBufferAllocator> allocator,
+                 offset_allocator::OffsetAllocationHandle chunk, size_t size,
+                 std::shared_ptr<BufferMagazine> magazine);
     ~BufferHandle();
 
-    BufferHandle(BufferHandle&&) = default;  // Allow move operations
-    BufferHandle& operator=(BufferHandle&&) = default;
+    BufferHandle(BufferHandle&& other) noexcept;  // Allow move operations
+    BufferHandle& operator=(BufferHandle&& other) noexcept;
 
     // Disable copy constructor and copy assignment operator
     BufferHandle(const BufferHandle&) = delete;
@@ -80,8 +116,12 @@ class BufferHandle {
     [[nodiscard]] size_t size() const;
 
    private:
+    void release();
+
     std::shared_ptr<ClientBufferAllocator> allocator_;
     offset_allocator::OffsetAllocationHandle handle_;
+    size_t size_;
+    std::shared_ptr<BufferMagazine> magazine_;
 };
 
 // Utility functions for buffer and slice management
@@ -110,4 +150,18 @@ int allocateSlices(std::vector<Slice>& slices,
                    const Replica::Descriptor& replica,
                    BufferHandle& buffer_handle);
 
+/**
+ * @brief Restrict a memory replica to the object bytes [offset, offset +
+ * length), where length is the total size of `slices`
+ * @param replica The memory replica descriptor, its buffer descriptors are
+ * reduced to the parts overlapping the range
+ * @param offset Offset of the range in the object
+ * @param slices Destination of the range, split in place at the buffer
+ * boundaries so that they correspond one to one to the remaining buffers
+ * @return ErrorCode::OK on success, INVALID_PARAMS if the range exceeds the
+ * object or the replica is not a memory replica
+ */
+ErrorCode restrictReplicaToRange(Replica::Descriptor& replica,
+                                 uint64_t offset, std::vector<Slice>& slices);
+
 }  // namespace mooncake
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include <ylt/util/tl/expected.hpp>
+
+#include "types.h"
+
+namespace mooncake {
+
+/**
+ * @brief Identifies an operation started by an asynchronous Client call. It is
+ * returned by the call and again with the completion of the operation.
+ */
+using AsyncHandle = uint64_t;
+
+/**
+ * @brief Completion of an asynchronous operation, with one result per key
+ */
+struct AsyncCompletion {
+    AsyncHandle handle;
+    std::vector<tl::expected<void, ErrorCode>> results;
+};
+
+/**
+ * @brief Queue that asynchronous Client operations complete into
+ *
+ * Operations complete on internal threads and push their completions here,
+ * and the application collects them from its own event loop. A queue may be
+ * shared by several clients and must outlive the operations completing into
+ * it.
+ */
+class CompletionQueue {
+   public:
+    /**
+     * @brief Appends up to max_completions completions without blocking
+     * @return Number of completions appended
+     */
+    size_t Poll(std::vector<AsyncCompletion>& completions,
+                size_t max_completions = std::numeric_limits<size_t>::max());
+
+    /**
+     * @brief Like Poll(), but first waits up to timeout for a completion
+     * @return Number of completions appended, 0 on timeout
+     */
+    size_t Wait(std::vector<AsyncCompletion>& completions,
+                std::chrono::milliseconds timeout,
+                size_t max_completions = std::numeric_limits<size_t>::max());
+
+    /**
+     * @brief Number of completions that have not been collected yet
+     */
+    size_t Size() const;
+
+    /**
+     * @brief Adds the completion of an operation, called by the client
+     */
+    void Push(AsyncCompletion completion);
+
+   private:
+    size_t PopLocked(std::vector<AsyncCompletion>& completions,
+                     size_t max_completions);
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<AsyncCompletion> completions_;
+};
+
+}  // namespace mooncake
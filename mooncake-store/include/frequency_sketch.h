@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string_view>
+
+namespace mooncake {
+
+/**
+ * @brief Count-min sketch of the recent events of each key, e.g. the reads
+ *        of the objects. The counters are halved by Decay, which the owner
+ *        calls periodically so that the counts follow the current rate.
+ *        Thread safe, racing increments may lose a count.
+ */
+class FrequencySketch {
+   public:
+    static constexpr size_t kDefaultWidth = 1 << 16;
+
+    // `width` counters per row, rounded up to a power of two
+    explicit FrequencySketch(size_t width = kDefaultWidth)
+        : width_(std::bit_ceil(std::max<size_t>(width, 64))),
+          counters_(new std::atomic<uint32_t>[kDepth * width_]) {
+        for (size_t i = 0; i < kDepth * width_; ++i) {
+            counters_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Count an event of the key and return its estimated count, which grows
+    // by at most one per call
+    uint32_t Increment(std::string_view key) {
+        uint64_t hash = Hash(key);
+        uint32_t estimate = std::numeric_limits<uint32_t>::max();
+        for (size_t row = 0; row < kDepth; ++row) {
+            auto& counter = counters_[Index(hash, row)];
+            uint32_t count = counter.load(std::memory_order_relaxed);
+            if (count < std::numeric_limits<uint32_t>::max()) {
+                counter.store(++count, std::memory_order_relaxed);
+            }
+            estimate = std::min(estimate, count);
+        }
+        return estimate;
+    }
+
+    // The estimated count of the key, never below its actual count
+    uint32_t Estimate(std::string_view key) const {
+        uint64_t hash = Hash(key);
+        uint32_t estimate = std::numeric_limits<uint32_t>::max();
+        for (size_t row = 0; row < kDepth; ++row) {
+            estimate = std::min(estimate, counters_[Index(hash, row)].load(
+                                              std::memory_order_relaxed));
+        }
+        return estimate;
+    }
+
+    // Halve all counters. Events during the decay may be halved or not.
+    void Decay() {
+        for (size_t i = 0; i < kDepth * width_; ++i) {
+            uint32_t count = counters_[i].load(std::memory_order_relaxed);
+            counters_[i].store(count / 2, std::memory_order_relaxed);
+        }
+    }
+
+   private:
+    static constexpr size_t kDepth = 4;
+
+    static uint64_t Hash(std::string_view key) {
+        // Spread the bits, std::hash may be the identity on some platforms
+        return std::hash<std::string_view>{}(key) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    // Double hashing, one counter per row
+    size_t Index(uint64_t hash, size_t row) const {
+        uint64_t step = (hash >> 32) | 1;
+        return row * width_ + ((hash + row * step) & (width_ - 1));
+    }
+
+    const size_t width_;
+    std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+};
+
+}  // namespace mooncake
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <async_simple/coro/Lazy.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -83,6 +84,29 @@ class MasterClient {
         ErrorCode>
     GetReplicaListByRegex(const std::string& str);
 
+    /**
+     * @brief Retrieves replica lists for object keys that start with a prefix
+     * @param prefix The prefix of the object keys
+     * @return An expected object containing a map from object keys to their
+     * replica descriptors on success, or an ErrorCode on failure.
+     */
+    [[nodiscard]] tl::expected<
+        std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+        ErrorCode>
+    GetReplicaListByPrefix(const std::string& prefix);
+
+    /**
+     * @brief Scans the object keys a page at a time
+     * @param cursor Empty for the first page, otherwise the next_cursor of
+     * the previous page
+     * @param limit Maximum number of keys of the page
+     * @param prefix The prefix of the object keys, empty for all keys
+     * @return An expected object containing the keys of the page and the
+     * cursor of the next one, empty once all keys were scanned
+     */
+    [[nodiscard]] tl::expected<ScanKeysResponse, ErrorCode> ScanKeys(
+        const std::string& cursor, uint64_t limit, const std::string& prefix);
+
     /**
      * @brief Gets object metadata without transferring data
      * @param object_keys Keys to query
@@ -154,6 +178,46 @@ class MasterClient {
     [[nodiscard]] std::vector<tl::expected<void, ErrorCode>> BatchPutRevoke(
         const std::vector<std::string>& keys);
 
+    /**
+     * @brief Coroutine versions of the RPCs above, used by the asynchronous
+     * client API. They suspend the awaiting coroutine instead of blocking the
+     * calling thread, and the arguments must stay valid until the returned
+     * Lazy completes.
+     */
+    [[nodiscard]] async_simple::coro::Lazy<
+        tl::expected<GetReplicaListResponse, ErrorCode>>
+    GetReplicaListAsync(const std::string& object_key);
+
+    [[nodiscard]] async_simple::coro::Lazy<
+        std::vector<tl::expected<GetReplicaListResponse, ErrorCode>>>
+    BatchGetReplicaListAsync(const std::vector<std::string>& object_keys);
+
+    [[nodiscard]] async_simple::coro::Lazy<
+        tl::expected<std::vector<Replica::Descriptor>, ErrorCode>>
+    PutStartAsync(const std::string& key,
+                  const std::vector<size_t>& slice_lengths,
+                  const ReplicateConfig& config);
+
+    [[nodiscard]] async_simple::coro::Lazy<
+        std::vector<tl::expected<std::vector<Replica::Descriptor>, ErrorCode>>>
+    BatchPutStartAsync(const std::vector<std::string>& keys,
+                       const std::vector<std::vector<uint64_t>>& slice_lengths,
+                       const ReplicateConfig& config);
+
+    [[nodiscard]] async_simple::coro::Lazy<tl::expected<void, ErrorCode>>
+    PutEndAsync(const std::string& key, ReplicaType replica_type);
+
+    [[nodiscard]] async_simple::coro::Lazy<
+        std::vector<tl::expected<void, ErrorCode>>>
+    BatchPutEndAsync(const std::vector<std::string>& keys);
+
+    [[nodiscard]] async_simple::coro::Lazy<tl::expected<void, ErrorCode>>
+    PutRevokeAsync(const std::string& key, ReplicaType replica_type);
+
+    [[nodiscard]] async_simple::coro::Lazy<
+        std::vector<tl::expected<void, ErrorCode>>>
+    BatchPutRevokeAsync(const std::vector<std::string>& keys);
+
     /**
      * @brief Removes an object and all its replicas
      * @param key Key to remove
@@ -170,6 +234,15 @@ class MasterClient {
     [[nodiscard]] tl::expected<long, ErrorCode> RemoveByRegex(
         const std::string& str);
 
+    /**
+     * @brief Removes objects from the master whose keys start with a prefix
+     * @param prefix The prefix of the object keys
+     * @return An expected object containing the number of removed objects on
+     * success, or an ErrorCode on failure.
+     */
+    [[nodiscard]] tl::expected<long, ErrorCode> RemoveByPrefix(
+        const std::string& prefix);
+
     /**
      * @brief Removes all objects and all its replicas
      * @return tl::expected<long, ErrorCode> number of removed objects or error
@@ -222,6 +295,34 @@ class MasterClient {
     [[nodiscard]] tl::expected<PingResponse, ErrorCode> Ping(
         const UUID& client_id);
 
+    /**
+     * @brief Reports the result of a compaction task received with Ping
+     * @param client_id The uuid of the client
+     * @param task_id ID of the compaction task
+     * @param success Whether the sources were copied to the targets
+     * @return tl::expected<void, ErrorCode> indicating success/failure
+     */
+    [[nodiscard]] tl::expected<void, ErrorCode> MoveEnd(const UUID& client_id,
+                                                        uint64_t task_id,
+                                                        bool success);
+
+    /**
+     * @brief Sets the capacity quota of a namespace
+     * @param name Name of the namespace
+     * @param quota Size in bytes of the memory replicas, 0 for no quota
+     * @return tl::expected<void, ErrorCode> indicating success/failure
+     */
+    [[nodiscard]] tl::expected<void, ErrorCode> SetNamespaceQuota(
+        const std::string& name, uint64_t quota);
+
+    /**
+     * @brief Drops all objects of a namespace
+     * @param name Name of the namespace
+     * @return tl::expected<void, ErrorCode> indicating success/failure
+     */
+    [[nodiscard]] tl::expected<void, ErrorCode> DropNamespace(
+        const std::string& name);
+
    private:
     /**
      * @brief Generic RPC invocation helper for single-result operations
@@ -235,6 +336,11 @@ class MasterClient {
     [[nodiscard]] tl::expected<ReturnType, ErrorCode> invoke_rpc(
         Args&&... args);
 
+    // Coroutine form of invoke_rpc, which it waits for
+    template <auto ServiceMethod, typename ReturnType, typename... Args>
+    [[nodiscard]] async_simple::coro::Lazy<tl::expected<ReturnType, ErrorCode>>
+    invoke_rpc_async(Args&&... args);
+
     /**
      * @brief Generic RPC invocation helper for batch operations
      * @tparam ServiceMethod Pointer to WrappedMasterService member function
@@ -248,6 +354,12 @@ class MasterClient {
     [[nodiscard]] std::vector<tl::expected<ResultType, ErrorCode>>
     invoke_batch_rpc(size_t input_size, Args&&... args);
 
+    // Coroutine form of invoke_batch_rpc, which it waits for
+    template <auto ServiceMethod, typename ResultType, typename... Args>
+    [[nodiscard]] async_simple::coro::Lazy<
+        std::vector<tl::expected<ResultType, ErrorCode>>>
+    invoke_batch_rpc_async(size_t input_size, Args&&... args);
+
     /**
      * @brief Accessor for the coro_rpc_client pool. Since coro_rpc_client pool
      * cannot reconnect to a different address, a new coro_rpc_client pool is
@@ -23,6 +23,13 @@ struct MasterConfig {
     bool allow_evict_soft_pinned_objects;
     double eviction_ratio;
     double eviction_high_watermark_ratio;
+    double compaction_fragmentation_ratio;
+    uint64_t num_metadata_shards;
+    bool hex_key_shard_hash;
+    bool enable_inline_eviction;
+    std::string put_admission_policy;
+    uint64_t hot_key_read_threshold;
+    uint64_t hot_key_extra_replicas;
     int64_t client_live_ttl_sec;
 
     bool enable_ha;
@@ -66,6 +73,14 @@ class MasterServiceSupervisorConfig {
     std::string root_fs_dir = DEFAULT_ROOT_FS_DIR;
     int64_t global_file_segment_size = DEFAULT_GLOBAL_FILE_SEGMENT_SIZE;
     BufferAllocatorType memory_allocator = BufferAllocatorType::OFFSET;
+    double compaction_fragmentation_ratio =
+        DEFAULT_COMPACTION_FRAGMENTATION_RATIO;
+    uint64_t num_metadata_shards = DEFAULT_NUM_METADATA_SHARDS;
+    bool hex_key_shard_hash = false;
+    bool enable_inline_eviction = DEFAULT_ENABLE_INLINE_EVICTION;
+    PutAdmissionPolicy put_admission_policy = PutAdmissionPolicy::ALWAYS;
+    uint64_t hot_key_read_threshold = DEFAULT_HOT_KEY_READ_THRESHOLD;
+    uint64_t hot_key_extra_replicas = DEFAULT_HOT_KEY_EXTRA_REPLICAS;
 
     MasterServiceSupervisorConfig() = default;
 
@@ -94,14 +109,29 @@ class MasterServiceSupervisorConfig {
         cluster_id = config.cluster_id;
         root_fs_dir = config.root_fs_dir;
         global_file_segment_size = config.global_file_segment_size;
+        compaction_fragmentation_ratio = config.compaction_fragmentation_ratio;
+        num_metadata_shards = config.num_metadata_shards;
+        hex_key_shard_hash = config.hex_key_shard_hash;
+        enable_inline_eviction = config.enable_inline_eviction;
+        hot_key_read_threshold = config.hot_key_read_threshold;
+        hot_key_extra_replicas = config.hot_key_extra_replicas;
 
         // Convert string memory_allocator to BufferAllocatorType enum
         if (config.memory_allocator == "cachelib") {
             memory_allocator = BufferAllocatorType::CACHELIB;
+        } else if (config.memory_allocator == "sharded_offset") {
+            memory_allocator = BufferAllocatorType::SHARDED_OFFSET;
         } else {
             memory_allocator = BufferAllocatorType::OFFSET;
         }
 
+        // Convert string put_admission_policy to PutAdmissionPolicy enum
+        if (config.put_admission_policy == "tinylfu") {
+            put_admission_policy = PutAdmissionPolicy::TINY_LFU;
+        } else {
+            put_admission_policy = PutAdmissionPolicy::ALWAYS;
+        }
+
         validate();
     }
 
@@ -166,6 +196,14 @@ class WrappedMasterServiceConfig {
     std::string root_fs_dir = DEFAULT_ROOT_FS_DIR;
     int64_t global_file_segment_size = DEFAULT_GLOBAL_FILE_SEGMENT_SIZE;
     BufferAllocatorType memory_allocator = BufferAllocatorType::OFFSET;
+    double compaction_fragmentation_ratio =
+        DEFAULT_COMPACTION_FRAGMENTATION_RATIO;
+    uint64_t num_metadata_shards = DEFAULT_NUM_METADATA_SHARDS;
+    bool hex_key_shard_hash = false;
+    bool enable_inline_eviction = DEFAULT_ENABLE_INLINE_EVICTION;
+    PutAdmissionPolicy put_admission_policy = PutAdmissionPolicy::ALWAYS;
+    uint64_t hot_key_read_threshold = DEFAULT_HOT_KEY_READ_THRESHOLD;
+    uint64_t hot_key_extra_replicas = DEFAULT_HOT_KEY_EXTRA_REPLICAS;
 
     WrappedMasterServiceConfig() = default;
 
@@ -189,13 +227,28 @@ class WrappedMasterServiceConfig {
         cluster_id = config.cluster_id;
         root_fs_dir = config.root_fs_dir;
         global_file_segment_size = config.global_file_segment_size;
+        compaction_fragmentation_ratio = config.compaction_fragmentation_ratio;
+        num_metadata_shards = config.num_metadata_shards;
+        hex_key_shard_hash = config.hex_key_shard_hash;
+        enable_inline_eviction = config.enable_inline_eviction;
+        hot_key_read_threshold = config.hot_key_read_threshold;
+        hot_key_extra_replicas = config.hot_key_extra_replicas;
 
         // Convert string memory_allocator to BufferAllocatorType enum
         if (config.memory_allocator == "cachelib") {
             memory_allocator = mooncake::BufferAllocatorType::CACHELIB;
+        } else if (config.memory_allocator == "sharded_offset") {
+            memory_allocator = mooncake::BufferAllocatorType::SHARDED_OFFSET;
         } else {
             memory_allocator = mooncake::BufferAllocatorType::OFFSET;
         }
+
+        // Convert string put_admission_policy to PutAdmissionPolicy enum
+        if (config.put_admission_policy == "tinylfu") {
+            put_admission_policy = mooncake::PutAdmissionPolicy::TINY_LFU;
+        } else {
+            put_admission_policy = mooncake::PutAdmissionPolicy::ALWAYS;
+        }
     }
 
     // From MasterServiceSupervisorConfig, enable_ha is set to true
@@ -221,6 +274,13 @@ class WrappedMasterServiceConfig {
         root_fs_dir = config.root_fs_dir;
         global_file_segment_size = config.global_file_segment_size;
         memory_allocator = config.memory_allocator;
+        compaction_fragmentation_ratio = config.compaction_fragmentation_ratio;
+        num_metadata_shards = config.num_metadata_shards;
+        hex_key_shard_hash = config.hex_key_shard_hash;
+        enable_inline_eviction = config.enable_inline_eviction;
+        put_admission_policy = config.put_admission_policy;
+        hot_key_read_threshold = config.hot_key_read_threshold;
+        hot_key_extra_replicas = config.hot_key_extra_replicas;
     }
 };
 
@@ -244,6 +304,14 @@ class MasterServiceConfigBuilder {
     std::string root_fs_dir_ = DEFAULT_ROOT_FS_DIR;
     int64_t global_file_segment_size_ = DEFAULT_GLOBAL_FILE_SEGMENT_SIZE;
     BufferAllocatorType memory_allocator_ = BufferAllocatorType::OFFSET;
+    double compaction_fragmentation_ratio_ =
+        DEFAULT_COMPACTION_FRAGMENTATION_RATIO;
+    uint64_t num_metadata_shards_ = DEFAULT_NUM_METADATA_SHARDS;
+    bool hex_key_shard_hash_ = false;
+    bool enable_inline_eviction_ = DEFAULT_ENABLE_INLINE_EVICTION;
+    PutAdmissionPolicy put_admission_policy_ = PutAdmissionPolicy::ALWAYS;
+    uint64_t hot_key_read_threshold_ = DEFAULT_HOT_KEY_READ_THRESHOLD;
+    uint64_t hot_key_extra_replicas_ = DEFAULT_HOT_KEY_EXTRA_REPLICAS;
 
    public:
     MasterServiceConfigBuilder() = default;
@@ -312,6 +380,45 @@ class MasterServiceConfigBuilder {
         return *this;
     }
 
+    MasterServiceConfigBuilder& set_compaction_fragmentation_ratio(
+        double ratio) {
+        compaction_fragmentation_ratio_ = ratio;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_num_metadata_shards(uint64_t num_shards) {
+        num_metadata_shards_ = num_shards;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_hex_key_shard_hash(bool enable) {
+        hex_key_shard_hash_ = enable;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_enable_inline_eviction(bool enable) {
+        enable_inline_eviction_ = enable;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_put_admission_policy(
+        PutAdmissionPolicy policy) {
+        put_admission_policy_ = policy;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_hot_key_read_threshold(
+        uint64_t threshold) {
+        hot_key_read_threshold_ = threshold;
+        return *this;
+    }
+
+    MasterServiceConfigBuilder& set_hot_key_extra_replicas(
+        uint64_t extra_replicas) {
+        hot_key_extra_replicas_ = extra_replicas;
+        return *this;
+    }
+
     MasterServiceConfig build() const;
 };
 
@@ -331,6 +438,14 @@ class MasterServiceConfig {
     std::string root_fs_dir = DEFAULT_ROOT_FS_DIR;
     int64_t global_file_segment_size = DEFAULT_GLOBAL_FILE_SEGMENT_SIZE;
     BufferAllocatorType memory_allocator = BufferAllocatorType::OFFSET;
+    double compaction_fragmentation_ratio =
+        DEFAULT_COMPACTION_FRAGMENTATION_RATIO;
+    uint64_t num_metadata_shards = DEFAULT_NUM_METADATA_SHARDS;
+    bool hex_key_shard_hash = false;
+    bool enable_inline_eviction = DEFAULT_ENABLE_INLINE_EVICTION;
+    PutAdmissionPolicy put_admission_policy = PutAdmissionPolicy::ALWAYS;
+    uint64_t hot_key_read_threshold = DEFAULT_HOT_KEY_READ_THRESHOLD;
+    uint64_t hot_key_extra_replicas = DEFAULT_HOT_KEY_EXTRA_REPLICAS;
 
     MasterServiceConfig() = default;
 
@@ -349,6 +464,13 @@ class MasterServiceConfig {
         root_fs_dir = config.root_fs_dir;
         global_file_segment_size = config.global_file_segment_size;
         memory_allocator = config.memory_allocator;
+        compaction_fragmentation_ratio = config.compaction_fragmentation_ratio;
+        num_metadata_shards = config.num_metadata_shards;
+        hex_key_shard_hash = config.hex_key_shard_hash;
+        enable_inline_eviction = config.enable_inline_eviction;
+        put_admission_policy = config.put_admission_policy;
+        hot_key_read_threshold = config.hot_key_read_threshold;
+        hot_key_extra_replicas = config.hot_key_extra_replicas;
     }
 
     // Static factory method to create a builder
@@ -370,6 +492,13 @@ inline MasterServiceConfig MasterServiceConfigBuilder::build() const {
     config.root_fs_dir = root_fs_dir_;
     config.global_file_segment_size = global_file_segment_size_;
     config.memory_allocator = memory_allocator_;
+    config.compaction_fragmentation_ratio = compaction_fragmentation_ratio_;
+    config.num_metadata_shards = num_metadata_shards_;
+    config.hex_key_shard_hash = hex_key_shard_hash_;
+    config.enable_inline_eviction = enable_inline_eviction_;
+    config.put_admission_policy = put_admission_policy_;
+    config.hot_key_read_threshold = hot_key_read_threshold_;
+    config.hot_key_extra_replicas = hot_key_extra_replicas_;
     return config;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <string>
 
@@ -27,6 +29,9 @@ class MasterMetricManager {
     int64_t get_allocated_mem_size();
     int64_t get_total_mem_capacity();
     double get_global_mem_used_ratio(void);
+    void set_fragmented_mem_size(int64_t val);
+    int64_t get_fragmented_mem_size();
+    double get_global_mem_fragmentation_ratio(void);
 
     // File Storage Metrics
     void inc_allocated_file_size(int64_t val = 1);
@@ -60,6 +65,8 @@ class MasterMetricManager {
     void inc_put_revoke_failures(int64_t val = 1);
     void inc_get_replica_list_by_regex_requests(int64_t val = 1);
     void inc_get_replica_list_by_regex_failures(int64_t val = 1);
+    void inc_get_replica_list_by_prefix_requests(int64_t val = 1);
+    void inc_get_replica_list_by_prefix_failures(int64_t val = 1);
     void inc_get_replica_list_requests(int64_t val = 1);
     void inc_get_replica_list_failures(int64_t val = 1);
     void inc_exist_key_requests(int64_t val = 1);
@@ -68,6 +75,8 @@ class MasterMetricManager {
     void inc_remove_failures(int64_t val = 1);
     void inc_remove_by_regex_requests(int64_t val = 1);
     void inc_remove_by_regex_failures(int64_t val = 1);
+    void inc_remove_by_prefix_requests(int64_t val = 1);
+    void inc_remove_by_prefix_failures(int64_t val = 1);
     void inc_remove_all_requests(int64_t val = 1);
     void inc_remove_all_failures(int64_t val = 1);
     void inc_mount_segment_requests(int64_t val = 1);
@@ -107,12 +116,16 @@ class MasterMetricManager {
     int64_t get_get_replica_list_failures();
     int64_t get_get_replica_list_by_regex_requests();
     int64_t get_get_replica_list_by_regex_failures();
+    int64_t get_get_replica_list_by_prefix_requests();
+    int64_t get_get_replica_list_by_prefix_failures();
     int64_t get_exist_key_requests();
     int64_t get_exist_key_failures();
     int64_t get_remove_requests();
     int64_t get_remove_failures();
     int64_t get_remove_by_regex_requests();
     int64_t get_remove_by_regex_failures();
+    int64_t get_remove_by_prefix_requests();
+    int64_t get_remove_by_prefix_failures();
     int64_t get_remove_all_requests();
     int64_t get_remove_all_failures();
     int64_t get_mount_segment_requests();
@@ -161,6 +174,49 @@ class MasterMetricManager {
     int64_t get_evicted_key_count();
     int64_t get_evicted_size();
 
+    // Admission Metrics, puts turned away by the put admission policy
+    void inc_put_admission_rejections();
+    int64_t get_put_admission_rejections();
+
+    // Dedup Metrics, puts sharing the replicas of the same content
+    void inc_dedup_puts(int64_t saved_size);
+    int64_t get_dedup_puts();
+    int64_t get_dedup_saved_size();
+
+    // Hot Key Metrics, extra replicas of heavily read objects
+    void inc_hot_key_replicas_added(int64_t count);
+    void inc_hot_key_replicas_dropped(int64_t count);
+    int64_t get_hot_key_replicas_added();
+    int64_t get_hot_key_replicas_dropped();
+
+    // Compaction Metrics
+    void inc_compaction_success(int64_t size);
+    void inc_compaction_fail();  // the moved object changed or the copy failed
+
+    // Compaction Metrics Getters
+    int64_t get_compaction_success();
+    int64_t get_compaction_attempts();
+    int64_t get_compacted_size();
+
+    // Namespace Metrics, labeled by the name of the namespace
+    void set_namespace_usage(const std::string& name, int64_t used_size,
+                             int64_t quota, int64_t key_count);
+    void inc_namespace_evicted_keys(const std::string& name, int64_t val = 1);
+    void inc_namespace_quota_rejections(const std::string& name,
+                                        int64_t val = 1);
+
+    // Namespace Metrics Getters
+    int64_t get_namespace_used_size(const std::string& name);
+    int64_t get_namespace_key_count(const std::string& name);
+    int64_t get_namespace_evicted_keys(const std::string& name);
+    int64_t get_namespace_quota_rejections(const std::string& name);
+
+    // Metadata Shard Metrics, sampled by the lockers of the shards. The
+    // histograms cover all shards, only the most contended shard is reported
+    // on its own, to keep the number of series small.
+    void observe_shard_lock_wait(size_t shard, int64_t wait_us);
+    void observe_shard_lock_hold(size_t shard, int64_t hold_us);
+
     // --- Serialization ---
     /**
      * @brief Serializes all managed metrics into Prometheus text format.
@@ -187,6 +243,7 @@ class MasterMetricManager {
     // Memory Storage Metrics
     ylt::metric::gauge_t mem_allocated_size_;  // Use update for gauge
     ylt::metric::gauge_t mem_total_capacity_;  // Use update for gauge
+    ylt::metric::gauge_t mem_fragmented_size_;  // Use update for gauge
 
     // File Storage Metrics
     ylt::metric::gauge_t file_allocated_size_;
@@ -211,12 +268,16 @@ class MasterMetricManager {
     ylt::metric::counter_t get_replica_list_failures_;
     ylt::metric::counter_t get_replica_list_by_regex_requests_;
     ylt::metric::counter_t get_replica_list_by_regex_failures_;
+    ylt::metric::counter_t get_replica_list_by_prefix_requests_;
+    ylt::metric::counter_t get_replica_list_by_prefix_failures_;
     ylt::metric::counter_t exist_key_requests_;
     ylt::metric::counter_t exist_key_failures_;
     ylt::metric::counter_t remove_requests_;
     ylt::metric::counter_t remove_failures_;
     ylt::metric::counter_t remove_by_regex_requests_;
     ylt::metric::counter_t remove_by_regex_failures_;
+    ylt::metric::counter_t remove_by_prefix_requests_;
+    ylt::metric::counter_t remove_by_prefix_failures_;
     ylt::metric::counter_t remove_all_requests_;
     ylt::metric::counter_t remove_all_failures_;
     ylt::metric::counter_t mount_segment_requests_;
@@ -260,6 +321,39 @@ class MasterMetricManager {
     ylt::metric::counter_t eviction_attempts_;
     ylt::metric::counter_t evicted_key_count_;
     ylt::metric::counter_t evicted_size_;
+    ylt::metric::counter_t put_admission_rejections_;
+
+    // Dedup Counters
+    ylt::metric::counter_t dedup_puts_;
+    ylt::metric::counter_t dedup_saved_size_;
+
+    // Hot Key Counters
+    ylt::metric::counter_t hot_key_replicas_added_;
+    ylt::metric::counter_t hot_key_replicas_dropped_;
+
+    // Compaction Counters
+    ylt::metric::counter_t compaction_success_;
+    ylt::metric::counter_t compaction_attempts_;
+    ylt::metric::counter_t compacted_size_;
+
+    // Namespace Metrics
+    ylt::metric::dynamic_gauge_1t namespace_used_size_;
+    ylt::metric::dynamic_gauge_1t namespace_quota_;
+    ylt::metric::dynamic_gauge_1t namespace_key_count_;
+    ylt::metric::dynamic_counter_1t namespace_evicted_key_count_;
+    ylt::metric::dynamic_counter_1t namespace_quota_rejections_;
+
+    // Metadata Shard Metrics
+    ylt::metric::histogram_t shard_lock_wait_us_;
+    ylt::metric::histogram_t shard_lock_hold_us_;
+    ylt::metric::gauge_t shard_lock_wait_max_us_;
+    ylt::metric::gauge_t shard_lock_wait_max_shard_;
+    // Sampled lock wait of each shard since the last serialization, to find
+    // the most contended one. Shards beyond kMaxTrackedShards share slots.
+    static constexpr size_t kMaxTrackedShards = 4096;
+    std::array<std::atomic<int64_t>, kMaxTrackedShards>
+        shard_lock_wait_sum_us_{};
+    void update_max_shard_lock_wait();
 
     // Some metrics are used only in HA mode. Use a flag to control the output
     // content.
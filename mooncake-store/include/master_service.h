@@ -1,14 +1,18 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <boost/functional/hash.hpp>
 #include <boost/lockfree/queue.hpp>
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
+#include <regex>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -16,7 +20,9 @@
 #include <ylt/util/expected.hpp>
 #include <ylt/util/tl/expected.hpp>
 
+#include "admission_policy.h"
 #include "allocation_strategy.h"
+#include "frequency_sketch.h"
 #include "master_metric_manager.h"
 #include "mutex.h"
 #include "segment.h"
@@ -36,6 +42,10 @@ class EvictionStrategy;
  * 1. client_mutex_
  * 2. metadata_shards_[shard_idx_].mutex
  * 3. segment_mutex_
+ * 4. compaction_mutex_
+ * 5. content_shards_[content_idx_].mutex
+ * 6. hot_key_mutex_
+ * PutStart allocates replicas without holding the shard mutex.
  */
 class MasterService {
    public:
@@ -88,11 +98,26 @@ class MasterService {
         const std::vector<std::string>& keys);
 
     /**
-     * @brief Fetch all keys
+     * @brief Fetch all keys. Holds all keys at once, prefer ScanKeys for
+     * large clusters.
      * @return ErrorCode::OK if exists
      */
     auto GetAllKeys() -> tl::expected<std::vector<std::string>, ErrorCode>;
 
+    /**
+     * @brief Fetch a page of at most `limit` keys starting with `prefix`.
+     * Pages are scanned shard by shard, locking one shard at a time. Keys
+     * stored during the whole scan are returned exactly once, keys put or
+     * removed meanwhile may or may not be.
+     * @param cursor Empty for the first page, otherwise the next_cursor of
+     * the previous page
+     * @return ErrorCode::OK on success, ErrorCode::INVALID_PARAMS if the
+     * limit is 0 or the cursor is invalid
+     */
+    auto ScanKeys(const std::string& cursor, size_t limit,
+                  const std::string& prefix)
+        -> tl::expected<ScanKeysResponse, ErrorCode>;
+
     /**
      * @brief Fetch all segments, each node has a unique real client with fixed
      * segment name : segment name, preferred format : {ip}:{port}, bad format :
@@ -109,6 +134,36 @@ class MasterService {
     auto QuerySegments(const std::string& segment)
         -> tl::expected<std::pair<size_t, size_t>, ErrorCode>;
 
+    /**
+     * @brief Set the capacity quota of a namespace, creating the namespace if
+     * needed. Puts to a namespace at its quota fail with NO_AVAILABLE_HANDLE
+     * and evict the oldest objects of that namespace instead of the objects
+     * of other namespaces.
+     * @param quota Size in bytes of the memory replicas of the namespace, 0
+     * for no quota
+     * @return ErrorCode::OK on success
+     */
+    auto SetNamespaceQuota(const std::string& name, uint64_t quota)
+        -> tl::expected<void, ErrorCode>;
+
+    /**
+     * @brief Drop all objects of a namespace in constant time. The objects
+     * are not found anymore, and are reclaimed in the background once their
+     * leases expire.
+     * @return ErrorCode::OK on success, ErrorCode::INVALID_PARAMS for the
+     * default namespace
+     */
+    auto DropNamespace(const std::string& name)
+        -> tl::expected<void, ErrorCode>;
+
+    /**
+     * @brief Query a namespace's used size and quota in bytes, 0 for no
+     * quota. Namespaces not used yet have neither.
+     * @return ErrorCode::OK on success
+     */
+    auto QueryNamespace(const std::string& name)
+        -> tl::expected<std::pair<size_t, size_t>, ErrorCode>;
+
     /**
      * @brief Retrieves replica lists for object keys that match a regex
      * pattern.
@@ -121,6 +176,18 @@ class MasterService {
             std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
             ErrorCode>;
 
+    /**
+     * @brief Retrieves replica lists for object keys that start with a prefix,
+     * e.g. the keys of one request or model.
+     * @param prefix The prefix of the object keys.
+     * @return An expected object containing a map from object keys to their
+     * replica descriptors on success, or an ErrorCode on failure.
+     */
+    auto GetReplicaListByPrefix(const std::string& prefix)
+        -> tl::expected<
+            std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+            ErrorCode>;
+
     /**
      * @brief Get list of replicas for an object
      * @param[out] replica_list Vector to store replica information
@@ -134,7 +201,11 @@ class MasterService {
      * @brief Start a put operation for an object
      * @param[out] replica_list Vector to store replica information for slices
      * @return ErrorCode::OK on success, ErrorCode::OBJECT_NOT_FOUND if exists,
-     *         ErrorCode::NO_AVAILABLE_HANDLE if allocation fails,
+     *         ErrorCode::CONTENT_ALREADY_EXISTS if the object was stored
+     *         right away with the replicas of the same content hash, with no
+     *         data to transfer and no PutEnd to call,
+     *         ErrorCode::NO_AVAILABLE_HANDLE if allocation fails, even after
+     *         evicting inline if enabled, see GetPutRetryAfterMs,
      *         ErrorCode::INVALID_PARAMS if slice size is invalid
      */
     auto PutStart(const std::string& key,
@@ -191,6 +262,15 @@ class MasterService {
      */
     auto RemoveByRegex(const std::string& str) -> tl::expected<long, ErrorCode>;
 
+    /**
+     * @brief Removes objects from the master whose keys start with a prefix.
+     * @param prefix The prefix of the object keys.
+     * @return An expected object containing the number of removed objects on
+     * success, or an ErrorCode on failure.
+     */
+    auto RemoveByPrefix(const std::string& prefix)
+        -> tl::expected<long, ErrorCode>;
+
     /**
      * @brief Remove all objects and their replicas
      * @return return the number of objects removed
@@ -212,6 +292,16 @@ class MasterService {
      */
     auto Ping(const UUID& client_id) -> tl::expected<PingResponse, ErrorCode>;
 
+    /**
+     * @brief Complete a compaction task handed out by Ping. If the client
+     * copied the object, its replica is switched to the target buffers once
+     * no lease is outstanding on it, otherwise the target buffers are freed.
+     * @return ErrorCode::OK on success, ErrorCode::INVALID_PARAMS if the task
+     * does not exist or belongs to another client
+     */
+    auto MoveEnd(const UUID& client_id, uint64_t task_id, bool success)
+        -> tl::expected<void, ErrorCode>;
+
     /**
      * @brief Get the master service cluster ID to use as subdirectory name
      * @return ErrorCode::OK on success, ErrorCode::INTERNAL_ERROR if cluster ID
@@ -219,6 +309,16 @@ class MasterService {
      */
     tl::expected<std::string, ErrorCode> GetFsdir() const;
 
+    /**
+     * @brief Get how long a client should wait before retrying a put that
+     * failed for lack of space, 0 if the last puts found space
+     * @return The hint in milliseconds, from the leases blocking the
+     * eviction or the interval of the eviction thread
+     */
+    uint64_t GetPutRetryAfterMs() const {
+        return put_retry_after_ms_.load(std::memory_order_relaxed);
+    }
+
    private:
     // Resolve the key to a sanitized format for storage
     std::string SanitizeKey(const std::string& key) const;
@@ -234,15 +334,144 @@ class MasterService {
     // fulfill evict ratio lowerbound.
     void BatchEvict(double evict_ratio_target, double evict_ratio_lowerbound);
 
-    // Clear invalid handles in all shards
-    void ClearInvalidHandles();
+    // Evict the objects of the namespaces which exceeded their quota, in the
+    // same near-LRU order as BatchEvict, until each of them is
+    // eviction_ratio_ below its quota. The objects of other namespaces are
+    // left alone.
+    void BatchEvictNamespaces();
+
+    enum class PutEvictionResult { FREED, NOT_ADMITTED, NO_VICTIMS };
+
+    // Evict objects to make room for a put of `size` bytes whose allocation
+    // failed. Only kInlineEvictionMaxShards shards are visited, starting at
+    // a random one, and their objects are evicted oldest lease first as in
+    // BatchEvict, except for the ones the admission policy prefers over the
+    // put. Unless `size` bytes were freed, `retry_after_ms` is set to when
+    // the leases blocking the eviction expire.
+    PutEvictionResult EvictForPut(const std::string& key, uint64_t size,
+                                  uint64_t& retry_after_ms);
+
+    // Erase the objects of dropped namespaces whose leases expired
+    void ReclaimDroppedObjects();
+
+    // Publish the usage of each namespace to the metric manager
+    void UpdateNamespaceMetrics();
+
+    // Lookup and removal of the objects whose keys start with `prefix` and
+    // match `pattern` if given. Only the keys with the prefix are visited,
+    // through the ordered key index of each shard.
+    auto GetReplicaListMatching(const std::string& prefix,
+                                const std::regex* pattern)
+        -> std::unordered_map<std::string, std::vector<Replica::Descriptor>>;
+    long RemoveMatching(const std::string& prefix, const std::regex* pattern);
+
+    // Clear the invalid handles of the objects in an unmounted segment, found
+    // through the segment index of each shard and visited in batches of
+    // kUnmountBatchSize keys per shard lock
+    void ClearInvalidHandles(const UUID& segment_id);
+
+    // A pending relocation of the buffers of one replica within their segment
+    struct CompactionMove {
+        std::string key;
+        UUID client_id;
+        const BufferAllocatorBase* allocator = nullptr;
+        std::vector<AllocatedBuffer::Descriptor> sources;
+        std::vector<std::unique_ptr<AllocatedBuffer>> targets;
+        // Moves not handed out to the client by this time are dropped
+        std::chrono::steady_clock::time_point deadline;
+        // Set once Ping handed the move to the client, which may then write
+        // the targets at any time. The targets are kept until MoveEnd or
+        // until the client is no longer alive.
+        bool delivered = false;
+        // Set once the client has copied the data, the move then waits for
+        // the leases on the object to expire.
+        bool copied = false;
+        // Set for the copy of a hot key to another segment, the targets are
+        // then added as a new replica rather than replacing the sources
+        bool add_replica = false;
+    };
+
+    // Compaction thread function, reports the fragmentation of the segments
+    // and compacts the ones above compaction_fragmentation_ratio_
+    void CompactionThreadFunc();
+
+    // Hand out moves of the smallest objects on the segment of `allocator`
+    // to the client owning it. Returns false if the segment was scanned but
+    // no object could be moved.
+    bool CompactSegment(const UUID& client_id,
+                        const std::shared_ptr<BufferAllocatorBase>& allocator);
+
+    enum class MoveResult { COMMITTED, WAIT_FOR_LEASE, ABORTED };
+
+    // Switch the replica to the target buffers of a copied move, or add them
+    // as a new replica for a hot key
+    MoveResult CommitMove(uint64_t task_id, CompactionMove& move);
+
+    // Commit the copied moves whose leases expired and drop the moves not
+    // handed out in time
+    void CommitCopiedMoves();
+
+    // Drop the moves of expired clients, which no longer write their targets
+    void DropClientMoves(const std::vector<UUID>& client_ids);
+
+    // Hand out moves to the clients owning their sources
+    void IssueMoves(std::vector<std::pair<uint64_t, CompactionMove>>& moves);
+
+    // Copy the objects read more than hot_key_read_threshold_ to other
+    // segments, up to hot_key_extra_replicas_ extra memory replicas, and drop
+    // the extra replicas of the objects which are cold again
+    void ReplicateHotKeys(
+        const std::vector<
+            std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>& allocators);
+
+    // Add a move copying the key to another segment if it is hot, or drop
+    // its extra replicas if it is cold. Returns whether to keep tracking it.
+    bool ReplicateHotKey(
+        const std::string& key,
+        const std::vector<
+            std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>& allocators,
+        std::vector<std::pair<uint64_t, CompactionMove>>& moves);
 
     // Internal data structures
+
+    // A namespace groups the objects of one tenant or model, for a capacity
+    // quota and for dropping all of them at once
+    struct Namespace {
+        explicit Namespace(std::string name) : name(std::move(name)) {}
+
+        const std::string name;
+        std::atomic<uint64_t> quota{0};  // 0 for no quota
+        // Size of the memory replicas and number of the objects
+        std::atomic<uint64_t> used_size{0};
+        std::atomic<int64_t> key_count{0};
+        // Bumped by DropNamespace, the objects of older generations are
+        // dropped
+        std::atomic<uint64_t> generation{0};
+        // Set when a put exceeded the quota
+        std::atomic<bool> need_eviction{false};
+        // Set by DropNamespace until the dropped objects are reclaimed
+        std::atomic<bool> need_reclaim{false};
+        // Evicted objects and rejected puts not yet published as metrics
+        std::atomic<int64_t> evicted_count{0};
+        std::atomic<int64_t> rejected_puts{0};
+
+        // Check if `size` more bytes fit the quota. Concurrent puts may
+        // overshoot it slightly, the eviction brings the namespace back.
+        bool HasRoom(uint64_t size) const {
+            uint64_t limit = quota.load(std::memory_order_relaxed);
+            return limit == 0 ||
+                   used_size.load(std::memory_order_relaxed) + size <= limit;
+        }
+    };
+
     struct ObjectMetadata {
         // RAII-style metric management
         ~ObjectMetadata() {
+            name_space->key_count.fetch_sub(1, std::memory_order_relaxed);
+            name_space->used_size.fetch_sub(charged_size,
+                                            std::memory_order_relaxed);
             MasterMetricManager::instance().dec_key_count(1);
-            if (soft_pin_timeout) {
+            if (soft_pin) {
                 MasterMetricManager::instance().dec_soft_pin_key_count(1);
             }
             MasterMetricManager::instance().dec_allocated_file_size(
@@ -252,14 +481,17 @@ class MasterService {
         ObjectMetadata() = delete;
 
         ObjectMetadata(size_t value_length, std::vector<Replica>&& reps,
-                       bool enable_soft_pin)
+                       bool enable_soft_pin, Namespace* ns)
             : replicas(std::move(reps)),
               size(value_length),
-              lease_timeout(),
-              soft_pin_timeout(std::nullopt) {
+              soft_pin(enable_soft_pin),
+              name_space(ns),
+              generation(ns->generation.load(std::memory_order_relaxed)),
+              put_replica_num(GetMemReplicaCount()) {
+            name_space->key_count.fetch_add(1, std::memory_order_relaxed);
+            ChargeNamespace();
             MasterMetricManager::instance().inc_key_count(1);
-            if (enable_soft_pin) {
-                soft_pin_timeout.emplace();
+            if (soft_pin) {
                 MasterMetricManager::instance().inc_soft_pin_key_count(1);
             }
             MasterMetricManager::instance().observe_value_size(value_length);
@@ -282,12 +514,43 @@ class MasterService {
 
         std::vector<Replica> replicas;
         size_t size;
-        // Default constructor, creates a time_point representing
-        // the Clock's epoch (i.e., time_since_epoch() is zero).
-        std::chrono::steady_clock::time_point lease_timeout;  // hard lease
-        std::optional<std::chrono::steady_clock::time_point>
-            soft_pin_timeout;  // optional soft pin, only set for vip objects
+        // Lease epochs from which the hard lease and the soft pin are over.
+        // Renewed with relaxed atomics under the shared shard lock, so that
+        // reads do not write the metadata more than once per epoch.
+        mutable std::atomic<uint64_t> lease_expiry{0};     // hard lease
+        mutable std::atomic<uint64_t> soft_pin_expiry{0};  // only for vip
+        const bool soft_pin;
         uint64_t disk_replica_size = 0;
+        // The latest compaction move issued for the object. A re-put object
+        // gets new metadata, so moves of its previous incarnation are
+        // rejected.
+        uint64_t compaction_task_id = 0;
+        Namespace* const name_space;
+        // Generation of the namespace when the object was put
+        const uint64_t generation;
+        // Size of the memory replicas charged to the namespace
+        uint64_t charged_size = 0;
+        // Hash of the content if put with one, see ReplicateConfig
+        std::string content_hash;
+        // Memory replicas the object was put with, the replicas added for a
+        // hot key come after them
+        const size_t put_replica_num;
+
+        // Charge the current size of the memory replicas to the namespace,
+        // to be called whenever memory replicas are removed
+        void ChargeNamespace() {
+            uint64_t mem_size = size * GetMemReplicaCount();
+            // Wraps around for a negative difference, as it should
+            name_space->used_size.fetch_add(mem_size - charged_size,
+                                            std::memory_order_relaxed);
+            charged_size = mem_size;
+        }
+
+        // Check if the namespace of the object was dropped
+        bool IsDropped() const {
+            return generation !=
+                   name_space->generation.load(std::memory_order_relaxed);
+        }
 
         // Check if there are some replicas with a different status than the
         // given value. If there are, return the status of the first replica
@@ -303,20 +566,30 @@ class MasterService {
             return {};
         }
 
-        // Grant a lease with timeout as now() + ttl, only update if the new
-        // timeout is larger
-        void GrantLease(const uint64_t ttl, const uint64_t soft_ttl) {
-            std::chrono::steady_clock::time_point now =
-                std::chrono::steady_clock::now();
-            lease_timeout =
-                std::max(lease_timeout, now + std::chrono::milliseconds(ttl));
-            if (soft_pin_timeout) {
-                soft_pin_timeout =
-                    std::max(*soft_pin_timeout,
-                             now + std::chrono::milliseconds(soft_ttl));
+        // Grant a lease until the epoch + ttl, both in lease epochs, only
+        // update if the new expiry is later. Concurrent renewals never
+        // lower the expiry.
+        void GrantLease(uint64_t epoch, uint64_t ttl,
+                        uint64_t soft_ttl) const {
+            ExtendExpiry(lease_expiry, epoch + ttl);
+            if (soft_pin) {
+                ExtendExpiry(soft_pin_expiry, epoch + soft_ttl);
+            }
+        }
+
+        static void ExtendExpiry(std::atomic<uint64_t>& expiry,
+                                 uint64_t target) {
+            uint64_t current = expiry.load(std::memory_order_relaxed);
+            while (current < target &&
+                   !expiry.compare_exchange_weak(current, target,
+                                                 std::memory_order_relaxed)) {
             }
         }
 
+        uint64_t LeaseExpiry() const {
+            return lease_expiry.load(std::memory_order_relaxed);
+        }
+
         // Erase all replicas of the given type
         void EraseReplica(ReplicaType replica_type) {
             replicas.erase(
@@ -325,6 +598,15 @@ class MasterService {
                                    return replica.type() == replica_type;
                                }),
                 replicas.end());
+            ChargeNamespace();
+        }
+
+        // Check if all replicas have buffers in unmounted segments
+        bool HasOnlyStaleHandles() const {
+            return std::all_of(replicas.begin(), replicas.end(),
+                               [](const Replica& replica) {
+                                   return replica.has_invalid_mem_handle();
+                               });
         }
 
         // Check if there is a memory replica
@@ -335,6 +617,23 @@ class MasterService {
                                });
         }
 
+        // Size of the memory replica buffers no other object shares, which
+        // is what evicting the object frees
+        uint64_t GetUnsharedMemSize() const {
+            uint64_t unshared_size = 0;
+            for (const auto& replica : replicas) {
+                if (replica.type() != ReplicaType::MEMORY) {
+                    continue;
+                }
+                for (const auto& buffer : replica.get_shared_buffers()) {
+                    if (buffer.use_count() == 1) {
+                        unshared_size += buffer->size();
+                    }
+                }
+            }
+            return unshared_size;
+        }
+
         // Get the count of memory replicas
         int GetMemReplicaCount() const {
             return std::count_if(
@@ -343,25 +642,15 @@ class MasterService {
                 });
         }
 
-        // Check if the lease has expired
-        bool IsLeaseExpired() const {
-            return std::chrono::steady_clock::now() >= lease_timeout;
-        }
-
-        // Check if the lease has expired
-        bool IsLeaseExpired(std::chrono::steady_clock::time_point& now) const {
-            return now >= lease_timeout;
-        }
-
-        // Check if is in soft pin status
-        bool IsSoftPinned() const {
-            return soft_pin_timeout &&
-                   std::chrono::steady_clock::now() < *soft_pin_timeout;
+        // Check if the lease has expired at the given lease epoch
+        bool IsLeaseExpired(uint64_t epoch) const {
+            return epoch >= LeaseExpiry();
         }
 
-        // Check if is in soft pin status
-        bool IsSoftPinned(std::chrono::steady_clock::time_point& now) const {
-            return soft_pin_timeout && now < *soft_pin_timeout;
+        // Check if is in soft pin status at the given lease epoch
+        bool IsSoftPinned(uint64_t epoch) const {
+            return soft_pin &&
+                   epoch < soft_pin_expiry.load(std::memory_order_relaxed);
         }
 
         // Check if the metadata is valid
@@ -376,22 +665,171 @@ class MasterService {
         }
     };
 
-    static constexpr size_t kNumShards = 1024;  // Number of metadata shards
+    // Namespaces by name, never removed so that the objects can point to
+    // theirs. Declared before the shards, which have to be destroyed first.
+    // namespace_mutex_ is never held along with the other locks.
+    mutable std::shared_mutex namespace_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Namespace>> namespaces_;
+    Namespace* default_namespace_ = nullptr;
+    // Set when a namespace needs eviction or has dropped objects left
+    std::atomic<bool> need_namespace_eviction_{false};
+    std::atomic<bool> need_reclaim_dropped_{false};
+
+    // Get the namespace with the given name, creating it if needed
+    Namespace* GetNamespace(const std::string& name);
+
+    static constexpr size_t kUnmountBatchSize =
+        256;  // Keys cleaned up per shard lock when unmounting a segment
 
     // Sharded metadata maps and their mutexes
     struct MetadataShard {
-        mutable Mutex mutex;
+        // Shared by the reads, which only renew leases
+        mutable SharedMutex mutex;
+        size_t index = 0;  // Position in metadata_shards_, for the metrics
         std::unordered_map<std::string, ObjectMetadata> metadata
             GUARDED_BY(mutex);
+        // Segment id -> keys of the objects with buffers in that segment,
+        // so that unmounting a segment only visits the objects it affects
+        std::unordered_map<UUID, std::unordered_set<std::string>,
+                           boost::hash<UUID>>
+            segment_keys GUARDED_BY(mutex);
+        // Namespace -> keys of its objects, so that evicting or reclaiming
+        // the objects of a namespace only visits them
+        std::unordered_map<const Namespace*, std::unordered_set<std::string>>
+            namespace_keys GUARDED_BY(mutex);
+        // The keys of `metadata` in order, for prefix queries
+        std::map<std::string_view, ObjectMetadata*> ordered_keys
+            GUARDED_BY(mutex);
+        // Keys reserved by a PutStart that is allocating its replicas
+        // outside the lock, the object is added once the allocation is done
+        std::unordered_set<std::string> pending_puts GUARDED_BY(mutex);
+
+        // Add a new object to the indexes
+        void Index(
+            std::unordered_map<std::string, ObjectMetadata>::iterator it)
+            REQUIRES(mutex) {
+            ordered_keys.emplace(it->first, &it->second);
+            namespace_keys[it->second.name_space].insert(it->first);
+            IndexSegments(it->first, it->second);
+        }
+
+        void IndexSegments(const std::string& key,
+                           const ObjectMetadata& metadata) REQUIRES(mutex) {
+            for (const auto& replica : metadata.replicas) {
+                for (const auto& segment_id : replica.get_segment_ids()) {
+                    segment_keys[segment_id].insert(key);
+                }
+            }
+        }
+
+        void UnindexSegments(const std::string& key,
+                             const ObjectMetadata& metadata) REQUIRES(mutex) {
+            for (const auto& replica : metadata.replicas) {
+                for (const auto& segment_id : replica.get_segment_ids()) {
+                    auto entry = segment_keys.find(segment_id);
+                    if (entry != segment_keys.end() &&
+                        entry->second.erase(key) > 0 &&
+                        entry->second.empty()) {
+                        segment_keys.erase(entry);
+                    }
+                }
+            }
+        }
+
+        // Evict the memory replicas of an object, erasing it if no replica
+        // is left, and return the iterator to the next object
+        std::unordered_map<std::string, ObjectMetadata>::iterator
+        EvictMemReplicas(
+            std::unordered_map<std::string, ObjectMetadata>::iterator it)
+            REQUIRES(mutex) {
+            it->second.name_space->evicted_count.fetch_add(
+                1, std::memory_order_relaxed);
+            UnindexSegments(it->first, it->second);
+            it->second.EraseReplica(ReplicaType::MEMORY);
+            if (!it->second.IsValid()) {
+                return Erase(it);
+            }
+            return std::next(it);
+        }
+
+        // Erase an object along with its index entries
+        std::unordered_map<std::string, ObjectMetadata>::iterator Erase(
+            std::unordered_map<std::string, ObjectMetadata>::iterator it)
+            REQUIRES(mutex) {
+            ordered_keys.erase(it->first);
+            auto entry = namespace_keys.find(it->second.name_space);
+            if (entry != namespace_keys.end() &&
+                entry->second.erase(it->first) > 0 && entry->second.empty()) {
+                namespace_keys.erase(entry);
+            }
+            UnindexSegments(it->first, it->second);
+            return metadata.erase(it);
+        }
     };
-    std::array<MetadataShard, kNumShards> metadata_shards_;
+    // Shard keys starting with hex digits by those digits, instead of hashing
+    // the whole key
+    const bool hex_key_shard_hash_;
+    std::vector<MetadataShard> metadata_shards_;
 
     // Helper to get shard index from key
-    size_t getShardIndex(const std::string& key) const {
-        return std::hash<std::string>{}(key) % kNumShards;
+    size_t getShardIndex(const std::string& key) const;
+
+    // Content hash -> buffers of the memory replicas of a complete object
+    // put with that content. The buffers are shared by the objects put with
+    // the same content and freed along with the last of them, the index only
+    // holds weak references.
+    using ContentBuffers =
+        std::vector<std::vector<std::weak_ptr<AllocatedBuffer>>>;
+    struct ContentShard {
+        Mutex mutex;
+        std::unordered_map<std::string, ContentBuffers> contents
+            GUARDED_BY(mutex);
+    };
+    static constexpr size_t kNumContentShards = 64;
+    std::array<ContentShard, kNumContentShards> content_shards_;
+    static constexpr uint64_t kContentIndexPurgeMs =
+        1000;  // 1000 ms between purges of the contents no longer stored
+
+    ContentShard& getContentShard(const std::string& content_hash) {
+        return content_shards_[std::hash<std::string>{}(content_hash) %
+                               kNumContentShards];
     }
 
-    // Helper to clean up stale handles pointing to unmounted segments
+    // Up to `replica_num` memory replicas sharing the buffers of the
+    // content, if it is stored with `size` bytes in valid segments
+    std::optional<std::vector<Replica>> FindContent(
+        const std::string& content_hash, uint64_t size, size_t replica_num);
+
+    // Index the memory replicas of a complete object put with a content hash
+    void IndexContent(const ObjectMetadata& metadata);
+
+    // Drop the contents whose buffers were all freed
+    void PurgeContentIndex();
+
+    // Locks a metadata shard, exclusively or shared. The time spent waiting
+    // for and holding the lock is sampled into the shard lock metrics.
+    class SCOPED_CAPABILITY ShardLocker {
+       public:
+        explicit ShardLocker(const MetadataShard* shard) ACQUIRE(shard->mutex);
+        ShardLocker(const MetadataShard* shard, const shared_lock_t&)
+            ACQUIRE_SHARED(shard->mutex);
+        ~ShardLocker() RELEASE();
+
+       private:
+        void Lock();
+        void Unlock();
+
+        const MetadataShard* shard_;
+        const bool shared_;
+        bool sampled_ = false;
+        std::chrono::steady_clock::time_point locked_at_;
+        int64_t wait_us_ = 0;
+    };
+    static constexpr uint64_t kShardLockSampleInterval =
+        64;  // One in this many lock acquisitions of a thread is timed
+
+    // Helper to clean up stale handles pointing to unmounted segments, only
+    // used by the unmount, which keeps the segment index up to date
     bool CleanupStaleHandles(ObjectMetadata& metadata);
 
     // Eviction thread function
@@ -402,33 +840,121 @@ class MasterService {
     const uint64_t default_kv_soft_pin_ttl_;  // in milliseconds
     const bool allow_evict_soft_pinned_objects_;
 
+    // Leases are kept in epochs of kLeaseEpochMs since the service started
+    static constexpr uint64_t kLeaseEpochMs = 10;
+    const std::chrono::steady_clock::time_point lease_clock_start_;
+
+    // The current epoch
+    uint64_t CurrentLeaseEpoch() const {
+        return (std::chrono::steady_clock::now() - lease_clock_start_) /
+               std::chrono::milliseconds(kLeaseEpochMs);
+    }
+
+    // A ttl in epochs, rounded up. The lease also covers the rest of the
+    // current epoch, so that it never ends before the ttl has passed and
+    // the clients reading the object within their ttl stay safe.
+    static uint64_t LeaseEpochs(uint64_t ttl_ms) {
+        return (ttl_ms + kLeaseEpochMs - 1) / kLeaseEpochMs + 1;
+    }
+
+    // Renew the lease of an object read by a client
+    void GrantReadLease(const ObjectMetadata& metadata) const {
+        metadata.GrantLease(CurrentLeaseEpoch(),
+                            LeaseEpochs(default_kv_lease_ttl_),
+                            LeaseEpochs(default_kv_soft_pin_ttl_));
+    }
+
     // Eviction related members
     std::atomic<bool> need_eviction_{
         false};  // Set to trigger eviction when not enough space left
     const double eviction_ratio_;                 // in range [0.0, 1.0]
     const double eviction_high_watermark_ratio_;  // in range [0.0, 1.0]
+    // Puts failing to allocate evict objects themselves, the admission
+    // policy deciding which objects a put may evict
+    const bool enable_inline_eviction_;
+    std::shared_ptr<AdmissionPolicy> admission_policy_;
+    static constexpr size_t kInlineEvictionMaxShards =
+        4;  // Shards visited by a put making room for itself
+    // Returned by GetPutRetryAfterMs, set by every put failing with
+    // NO_AVAILABLE_HANDLE and cleared by the next successful put
+    std::atomic<uint64_t> put_retry_after_ms_{0};
 
     // Eviction thread related members
     std::thread eviction_thread_;
     std::atomic<bool> eviction_running_{false};
     static constexpr uint64_t kEvictionThreadSleepMs =
         10;  // 10 ms sleep between eviction checks
-
-    // Helper class for accessing metadata with automatic locking and cleanup
+    static constexpr uint64_t kReclaimDroppedRetryMs =
+        1000;  // 1000 ms between reclaims of leased dropped objects
+
+    // Compaction related members
+    const double compaction_fragmentation_ratio_;  // 0 disables compaction
+    std::thread compaction_thread_;
+    std::atomic<bool> compaction_running_{false};
+    static constexpr uint64_t kCompactionThreadSleepMs =
+        1000;  // 1000 ms sleep between fragmentation checks
+    static constexpr size_t kMaxMovesPerSegment =
+        64;  // Objects moved in one round of compacting a segment
+    static constexpr size_t kMaxSkippedHoles =
+        4;  // Holes above an object passed over looking for its target
+    static constexpr uint64_t kCompactionMoveTimeoutMs =
+        30000;  // Moves not handed out or committed within this time are
+                // dropped
+    static constexpr uint64_t kCompactionRescanMs =
+        30000;  // Unchanged segments with nothing to move wait this long
+    // A scan of a segment that found nothing to move, only used by the
+    // compaction thread. The segment is not scanned again until its free
+    // space changes or kCompactionRescanMs passed.
+    struct FruitlessCompaction {
+        size_t free = 0;
+        size_t largest_free = 0;
+        std::chrono::steady_clock::time_point time;
+    };
+    std::unordered_map<const BufferAllocatorBase*, FruitlessCompaction>
+        fruitless_compactions_;
+    std::atomic<uint64_t> next_compaction_task_id_{1};
+    Mutex compaction_mutex_;
+    std::unordered_map<uint64_t, CompactionMove> compaction_moves_
+        GUARDED_BY(compaction_mutex_);
+    // Tasks waiting to be handed out to the clients by Ping
+    std::unordered_map<UUID, std::vector<CompactionTask>, boost::hash<UUID>>
+        compaction_tasks_ GUARDED_BY(compaction_mutex_);
+
+    // Hot key replication related members
+    const uint64_t hot_key_read_threshold_;  // 0 disables it
+    const uint64_t hot_key_extra_replicas_;
+    // Reads per key, halved every kCompactionThreadSleepMs. Only set if hot
+    // key replication is enabled.
+    std::unique_ptr<FrequencySketch> read_sketch_;
+    Mutex hot_key_mutex_;
+    // Keys whose reads reached the threshold since the last pass
+    std::unordered_set<std::string> hot_key_candidates_
+        GUARDED_BY(hot_key_mutex_);
+    // Keys replicated for their reads, only used by the compaction thread
+    std::unordered_set<std::string> replicated_hot_keys_;
+    // Rotates the replicas of hot keys in GetReplicaList, so that the
+    // readers spread over them
+    std::atomic<uint64_t> replica_rotation_{0};
+
+    // Helper class for accessing metadata with automatic locking. Objects left
+    // with stale handles only read as missing, they are cleaned up by the
+    // unmount of their segments.
     class MetadataAccessor {
        public:
         MetadataAccessor(MasterService* service, const std::string& key)
             : service_(service),
               key_(key),
               shard_idx_(service_->getShardIndex(key)),
-              lock_(&service_->metadata_shards_[shard_idx_].mutex),
+              lock_(&service_->metadata_shards_[shard_idx_]),
               it_(service_->metadata_shards_[shard_idx_].metadata.find(key)) {
-            // Automatically clean up invalid handles
-            if (it_ != service_->metadata_shards_[shard_idx_].metadata.end()) {
-                if (service_->CleanupStaleHandles(it_->second)) {
-                    service_->metadata_shards_[shard_idx_].metadata.erase(it_);
-                    it_ = service_->metadata_shards_[shard_idx_].metadata.end();
-                }
+            if (it_ != service_->metadata_shards_[shard_idx_].metadata.end() &&
+                (it_->second.HasOnlyStaleHandles() ||
+                 (it_->second.IsDropped() &&
+                  it_->second.IsAllReplicasComplete()))) {
+                // A dropped object is reclaimed by ReclaimDroppedObjects, as
+                // it may have a lease. An unfinished put can still end or
+                // revoke it.
+                it_ = service_->metadata_shards_[shard_idx_].metadata.end();
             }
         }
 
@@ -440,9 +966,20 @@ class MasterService {
         // Get metadata (only call when Exists() is true)
         ObjectMetadata& Get() NO_THREAD_SAFETY_ANALYSIS { return it_->second; }
 
+        // Update the segment index of the object around changes of its
+        // replicas (only call when Exists() is true)
+        void UnindexSegments() NO_THREAD_SAFETY_ANALYSIS {
+            service_->metadata_shards_[shard_idx_].UnindexSegments(
+                it_->first, it_->second);
+        }
+        void IndexSegments() NO_THREAD_SAFETY_ANALYSIS {
+            service_->metadata_shards_[shard_idx_].IndexSegments(it_->first,
+                                                                 it_->second);
+        }
+
         // Delete current metadata (for PutRevoke or Remove operations)
         void Erase() NO_THREAD_SAFETY_ANALYSIS {
-            service_->metadata_shards_[shard_idx_].metadata.erase(it_);
+            service_->metadata_shards_[shard_idx_].Erase(it_);
             it_ = service_->metadata_shards_[shard_idx_].metadata.end();
         }
 
@@ -450,11 +987,44 @@ class MasterService {
         MasterService* service_;
         std::string key_;
         size_t shard_idx_;
-        MutexLocker lock_;
+        ShardLocker lock_;
         std::unordered_map<std::string, ObjectMetadata>::iterator it_;
     };
 
+    // Helper class for reading metadata under the shared shard lock. The
+    // reads only renew leases, which are atomics, so they do not block each
+    // other. Objects left with stale handles read as missing, as with
+    // MetadataAccessor.
+    class MetadataReader {
+       public:
+        MetadataReader(const MasterService* service, const std::string& key)
+            : shard_(&service->metadata_shards_[service->getShardIndex(key)]),
+              lock_(shard_, shared_lock),
+              it_(shard_->metadata.find(key)) {
+            if (it_ != shard_->metadata.end() &&
+                (it_->second.HasOnlyStaleHandles() ||
+                 (it_->second.IsDropped() &&
+                  it_->second.IsAllReplicasComplete()))) {
+                it_ = shard_->metadata.end();
+            }
+        }
+
+        // Check if metadata exists
+        bool Exists() const NO_THREAD_SAFETY_ANALYSIS {
+            return it_ != shard_->metadata.end();
+        }
+
+        // Get metadata (only call when Exists() is true)
+        const ObjectMetadata& Get() const { return it_->second; }
+
+       private:
+        const MetadataShard* shard_;
+        ShardLocker lock_;
+        std::unordered_map<std::string, ObjectMetadata>::const_iterator it_;
+    };
+
     friend class MetadataAccessor;
+    friend class MetadataReader;
 
     ViewVersionId view_version_;
 
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 #include <glog/logging.h>
 
 #include "mutex.h"
@@ -198,6 +199,54 @@ class OffsetAllocator : public std::enable_shared_from_this<OffsetAllocator> {
     friend class OffsetAllocatorTest;  // for unit tests
 };
 
+// Splits a buffer into independently locked OffsetAllocator arenas, so that
+// concurrent allocations rarely wait on the same mutex. Every arena is below
+// the largest bin size, so offsets are exact 64-bit addresses and sizes are
+// not rounded to the multiplier a single OffsetAllocator uses for buffers
+// larger than 3.75GB. An allocation starts at the home arena of the calling
+// thread and steals from the others when it is full. Allocations larger than
+// an arena fail.
+class ShardedOffsetAllocator {
+   public:
+    static constexpr uint64_t kMaxShardSize = 1ull << 31;  // 2GB
+    static constexpr uint64_t kMinShardSize = 256ull << 20;
+    static constexpr uint32 kDefaultNumShards = 16;
+
+    // num_shards = 0 uses up to kDefaultNumShards arenas of at least
+    // kMinShardSize. Arenas are never larger than kMaxShardSize. The node
+    // capacities are split between the arenas.
+    static std::shared_ptr<ShardedOffsetAllocator> create(
+        uint64_t base, size_t size, uint32 num_shards = 0,
+        uint32 init_capacity = 128 * 1024, uint32 max_capacity = (1 << 20));
+
+    ShardedOffsetAllocator(const ShardedOffsetAllocator&) = delete;
+    ShardedOffsetAllocator& operator=(const ShardedOffsetAllocator&) = delete;
+
+    // Allocate memory and return a Handle (thread-safe)
+    [[nodiscard]]
+    std::optional<OffsetAllocationHandle> allocate(size_t size);
+
+    // Free space summed over the arenas, the largest free region of any
+    // arena (thread-safe)
+    [[nodiscard]]
+    OffsetAllocStorageReport storageReport() const;
+
+    // Metrics summed over the arenas (thread-safe)
+    [[nodiscard]]
+    OffsetAllocatorMetrics get_metrics() const;
+
+    size_t num_shards() const { return m_shards.size(); }
+    uint64_t shard_size() const { return m_shard_size; }
+
+   private:
+    ShardedOffsetAllocator(uint64_t base, size_t size, uint32 num_shards,
+                           uint32 init_capacity, uint32 max_capacity);
+
+    std::vector<std::shared_ptr<OffsetAllocator>> m_shards;
+    uint64_t m_shard_size;
+    uint64_t m_capacity;
+};
+
 class __Allocator {
    public:
     __Allocator(uint32 size, uint32 init_capacity, uint32 max_capacity);
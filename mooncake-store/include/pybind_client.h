@@ -94,6 +94,21 @@ class PyClient {
     int initAll(const std::string &protocol, const std::string &device_name,
                 size_t mount_segment_size = 1024 * 1024 * 16);  // Default 16MB
 
+    /**
+     * @brief Mount segments of size_per_node bytes on each of the given NUMA
+     * nodes, in addition to the segments mounted by setup
+     * @param size_per_node Segment size per node, a multiple of page_size
+     * @param page_size Huge page size backing the segments, 2MB or 1GB, or 0
+     * for regular pages
+     * @param numa_nodes Nodes to bind the segments to, all nodes if empty,
+     * -1 for a segment without binding
+     * @param prefault_threads Number of threads faulting in each segment
+     * @return 0 on success, negative value on error
+     */
+    int mount_segments(size_t size_per_node, size_t page_size = 0,
+                       const std::vector<int> &numa_nodes = {},
+                       size_t prefault_threads = 8);
+
     int put(const std::string &key, std::span<const char> value,
             const ReplicateConfig &config = ReplicateConfig{});
 
@@ -113,6 +128,36 @@ class PyClient {
      */
     int64_t get_into(const std::string &key, void *buffer, size_t size);
 
+    /**
+     * @brief Get bytes [offset, offset + size) of an object directly into a
+     * pre-allocated buffer, transferring only the replica buffers that
+     * overlap the range
+     * @param key Key of the object to get
+     * @param buffer Pointer to the pre-allocated buffer (must be registered
+     * with register_buffer)
+     * @param offset Offset of the range in the object
+     * @param size Size of the range and the buffer
+     * @return Number of bytes read on success, negative value on error
+     */
+    int64_t get_range_into(const std::string &key, void *buffer,
+                           uint64_t offset, size_t size);
+
+    /**
+     * @brief Get a byte range of multiple objects directly into
+     * pre-allocated buffers (batch version of get_range_into)
+     * @param keys Vector of keys, a key may appear several times
+     * @param buffers Vector of pointers to the pre-allocated buffers
+     * @param offsets Vector of offsets of the ranges in the objects
+     * @param sizes Vector of sizes of the ranges and buffers
+     * @return Vector of 64-bit integers, where each element is the number of
+     * bytes read on success, or a negative value on error
+     */
+    std::vector<int64_t> batch_get_range_into(
+        const std::vector<std::string> &keys,
+        const std::vector<void *> &buffers,
+        const std::vector<uint64_t> &offsets,
+        const std::vector<size_t> &sizes);
+
     /**
      * @brief Get object data directly into pre-allocated buffers for multiple
      * keys (batch version)
@@ -224,6 +269,23 @@ class PyClient {
                   const std::vector<std::span<const char>> &values,
                   const ReplicateConfig &config = ReplicateConfig{});
 
+    /**
+     * @brief Put multiple objects, each assembled from several parts, with a
+     * single BatchPut
+     * @param keys Vector of keys of the objects to put
+     * @param all_values Vector of the parts of each object, concatenated in
+     * order
+     * @param config Replication configuration
+     * @return Vector of integers, where each element is 0 on success, or a
+     * negative value on error
+     * @note The parts are copied into the client buffer, they need not be
+     * registered
+     */
+    std::vector<int> batch_put_parts(
+        const std::vector<std::string> &keys,
+        const std::vector<std::vector<std::span<const char>>> &all_values,
+        const ReplicateConfig &config = ReplicateConfig{});
+
     [[nodiscard]] std::string get_hostname() const;
 
     /**
@@ -247,8 +309,14 @@ class PyClient {
 
     long removeByRegex(const std::string &str);
 
+    long removeByPrefix(const std::string &prefix);
+
     long removeAll();
 
+    int setNamespaceQuota(const std::string &name, uint64_t quota);
+
+    int dropNamespace(const std::string &name);
+
     int tearDownAll();
 
     /**
@@ -288,6 +356,10 @@ class PyClient {
         const std::string &protocol, const std::string &device_name,
         size_t mount_segment_size = 1024 * 1024 * 16);
 
+    tl::expected<void, ErrorCode> mount_segments_internal(
+        size_t size_per_node, size_t page_size,
+        const std::vector<int> &numa_nodes, size_t prefault_threads);
+
     tl::expected<void, ErrorCode> unregister_buffer_internal(void *buffer);
 
     tl::expected<void, ErrorCode> put_internal(
@@ -305,6 +377,12 @@ class PyClient {
         const std::vector<std::string> &keys,
         const std::vector<void *> &buffers, const std::vector<size_t> &sizes);
 
+    std::vector<tl::expected<int64_t, ErrorCode>> batch_get_range_into_internal(
+        const std::vector<std::string> &keys,
+        const std::vector<void *> &buffers,
+        const std::vector<uint64_t> &offsets,
+        const std::vector<size_t> &sizes);
+
     std::vector<tl::expected<int64_t, ErrorCode>>
     batch_get_into_multi_buffers_internal(
         const std::vector<std::string> &keys,
@@ -337,13 +415,27 @@ class PyClient {
         const std::vector<std::span<const char>> &values,
         const ReplicateConfig &config = ReplicateConfig{});
 
+    std::vector<tl::expected<void, ErrorCode>> batch_put_parts_internal(
+        const std::vector<std::string> &keys,
+        const std::vector<std::vector<std::span<const char>>> &all_values,
+        const ReplicateConfig &config = ReplicateConfig{});
+
     tl::expected<void, ErrorCode> remove_internal(const std::string &key);
 
     tl::expected<long, ErrorCode> removeByRegex_internal(
         const std::string &str);
 
+    tl::expected<long, ErrorCode> removeByPrefix_internal(
+        const std::string &prefix);
+
     tl::expected<int64_t, ErrorCode> removeAll_internal();
 
+    tl::expected<void, ErrorCode> setNamespaceQuota_internal(
+        const std::string &name, uint64_t quota);
+
+    tl::expected<void, ErrorCode> dropNamespace_internal(
+        const std::string &name);
+
     tl::expected<void, ErrorCode> tearDownAll_internal();
 
     tl::expected<bool, ErrorCode> isExist_internal(const std::string &key);
@@ -379,7 +471,18 @@ class PyClient {
         }
     };
 
+    struct MappedSegmentDeleter {
+        size_t size;
+        void operator()(void *ptr) {
+            if (ptr) {
+                unmap_segment_memory(ptr, size);
+            }
+        }
+    };
+
     std::vector<std::unique_ptr<void, SegmentDeleter>> segment_ptrs_;
+    std::vector<std::unique_ptr<void, MappedSegmentDeleter>>
+        mapped_segment_ptrs_;
     std::vector<std::unique_ptr<void, AscendSegmentDeleter>>
         ascend_segment_ptrs_;
     std::string protocol;
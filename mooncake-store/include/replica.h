@@ -76,18 +76,28 @@ struct ReplicateConfig {
     bool with_soft_pin{false};
     std::string preferred_segment{};  // Preferred segment for allocation
     bool prefer_alloc_in_same_node{false};
+    // Namespace of the objects for quotas and bulk drops, empty for the
+    // default namespace
+    std::string namespace_name{};
+    // Hash of the value of a single put, e.g. of the tokens of a KV cache
+    // block. A put whose content is already stored shares its replicas
+    // instead of transferring the data. Empty to store the value as is.
+    std::string content_hash{};
 
     friend std::ostream& operator<<(std::ostream& os,
                                     const ReplicateConfig& config) noexcept {
         return os << "ReplicateConfig: { replica_num: " << config.replica_num
                   << ", with_soft_pin: " << config.with_soft_pin
                   << ", preferred_segment: " << config.preferred_segment
-                  << " }";
+                  << ", namespace_name: " << config.namespace_name
+                  << ", content_hash: " << config.content_hash << " }";
     }
 };
 
+// The buffers may be shared by the replicas of objects with the same
+// content, they are freed along with the last replica
 struct MemoryReplicaData {
-    std::vector<std::unique_ptr<AllocatedBuffer>> buffers;
+    std::vector<std::shared_ptr<AllocatedBuffer>> buffers;
 };
 
 struct DiskReplicaData {
@@ -113,6 +123,13 @@ class Replica {
     // memory replica constructor
     Replica(std::vector<std::unique_ptr<AllocatedBuffer>> buffers,
             ReplicaStatus status)
+        : data_(MemoryReplicaData{{std::make_move_iterator(buffers.begin()),
+                                   std::make_move_iterator(buffers.end())}}),
+          status_(status) {}
+
+    // memory replica constructor, sharing the buffers of another replica
+    Replica(std::vector<std::shared_ptr<AllocatedBuffer>> buffers,
+            ReplicaStatus status)
         : data_(MemoryReplicaData{std::move(buffers)}), status_(status) {}
 
     // disk replica constructor
@@ -141,16 +158,75 @@ class Replica {
             const auto& mem_data = std::get<MemoryReplicaData>(data_);
             return std::any_of(
                 mem_data.buffers.begin(), mem_data.buffers.end(),
-                [](const std::unique_ptr<AllocatedBuffer>& buf_ptr) {
+                [](const std::shared_ptr<AllocatedBuffer>& buf_ptr) {
                     return !buf_ptr->isAllocatorValid();
                 });
         }
         return false;  // DiskReplicaData does not have handles
     }
 
+    // The buffers of a memory replica, to share them with another replica
+    [[nodiscard]] const std::vector<std::shared_ptr<AllocatedBuffer>>&
+    get_shared_buffers() const {
+        return std::get<MemoryReplicaData>(data_).buffers;
+    }
+
+    // Check if some buffers are shared with the replicas of other objects
+    [[nodiscard]] bool has_shared_buffers() const {
+        if (is_memory_replica()) {
+            const auto& mem_data = std::get<MemoryReplicaData>(data_);
+            return std::any_of(
+                mem_data.buffers.begin(), mem_data.buffers.end(),
+                [](const std::shared_ptr<AllocatedBuffer>& buf_ptr) {
+                    return buf_ptr.use_count() > 1;
+                });
+        }
+        return false;
+    }
+
     [[nodiscard]] std::vector<std::optional<std::string>> get_segment_names()
         const;
 
+    // Ids of the segments of the buffers of a memory replica, including
+    // segments already unmounted
+    [[nodiscard]] std::vector<UUID> get_segment_ids() const {
+        std::vector<UUID> segment_ids;
+        if (is_memory_replica()) {
+            const auto& mem_data = std::get<MemoryReplicaData>(data_);
+            for (const auto& buffer : mem_data.buffers) {
+                if (buffer) {
+                    segment_ids.push_back(buffer->getSegmentId());
+                }
+            }
+        }
+        return segment_ids;
+    }
+
+    // Indexes of the buffers of a memory replica allocated by `allocator`
+    [[nodiscard]] std::vector<size_t> get_buffer_indexes(
+        const BufferAllocatorBase* allocator) const {
+        std::vector<size_t> indexes;
+        if (is_memory_replica()) {
+            const auto& mem_data = std::get<MemoryReplicaData>(data_);
+            for (size_t i = 0; i < mem_data.buffers.size(); ++i) {
+                if (mem_data.buffers[i] &&
+                    mem_data.buffers[i]->isAllocatedBy(allocator)) {
+                    indexes.push_back(i);
+                }
+            }
+        }
+        return indexes;
+    }
+
+    // Replace the buffer at `index` of a memory replica with `buffer`, used
+    // to relocate the replica when its segment is compacted. The previous
+    // buffer is freed unless another replica shares it.
+    void replace_buffer(size_t index,
+                        std::unique_ptr<AllocatedBuffer> buffer) {
+        auto& mem_data = std::get<MemoryReplicaData>(data_);
+        mem_data.buffers.at(index) = std::move(buffer);
+    }
+
     void mark_complete() {
         if (status_ == ReplicaStatus::PROCESSING) {
             status_ = ReplicaStatus::COMPLETE;
@@ -34,6 +34,14 @@ class WrappedMasterService {
         ErrorCode>
     GetReplicaListByRegex(const std::string& str);
 
+    tl::expected<
+        std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+        ErrorCode>
+    GetReplicaListByPrefix(const std::string& prefix);
+
+    tl::expected<ScanKeysResponse, ErrorCode> ScanKeys(
+        const std::string& cursor, uint64_t limit, const std::string& prefix);
+
     tl::expected<GetReplicaListResponse, ErrorCode> GetReplicaList(
         const std::string& key);
 
@@ -65,6 +73,8 @@ class WrappedMasterService {
 
     tl::expected<long, ErrorCode> RemoveByRegex(const std::string& str);
 
+    tl::expected<long, ErrorCode> RemoveByPrefix(const std::string& prefix);
+
     long RemoveAll();
 
     tl::expected<void, ErrorCode> MountSegment(const Segment& segment,
@@ -80,6 +90,14 @@ class WrappedMasterService {
 
     tl::expected<PingResponse, ErrorCode> Ping(const UUID& client_id);
 
+    tl::expected<void, ErrorCode> MoveEnd(const UUID& client_id,
+                                          uint64_t task_id, bool success);
+
+    tl::expected<void, ErrorCode> SetNamespaceQuota(const std::string& name,
+                                                    uint64_t quota);
+
+    tl::expected<void, ErrorCode> DropNamespace(const std::string& name);
+
     tl::expected<void, ErrorCode> ServiceReady();
 
    private:
@@ -5,12 +5,30 @@
 
 namespace mooncake {
 
+/**
+ * @brief A buffer relocation requested by the master to compact a segment.
+ * The client owning the segment copies each source buffer into the target
+ * buffer at the same index and reports the result with MoveEnd.
+ */
+struct CompactionTask {
+    uint64_t task_id;
+    std::string key;
+    std::vector<AllocatedBuffer::Descriptor> sources;
+    std::vector<AllocatedBuffer::Descriptor> targets;
+};
+YLT_REFL(CompactionTask, task_id, key, sources, targets);
+
 /**
  * @brief Response structure for Ping operation
  */
 struct PingResponse {
     ViewVersionId view_version_id;
     ClientStatus client_status;
+    // Compaction tasks for the segments of the client
+    std::vector<CompactionTask> compaction_tasks;
+    // Wait before retrying puts that failed for lack of space, 0 if the
+    // last puts found space
+    uint64_t put_retry_after_ms = 0;
 
     PingResponse() = default;
     PingResponse(ViewVersionId view_version, ClientStatus status)
@@ -20,10 +38,15 @@ struct PingResponse {
                                     const PingResponse& response) noexcept {
         return os << "PingResponse: { view_version_id: "
                   << response.view_version_id
-                  << ", client_status: " << response.client_status << " }";
+                  << ", client_status: " << response.client_status
+                  << ", compaction_tasks: "
+                  << response.compaction_tasks.size()
+                  << ", put_retry_after_ms: " << response.put_retry_after_ms
+                  << " }";
     }
 };
-YLT_REFL(PingResponse, view_version_id, client_status);
+YLT_REFL(PingResponse, view_version_id, client_status, compaction_tasks,
+         put_retry_after_ms);
 
 /**
  * @brief Response structure for GetReplicaList operation
@@ -40,4 +63,14 @@ struct GetReplicaListResponse {
 };
 YLT_REFL(GetReplicaListResponse, replicas, lease_ttl_ms);
 
+/**
+ * @brief Response structure for ScanKeys operation
+ */
+struct ScanKeysResponse {
+    std::vector<std::string> keys;
+    // Cursor of the next page, empty once all keys were scanned
+    std::string next_cursor;
+};
+YLT_REFL(ScanKeysResponse, keys, next_cursor);
+
 }  // namespace mooncake
\ No newline at end of file
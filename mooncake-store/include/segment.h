@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <boost/functional/hash.hpp>
 #include <ostream>
 #include <shared_mutex>
@@ -43,6 +45,43 @@ struct MountedSegment {
     std::shared_ptr<BufferAllocatorBase> buf_allocator;
 };
 
+/**
+ * @brief Reader-writer lock striped over cache lines. Readers lock the stripe
+ * of their thread only, so that concurrent allocations do not contend on a
+ * single lock word. Writers lock every stripe, in order.
+ */
+class StripedSharedMutex {
+   public:
+    void lock() {
+        for (auto& stripe : stripes_) {
+            stripe.mutex.lock();
+        }
+    }
+
+    void unlock() {
+        for (auto it = stripes_.rbegin(); it != stripes_.rend(); ++it) {
+            it->mutex.unlock();
+        }
+    }
+
+    /**
+     * @brief The stripe to be locked shared by the calling thread
+     */
+    std::shared_mutex& stripe() {
+        static std::atomic<size_t> next_stripe{0};
+        thread_local const size_t stripe_idx =
+            next_stripe.fetch_add(1, std::memory_order_relaxed) % kNumStripes;
+        return stripes_[stripe_idx].mutex;
+    }
+
+   private:
+    static constexpr size_t kNumStripes = 64;
+    struct alignas(64) Stripe {
+        std::shared_mutex mutex;
+    };
+    std::array<Stripe, kNumStripes> stripes_;
+};
+
 // Forward declarations
 class SegmentManager;
 
@@ -56,7 +95,7 @@ class ScopedSegmentAccess {
      * @param mutex Reference to the segment mutex
      */
     explicit ScopedSegmentAccess(SegmentManager* segment_manager,
-                                 std::shared_mutex& mutex)
+                                 StripedSharedMutex& mutex)
         : segment_manager_(segment_manager), lock_(mutex) {}
 
     /**
@@ -92,6 +131,14 @@ class ScopedSegmentAccess {
     ErrorCode GetClientSegments(const UUID& client_id,
                                 std::vector<Segment>& segments) const;
 
+    /**
+     * @brief Get the allocators of all the mounted segments together with the
+     * clients owning them
+     */
+    ErrorCode GetClientAllocators(
+        std::vector<std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>&
+            allocators) const;
+
     /**
      * @brief Get the names of all the segments
      */
@@ -106,7 +153,7 @@ class ScopedSegmentAccess {
 
    private:
     SegmentManager* segment_manager_;
-    std::unique_lock<std::shared_mutex> lock_;
+    std::unique_lock<StripedSharedMutex> lock_;
 };
 
 /**
@@ -119,10 +166,10 @@ class ScopedAllocatorAccess {
                            std::vector<std::shared_ptr<BufferAllocatorBase>>>&
             allocators_by_name,
         std::vector<std::shared_ptr<BufferAllocatorBase>>& allocators,
-        std::shared_mutex& mutex)
+        StripedSharedMutex& mutex)
         : allocators_by_name_(allocators_by_name),
           allocators_(allocators),
-          lock_(mutex) {}
+          lock_(mutex.stripe()) {}
 
     const std::unordered_map<std::string,
                              std::vector<std::shared_ptr<BufferAllocatorBase>>>&
@@ -170,7 +217,9 @@ class SegmentManager {
     }
 
    private:
-    mutable std::shared_mutex segment_mutex_;
+    // Allocators are used under one stripe of the lock, while the segments
+    // are only changed under all of them
+    mutable StripedSharedMutex segment_mutex_;
     std::shared_ptr<AllocationStrategy> allocation_strategy_;
     const BufferAllocatorType
         memory_allocator_;  // Type of buffer allocator to use
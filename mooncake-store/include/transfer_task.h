@@ -1,9 +1,13 @@
 #pragma once
 
+#include <async_simple/Promise.h>
+#include <async_simple/coro/Lazy.h>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -21,6 +25,9 @@
 
 namespace mooncake {
 
+// Transfers not completed within this time fail with TRANSFER_TIMEOUT
+inline constexpr int64_t kTransferTimeoutSeconds = 60;
+
 /**
  * @brief Transfer strategy enumeration
  */
@@ -92,6 +99,21 @@ class OperationState {
      */
     virtual void wait_for_completion() = 0;
 
+    /**
+     * @brief Fail the operation unless it already completed, e.g. when it
+     * did not complete in time
+     */
+    void fail(ErrorCode error_code) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (result_.has_value()) {
+                return;
+            }
+            result_.emplace(error_code);
+        }
+        cv_.notify_all();
+    }
+
    protected:
     std::optional<ErrorCode> result_ = std::nullopt;
     mutable std::mutex mutex_;
@@ -125,7 +147,10 @@ class MemcpyOperationState : public OperationState {
     void set_completed(ErrorCode error_code) {
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            assert(!result_.has_value());
+            // The operation may have been failed by fail() meanwhile
+            if (result_.has_value()) {
+                return;
+            }
             result_.emplace(error_code);
         }
         cv_.notify_all();
@@ -151,7 +176,10 @@ class FilereadOperationState : public OperationState {
     void set_completed(ErrorCode error_code) {
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            assert(!result_.has_value());
+            // The operation may have been failed by fail() meanwhile
+            if (result_.has_value()) {
+                return;
+            }
             result_.emplace(error_code);
         }
         cv_.notify_all();
@@ -242,10 +270,68 @@ class TransferFuture {
      */
     TransferStrategy strategy() const;
 
+    /**
+     * @brief Fail the operation unless it already completed
+     */
+    void fail(ErrorCode error_code) const;
+
    private:
     std::shared_ptr<OperationState> state_;
 };
 
+/**
+ * @brief Waits for transfer futures on behalf of coroutines
+ *
+ * A single thread polls the futures registered by waitReady() and resumes
+ * each awaiting coroutine once its transfer has finished, so that any number
+ * of outstanding transfers takes no thread of its own. Transfers not done
+ * within kTransferTimeoutSeconds fail with TRANSFER_TIMEOUT.
+ */
+class TransferPoller {
+   public:
+    TransferPoller();
+    ~TransferPoller();
+
+    // Non-copyable, non-movable
+    TransferPoller(const TransferPoller&) = delete;
+    TransferPoller& operator=(const TransferPoller&) = delete;
+    TransferPoller(TransferPoller&&) = delete;
+    TransferPoller& operator=(TransferPoller&&) = delete;
+
+    /**
+     * @brief Suspend until the future is ready, after which get() returns
+     * without blocking. The future must stay valid until then.
+     */
+    async_simple::coro::Lazy<void> waitReady(const TransferFuture& future);
+
+    /**
+     * @brief Fail the pending transfers and resume their coroutines, later
+     * waitReady() calls fail their future right away. Called before waiting
+     * for the coroutines to finish.
+     */
+    void shutdown();
+
+   private:
+    struct Waiter {
+        const TransferFuture* future;
+        async_simple::Promise<bool> promise;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    // The poller sleeps between polls, doubling the sleep up to the maximum
+    // while no transfer completes
+    static constexpr std::chrono::microseconds kMinPollInterval{10};
+    static constexpr std::chrono::microseconds kMaxPollInterval{1000};
+
+    void pollerThread();
+
+    std::thread poller_;
+    std::vector<Waiter> waiters_;
+    std::mutex waiters_mutex_;
+    std::condition_variable waiters_cv_;
+    bool shutdown_ = false;
+};
+
 /**
  * @brief Memory copy operation descriptor
  */
@@ -355,6 +441,23 @@ class FilereadWorkerPool {
     std::shared_ptr<StorageBackend> backend_;
 };
 
+/**
+ * @brief Checks if the range [addr, addr + length) of a segment lies within a
+ * single registered buffer of the segment
+ */
+using RegisteredRangeCheck =
+    std::function<bool(SegmentID segment_id, uint64_t addr, uint64_t length)>;
+
+/**
+ * @brief Merges requests whose source and target ranges continue each other
+ * into single requests, so that many small adjacent buffers take one network
+ * operation. The order of the requests is not kept. Ranges are only merged
+ * if `in_one_buffer` finds both merged ranges in a single registered buffer,
+ * the source ones being checked against LOCAL_SEGMENT_ID.
+ */
+void coalesceTransferRequests(std::vector<TransferRequest>& requests,
+                              const RegisteredRangeCheck& in_one_buffer);
+
 /**
  * @brief Submitter class for asynchronous transfer operations
  *
@@ -390,6 +493,25 @@ class TransferSubmitter {
         std::vector<std::vector<Slice>>& all_slices,
         TransferRequest::OpCode op_code);
 
+    /**
+     * @brief Submit the transfers of several replicas at once
+     *
+     * The replicas that go through the transfer engine are submitted as one
+     * batch, so that adjacent requests of different objects are coalesced.
+     * They share one result: if the batch fails, all of them fail. The other
+     * replicas are submitted as with submit().
+     *
+     * @param replicas Replicas to transfer
+     * @param all_slices Memory slices for each replica
+     * @param op_code Transfer operation (READ/WRITE)
+     * @return One TransferFuture per replica, or nullopt where the submission
+     * failed
+     */
+    std::vector<std::optional<TransferFuture>> submit_all(
+        const std::vector<const Replica::Descriptor*>& replicas,
+        const std::vector<std::vector<Slice>*>& all_slices,
+        TransferRequest::OpCode op_code);
+
    private:
     TransferEngine& engine_;
     std::unique_ptr<MemcpyWorkerPool> memcpy_pool_;
@@ -431,6 +553,14 @@ class TransferSubmitter {
         const std::vector<AllocatedBuffer::Descriptor>& handles,
         std::vector<Slice>& slices, TransferRequest::OpCode op_code);
 
+    /**
+     * @brief Append the transfer engine requests of one replica
+     */
+    bool appendTransferRequests(
+        const std::vector<AllocatedBuffer::Descriptor>& handles,
+        const std::vector<Slice>& slices, TransferRequest::OpCode op_code,
+        std::vector<TransferRequest>& requests);
+
     std::optional<TransferFuture> submitFileReadOperation(
         const Replica::Descriptor& replica, std::vector<Slice>& slices,
         TransferRequest::OpCode op_code);
@@ -443,6 +573,9 @@ class TransferSubmitter {
 
     std::optional<TransferFuture> submitTransfer(
         std::vector<TransferRequest>& requests);
+
+    std::shared_ptr<OperationState> submitTransferState(
+        std::vector<TransferRequest>& requests);
 };
 
 }  // namespace mooncake
\ No newline at end of file
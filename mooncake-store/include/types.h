@@ -30,6 +30,14 @@ static constexpr uint64_t DEFAULT_KV_SOFT_PIN_TTL_MS =
 static constexpr bool DEFAULT_ALLOW_EVICT_SOFT_PINNED_OBJECTS = true;
 static constexpr double DEFAULT_EVICTION_RATIO = 0.05;
 static constexpr double DEFAULT_EVICTION_HIGH_WATERMARK_RATIO = 0.95;
+// 0 disables compaction, fragmentation is still reported
+static constexpr double DEFAULT_COMPACTION_FRAGMENTATION_RATIO = 0.0;
+static constexpr uint64_t DEFAULT_NUM_METADATA_SHARDS = 1024;
+// Puts failing to allocate wait for the eviction thread by default
+static constexpr bool DEFAULT_ENABLE_INLINE_EVICTION = false;
+// 0 disables the extra replicas of heavily read objects
+static constexpr uint64_t DEFAULT_HOT_KEY_READ_THRESHOLD = 0;
+static constexpr uint64_t DEFAULT_HOT_KEY_EXTRA_REPLICAS = 1;
 static constexpr int64_t ETCD_MASTER_VIEW_LEASE_TTL = 5;    // in seconds
 static constexpr int64_t DEFAULT_CLIENT_LIVE_TTL_SEC = 10;  // in seconds
 static const std::string DEFAULT_CLUSTER_ID = "mooncake_cluster";
@@ -46,6 +54,7 @@ static const std::string PUT_NO_SPACE_HELPER_STR =  // A helpful string
 class BufferAllocatorBase;
 class CachelibBufferAllocator;
 class OffsetBufferAllocator;
+class ShardedOffsetBufferAllocator;
 class AllocatedBuffer;
 class Replica;
 
@@ -119,15 +128,18 @@ enum class ErrorCode : int32_t {
     INVALID_READ = -701,     ///< Invalid read operation.
     INVALID_REPLICA = -702,  ///< Invalid replica operation.
 
-    // Object errors (Range: -703 to -707)
+    // Object errors (Range: -703 to -708)
     REPLICA_IS_NOT_READY = -703,   ///< Replica is not ready.
     OBJECT_NOT_FOUND = -704,       ///< Object not found.
     OBJECT_ALREADY_EXISTS = -705,  ///< Object already exists.
     OBJECT_HAS_LEASE = -706,       ///< Object has lease.
     LEASE_EXPIRED = -707,  ///< Lease expired before data transfer completed.
+    CONTENT_ALREADY_EXISTS =
+        -708,  ///< Object stored with the replicas of the same content.
 
     // Transfer errors (Range: -800 to -899)
-    TRANSFER_FAIL = -800,  ///< Transfer operation failed.
+    TRANSFER_FAIL = -800,     ///< Transfer operation failed.
+    TRANSFER_TIMEOUT = -801,  ///< Transfer did not complete in time.
 
     // RPC errors (Range: -900 to -999)
     RPC_FAIL = -900,  ///< RPC operation failed.
@@ -219,8 +231,9 @@ inline std::ostream& operator<<(std::ostream& os,
 }
 
 enum class BufferAllocatorType {
-    CACHELIB = 0,  // CachelibBufferAllocator
-    OFFSET = 1,    // OffsetBufferAllocator
+    CACHELIB = 0,        // CachelibBufferAllocator
+    OFFSET = 1,          // OffsetBufferAllocator
+    SHARDED_OFFSET = 2,  // ShardedOffsetBufferAllocator
 };
 
 /**
@@ -230,10 +243,30 @@ inline std::ostream& operator<<(std::ostream& os,
                                 const BufferAllocatorType& type) noexcept {
     static const std::unordered_map<BufferAllocatorType, std::string_view>
         type_strings{{BufferAllocatorType::CACHELIB, "CACHELIB"},
-                     {BufferAllocatorType::OFFSET, "OFFSET"}};
+                     {BufferAllocatorType::OFFSET, "OFFSET"},
+                     {BufferAllocatorType::SHARDED_OFFSET, "SHARDED_OFFSET"}};
 
     os << (type_strings.count(type) ? type_strings.at(type) : "UNKNOWN");
     return os;
 }
 
+enum class PutAdmissionPolicy {
+    ALWAYS = 0,    // AlwaysAdmissionPolicy
+    TINY_LFU = 1,  // TinyLFUAdmissionPolicy
+};
+
+/**
+ * @brief Stream operator for PutAdmissionPolicy
+ */
+inline std::ostream& operator<<(std::ostream& os,
+                                const PutAdmissionPolicy& policy) noexcept {
+    static const std::unordered_map<PutAdmissionPolicy, std::string_view>
+        policy_strings{{PutAdmissionPolicy::ALWAYS, "ALWAYS"},
+                       {PutAdmissionPolicy::TINY_LFU, "TINY_LFU"}};
+
+    os << (policy_strings.count(policy) ? policy_strings.at(policy)
+                                        : "UNKNOWN");
+    return os;
+}
+
 }  // namespace mooncake
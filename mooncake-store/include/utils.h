@@ -104,6 +104,21 @@ void* allocate_buffer_allocator_memory(
 
 void free_memory(const std::string& protocol, void* ptr);
 
+/*
+    @brief Maps memory for a store segment, optionally backed by huge pages
+    and bound to a NUMA node, and faults all of its pages in.
+    @param total_size The size of the memory, a multiple of page_size.
+    @param page_size The huge page size, 2MB or 1GB, or 0 for regular pages.
+    @param numa_node The node to bind the memory to, or -1 for no binding.
+    @param prefault_threads The number of threads faulting the pages in.
+    @return A pointer to the mapped memory, nullptr on failure. Release it
+    with unmap_segment_memory.
+*/
+void* map_segment_memory(size_t total_size, size_t page_size = 0,
+                         int numa_node = -1, size_t prefault_threads = 1);
+
+void unmap_segment_memory(void* ptr, size_t total_size);
+
 [[nodiscard]] inline std::string byte_size_to_string(uint64_t bytes) {
     const double KB = 1024.0;
     const double MB = KB * 1024.0;
@@ -147,6 +162,15 @@ std::vector<std::string> splitString(const std::string& str,
                                      bool trim_spaces = true,
                                      bool keep_empty = false);
 
+/**
+ * @brief Get the literal prefix of all the strings an ECMAScript regex
+ * matches, e.g. "model_1/layer_" for "^model_1/layer_\d+"
+ * @param regex The regular expression
+ * @return The prefix, empty if the regex is not anchored at the start or
+ * has no literal prefix
+ */
+std::string regexLiteralPrefix(const std::string& regex);
+
 // Network utility functions
 
 /**
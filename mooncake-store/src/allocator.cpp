@@ -4,11 +4,22 @@
 #include <glog/logging.h>
 
 #include <memory>
+#include <utility>
 
 #include "master_metric_manager.h"
 
 namespace mooncake {
 
+AllocatedBuffer::AllocatedBuffer(
+    std::shared_ptr<BufferAllocatorBase> allocator, void* buffer_ptr,
+    std::size_t size,
+    std::optional<offset_allocator::OffsetAllocationHandle>&& offset_handle)
+    : allocator_(allocator),
+      segment_id_(allocator ? allocator->getSegmentId() : UUID{0, 0}),
+      buffer_ptr_(buffer_ptr),
+      size_(size),
+      offset_handle_(std::move(offset_handle)) {}
+
 std::string AllocatedBuffer::getSegmentName() const noexcept {
     auto alloc = allocator_.lock();
     if (alloc) {
@@ -138,6 +149,25 @@ void CachelibBufferAllocator::deallocate(AllocatedBuffer* handle) {
     }
 }
 
+namespace {
+
+// Initial and maximum node capacity of the offset allocator of a segment
+std::pair<uint32_t, uint32_t> offsetAllocatorCapacity(size_t size) {
+    // 1k <= init_capacity <= 64k
+    uint64_t init_capacity = size / 4096;
+    init_capacity = std::max(init_capacity, static_cast<uint64_t>(1024));
+    init_capacity = std::min(init_capacity, static_cast<uint64_t>(64 * 1024));
+    // 1M <= max_capacity <= 64G / 1K = 64M
+    uint64_t max_capacity = size / 1024;
+    max_capacity = std::max(max_capacity, static_cast<uint64_t>(1024 * 1024));
+    max_capacity =
+        std::min(max_capacity, static_cast<uint64_t>(64 * 1024 * 1024));
+    return {static_cast<uint32_t>(init_capacity),
+            static_cast<uint32_t>(max_capacity)};
+}
+
+}  // namespace
+
 // OffsetBufferAllocator implementation
 OffsetBufferAllocator::OffsetBufferAllocator(std::string segment_name,
                                              size_t base, size_t size,
@@ -152,21 +182,10 @@ OffsetBufferAllocator::OffsetBufferAllocator(std::string segment_name,
             << " size=" << size;
 
     try {
-        // 1k <= init_capacity <= 64k
-        uint64_t init_capacity = size / 4096;
-        init_capacity = std::max(init_capacity, static_cast<uint64_t>(1024));
-        init_capacity =
-            std::min(init_capacity, static_cast<uint64_t>(64 * 1024));
-        // 1M <= max_capacity <= 64G / 1K = 64M
-        uint64_t max_capacity = size / 1024;
-        max_capacity =
-            std::max(max_capacity, static_cast<uint64_t>(1024 * 1024));
-        max_capacity =
-            std::min(max_capacity, static_cast<uint64_t>(64 * 1024 * 1024));
+        auto [init_capacity, max_capacity] = offsetAllocatorCapacity(size);
         // Create the offset allocator
         offset_allocator_ = offset_allocator::OffsetAllocator::create(
-            base, size, static_cast<uint32_t>(init_capacity),
-            static_cast<uint32_t>(max_capacity));
+            base, size, init_capacity, max_capacity);
         if (!offset_allocator_) {
             LOG(ERROR) << "status=failed_to_create_offset_allocator";
             throw std::runtime_error("Failed to create offset allocator");
@@ -257,6 +276,112 @@ size_t OffsetBufferAllocator::getLargestFreeRegion() const {
     }
 }
 
+// ShardedOffsetBufferAllocator implementation
+ShardedOffsetBufferAllocator::ShardedOffsetBufferAllocator(
+    std::string segment_name, size_t base, size_t size,
+    std::string transport_endpoint, uint32_t num_shards)
+    : segment_name_(segment_name),
+      base_(base),
+      total_size_(size),
+      cur_size_(0),
+      transport_endpoint_(std::move(transport_endpoint)) {
+    VLOG(1) << "initializing_sharded_offset_buffer_allocator segment_name="
+            << segment_name << " base_address=" << reinterpret_cast<void*>(base)
+            << " size=" << size;
+
+    try {
+        // The capacity of the whole segment is split between the arenas
+        auto [init_capacity, max_capacity] = offsetAllocatorCapacity(size);
+        offset_allocator_ = offset_allocator::ShardedOffsetAllocator::create(
+            base, size, num_shards, init_capacity, max_capacity);
+        if (!offset_allocator_) {
+            LOG(ERROR) << "status=failed_to_create_sharded_offset_allocator";
+            throw std::runtime_error(
+                "Failed to create sharded offset allocator");
+        }
+
+        VLOG(1) << "sharded_offset_buffer_allocator_initialized segment_name="
+                << segment_name
+                << " num_shards=" << offset_allocator_->num_shards()
+                << " shard_size=" << offset_allocator_->shard_size();
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "sharded_offset_allocator_init_exception error="
+                   << e.what();
+        throw;
+    }
+}
+
+ShardedOffsetBufferAllocator::~ShardedOffsetBufferAllocator() = default;
+
+std::unique_ptr<AllocatedBuffer> ShardedOffsetBufferAllocator::allocate(
+    size_t size) {
+    if (!offset_allocator_) {
+        LOG(ERROR) << "allocator_status=not_initialized";
+        return nullptr;
+    }
+
+    std::unique_ptr<AllocatedBuffer> allocated_buffer = nullptr;
+    try {
+        auto allocation_handle = offset_allocator_->allocate(size);
+        if (!allocation_handle) {
+            VLOG(1) << "allocation_failed size=" << size
+                    << " segment=" << segment_name_
+                    << " current_size=" << cur_size_;
+            return nullptr;
+        }
+
+        void* buffer_ptr = allocation_handle->ptr();
+        allocated_buffer = std::make_unique<AllocatedBuffer>(
+            shared_from_this(), buffer_ptr, size, std::move(allocation_handle));
+        VLOG(1) << "allocation_succeeded size=" << size
+                << " segment=" << segment_name_ << " address=" << buffer_ptr;
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "allocation_exception error=" << e.what();
+        return nullptr;
+    } catch (...) {
+        LOG(ERROR) << "allocation_unknown_exception";
+        return nullptr;
+    }
+
+    cur_size_.fetch_add(size);
+    MasterMetricManager::instance().inc_allocated_mem_size(size);
+    return allocated_buffer;
+}
+
+void ShardedOffsetBufferAllocator::deallocate(AllocatedBuffer* handle) {
+    try {
+        // The arena is freed by the OffsetAllocationHandle destructor
+        size_t freed_size = handle->size();
+        handle->offset_handle_.reset();
+        cur_size_.fetch_sub(freed_size);
+        MasterMetricManager::instance().dec_allocated_mem_size(freed_size);
+        VLOG(1) << "deallocation_succeeded address=" << handle->data()
+                << " size=" << freed_size << " segment=" << segment_name_;
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "deallocation_exception error=" << e.what();
+    } catch (...) {
+        LOG(ERROR) << "deallocation_unknown_exception";
+    }
+}
+
+size_t ShardedOffsetBufferAllocator::getLargestFreeRegion() const {
+    if (!offset_allocator_) {
+        return 0;
+    }
+
+    try {
+        return offset_allocator_->storageReport().largestFreeRegion;
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "Failed to get storage report: " << e.what()
+                   << " segment=" << segment_name_;
+        return 0;
+    } catch (...) {
+        LOG(ERROR) << "Unknown error getting storage report"
+                   << " segment=" << segment_name_;
+        return 0;
+    }
+}
+
 SimpleAllocator::SimpleAllocator(size_t size) {
     LOG(INFO) << "initializing_simple_allocator size=" << size;
 
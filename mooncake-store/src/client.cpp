@@ -1,5 +1,6 @@
 #include "client.h"
 
+#include <async_simple/coro/SyncAwait.h>
 #include <glog/logging.h>
 
 #include <algorithm>
@@ -7,10 +8,13 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <future>
 #include <optional>
 #include <ranges>
 #include <thread>
+#include <ylt/coro_io/io_context_pool.hpp>
 
+#include "client_buffer.hpp"
 #include "transfer_engine.h"
 #include "transfer_task.h"
 #include "config.h"
@@ -60,6 +64,15 @@ Client::Client(const std::string& local_hostname,
 }
 
 Client::~Client() {
+    // Outstanding asynchronous operations use the client until they complete,
+    // fail their pending transfers so that they do so right away
+    if (transfer_poller_) {
+        transfer_poller_->shutdown();
+    }
+    while (async_operations_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
     // Make a copy of mounted_segments_ to avoid modifying while iterating
     std::vector<Segment> segments_to_unmount;
     {
@@ -94,6 +107,24 @@ Client::~Client() {
     }
 }
 
+// Number of segment chunks registered in parallel, with one metadata update
+static constexpr size_t kMountChunksPerBatch = 8;
+
+static size_t get_mount_chunk_size() {
+    static constexpr size_t kDefaultMountChunkSize = 16ull << 30;
+    const char* ev_cs = std::getenv("MC_STORE_MOUNT_CHUNK_SIZE");
+    if (ev_cs) {
+        try {
+            return std::stoull(ev_cs);
+        } catch (const std::exception&) {
+            LOG(WARNING) << "invalid MC_STORE_MOUNT_CHUNK_SIZE value: "
+                         << ev_cs << ", using default: "
+                         << kDefaultMountChunkSize;
+        }
+    }
+    return kDefaultMountChunkSize;
+}
+
 static std::optional<bool> get_auto_discover() {
     const char* ev_ad = std::getenv("MC_MS_AUTO_DISC");
     if (ev_ad) {
@@ -349,6 +380,7 @@ void Client::InitTransferSubmitter() {
     transfer_submitter_ = std::make_unique<TransferSubmitter>(
         *transfer_engine_, storage_backend_,
         metrics_ ? &metrics_->transfer_metric : nullptr);
+    transfer_poller_ = std::make_unique<TransferPoller>();
 }
 
 std::optional<std::shared_ptr<Client>> Client::Create(
@@ -470,6 +502,12 @@ Client::QueryByRegex(const std::string& str) {
     return result;
 }
 
+tl::expected<std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+             ErrorCode>
+Client::QueryByPrefix(const std::string& prefix) {
+    return master_client_.GetReplicaListByPrefix(prefix);
+}
+
 tl::expected<QueryResult, ErrorCode> Client::Query(
     const std::string& object_key) {
     std::chrono::steady_clock::time_point start_time =
@@ -483,20 +521,19 @@ tl::expected<QueryResult, ErrorCode> Client::Query(
         start_time + std::chrono::milliseconds(result.value().lease_ttl_ms));
 }
 
-std::vector<tl::expected<QueryResult, ErrorCode>> Client::BatchQuery(
-    const std::vector<std::string>& object_keys) {
-    std::chrono::steady_clock::time_point start_time =
-        std::chrono::steady_clock::now();
-    auto response = master_client_.BatchGetReplicaList(object_keys);
-
+// Converts the replica lists of a batch query to query results, whose leases
+// count from the time the query was sent
+static std::vector<tl::expected<QueryResult, ErrorCode>> ToQueryResults(
+    size_t num_keys, std::chrono::steady_clock::time_point start_time,
+    std::vector<tl::expected<GetReplicaListResponse, ErrorCode>>& response) {
     // Check if we got the expected number of responses
-    if (response.size() != object_keys.size()) {
+    if (response.size() != num_keys) {
         LOG(ERROR) << "BatchQuery response size mismatch. Expected: "
-                   << object_keys.size() << ", Got: " << response.size();
+                   << num_keys << ", Got: " << response.size();
         // Return vector of RPC_FAIL errors
         std::vector<tl::expected<QueryResult, ErrorCode>> results;
-        results.reserve(object_keys.size());
-        for (size_t i = 0; i < object_keys.size(); ++i) {
+        results.reserve(num_keys);
+        for (size_t i = 0; i < num_keys; ++i) {
             results.emplace_back(tl::unexpected(ErrorCode::RPC_FAIL));
         }
         return results;
@@ -516,6 +553,14 @@ std::vector<tl::expected<QueryResult, ErrorCode>> Client::BatchQuery(
     return results;
 }
 
+std::vector<tl::expected<QueryResult, ErrorCode>> Client::BatchQuery(
+    const std::vector<std::string>& object_keys) {
+    std::chrono::steady_clock::time_point start_time =
+        std::chrono::steady_clock::now();
+    auto response = master_client_.BatchGetReplicaList(object_keys);
+    return ToQueryResults(object_keys.size(), start_time, response);
+}
+
 tl::expected<void, ErrorCode> Client::Get(const std::string& object_key,
                                           const QueryResult& query_result,
                                           std::vector<Slice>& slices) {
@@ -550,6 +595,138 @@ tl::expected<void, ErrorCode> Client::Get(const std::string& object_key,
     return {};
 }
 
+tl::expected<void, ErrorCode> Client::GetRange(const std::string& object_key,
+                                               const QueryResult& query_result,
+                                               uint64_t offset,
+                                               std::vector<Slice>& slices) {
+    Replica::Descriptor replica;
+    ErrorCode err = FindFirstCompleteReplica(query_result.replicas, replica);
+    if (err != ErrorCode::OK) {
+        if (err == ErrorCode::INVALID_REPLICA) {
+            LOG(ERROR) << "no_complete_replicas_found key=" << object_key;
+        }
+        return tl::unexpected(err);
+    }
+
+    auto t0_get = std::chrono::steady_clock::now();
+    err = TransferReadRange(replica, offset, slices);
+    auto us_get = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0_get)
+                      .count();
+    if (metrics_) {
+        metrics_->transfer_metric.get_latency_us.observe(us_get);
+    }
+
+    if (err != ErrorCode::OK) {
+        LOG(ERROR) << "transfer_read_range_failed key=" << object_key
+                   << " offset=" << offset;
+        return tl::unexpected(err);
+    }
+    if (query_result.IsLeaseExpired()) {
+        LOG(WARNING) << "lease_expired_before_data_transfer_completed key="
+                     << object_key;
+        return tl::unexpected(ErrorCode::LEASE_EXPIRED);
+    }
+    return {};
+}
+
+std::vector<tl::expected<void, ErrorCode>> Client::BatchGetRange(
+    const std::vector<std::string>& object_keys,
+    const std::vector<QueryResult>& query_results,
+    const std::vector<uint64_t>& offsets,
+    std::vector<std::vector<Slice>>& slices) {
+    std::vector<tl::expected<void, ErrorCode>> results(object_keys.size());
+    if (!transfer_submitter_) {
+        LOG(ERROR) << "TransferSubmitter not initialized";
+        std::fill(results.begin(), results.end(),
+                  tl::unexpected(ErrorCode::INVALID_PARAMS));
+        return results;
+    }
+    if (query_results.size() != object_keys.size() ||
+        offsets.size() != object_keys.size() ||
+        slices.size() != object_keys.size()) {
+        LOG(ERROR) << "Input sizes mismatch: keys=" << object_keys.size()
+                   << ", query_results=" << query_results.size()
+                   << ", offsets=" << offsets.size()
+                   << ", slices=" << slices.size();
+        std::fill(results.begin(), results.end(),
+                  tl::unexpected(ErrorCode::INVALID_PARAMS));
+        return results;
+    }
+
+    std::vector<std::pair<size_t, TransferFuture>> pending_transfers;
+    auto t0_batch_get = std::chrono::steady_clock::now();
+
+    // Submit the ranges of memory replicas in parallel, disk replicas are
+    // read whole and synchronously
+    for (size_t i = 0; i < object_keys.size(); ++i) {
+        const auto& key = object_keys[i];
+        Replica::Descriptor replica;
+        ErrorCode err =
+            FindFirstCompleteReplica(query_results[i].replicas, replica);
+        if (err != ErrorCode::OK) {
+            if (err == ErrorCode::INVALID_REPLICA) {
+                LOG(ERROR) << "no_complete_replicas_found key=" << key;
+            }
+            results[i] = tl::unexpected(err);
+            continue;
+        }
+        if (!replica.is_memory_replica()) {
+            err = TransferReadRange(replica, offsets[i], slices[i]);
+            if (err != ErrorCode::OK) {
+                results[i] = tl::unexpected(err);
+            }
+            continue;
+        }
+
+        std::vector<Slice> range_slices = slices[i];
+        err = restrictReplicaToRange(replica, offsets[i], range_slices);
+        if (err != ErrorCode::OK) {
+            results[i] = tl::unexpected(err);
+            continue;
+        }
+        if (range_slices.empty()) {
+            continue;
+        }
+        auto future = transfer_submitter_->submit(replica, range_slices,
+                                                  TransferRequest::READ);
+        if (!future) {
+            LOG(ERROR) << "Failed to submit transfer operation for key: "
+                       << key;
+            results[i] = tl::unexpected(ErrorCode::TRANSFER_FAIL);
+            continue;
+        }
+        pending_transfers.emplace_back(i, std::move(*future));
+    }
+
+    for (auto& [index, future] : pending_transfers) {
+        ErrorCode result = future.get();
+        if (result != ErrorCode::OK) {
+            LOG(ERROR) << "Transfer failed for key: " << object_keys[index]
+                       << " with error: " << static_cast<int>(result);
+            results[index] = tl::unexpected(result);
+        }
+    }
+
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    for (size_t i = 0; i < object_keys.size(); ++i) {
+        if (results[i].has_value() && query_results[i].IsLeaseExpired(now)) {
+            LOG(WARNING) << "lease_expired_before_data_transfer_completed key="
+                         << object_keys[i];
+            results[i] = tl::unexpected(ErrorCode::LEASE_EXPIRED);
+        }
+    }
+
+    auto us_batch_get = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - t0_batch_get)
+                            .count();
+    if (metrics_) {
+        metrics_->transfer_metric.batch_get_latency_us.observe(us_batch_get);
+    }
+    return results;
+}
+
 struct BatchGetOperation {
     std::vector<Replica::Descriptor> replicas;
     std::vector<std::vector<Slice>> batched_slices;
@@ -667,13 +844,34 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchGet(
         return BatchGetWhenPreferSameNode(object_keys, query_results, slices);
     }
 
-    // Collect all transfer operations for parallel execution
-    std::vector<std::tuple<size_t, std::string, TransferFuture>>
-        pending_transfers;
     std::vector<tl::expected<void, ErrorCode>> results(object_keys.size());
     // Record batch get transfer latency (Submit + Wait)
     auto t0_batch_get = std::chrono::steady_clock::now();
 
+    auto pending_transfers =
+        SubmitBatchGetTransfers(object_keys, query_results, slices, results);
+    CollectBatchGetTransfers(object_keys, query_results, pending_transfers,
+                             results);
+
+    auto us_batch_get = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - t0_batch_get)
+                            .count();
+    if (metrics_) {
+        metrics_->transfer_metric.batch_get_latency_us.observe(us_batch_get);
+    }
+
+    VLOG(1) << "BatchGet completed for " << object_keys.size() << " keys";
+    return results;
+}
+
+std::vector<Client::PendingGetTransfer> Client::SubmitBatchGetTransfers(
+    const std::vector<std::string>& object_keys,
+    const std::vector<QueryResult>& query_results,
+    std::unordered_map<std::string, std::vector<Slice>>& slices,
+    std::vector<tl::expected<void, ErrorCode>>& results) {
+    // Collect all transfer operations for parallel execution
+    std::vector<PendingGetTransfer> pending_transfers;
+
     // Submit all transfers in parallel
     for (size_t i = 0; i < object_keys.size(); ++i) {
         const auto& key = object_keys[i];
@@ -713,7 +911,14 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchGet(
 
         pending_transfers.emplace_back(i, key, std::move(*future));
     }
+    return pending_transfers;
+}
 
+void Client::CollectBatchGetTransfers(
+    const std::vector<std::string>& object_keys,
+    const std::vector<QueryResult>& query_results,
+    std::vector<PendingGetTransfer>& pending_transfers,
+    std::vector<tl::expected<void, ErrorCode>>& results) {
     // Wait for all transfers to complete
     for (auto& [index, key, future] : pending_transfers) {
         ErrorCode result = future.get();
@@ -738,16 +943,28 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchGet(
             results[i] = tl::unexpected(ErrorCode::LEASE_EXPIRED);
         }
     }
+}
 
-    auto us_batch_get = std::chrono::duration_cast<std::chrono::microseconds>(
-                            std::chrono::steady_clock::now() - t0_batch_get)
-                            .count();
-    if (metrics_) {
-        metrics_->transfer_metric.batch_get_latency_us.observe(us_batch_get);
+// Result of a put whose PutStart failed, an existing object counts as stored,
+// as does an object stored with the replicas of the same content
+static tl::expected<void, ErrorCode> PutStartFailure(const ObjectKey& key,
+                                                     ErrorCode err) {
+    if (err == ErrorCode::OBJECT_ALREADY_EXISTS) {
+        VLOG(1) << "object_already_exists key=" << key;
+        return {};
+    }
+    if (err == ErrorCode::CONTENT_ALREADY_EXISTS) {
+        VLOG(1) << "content_already_exists key=" << key;
+        return {};
+    }
+    if (err == ErrorCode::NO_AVAILABLE_HANDLE) {
+        LOG(WARNING) << "Failed to start put operation for key=" << key
+                     << PUT_NO_SPACE_HELPER_STR;
+    } else {
+        LOG(ERROR) << "Failed to start put operation for key=" << key << ": "
+                   << toString(err);
     }
-
-    VLOG(1) << "BatchGet completed for " << object_keys.size() << " keys";
-    return results;
+    return tl::unexpected(err);
 }
 
 tl::expected<void, ErrorCode> Client::Put(const ObjectKey& key,
@@ -762,19 +979,7 @@ tl::expected<void, ErrorCode> Client::Put(const ObjectKey& key,
     // Start put operation
     auto start_result = master_client_.PutStart(key, slice_lengths, config);
     if (!start_result) {
-        ErrorCode err = start_result.error();
-        if (err == ErrorCode::OBJECT_ALREADY_EXISTS) {
-            VLOG(1) << "object_already_exists key=" << key;
-            return {};
-        }
-        if (err == ErrorCode::NO_AVAILABLE_HANDLE) {
-            LOG(WARNING) << "Failed to start put operation for key=" << key
-                         << PUT_NO_SPACE_HELPER_STR;
-        } else {
-            LOG(ERROR) << "Failed to start put operation for key=" << key
-                       << ": " << toString(err);
-        }
-        return tl::unexpected(err);
+        return PutStartFailure(key, start_result.error());
     }
 
     // Record Put transfer latency (all replicas)
@@ -904,8 +1109,8 @@ std::vector<PutOperation> Client::CreatePutOperations(
     return ops;
 }
 
-void Client::StartBatchPut(std::vector<PutOperation>& ops,
-                           const ReplicateConfig& config) {
+async_simple::coro::Lazy<void> Client::StartBatchPut(
+    std::vector<PutOperation>& ops, const ReplicateConfig& config) {
     std::vector<std::string> keys;
     std::vector<std::vector<uint64_t>> slice_lengths;
 
@@ -923,8 +1128,8 @@ void Client::StartBatchPut(std::vector<PutOperation>& ops,
         slice_lengths.emplace_back(std::move(slice_sizes));
     }
 
-    auto start_responses =
-        master_client_.BatchPutStart(keys, slice_lengths, config);
+    auto start_responses = co_await master_client_.BatchPutStartAsync(
+        keys, slice_lengths, config);
 
     // Ensure response size matches request size
     if (start_responses.size() != ops.size()) {
@@ -934,7 +1139,7 @@ void Client::StartBatchPut(std::vector<PutOperation>& ops,
             op.SetError(ErrorCode::RPC_FAIL,
                         "BatchPutStart response size mismatch");
         }
-        return;
+        co_return;
     }
 
     // Process individual responses with robust error handling
@@ -962,7 +1167,13 @@ void Client::SubmitTransfers(std::vector<PutOperation>& ops) {
         return;
     }
 
-    for (auto& op : ops) {
+    // The memory replicas of all operations are submitted together, so that
+    // adjacent writes of different objects can be coalesced
+    std::vector<const Replica::Descriptor*> replicas;
+    std::vector<std::vector<Slice>*> replica_slices;
+    std::vector<std::pair<size_t, size_t>> replica_owners;
+    for (size_t op_idx = 0; op_idx < ops.size(); ++op_idx) {
+        auto& op = ops[op_idx];
         // Skip operations that already failed in previous stages
         if (op.IsResolved()) {
             continue;
@@ -975,9 +1186,6 @@ void Client::SubmitTransfers(std::vector<PutOperation>& ops) {
             continue;
         }
 
-        bool all_transfers_submitted = true;
-        std::string failure_context;
-
         // We must deal with disk replica first, then the disk putrevoke/putend
         // can be called surely
         if (storage_backend_) {
@@ -996,25 +1204,40 @@ void Client::SubmitTransfers(std::vector<PutOperation>& ops) {
              ++replica_idx) {
             const auto& replica = op.replicas[replica_idx];
             if (replica.is_memory_replica()) {
-                auto submit_result = transfer_submitter_->submit(
-                    replica, op.slices, TransferRequest::WRITE);
-
-                if (!submit_result) {
-                    failure_context = "Failed to submit transfer for replica " +
-                                      std::to_string(replica_idx);
-                    all_transfers_submitted = false;
-                    break;
-                }
+                replicas.push_back(&replica);
+                replica_slices.push_back(&op.slices);
+                replica_owners.emplace_back(op_idx, replica_idx);
+            }
+        }
+    }
+
+    auto futures = transfer_submitter_->submit_all(replicas, replica_slices,
+                                                   TransferRequest::WRITE);
 
-                op.pending_transfers.emplace_back(
-                    std::move(submit_result.value()));
+    std::vector<std::string> failure_contexts(ops.size());
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto [op_idx, replica_idx] = replica_owners[i];
+        auto& op = ops[op_idx];
+        if (!futures[i]) {
+            if (failure_contexts[op_idx].empty()) {
+                failure_contexts[op_idx] =
+                    "Failed to submit transfer for replica " +
+                    std::to_string(replica_idx);
             }
+            continue;
         }
+        op.pending_transfers.emplace_back(std::move(futures[i].value()));
+    }
 
-        if (!all_transfers_submitted) {
+    for (size_t op_idx = 0; op_idx < ops.size(); ++op_idx) {
+        auto& op = ops[op_idx];
+        if (op.IsResolved()) {
+            continue;
+        }
+        if (!failure_contexts[op_idx].empty()) {
             LOG(ERROR) << "Transfer submission failed for key " << op.key
-                       << ": " << failure_context;
-            op.SetError(ErrorCode::TRANSFER_FAIL, failure_context);
+                       << ": " << failure_contexts[op_idx];
+            op.SetError(ErrorCode::TRANSFER_FAIL, failure_contexts[op_idx]);
             op.pending_transfers.clear();
         } else {
             VLOG(1) << "Successfully submitted " << op.pending_transfers.size()
@@ -1069,7 +1292,8 @@ void Client::WaitForTransfers(std::vector<PutOperation>& ops) {
     }
 }
 
-void Client::FinalizeBatchPut(std::vector<PutOperation>& ops) {
+async_simple::coro::Lazy<void> Client::FinalizeBatchPut(
+    std::vector<PutOperation>& ops) {
     // For each operation,
     // If transfers completed successfully, we need to call BatchPutEnd
     // If the operation failed but has allocated replicas, we need to call
@@ -1107,7 +1331,8 @@ void Client::FinalizeBatchPut(std::vector<PutOperation>& ops) {
 
     // Process successful operations
     if (!successful_keys.empty()) {
-        auto end_responses = master_client_.BatchPutEnd(successful_keys);
+        auto end_responses =
+            co_await master_client_.BatchPutEndAsync(successful_keys);
         if (end_responses.size() != successful_keys.size()) {
             LOG(ERROR) << "BatchPutEnd response size mismatch: expected "
                        << successful_keys.size() << ", got "
@@ -1138,7 +1363,8 @@ void Client::FinalizeBatchPut(std::vector<PutOperation>& ops) {
 
     // Process failed operations that need cleanup
     if (!failed_keys.empty()) {
-        auto revoke_responses = master_client_.BatchPutRevoke(failed_keys);
+        auto revoke_responses =
+            co_await master_client_.BatchPutRevokeAsync(failed_keys);
         if (revoke_responses.size() != failed_keys.size()) {
             LOG(ERROR) << "BatchPutRevoke response size mismatch: expected "
                        << failed_keys.size() << ", got "
@@ -1307,7 +1533,7 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchPutWhenPreferSameNode(
     if (metrics_) {
         metrics_->transfer_metric.batch_put_latency_us.observe(us);
     }
-    FinalizeBatchPut(ops);
+    async_simple::coro::syncAwait(FinalizeBatchPut(ops));
     return CollectResults(ops);
 }
 
@@ -1323,10 +1549,10 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchPut(
             return std::vector<tl::expected<void, ErrorCode>>(
                 keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
         }
-        StartBatchPut(ops, config);
+        async_simple::coro::syncAwait(StartBatchPut(ops, config));
         return BatchPutWhenPreferSameNode(ops);
     }
-    StartBatchPut(ops, config);
+    async_simple::coro::syncAwait(StartBatchPut(ops, config));
 
     auto t0 = std::chrono::steady_clock::now();
     SubmitTransfers(ops);
@@ -1338,10 +1564,336 @@ std::vector<tl::expected<void, ErrorCode>> Client::BatchPut(
         metrics_->transfer_metric.batch_put_latency_us.observe(us);
     }
 
-    FinalizeBatchPut(ops);
+    async_simple::coro::syncAwait(FinalizeBatchPut(ops));
     return CollectResults(ops);
 }
 
+// Checks that the slices can hold the whole object of the replica
+static ErrorCode CheckReadSlices(const Replica::Descriptor& replica_descriptor,
+                                 const std::vector<Slice>& slices) {
+    size_t total_size = 0;
+    if (replica_descriptor.is_memory_replica()) {
+        auto& mem_desc = replica_descriptor.get_memory_descriptor();
+        for (const auto& handle : mem_desc.buffer_descriptors) {
+            total_size += handle.size_;
+        }
+    } else {
+        auto& disk_desc = replica_descriptor.get_disk_descriptor();
+        total_size = disk_desc.object_size;
+    }
+
+    size_t slices_size = CalculateSliceSize(slices);
+    if (slices_size < total_size) {
+        LOG(ERROR) << "Slice size " << slices_size << " is smaller than total "
+                   << "size " << total_size;
+        return ErrorCode::INVALID_PARAMS;
+    }
+    return ErrorCode::OK;
+}
+
+AsyncHandle Client::AsyncGet(CompletionQueue& queue,
+                             const std::string& object_key,
+                             std::vector<Slice> slices) {
+    return StartAsync(
+        queue,
+        [](Client* client, std::string key, std::vector<Slice> slices)
+            -> async_simple::coro::Lazy<
+                std::vector<tl::expected<void, ErrorCode>>> {
+            std::vector<tl::expected<void, ErrorCode>> results;
+            results.emplace_back(co_await client->CoGet(key, slices));
+            co_return results;
+        }(this, object_key, std::move(slices)),
+        1);
+}
+
+AsyncHandle Client::AsyncBatchGet(
+    CompletionQueue& queue, const std::vector<std::string>& object_keys,
+    std::unordered_map<std::string, std::vector<Slice>> slices) {
+    return StartAsync(
+        queue,
+        [](Client* client, std::vector<std::string> keys,
+           std::unordered_map<std::string, std::vector<Slice>> slices)
+            -> async_simple::coro::Lazy<
+                std::vector<tl::expected<void, ErrorCode>>> {
+            co_return co_await client->CoBatchGet(keys, slices);
+        }(this, object_keys, std::move(slices)),
+        object_keys.size());
+}
+
+AsyncHandle Client::AsyncPut(CompletionQueue& queue, const ObjectKey& key,
+                             std::vector<Slice> slices,
+                             const ReplicateConfig& config) {
+    return StartAsync(
+        queue,
+        [](Client* client, ObjectKey key, std::vector<Slice> slices,
+           ReplicateConfig config)
+            -> async_simple::coro::Lazy<
+                std::vector<tl::expected<void, ErrorCode>>> {
+            std::vector<tl::expected<void, ErrorCode>> results;
+            results.emplace_back(co_await client->CoPut(key, slices, config));
+            co_return results;
+        }(this, key, std::move(slices), config),
+        1);
+}
+
+AsyncHandle Client::AsyncBatchPut(
+    CompletionQueue& queue, const std::vector<ObjectKey>& keys,
+    std::vector<std::vector<Slice>> batched_slices,
+    const ReplicateConfig& config) {
+    return StartAsync(
+        queue,
+        [](Client* client, std::vector<ObjectKey> keys,
+           std::vector<std::vector<Slice>> batched_slices,
+           ReplicateConfig config)
+            -> async_simple::coro::Lazy<
+                std::vector<tl::expected<void, ErrorCode>>> {
+            co_return co_await client->CoBatchPut(keys, batched_slices,
+                                                  config);
+        }(this, keys, std::move(batched_slices), config),
+        keys.size());
+}
+
+AsyncHandle Client::StartAsync(
+    CompletionQueue& queue,
+    async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+        operation,
+    size_t num_results) {
+    AsyncHandle handle = next_async_handle_.fetch_add(1);
+    async_operations_.fetch_add(1);
+    std::move(operation)
+        .via(coro_io::get_global_executor())
+        .start([this, &queue, handle, num_results](
+                   async_simple::Try<std::vector<tl::expected<void, ErrorCode>>>
+                       result) {
+            AsyncCompletion completion{handle, {}};
+            if (result.hasError()) {
+                LOG(ERROR) << "async_operation_failed handle=" << handle;
+                completion.results.assign(
+                    num_results, tl::unexpected(ErrorCode::INTERNAL_ERROR));
+            } else {
+                completion.results = std::move(result).value();
+            }
+            queue.Push(std::move(completion));
+            async_operations_.fetch_sub(1);
+        });
+    return handle;
+}
+
+async_simple::coro::Lazy<tl::expected<void, ErrorCode>> Client::CoGet(
+    const std::string& object_key, std::vector<Slice>& slices) {
+    auto start_time = std::chrono::steady_clock::now();
+    auto response = co_await master_client_.GetReplicaListAsync(object_key);
+    if (!response) {
+        co_return tl::unexpected(response.error());
+    }
+    QueryResult query_result(
+        std::move(response.value().replicas),
+        start_time + std::chrono::milliseconds(response.value().lease_ttl_ms));
+
+    Replica::Descriptor replica;
+    ErrorCode err = FindFirstCompleteReplica(query_result.replicas, replica);
+    if (err != ErrorCode::OK) {
+        if (err == ErrorCode::INVALID_REPLICA) {
+            LOG(ERROR) << "no_complete_replicas_found key=" << object_key;
+        }
+        co_return tl::unexpected(err);
+    }
+    err = CheckReadSlices(replica, slices);
+    if (err != ErrorCode::OK) {
+        co_return tl::unexpected(err);
+    }
+
+    auto t0_get = std::chrono::steady_clock::now();
+    err = co_await CoTransferData(replica, slices, TransferRequest::READ);
+    auto us_get = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0_get)
+                      .count();
+    if (metrics_) {
+        metrics_->transfer_metric.get_latency_us.observe(us_get);
+    }
+
+    if (err != ErrorCode::OK) {
+        LOG(ERROR) << "transfer_read_failed key=" << object_key;
+        co_return tl::unexpected(err);
+    }
+    if (query_result.IsLeaseExpired()) {
+        LOG(WARNING) << "lease_expired_before_data_transfer_completed key="
+                     << object_key;
+        co_return tl::unexpected(ErrorCode::LEASE_EXPIRED);
+    }
+    co_return tl::expected<void, ErrorCode>{};
+}
+
+async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+Client::CoBatchGet(
+    const std::vector<std::string>& object_keys,
+    std::unordered_map<std::string, std::vector<Slice>>& slices) {
+    auto start_time = std::chrono::steady_clock::now();
+    auto response =
+        co_await master_client_.BatchGetReplicaListAsync(object_keys);
+    auto batched_query_results =
+        ToQueryResults(object_keys.size(), start_time, response);
+
+    std::vector<tl::expected<void, ErrorCode>> results(object_keys.size());
+    std::vector<QueryResult> valid_query_results;
+    std::vector<size_t> valid_indices;
+    std::vector<std::string> valid_keys;
+    for (size_t i = 0; i < batched_query_results.size(); ++i) {
+        if (batched_query_results[i]) {
+            valid_query_results.emplace_back(batched_query_results[i].value());
+            valid_indices.emplace_back(i);
+            valid_keys.emplace_back(object_keys[i]);
+        } else {
+            results[i] = tl::unexpected(batched_query_results[i].error());
+        }
+    }
+    if (valid_keys.empty()) {
+        co_return results;
+    }
+    if (!transfer_submitter_) {
+        LOG(ERROR) << "TransferSubmitter not initialized";
+        for (size_t index : valid_indices) {
+            results[index] = tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        co_return results;
+    }
+
+    auto t0_batch_get = std::chrono::steady_clock::now();
+    std::vector<tl::expected<void, ErrorCode>> valid_results(valid_keys.size());
+    auto pending_transfers = SubmitBatchGetTransfers(
+        valid_keys, valid_query_results, slices, valid_results);
+    for (auto& pending : pending_transfers) {
+        co_await transfer_poller_->waitReady(std::get<TransferFuture>(pending));
+    }
+    CollectBatchGetTransfers(valid_keys, valid_query_results,
+                             pending_transfers, valid_results);
+    auto us_batch_get = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - t0_batch_get)
+                            .count();
+    if (metrics_) {
+        metrics_->transfer_metric.batch_get_latency_us.observe(us_batch_get);
+    }
+
+    for (size_t i = 0; i < valid_indices.size(); ++i) {
+        results[valid_indices[i]] = std::move(valid_results[i]);
+    }
+    co_return results;
+}
+
+async_simple::coro::Lazy<tl::expected<void, ErrorCode>> Client::CoPut(
+    const ObjectKey& key, std::vector<Slice>& slices,
+    const ReplicateConfig& config) {
+    std::vector<size_t> slice_lengths;
+    for (const auto& slice : slices) {
+        slice_lengths.emplace_back(slice.size);
+    }
+
+    auto start_result =
+        co_await master_client_.PutStartAsync(key, slice_lengths, config);
+    if (!start_result) {
+        co_return PutStartFailure(key, start_result.error());
+    }
+
+    auto t0_put = std::chrono::steady_clock::now();
+
+    // We must deal with disk replica first, then the disk putrevoke/putend can
+    // be called surely
+    if (storage_backend_) {
+        for (auto it = start_result.value().rbegin();
+             it != start_result.value().rend(); ++it) {
+            if (it->is_disk_replica()) {
+                PutToLocalFile(key, slices, it->get_disk_descriptor());
+                break;  // Only one disk replica is needed
+            }
+        }
+    }
+
+    for (const auto& replica : start_result.value()) {
+        if (replica.is_memory_replica()) {
+            ErrorCode transfer_err = co_await CoTransferData(
+                replica, slices, TransferRequest::WRITE);
+            if (transfer_err != ErrorCode::OK) {
+                auto revoke_result = co_await master_client_.PutRevokeAsync(
+                    key, ReplicaType::MEMORY);
+                if (!revoke_result) {
+                    LOG(ERROR) << "Failed to revoke put operation";
+                    co_return tl::unexpected(revoke_result.error());
+                }
+                co_return tl::unexpected(transfer_err);
+            }
+        }
+    }
+
+    auto us_put = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0_put)
+                      .count();
+    if (metrics_) {
+        metrics_->transfer_metric.put_latency_us.observe(us_put);
+    }
+
+    auto end_result =
+        co_await master_client_.PutEndAsync(key, ReplicaType::MEMORY);
+    if (!end_result) {
+        LOG(ERROR) << "Failed to end put operation: " << end_result.error();
+        co_return tl::unexpected(end_result.error());
+    }
+    co_return tl::expected<void, ErrorCode>{};
+}
+
+async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+Client::CoBatchPut(const std::vector<ObjectKey>& keys,
+                   std::vector<std::vector<Slice>>& batched_slices,
+                   const ReplicateConfig& config) {
+    if (config.prefer_alloc_in_same_node) {
+        LOG(ERROR) << "prefer_alloc_in_same_node is not supported by the "
+                      "asynchronous API";
+        co_return std::vector<tl::expected<void, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+    std::vector<PutOperation> ops = CreatePutOperations(keys, batched_slices);
+    co_await StartBatchPut(ops, config);
+
+    auto t0 = std::chrono::steady_clock::now();
+    SubmitTransfers(ops);
+    for (auto& op : ops) {
+        for (auto& future : op.pending_transfers) {
+            co_await transfer_poller_->waitReady(future);
+        }
+    }
+    // The transfers are done, so this only collects their results
+    WaitForTransfers(ops);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - t0)
+                  .count();
+    if (metrics_) {
+        metrics_->transfer_metric.batch_put_latency_us.observe(us);
+    }
+
+    co_await FinalizeBatchPut(ops);
+    co_return CollectResults(ops);
+}
+
+async_simple::coro::Lazy<ErrorCode> Client::CoTransferData(
+    const Replica::Descriptor& replica_descriptor, std::vector<Slice>& slices,
+    TransferRequest::OpCode op_code) {
+    if (!transfer_submitter_) {
+        LOG(ERROR) << "TransferSubmitter not initialized";
+        co_return ErrorCode::INVALID_PARAMS;
+    }
+
+    auto future =
+        transfer_submitter_->submit(replica_descriptor, slices, op_code);
+    if (!future) {
+        LOG(ERROR) << "Failed to submit transfer operation";
+        co_return ErrorCode::TRANSFER_FAIL;
+    }
+
+    VLOG(1) << "Using transfer strategy: " << future->strategy();
+
+    co_await transfer_poller_->waitReady(*future);
+    co_return future->get();
+}
+
 tl::expected<void, ErrorCode> Client::Remove(const ObjectKey& key) {
     auto result = master_client_.Remove(key);
     // if (storage_backend_) {
@@ -1364,6 +1916,11 @@ tl::expected<long, ErrorCode> Client::RemoveByRegex(const ObjectKey& str) {
     return result.value();
 }
 
+tl::expected<long, ErrorCode> Client::RemoveByPrefix(
+    const std::string& prefix) {
+    return master_client_.RemoveByPrefix(prefix);
+}
+
 tl::expected<long, ErrorCode> Client::RemoveAll() {
     // if (storage_backend_) {
     //     storage_backend_->RemoveAll();
@@ -1371,6 +1928,15 @@ tl::expected<long, ErrorCode> Client::RemoveAll() {
     return master_client_.RemoveAll();
 }
 
+tl::expected<void, ErrorCode> Client::SetNamespaceQuota(
+    const std::string& name, uint64_t quota) {
+    return master_client_.SetNamespaceQuota(name, quota);
+}
+
+tl::expected<void, ErrorCode> Client::DropNamespace(const std::string& name) {
+    return master_client_.DropNamespace(name);
+}
+
 tl::expected<void, ErrorCode> Client::MountSegment(const void* buffer,
                                                    size_t size) {
     auto check_result = CheckRegisterMemoryParams(buffer, size);
@@ -1395,14 +1961,120 @@ tl::expected<void, ErrorCode> Client::MountSegment(const void* buffer,
         }
     }
 
-    int rc = transfer_engine_->registerLocalMemory(
-        (void*)buffer, size, kWildcardLocation, true, true);
-    if (rc != 0) {
-        LOG(ERROR) << "register_local_memory_failed base=" << buffer
-                   << " size=" << size << ", error=" << rc;
-        return tl::unexpected(ErrorCode::INVALID_PARAMS);
-    }
+    static const size_t chunk_size = get_mount_chunk_size();
+    if (chunk_size == 0 || size <= chunk_size) {
+        int rc = transfer_engine_->registerLocalMemory(
+            (void*)buffer, size, kWildcardLocation, true, true);
+        if (rc != 0) {
+            LOG(ERROR) << "register_local_memory_failed base=" << buffer
+                       << " size=" << size << ", error=" << rc;
+            return tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        auto mount_result = MountRegisteredSegment(buffer, size);
+        if (!mount_result) {
+            transfer_engine_->unregisterLocalMemory((void*)buffer);
+            return tl::unexpected(mount_result.error());
+        }
+        return {};
+    }
+
+    // Register the first chunk on its own so master allocates from it as
+    // early as possible, then the others in parallel batches. Each chunk is
+    // a segment of its own on master, all of them named after this host so
+    // that puts preferring this host allocate from any of them. Unmounting
+    // one chunk thus visits the objects of all of them on master.
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<BufferEntry> chunks;
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+        chunks.push_back({(char*)buffer + offset,
+                          std::min(chunk_size, size - offset)});
+    }
+    // A failed mount undoes the chunks done so far, so that the caller can
+    // retry it
+    std::vector<void*> registered;
+    std::vector<UUID> mounted;
+    auto rollback = [&]() {
+        for (const auto& segment_id : mounted) {
+            auto unmount_result =
+                master_client_.UnmountSegment(segment_id, client_id_);
+            if (!unmount_result) {
+                LOG(ERROR) << "unmount_chunk_failed segment_id=" << segment_id
+                           << ", error=" << unmount_result.error();
+            }
+            mounted_segments_.erase(segment_id);
+        }
+        if (!registered.empty() &&
+            transfer_engine_->unregisterLocalMemoryBatch(registered) != 0) {
+            LOG(ERROR) << "unregister_chunks_failed base=" << buffer
+                       << " chunks=" << registered.size();
+        }
+    };
+    for (size_t begin = 0; begin < chunks.size();) {
+        size_t end = begin == 0 ? 1
+                                : std::min(chunks.size(),
+                                           begin + kMountChunksPerBatch);
+        // registerLocalMemoryBatch only logs the buffers it fails to
+        // register, so register the chunks one by one in parallel and
+        // publish them with a single metadata update
+        std::vector<std::future<int>> results;
+        for (size_t i = begin; i < end; ++i) {
+            results.push_back(std::async(
+                std::launch::async, [this, chunk = chunks[i]]() {
+                    return transfer_engine_->registerLocalMemory(
+                        chunk.addr, chunk.length, kWildcardLocation, true,
+                        false);
+                }));
+        }
+        bool failed = false;
+        for (size_t i = begin; i < end; ++i) {
+            int rc = results[i - begin].get();
+            if (rc != 0) {
+                LOG(ERROR) << "register_local_memory_failed base="
+                           << chunks[i].addr << " size=" << chunks[i].length
+                           << ", error=" << rc;
+                failed = true;
+            } else {
+                registered.push_back(chunks[i].addr);
+            }
+        }
+        if (!failed &&
+            transfer_engine_->getMetadata()->updateLocalSegmentDesc() != 0) {
+            LOG(ERROR) << "update_segment_desc_failed base="
+                       << chunks[begin].addr;
+            failed = true;
+        }
+        if (failed) {
+            rollback();
+            return tl::unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        for (size_t i = begin; i < end; ++i) {
+            auto mount_result =
+                MountRegisteredSegment(chunks[i].addr, chunks[i].length);
+            if (!mount_result) {
+                rollback();
+                return tl::unexpected(mount_result.error());
+            }
+            mounted.push_back(mount_result.value());
+        }
+        if (begin == 0) {
+            LOG(INFO) << "first_chunk_mounted base=" << buffer
+                      << " size=" << chunks[0].length << " elapsed_ms="
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+        }
+        begin = end;
+    }
+    LOG(INFO) << "segment_mounted base=" << buffer << " size=" << size
+              << " chunks=" << chunks.size() << " elapsed_ms="
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start_time)
+                     .count();
+    return {};
+}
 
+tl::expected<UUID, ErrorCode> Client::MountRegisteredSegment(
+    const void* buffer, size_t size) {
     // Build segment with logical name; attach TE endpoint for transport
     Segment segment;
     segment.id = generate_uuid();
@@ -1427,50 +2099,54 @@ tl::expected<void, ErrorCode> Client::MountSegment(const void* buffer,
     }
 
     mounted_segments_[segment.id] = segment;
-    return {};
+    return segment.id;
 }
 
 tl::expected<void, ErrorCode> Client::UnmountSegment(const void* buffer,
                                                      size_t size) {
     std::lock_guard<std::mutex> lock(mounted_segments_mutex_);
-    auto segment = mounted_segments_.end();
 
-    for (auto it = mounted_segments_.begin(); it != mounted_segments_.end();
-         ++it) {
-        if (it->second.base == reinterpret_cast<uintptr_t>(buffer) &&
-            it->second.size == size) {
-            segment = it;
-            break;
+    // A segment mounted in chunks is unmounted chunk by chunk
+    uintptr_t begin = reinterpret_cast<uintptr_t>(buffer);
+    std::vector<UUID> segment_ids;
+    size_t found_size = 0;
+    for (const auto& [id, segment] : mounted_segments_) {
+        if (segment.base >= begin && segment.base < begin + size) {
+            segment_ids.push_back(id);
+            found_size += segment.size;
         }
     }
-    if (segment == mounted_segments_.end()) {
+    if (segment_ids.empty() || found_size != size) {
         LOG(ERROR) << "segment_not_found base=" << buffer << " size=" << size;
         return tl::unexpected(ErrorCode::INVALID_PARAMS);
     }
 
-    auto unmount_result =
-        master_client_.UnmountSegment(segment->second.id, client_id_);
-    if (!unmount_result) {
-        ErrorCode err = unmount_result.error();
-        LOG(ERROR) << "Failed to unmount segment from master: "
-                   << toString(err);
-        return tl::unexpected(err);
-    }
-
-    int rc = transfer_engine_->unregisterLocalMemory(
-        reinterpret_cast<void*>(segment->second.base));
-    if (rc != 0) {
-        LOG(ERROR) << "Failed to unregister transfer buffer with transfer "
-                      "engine ret is "
-                   << rc;
-        if (rc != ERR_ADDRESS_NOT_REGISTERED) {
-            return tl::unexpected(ErrorCode::INTERNAL_ERROR);
+    for (const auto& id : segment_ids) {
+        auto segment = mounted_segments_.find(id);
+        auto unmount_result =
+            master_client_.UnmountSegment(segment->second.id, client_id_);
+        if (!unmount_result) {
+            ErrorCode err = unmount_result.error();
+            LOG(ERROR) << "Failed to unmount segment from master: "
+                       << toString(err);
+            return tl::unexpected(err);
+        }
+
+        int rc = transfer_engine_->unregisterLocalMemory(
+            reinterpret_cast<void*>(segment->second.base));
+        if (rc != 0) {
+            LOG(ERROR) << "Failed to unregister transfer buffer with transfer "
+                          "engine ret is "
+                       << rc;
+            if (rc != ERR_ADDRESS_NOT_REGISTERED) {
+                return tl::unexpected(ErrorCode::INTERNAL_ERROR);
+            }
+            // Otherwise, the segment is already unregistered from transfer
+            // engine, we can continue
         }
-        // Otherwise, the segment is already unregistered from transfer
-        // engine, we can continue
-    }
 
-    mounted_segments_.erase(segment);
+        mounted_segments_.erase(segment);
+    }
     return {};
 }
 
@@ -1608,25 +2284,51 @@ ErrorCode Client::TransferWrite(const Replica::Descriptor& replica_descriptor,
 
 ErrorCode Client::TransferRead(const Replica::Descriptor& replica_descriptor,
                                std::vector<Slice>& slices) {
-    size_t total_size = 0;
-    if (replica_descriptor.is_memory_replica()) {
-        auto& mem_desc = replica_descriptor.get_memory_descriptor();
-        for (const auto& handle : mem_desc.buffer_descriptors) {
-            total_size += handle.size_;
-        }
-    } else {
-        auto& disk_desc = replica_descriptor.get_disk_descriptor();
-        total_size = disk_desc.object_size;
+    ErrorCode err = CheckReadSlices(replica_descriptor, slices);
+    if (err != ErrorCode::OK) {
+        return err;
     }
+    return TransferData(replica_descriptor, slices, TransferRequest::READ);
+}
 
-    size_t slices_size = CalculateSliceSize(slices);
-    if (slices_size < total_size) {
-        LOG(ERROR) << "Slice size " << slices_size << " is smaller than total "
-                   << "size " << total_size;
-        return ErrorCode::INVALID_PARAMS;
+ErrorCode Client::TransferReadRange(
+    const Replica::Descriptor& replica_descriptor, uint64_t offset,
+    std::vector<Slice>& slices) {
+    if (!replica_descriptor.is_memory_replica()) {
+        // Files are read whole, the range is copied out of the object
+        uint64_t total_size = calculate_total_size(replica_descriptor);
+        uint64_t length = CalculateSliceSize(slices);
+        if (offset > total_size || length > total_size - offset) {
+            LOG(ERROR) << "Range [" << offset << ", " << offset + length
+                       << ") exceeds object size " << total_size;
+            return ErrorCode::INVALID_PARAMS;
+        }
+        std::vector<char> object(total_size);
+        std::vector<Slice> object_slices;
+        for (uint64_t pos = 0; pos < total_size; pos += kMaxSliceSize) {
+            object_slices.push_back(
+                {object.data() + pos, std::min(total_size - pos, kMaxSliceSize)});
+        }
+        ErrorCode err = TransferRead(replica_descriptor, object_slices);
+        if (err != ErrorCode::OK) {
+            return err;
+        }
+        for (const auto& slice : slices) {
+            if (slice.ptr) {
+                memcpy(slice.ptr, object.data() + offset, slice.size);
+            }
+            offset += slice.size;
+        }
+        return ErrorCode::OK;
     }
 
-    return TransferData(replica_descriptor, slices, TransferRequest::READ);
+    Replica::Descriptor range_replica = replica_descriptor;
+    std::vector<Slice> range_slices = slices;
+    ErrorCode err = restrictReplicaToRange(range_replica, offset, range_slices);
+    if (err != ErrorCode::OK || range_slices.empty()) {
+        return err;
+    }
+    return TransferData(range_replica, range_slices, TransferRequest::READ);
 }
 
 void Client::PingThreadMain(bool is_ha_mode,
@@ -1661,6 +2363,8 @@ void Client::PingThreadMain(bool is_ha_mode,
     // Use another thread to remount segments to avoid blocking the ping
     // thread
     std::future<void> remount_segment_future;
+    // Likewise for the copies of compaction tasks
+    std::future<void> compaction_future;
 
     while (ping_running_) {
         // Join the remount segment thread if it is ready
@@ -1676,12 +2380,36 @@ void Client::PingThreadMain(bool is_ha_mode,
             // Reset ping failure count
             ping_fail_count = 0;
             auto& ping_response = ping_result.value();
+            put_retry_after_ms_.store(ping_response.put_retry_after_ms,
+                                      std::memory_order_relaxed);
             if (ping_response.client_status == ClientStatus::NEED_REMOUNT &&
                 !remount_segment_future.valid()) {
                 // Ensure at most one remount segment thread is running
                 remount_segment_future =
                     std::async(std::launch::async, remount_segment);
             }
+            auto& tasks = ping_response.compaction_tasks;
+            if (!tasks.empty()) {
+                if (compaction_future.valid() &&
+                    compaction_future.wait_for(std::chrono::seconds(0)) !=
+                        std::future_status::ready) {
+                    // Still copying the previous tasks, give these back
+                    for (const auto& task : tasks) {
+                        auto result = master_client_.MoveEnd(
+                            client_id_, task.task_id, false);
+                        if (!result) {
+                            LOG(ERROR) << "Failed to end move of key: "
+                                       << task.key;
+                        }
+                    }
+                } else {
+                    compaction_future = std::async(
+                        std::launch::async,
+                        [this, tasks = std::move(tasks)]() {
+                            MoveObjects(tasks);
+                        });
+                }
+            }
             std::this_thread::sleep_for(
                 std::chrono::milliseconds(success_ping_interval_ms));
             continue;
@@ -1744,6 +2472,38 @@ void Client::PingThreadMain(bool is_ha_mode,
     if (remount_segment_future.valid()) {
         remount_segment_future.wait();
     }
+    if (compaction_future.valid()) {
+        compaction_future.wait();
+    }
+}
+
+void Client::MoveObjects(const std::vector<CompactionTask>& tasks) {
+    for (const auto& task : tasks) {
+        // Write the sources, which are in our own segment, to the targets,
+        // in the same segment when compacting it or in another one when
+        // replicating a hot key
+        Replica::Descriptor target;
+        target.descriptor_variant = MemoryDescriptor{task.targets};
+        target.status = ReplicaStatus::COMPLETE;
+        std::vector<Slice> slices;
+        slices.reserve(task.sources.size());
+        for (const auto& source : task.sources) {
+            slices.push_back(
+                Slice{reinterpret_cast<void*>(source.buffer_address_),
+                      source.size_});
+        }
+
+        ErrorCode err = TransferWrite(target, slices);
+        if (err != ErrorCode::OK) {
+            LOG(ERROR) << "Failed to move key: " << task.key
+                       << ", error: " << err;
+        }
+        auto result = master_client_.MoveEnd(client_id_, task.task_id,
+                                             err == ErrorCode::OK);
+        if (!result) {
+            LOG(ERROR) << "Failed to end move of key: " << task.key;
+        }
+    }
 }
 
 ErrorCode Client::FindFirstCompleteReplica(
@@ -1,15 +1,158 @@
 #include "client_buffer.hpp"
 
+#include <glog/logging.h>
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstdlib>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "utils.h"
 
 namespace mooncake {
 
+namespace {
+
+constexpr size_t kMinCachedShift = 16;
+constexpr size_t kMaxCachedShift = 22;
+static_assert(size_t(1) << kMinCachedShift ==
+              ClientBufferAllocator::kMinCachedSize);
+static_assert(size_t(1) << kMaxCachedShift ==
+              ClientBufferAllocator::kMaxCachedSize);
+
+// Four size classes per power of two, so at most a fifth of a chunk is
+// unused
+constexpr size_t kClassesPerDoubling = 4;
+constexpr size_t kNumSizeClasses =
+    (kMaxCachedShift - kMinCachedShift) * kClassesPerDoubling + 1;
+
+// Chunks a magazine keeps per size class
+constexpr size_t kMaxChunksPerClass = 8;
+
+// Index of the smallest size class holding `size` bytes, for sizes between
+// kMinCachedSize and kMaxCachedSize
+size_t sizeClassOf(size_t size) {
+    if (size <= ClientBufferAllocator::kMinCachedSize) {
+        return 0;
+    }
+    // 2^shift < size <= 2^(shift + 1)
+    size_t shift = std::bit_width(size - 1) - 1;
+    size_t step = size_t(1) << (shift - 2);
+    size_t sub = (size - 1 - (size_t(1) << shift)) / step;
+    return (shift - kMinCachedShift) * kClassesPerDoubling + sub + 1;
+}
+
+size_t sizeOfClass(size_t size_class) {
+    if (size_class == 0) {
+        return ClientBufferAllocator::kMinCachedSize;
+    }
+    size_t shift = kMinCachedShift + (size_class - 1) / kClassesPerDoubling;
+    size_t sub = (size_class - 1) % kClassesPerDoubling;
+    return (size_t(1) << shift) + ((sub + 1) << (shift - 2));
+}
+
+std::atomic<uint64_t> next_allocator_id{1};
+
+}  // namespace
+
+/**
+ * Freed size class chunks of one thread and allocator. Only the owning
+ * thread takes chunks out, so the mutex is contended only by frees from
+ * other threads and by trimming.
+ */
+class BufferMagazine {
+   public:
+    BufferMagazine(std::weak_ptr<offset_allocator::OffsetAllocator> allocator,
+                   size_t max_cached_bytes)
+        : allocator_(std::move(allocator)),
+          max_cached_bytes_(max_cached_bytes) {}
+
+    std::optional<offset_allocator::OffsetAllocationHandle> pop(
+        size_t size_class) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& chunks = chunks_[size_class];
+        if (chunks.empty()) {
+            return std::nullopt;
+        }
+        auto chunk = std::move(chunks.back());
+        chunks.pop_back();
+        cached_bytes_ -= chunk.size();
+        return chunk;
+    }
+
+    // Keeps a freed chunk for reuse, or returns it to the buffer if the
+    // magazine is full or its thread has exited.
+    void push(size_t size_class,
+              offset_allocator::OffsetAllocationHandle chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& chunks = chunks_[size_class];
+        if (orphaned_ || chunks.size() >= kMaxChunksPerClass ||
+            cached_bytes_ + chunk.size() > max_cached_bytes_) {
+            // Freed by the chunk destructor
+            return;
+        }
+        cached_bytes_ += chunk.size();
+        chunks.push_back(std::move(chunk));
+    }
+
+    // Returns all cached chunks to the buffer, and every chunk freed later
+    // if `orphan` is set.
+    void trim(bool orphan) {
+        std::array<std::vector<offset_allocator::OffsetAllocationHandle>,
+                   kNumSizeClasses>
+            released;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            released.swap(chunks_);
+            cached_bytes_ = 0;
+            orphaned_ = orphaned_ || orphan;
+        }
+    }
+
+    // Whether the allocator the chunks belong to is gone
+    bool expired() const { return allocator_.expired(); }
+
+   private:
+    const std::weak_ptr<offset_allocator::OffsetAllocator> allocator_;
+    const size_t max_cached_bytes_;
+
+    std::mutex mutex_;
+    std::array<std::vector<offset_allocator::OffsetAllocationHandle>,
+               kNumSizeClasses>
+        chunks_;
+    size_t cached_bytes_ = 0;
+    bool orphaned_ = false;
+};
+
+namespace {
+
+// Magazines of the calling thread by allocator id, orphaned when the thread
+// exits. Handles allocated by the thread may still refer to them.
+struct ThreadMagazines {
+    std::unordered_map<uint64_t, std::shared_ptr<BufferMagazine>> magazines;
+
+    ~ThreadMagazines() {
+        for (auto& [id, magazine] : magazines) {
+            magazine->trim(true);
+        }
+    }
+};
+
+thread_local ThreadMagazines thread_magazines;
+
+}  // namespace
+
 ClientBufferAllocator::ClientBufferAllocator(size_t size,
-                                             const std::string& protocol)
-    : protocol(protocol), buffer_size_(size) {
+                                             const std::string& protocol,
+                                             bool use_thread_cache)
+    : protocol(protocol),
+      buffer_size_(size),
+      id_(next_allocator_id.fetch_add(1, std::memory_order_relaxed)),
+      use_thread_cache_(use_thread_cache),
+      max_cached_bytes_(use_thread_cache ? size / 16 : 0) {
     // Align to 64 bytes(cache line size) for better cache performance
     constexpr size_t alignment = 64;
     buffer_ = allocate_buffer_allocator_memory(size, protocol, alignment);
@@ -29,7 +172,31 @@ ClientBufferAllocator::~ClientBufferAllocator() {
 }
 
 std::optional<BufferHandle> ClientBufferAllocator::allocate(size_t size) {
+    if (use_thread_cache_ && size >= kMinCachedSize &&
+        size <= kMaxCachedSize) {
+        size_t size_class = sizeClassOf(size);
+        auto magazine = localMagazine();
+        auto chunk = magazine->pop(size_class);
+        if (!chunk) {
+            chunk = allocator_->allocate(sizeOfClass(size_class));
+        }
+        if (!chunk) {
+            trimThreadCaches();
+            chunk = allocator_->allocate(sizeOfClass(size_class));
+        }
+        if (chunk) {
+            return std::make_optional<BufferHandle>(
+                shared_from_this(), std::move(*chunk), size,
+                std::move(magazine));
+        }
+        // The rounded up chunk does not fit, the exact size may
+    }
+
     auto handle = allocator_->allocate(size);
+    if (!handle && use_thread_cache_) {
+        trimThreadCaches();
+        handle = allocator_->allocate(size);
+    }
     if (!handle) {
         return std::nullopt;
     }
@@ -38,19 +205,93 @@ std::optional<BufferHandle> ClientBufferAllocator::allocate(size_t size) {
                                             std::move(*handle));
 }
 
+void ClientBufferAllocator::trimThreadCaches() {
+    std::vector<std::shared_ptr<BufferMagazine>> magazines;
+    {
+        std::lock_guard<std::mutex> lock(magazines_mutex_);
+        for (const auto& weak_magazine : magazines_) {
+            if (auto magazine = weak_magazine.lock()) {
+                magazines.push_back(std::move(magazine));
+            }
+        }
+    }
+    for (auto& magazine : magazines) {
+        magazine->trim(false);
+    }
+}
+
+std::shared_ptr<BufferMagazine> ClientBufferAllocator::localMagazine() {
+    auto& magazines = thread_magazines.magazines;
+    auto it = magazines.find(id_);
+    if (it != magazines.end()) {
+        return it->second;
+    }
+
+    // Drop the magazines of destroyed allocators first
+    std::erase_if(magazines, [](const auto& entry) {
+        return entry.second->expired();
+    });
+    auto magazine =
+        std::make_shared<BufferMagazine>(allocator_, max_cached_bytes_);
+    {
+        std::lock_guard<std::mutex> lock(magazines_mutex_);
+        std::erase_if(magazines_, [](const auto& weak_magazine) {
+            return weak_magazine.expired();
+        });
+        magazines_.push_back(magazine);
+    }
+    magazines.emplace(id_, magazine);
+    return magazine;
+}
+
 BufferHandle::BufferHandle(
     std::shared_ptr<ClientBufferAllocator> allocator,
     mooncake::offset_allocator::OffsetAllocationHandle handle)
-    : allocator_(std::move(allocator)), handle_(std::move(handle)) {}
+    : allocator_(std::move(allocator)),
+      handle_(std::move(handle)),
+      size_(handle_.size()) {}
 
-BufferHandle::~BufferHandle() {
-    // The OffsetAllocationHandle destructor will automatically deallocate
-    // No need to manually call deallocate
+BufferHandle::BufferHandle(
+    std::shared_ptr<ClientBufferAllocator> allocator,
+    mooncake::offset_allocator::OffsetAllocationHandle chunk, size_t size,
+    std::shared_ptr<BufferMagazine> magazine)
+    : allocator_(std::move(allocator)),
+      handle_(std::move(chunk)),
+      size_(size),
+      magazine_(std::move(magazine)) {}
+
+BufferHandle::BufferHandle(BufferHandle&& other) noexcept
+    : allocator_(std::move(other.allocator_)),
+      handle_(std::move(other.handle_)),
+      size_(std::exchange(other.size_, 0)),
+      magazine_(std::move(other.magazine_)) {}
+
+BufferHandle& BufferHandle::operator=(BufferHandle&& other) noexcept {
+    if (this != &other) {
+        release();
+        handle_ = std::move(other.handle_);
+        allocator_ = std::move(other.allocator_);
+        size_ = std::exchange(other.size_, 0);
+        magazine_ = std::move(other.magazine_);
+    }
+    return *this;
+}
+
+BufferHandle::~BufferHandle() { release(); }
+
+void BufferHandle::release() {
+    // A size class chunk goes back to the magazine it came from, any other
+    // allocation is freed by the OffsetAllocationHandle destructor
+    if (magazine_) {
+        size_t size_class = sizeClassOf(handle_.size());
+        magazine_->push(size_class, std::move(handle_));
+        magazine_.reset();
+    }
 }
 
 void* BufferHandle::ptr() const { return handle_.ptr(); }
 
-size_t BufferHandle::size() const { return handle_.size(); }
+size_t BufferHandle::size() const { return size_; }
 
 // Utility functions for buffer and slice management
 std::vector<Slice> split_into_slices(BufferHandle& handle) {
@@ -106,4 +347,62 @@ int allocateSlices(std::vector<Slice>& slices,
     return 0;
 }
 
+ErrorCode restrictReplicaToRange(Replica::Descriptor& replica,
+                                 uint64_t offset, std::vector<Slice>& slices) {
+    if (!replica.is_memory_replica()) {
+        LOG(ERROR) << "Ranged reads require a memory replica";
+        return ErrorCode::INVALID_PARAMS;
+    }
+    uint64_t length = 0;
+    for (const auto& slice : slices) {
+        length += slice.size;
+    }
+    auto& buffers = replica.get_memory_descriptor().buffer_descriptors;
+    uint64_t total_length = calculate_total_size(replica);
+    if (offset > total_length || length > total_length - offset) {
+        LOG(ERROR) << "Range [" << offset << ", " << offset + length
+                   << ") exceeds object size " << total_length;
+        return ErrorCode::INVALID_PARAMS;
+    }
+
+    // Walk the buffers and the slices together, emitting a piece for every
+    // overlap of a buffer with a slice within the range
+    std::vector<AllocatedBuffer::Descriptor> range_buffers;
+    std::vector<Slice> range_slices;
+    uint64_t buffer_begin = 0;
+    uint64_t position = offset;
+    uint64_t end = offset + length;
+    size_t slice_index = 0;
+    uint64_t slice_offset = 0;
+    for (const auto& buffer : buffers) {
+        uint64_t buffer_end = buffer_begin + buffer.size_;
+        while (position < end && position < buffer_end) {
+            while (slices[slice_index].size == slice_offset) {
+                ++slice_index;
+                slice_offset = 0;
+            }
+            const auto& slice = slices[slice_index];
+            uint64_t size = std::min(buffer_end - position,
+                                     slice.size - slice_offset);
+            AllocatedBuffer::Descriptor piece = buffer;
+            piece.buffer_address_ += position - buffer_begin;
+            piece.size_ = size;
+            range_buffers.push_back(std::move(piece));
+            // Null slices stay null, their bytes are skipped
+            range_slices.push_back(
+                {slice.ptr ? static_cast<char*>(slice.ptr) + slice_offset
+                           : nullptr,
+                 size});
+            position += size;
+            slice_offset += size;
+        }
+        buffer_begin = buffer_end;
+        if (position == end) break;
+    }
+
+    buffers = std::move(range_buffers);
+    slices = std::move(range_slices);
+    return ErrorCode::OK;
+}
+
 }  // namespace mooncake
\ No newline at end of file
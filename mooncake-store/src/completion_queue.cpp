@@ -0,0 +1,44 @@
+#include "completion_queue.h"
+
+#include <algorithm>
+
+namespace mooncake {
+
+size_t CompletionQueue::Poll(std::vector<AsyncCompletion>& completions,
+                             size_t max_completions) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return PopLocked(completions, max_completions);
+}
+
+size_t CompletionQueue::Wait(std::vector<AsyncCompletion>& completions,
+                             std::chrono::milliseconds timeout,
+                             size_t max_completions) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, timeout, [this] { return !completions_.empty(); });
+    return PopLocked(completions, max_completions);
+}
+
+size_t CompletionQueue::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completions_.size();
+}
+
+void CompletionQueue::Push(AsyncCompletion completion) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completions_.push_back(std::move(completion));
+    }
+    cv_.notify_one();
+}
+
+size_t CompletionQueue::PopLocked(std::vector<AsyncCompletion>& completions,
+                                  size_t max_completions) {
+    size_t count = std::min(max_completions, completions_.size());
+    for (size_t i = 0; i < count; ++i) {
+        completions.push_back(std::move(completions_.front()));
+        completions_.pop_front();
+    }
+    return count;
+}
+
+}  // namespace mooncake
@@ -38,6 +38,27 @@ DEFINE_double(eviction_ratio, mooncake::DEFAULT_EVICTION_RATIO,
 DEFINE_double(eviction_high_watermark_ratio,
               mooncake::DEFAULT_EVICTION_HIGH_WATERMARK_RATIO,
               "Ratio of high watermark trigger eviction");
+DEFINE_double(compaction_fragmentation_ratio,
+              mooncake::DEFAULT_COMPACTION_FRAGMENTATION_RATIO,
+              "Fragmentation ratio (1 - largest free region / free space) "
+              "above which a segment is compacted, 0 disables compaction");
+DEFINE_uint64(num_metadata_shards, mooncake::DEFAULT_NUM_METADATA_SHARDS,
+              "Number of shards of the object metadata, each with its own "
+              "lock");
+DEFINE_bool(hex_key_shard_hash, false,
+            "Shard keys starting with 16 hex digits, e.g. SHA-256 hex "
+            "digests, by those digits instead of hashing the whole key");
+DEFINE_bool(enable_inline_eviction, mooncake::DEFAULT_ENABLE_INLINE_EVICTION,
+            "Evict objects within a put that failed to allocate, instead of "
+            "failing it until the eviction thread makes room");
+DEFINE_string(put_admission_policy, "always",
+              "Which objects a put may evict inline, always | tinylfu, "
+              "tinylfu keeps the objects accessed more often than the put");
+DEFINE_uint64(hot_key_read_threshold, mooncake::DEFAULT_HOT_KEY_READ_THRESHOLD,
+              "Decayed read count, about twice the reads per second, above "
+              "which an object gets extra memory replicas, 0 to disable");
+DEFINE_uint64(hot_key_extra_replicas, mooncake::DEFAULT_HOT_KEY_EXTRA_REPLICAS,
+              "Number of extra memory replicas of a heavily read object");
 // RPC server configuration parameters (new, preferred)
 // TODO: deprecate port and max_threads in the future
 DEFINE_int32(rpc_thread_num, 0,
@@ -78,7 +99,8 @@ DEFINE_string(cluster_id, mooncake::DEFAULT_CLUSTER_ID,
               "in HA mode");
 
 DEFINE_string(memory_allocator, "offset",
-              "Memory allocator for global segments, cachelib | offset");
+              "Memory allocator for global segments, cachelib | offset | "
+              "sharded_offset");
 DEFINE_bool(enable_http_metadata_server, false,
             "Enable HTTP metadata server instead of etcd");
 DEFINE_int32(http_metadata_server_port, 8080,
@@ -120,6 +142,27 @@ void InitMasterConf(const mooncake::DefaultConfig& default_config,
     default_config.GetDouble("eviction_high_watermark_ratio",
                              &master_config.eviction_high_watermark_ratio,
                              FLAGS_eviction_high_watermark_ratio);
+    default_config.GetDouble("compaction_fragmentation_ratio",
+                             &master_config.compaction_fragmentation_ratio,
+                             FLAGS_compaction_fragmentation_ratio);
+    default_config.GetUInt64("num_metadata_shards",
+                             &master_config.num_metadata_shards,
+                             FLAGS_num_metadata_shards);
+    default_config.GetBool("hex_key_shard_hash",
+                           &master_config.hex_key_shard_hash,
+                           FLAGS_hex_key_shard_hash);
+    default_config.GetBool("enable_inline_eviction",
+                           &master_config.enable_inline_eviction,
+                           FLAGS_enable_inline_eviction);
+    default_config.GetString("put_admission_policy",
+                             &master_config.put_admission_policy,
+                             FLAGS_put_admission_policy);
+    default_config.GetUInt64("hot_key_read_threshold",
+                             &master_config.hot_key_read_threshold,
+                             FLAGS_hot_key_read_threshold);
+    default_config.GetUInt64("hot_key_extra_replicas",
+                             &master_config.hot_key_extra_replicas,
+                             FLAGS_hot_key_extra_replicas);
     default_config.GetInt64("client_live_ttl_sec",
                             &master_config.client_live_ttl_sec,
                             FLAGS_client_ttl);
@@ -250,6 +293,43 @@ void LoadConfigFromCmdline(mooncake::MasterConfig& master_config,
         master_config.eviction_high_watermark_ratio =
             FLAGS_eviction_high_watermark_ratio;
     }
+    if ((google::GetCommandLineFlagInfo("compaction_fragmentation_ratio",
+                                        &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.compaction_fragmentation_ratio =
+            FLAGS_compaction_fragmentation_ratio;
+    }
+    if ((google::GetCommandLineFlagInfo("num_metadata_shards", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.num_metadata_shards = FLAGS_num_metadata_shards;
+    }
+    if ((google::GetCommandLineFlagInfo("hex_key_shard_hash", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.hex_key_shard_hash = FLAGS_hex_key_shard_hash;
+    }
+    if ((google::GetCommandLineFlagInfo("enable_inline_eviction", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.enable_inline_eviction = FLAGS_enable_inline_eviction;
+    }
+    if ((google::GetCommandLineFlagInfo("put_admission_policy", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.put_admission_policy = FLAGS_put_admission_policy;
+    }
+    if ((google::GetCommandLineFlagInfo("hot_key_read_threshold", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.hot_key_read_threshold = FLAGS_hot_key_read_threshold;
+    }
+    if ((google::GetCommandLineFlagInfo("hot_key_extra_replicas", &info) &&
+         !info.is_default) ||
+        !conf_set) {
+        master_config.hot_key_extra_replicas = FLAGS_hot_key_extra_replicas;
+    }
     if ((google::GetCommandLineFlagInfo("enable_ha", &info) &&
          !info.is_default) ||
         !conf_set) {
@@ -358,10 +438,18 @@ int main(int argc, char* argv[]) {
             << "Etcd endpoints are set but will not be used in non-HA mode";
     }
     if (master_config.memory_allocator != "cachelib" &&
-        master_config.memory_allocator != "offset") {
+        master_config.memory_allocator != "offset" &&
+        master_config.memory_allocator != "sharded_offset") {
         LOG(FATAL) << "Invalid memory allocator: "
                    << master_config.memory_allocator
-                   << ", must be 'cachelib' or 'offset'";
+                   << ", must be 'cachelib', 'offset' or 'sharded_offset'";
+        return 1;
+    }
+    if (master_config.put_admission_policy != "always" &&
+        master_config.put_admission_policy != "tinylfu") {
+        LOG(FATAL) << "Invalid put admission policy: "
+                   << master_config.put_admission_policy
+                   << ", must be 'always' or 'tinylfu'";
         return 1;
     }
 
@@ -383,6 +471,18 @@ int main(int argc, char* argv[]) {
               << ", eviction_ratio=" << master_config.eviction_ratio
               << ", eviction_high_watermark_ratio="
               << master_config.eviction_high_watermark_ratio
+              << ", compaction_fragmentation_ratio="
+              << master_config.compaction_fragmentation_ratio
+              << ", num_metadata_shards=" << master_config.num_metadata_shards
+              << ", hex_key_shard_hash=" << master_config.hex_key_shard_hash
+              << ", enable_inline_eviction="
+              << master_config.enable_inline_eviction
+              << ", put_admission_policy="
+              << master_config.put_admission_policy
+              << ", hot_key_read_threshold="
+              << master_config.hot_key_read_threshold
+              << ", hot_key_extra_replicas="
+              << master_config.hot_key_extra_replicas
               << ", enable_ha=" << master_config.enable_ha
               << ", etcd_endpoints=" << master_config.etcd_endpoints
               << ", client_ttl=" << master_config.client_live_ttl_sec
@@ -39,6 +39,16 @@ struct RpcNameTraits<&WrappedMasterService::GetReplicaListByRegex> {
     static constexpr const char* value = "GetReplicaListByRegex";
 };
 
+template <>
+struct RpcNameTraits<&WrappedMasterService::GetReplicaListByPrefix> {
+    static constexpr const char* value = "GetReplicaListByPrefix";
+};
+
+template <>
+struct RpcNameTraits<&WrappedMasterService::ScanKeys> {
+    static constexpr const char* value = "ScanKeys";
+};
+
 template <>
 struct RpcNameTraits<&WrappedMasterService::BatchGetReplicaList> {
     static constexpr const char* value = "BatchGetReplicaList";
@@ -84,6 +94,11 @@ struct RpcNameTraits<&WrappedMasterService::RemoveByRegex> {
     static constexpr const char* value = "RemoveByRegex";
 };
 
+template <>
+struct RpcNameTraits<&WrappedMasterService::RemoveByPrefix> {
+    static constexpr const char* value = "RemoveByPrefix";
+};
+
 template <>
 struct RpcNameTraits<&WrappedMasterService::RemoveAll> {
     static constexpr const char* value = "RemoveAll";
@@ -109,6 +124,21 @@ struct RpcNameTraits<&WrappedMasterService::Ping> {
     static constexpr const char* value = "Ping";
 };
 
+template <>
+struct RpcNameTraits<&WrappedMasterService::MoveEnd> {
+    static constexpr const char* value = "MoveEnd";
+};
+
+template <>
+struct RpcNameTraits<&WrappedMasterService::SetNamespaceQuota> {
+    static constexpr const char* value = "SetNamespaceQuota";
+};
+
+template <>
+struct RpcNameTraits<&WrappedMasterService::DropNamespace> {
+    static constexpr const char* value = "DropNamespace";
+};
+
 template <>
 struct RpcNameTraits<&WrappedMasterService::GetFsdir> {
     static constexpr const char* value = "GetFsdir";
@@ -120,7 +150,8 @@ struct RpcNameTraits<&WrappedMasterService::ServiceReady> {
 };
 
 template <auto ServiceMethod, typename ReturnType, typename... Args>
-tl::expected<ReturnType, ErrorCode> MasterClient::invoke_rpc(Args&&... args) {
+async_simple::coro::Lazy<tl::expected<ReturnType, ErrorCode>>
+MasterClient::invoke_rpc_async(Args&&... args) {
     auto pool = client_accessor_.GetClientPool();
 
     // Increment RPC counter
@@ -129,38 +160,40 @@ tl::expected<ReturnType, ErrorCode> MasterClient::invoke_rpc(Args&&... args) {
     }
 
     auto start_time = std::chrono::steady_clock::now();
+    auto ret = co_await pool->send_request(
+        [&](coro_io::client_reuse_hint, coro_rpc::coro_rpc_client& client) {
+            return client.send_request<ServiceMethod>(
+                std::forward<Args>(args)...);
+        });
+    if (!ret.has_value()) {
+        LOG(ERROR) << "Client not available";
+        co_return tl::make_unexpected(ErrorCode::RPC_FAIL);
+    }
+    auto result = co_await std::move(ret.value());
+    if (!result) {
+        LOG(ERROR) << "RPC call failed: " << result.error().msg;
+        co_return tl::make_unexpected(ErrorCode::RPC_FAIL);
+    }
+    if (metrics_) {
+        auto end_time = std::chrono::steady_clock::now();
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            end_time - start_time);
+        metrics_->rpc_latency.observe({RpcNameTraits<ServiceMethod>::value},
+                                      latency.count());
+    }
+    co_return result->result();
+}
+
+template <auto ServiceMethod, typename ReturnType, typename... Args>
+tl::expected<ReturnType, ErrorCode> MasterClient::invoke_rpc(Args&&... args) {
     return async_simple::coro::syncAwait(
-        [&]() -> async_simple::coro::Lazy<tl::expected<ReturnType, ErrorCode>> {
-            auto ret = co_await pool->send_request(
-                [&](coro_io::client_reuse_hint,
-                    coro_rpc::coro_rpc_client& client) {
-                    return client.send_request<ServiceMethod>(
-                        std::forward<Args>(args)...);
-                });
-            if (!ret.has_value()) {
-                LOG(ERROR) << "Client not available";
-                co_return tl::make_unexpected(ErrorCode::RPC_FAIL);
-            }
-            auto result = co_await std::move(ret.value());
-            if (!result) {
-                LOG(ERROR) << "RPC call failed: " << result.error().msg;
-                co_return tl::make_unexpected(ErrorCode::RPC_FAIL);
-            }
-            if (metrics_) {
-                auto end_time = std::chrono::steady_clock::now();
-                auto latency =
-                    std::chrono::duration_cast<std::chrono::microseconds>(
-                        end_time - start_time);
-                metrics_->rpc_latency.observe(
-                    {RpcNameTraits<ServiceMethod>::value}, latency.count());
-            }
-            co_return result->result();
-        }());
+        invoke_rpc_async<ServiceMethod, ReturnType>(
+            std::forward<Args>(args)...));
 }
 
 template <auto ServiceMethod, typename ResultType, typename... Args>
-std::vector<tl::expected<ResultType, ErrorCode>> MasterClient::invoke_batch_rpc(
-    size_t input_size, Args&&... args) {
+async_simple::coro::Lazy<std::vector<tl::expected<ResultType, ErrorCode>>>
+MasterClient::invoke_batch_rpc_async(size_t input_size, Args&&... args) {
     auto pool = client_accessor_.GetClientPool();
 
     // Increment RPC counter
@@ -169,41 +202,43 @@ std::vector<tl::expected<ResultType, ErrorCode>> MasterClient::invoke_batch_rpc(
     }
 
     auto start_time = std::chrono::steady_clock::now();
+    auto ret = co_await pool->send_request(
+        [&](coro_io::client_reuse_hint, coro_rpc::coro_rpc_client& client) {
+            return client.send_request<ServiceMethod>(
+                std::forward<Args>(args)...);
+        });
+    if (!ret.has_value()) {
+        LOG(ERROR) << "Client not available";
+        co_return std::vector<tl::expected<ResultType, ErrorCode>>(
+            input_size, tl::make_unexpected(ErrorCode::RPC_FAIL));
+    }
+    auto result = co_await std::move(ret.value());
+    if (!result) {
+        LOG(ERROR) << "Batch RPC call failed: " << result.error().msg;
+        std::vector<tl::expected<ResultType, ErrorCode>> error_results;
+        error_results.reserve(input_size);
+        for (size_t i = 0; i < input_size; ++i) {
+            error_results.emplace_back(
+                tl::make_unexpected(ErrorCode::RPC_FAIL));
+        }
+        co_return error_results;
+    }
+    if (metrics_) {
+        auto end_time = std::chrono::steady_clock::now();
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            end_time - start_time);
+        metrics_->rpc_latency.observe({RpcNameTraits<ServiceMethod>::value},
+                                      latency.count());
+    }
+    co_return result->result();
+}
+
+template <auto ServiceMethod, typename ResultType, typename... Args>
+std::vector<tl::expected<ResultType, ErrorCode>> MasterClient::invoke_batch_rpc(
+    size_t input_size, Args&&... args) {
     return async_simple::coro::syncAwait(
-        [&]() -> async_simple::coro::Lazy<
-                  std::vector<tl::expected<ResultType, ErrorCode>>> {
-            auto ret = co_await pool->send_request(
-                [&](coro_io::client_reuse_hint,
-                    coro_rpc::coro_rpc_client& client) {
-                    return client.send_request<ServiceMethod>(
-                        std::forward<Args>(args)...);
-                });
-            if (!ret.has_value()) {
-                LOG(ERROR) << "Client not available";
-                co_return std::vector<tl::expected<ResultType, ErrorCode>>(
-                    input_size, tl::make_unexpected(ErrorCode::RPC_FAIL));
-            }
-            auto result = co_await std::move(ret.value());
-            if (!result) {
-                LOG(ERROR) << "Batch RPC call failed: " << result.error().msg;
-                std::vector<tl::expected<ResultType, ErrorCode>> error_results;
-                error_results.reserve(input_size);
-                for (size_t i = 0; i < input_size; ++i) {
-                    error_results.emplace_back(
-                        tl::make_unexpected(ErrorCode::RPC_FAIL));
-                }
-                co_return error_results;
-            }
-            if (metrics_) {
-                auto end_time = std::chrono::steady_clock::now();
-                auto latency =
-                    std::chrono::duration_cast<std::chrono::microseconds>(
-                        end_time - start_time);
-                metrics_->rpc_latency.observe(
-                    {RpcNameTraits<ServiceMethod>::value}, latency.count());
-            }
-            co_return result->result();
-        }());
+        invoke_batch_rpc_async<ServiceMethod, ResultType>(
+            input_size, std::forward<Args>(args)...));
 }
 
 MasterClient::~MasterClient() = default;
@@ -267,6 +302,33 @@ MasterClient::GetReplicaListByRegex(const std::string& str) {
     return result;
 }
 
+tl::expected<std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+             ErrorCode>
+MasterClient::GetReplicaListByPrefix(const std::string& prefix) {
+    ScopedVLogTimer timer(1, "MasterClient::GetReplicaListByPrefix");
+    timer.LogRequest("prefix=", prefix);
+
+    auto result = invoke_rpc<
+        &WrappedMasterService::GetReplicaListByPrefix,
+        std::unordered_map<std::string, std::vector<Replica::Descriptor>>>(
+        prefix);
+
+    timer.LogResponseExpected(result);
+    return result;
+}
+
+tl::expected<ScanKeysResponse, ErrorCode> MasterClient::ScanKeys(
+    const std::string& cursor, uint64_t limit, const std::string& prefix) {
+    ScopedVLogTimer timer(1, "MasterClient::ScanKeys");
+    timer.LogRequest("cursor=", cursor, ", limit=", limit,
+                     ", prefix=", prefix);
+
+    auto result = invoke_rpc<&WrappedMasterService::ScanKeys, ScanKeysResponse>(
+        cursor, limit, prefix);
+    timer.LogResponseExpected(result);
+    return result;
+}
+
 tl::expected<GetReplicaListResponse, ErrorCode> MasterClient::GetReplicaList(
     const std::string& object_key) {
     ScopedVLogTimer timer(1, "MasterClient::GetReplicaList");
@@ -370,6 +432,68 @@ std::vector<tl::expected<void, ErrorCode>> MasterClient::BatchPutRevoke(
     return result;
 }
 
+async_simple::coro::Lazy<tl::expected<GetReplicaListResponse, ErrorCode>>
+MasterClient::GetReplicaListAsync(const std::string& object_key) {
+    co_return co_await invoke_rpc_async<&WrappedMasterService::GetReplicaList,
+                                        GetReplicaListResponse>(object_key);
+}
+
+async_simple::coro::Lazy<
+    std::vector<tl::expected<GetReplicaListResponse, ErrorCode>>>
+MasterClient::BatchGetReplicaListAsync(
+    const std::vector<std::string>& object_keys) {
+    co_return co_await invoke_batch_rpc_async<
+        &WrappedMasterService::BatchGetReplicaList, GetReplicaListResponse>(
+        object_keys.size(), object_keys);
+}
+
+async_simple::coro::Lazy<
+    tl::expected<std::vector<Replica::Descriptor>, ErrorCode>>
+MasterClient::PutStartAsync(const std::string& key,
+                            const std::vector<size_t>& slice_lengths,
+                            const ReplicateConfig& config) {
+    std::vector<uint64_t> rpc_slice_lengths(slice_lengths.begin(),
+                                            slice_lengths.end());
+    co_return co_await invoke_rpc_async<&WrappedMasterService::PutStart,
+                                        std::vector<Replica::Descriptor>>(
+        key, rpc_slice_lengths, config);
+}
+
+async_simple::coro::Lazy<
+    std::vector<tl::expected<std::vector<Replica::Descriptor>, ErrorCode>>>
+MasterClient::BatchPutStartAsync(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint64_t>>& slice_lengths,
+    const ReplicateConfig& config) {
+    co_return co_await invoke_batch_rpc_async<
+        &WrappedMasterService::BatchPutStart, std::vector<Replica::Descriptor>>(
+        keys.size(), keys, slice_lengths, config);
+}
+
+async_simple::coro::Lazy<tl::expected<void, ErrorCode>>
+MasterClient::PutEndAsync(const std::string& key, ReplicaType replica_type) {
+    co_return co_await invoke_rpc_async<&WrappedMasterService::PutEnd, void>(
+        key, replica_type);
+}
+
+async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+MasterClient::BatchPutEndAsync(const std::vector<std::string>& keys) {
+    co_return co_await invoke_batch_rpc_async<
+        &WrappedMasterService::BatchPutEnd, void>(keys.size(), keys);
+}
+
+async_simple::coro::Lazy<tl::expected<void, ErrorCode>>
+MasterClient::PutRevokeAsync(const std::string& key, ReplicaType replica_type) {
+    co_return co_await invoke_rpc_async<&WrappedMasterService::PutRevoke, void>(
+        key, replica_type);
+}
+
+async_simple::coro::Lazy<std::vector<tl::expected<void, ErrorCode>>>
+MasterClient::BatchPutRevokeAsync(const std::vector<std::string>& keys) {
+    co_return co_await invoke_batch_rpc_async<
+        &WrappedMasterService::BatchPutRevoke, void>(keys.size(), keys);
+}
+
 tl::expected<void, ErrorCode> MasterClient::Remove(const std::string& key) {
     ScopedVLogTimer timer(1, "MasterClient::Remove");
     timer.LogRequest("key=", key);
@@ -389,6 +513,17 @@ tl::expected<long, ErrorCode> MasterClient::RemoveByRegex(
     return result;
 }
 
+tl::expected<long, ErrorCode> MasterClient::RemoveByPrefix(
+    const std::string& prefix) {
+    ScopedVLogTimer timer(1, "MasterClient::RemoveByPrefix");
+    timer.LogRequest("prefix=", prefix);
+
+    auto result =
+        invoke_rpc<&WrappedMasterService::RemoveByPrefix, long>(prefix);
+    timer.LogResponseExpected(result);
+    return result;
+}
+
 tl::expected<long, ErrorCode> MasterClient::RemoveAll() {
     ScopedVLogTimer timer(1, "MasterClient::RemoveAll");
     timer.LogRequest("action=remove_all_objects");
@@ -445,6 +580,40 @@ tl::expected<PingResponse, ErrorCode> MasterClient::Ping(
     return result;
 }
 
+tl::expected<void, ErrorCode> MasterClient::MoveEnd(const UUID& client_id,
+                                                    uint64_t task_id,
+                                                    bool success) {
+    ScopedVLogTimer timer(1, "MasterClient::MoveEnd");
+    timer.LogRequest("client_id=", client_id, ", task_id=", task_id,
+                     ", success=", success);
+
+    auto result = invoke_rpc<&WrappedMasterService::MoveEnd, void>(
+        client_id, task_id, success);
+    timer.LogResponseExpected(result);
+    return result;
+}
+
+tl::expected<void, ErrorCode> MasterClient::SetNamespaceQuota(
+    const std::string& name, uint64_t quota) {
+    ScopedVLogTimer timer(1, "MasterClient::SetNamespaceQuota");
+    timer.LogRequest("name=", name, ", quota=", quota);
+
+    auto result = invoke_rpc<&WrappedMasterService::SetNamespaceQuota, void>(
+        name, quota);
+    timer.LogResponseExpected(result);
+    return result;
+}
+
+tl::expected<void, ErrorCode> MasterClient::DropNamespace(
+    const std::string& name) {
+    ScopedVLogTimer timer(1, "MasterClient::DropNamespace");
+    timer.LogRequest("name=", name);
+
+    auto result = invoke_rpc<&WrappedMasterService::DropNamespace, void>(name);
+    timer.LogResponseExpected(result);
+    return result;
+}
+
 tl::expected<std::string, ErrorCode> MasterClient::GetFsdir() {
     ScopedVLogTimer timer(1, "MasterClient::GetFsdir");
     timer.LogRequest("action=get_fsdir");
@@ -23,6 +23,9 @@ MasterMetricManager::MasterMetricManager()
           "Total memory bytes currently allocated across all segments"),
       mem_total_capacity_("master_total_capacity_bytes",
                           "Total memory capacity across all mounted segments"),
+      mem_fragmented_size_(
+          "master_fragmented_bytes",
+          "Free memory bytes outside the largest free region of each segment"),
       file_total_capacity_("master_total_file_capacity_bytes",
                            "Total capacity for file storage in 3fs/nfs"),
       file_allocated_size_(
@@ -66,6 +69,12 @@ MasterMetricManager::MasterMetricManager()
       get_replica_list_by_regex_failures_(
           "master_get_replica_list_by_regex_failures_total",
           "Total number of failed GetReplicaListByRegex requests"),
+      get_replica_list_by_prefix_requests_(
+          "master_get_replica_list_by_prefix_requests_total",
+          "Total number of GetReplicaListByPrefix requests received"),
+      get_replica_list_by_prefix_failures_(
+          "master_get_replica_list_by_prefix_failures_total",
+          "Total number of failed GetReplicaListByPrefix requests"),
       exist_key_requests_("master_exist_key_requests_total",
                           "Total number of ExistKey requests received"),
       exist_key_failures_("master_exist_key_failures_total",
@@ -80,6 +89,12 @@ MasterMetricManager::MasterMetricManager()
       remove_by_regex_failures_(
           "master_remove_by_regex_failures_total",
           "Total number of failed RemoveByRegex requests"),
+      remove_by_prefix_requests_(
+          "master_remove_by_prefix_requests_total",
+          "Total number of RemoveByPrefix requests received"),
+      remove_by_prefix_failures_(
+          "master_remove_by_prefix_failures_total",
+          "Total number of failed RemoveByPrefix requests"),
       remove_all_requests_("master_remove_all_requests_total",
                            "Total number of Remove all requests received"),
       remove_all_failures_("master_remove_all_failures_total",
@@ -189,7 +204,68 @@ MasterMetricManager::MasterMetricManager()
       evicted_key_count_("master_evicted_key_count",
                          "Total number of keys evicted"),
       evicted_size_("master_evicted_size_bytes",
-                    "Total bytes of evicted objects") {}
+                    "Total bytes of evicted objects"),
+      put_admission_rejections_(
+          "master_put_admission_rejections_total",
+          "Total number of puts turned away by the put admission policy"),
+
+      // Initialize Dedup Counters
+      dedup_puts_("master_dedup_puts_total",
+                  "Total number of puts sharing the replicas of the same "
+                  "content"),
+      dedup_saved_size_("master_dedup_saved_bytes_total",
+                        "Total bytes not allocated by puts sharing the "
+                        "replicas of the same content"),
+
+      // Initialize Hot Key Counters
+      hot_key_replicas_added_(
+          "master_hot_key_replicas_added_total",
+          "Total number of replicas added for heavily read objects"),
+      hot_key_replicas_dropped_(
+          "master_hot_key_replicas_dropped_total",
+          "Total number of replicas of heavily read objects dropped once "
+          "they cooled down"),
+
+      // Initialize Compaction Counters
+      compaction_success_("master_successful_compactions_total",
+                          "Total number of objects moved by compaction"),
+      compaction_attempts_("master_attempted_compactions_total",
+                           "Total number of attempted compaction moves"),
+      compacted_size_("master_compacted_size_bytes",
+                      "Total bytes of objects moved by compaction"),
+
+      // Initialize Namespace Metrics
+      namespace_used_size_(
+          "master_namespace_used_bytes",
+          "Memory bytes used by the objects of each namespace", {"namespace"}),
+      namespace_quota_("master_namespace_quota_bytes",
+                       "Memory quota of each namespace, 0 for none",
+                       {"namespace"}),
+      namespace_key_count_("master_namespace_key_count",
+                           "Number of keys in each namespace", {"namespace"}),
+      namespace_evicted_key_count_(
+          "master_namespace_evicted_key_count",
+          "Total number of keys evicted from each namespace", {"namespace"}),
+      namespace_quota_rejections_(
+          "master_namespace_quota_rejections_total",
+          "Total number of PutStart requests rejected by the namespace quota",
+          {"namespace"}),
+      shard_lock_wait_us_(
+          "master_shard_lock_wait_microseconds",
+          "Sampled time spent waiting for the locks of the metadata shards",
+          {1, 4, 16, 64, 256, 1024, 4096, 16384, 65536}),
+      shard_lock_hold_us_(
+          "master_shard_lock_hold_microseconds",
+          "Sampled time the locks of the metadata shards are held",
+          {1, 4, 16, 64, 256, 1024, 4096, 16384, 65536}),
+      shard_lock_wait_max_us_(
+          "master_shard_lock_wait_max_microseconds",
+          "Sampled lock wait of the most contended metadata shard since the "
+          "previous scrape"),
+      shard_lock_wait_max_shard_(
+          "master_shard_lock_wait_max_shard",
+          "Index of the most contended metadata shard since the previous "
+          "scrape") {}
 
 // --- Metric Interface Methods ---
 
@@ -225,6 +301,23 @@ double MasterMetricManager::get_global_mem_used_ratio(void) {
     return allocated / capacity;
 }
 
+void MasterMetricManager::set_fragmented_mem_size(int64_t val) {
+    mem_fragmented_size_.update(val);
+}
+
+int64_t MasterMetricManager::get_fragmented_mem_size() {
+    return mem_fragmented_size_.value();
+}
+
+double MasterMetricManager::get_global_mem_fragmentation_ratio(void) {
+    double fragmented = mem_fragmented_size_.value();
+    double free = mem_total_capacity_.value() - mem_allocated_size_.value();
+    if (free <= 0) {
+        return 0.0;
+    }
+    return fragmented / free;
+}
+
 // File Storage Metrics
 void MasterMetricManager::inc_allocated_file_size(int64_t val) {
     file_allocated_size_.inc(val);
@@ -328,6 +421,12 @@ void MasterMetricManager::inc_get_replica_list_by_regex_requests(int64_t val) {
 void MasterMetricManager::inc_get_replica_list_by_regex_failures(int64_t val) {
     get_replica_list_by_regex_failures_.inc(val);
 }
+void MasterMetricManager::inc_get_replica_list_by_prefix_requests(int64_t val) {
+    get_replica_list_by_prefix_requests_.inc(val);
+}
+void MasterMetricManager::inc_get_replica_list_by_prefix_failures(int64_t val) {
+    get_replica_list_by_prefix_failures_.inc(val);
+}
 void MasterMetricManager::inc_remove_requests(int64_t val) {
     remove_requests_.inc(val);
 }
@@ -340,6 +439,12 @@ void MasterMetricManager::inc_remove_by_regex_requests(int64_t val) {
 void MasterMetricManager::inc_remove_by_regex_failures(int64_t val) {
     remove_by_regex_failures_.inc(val);
 }
+void MasterMetricManager::inc_remove_by_prefix_requests(int64_t val) {
+    remove_by_prefix_requests_.inc(val);
+}
+void MasterMetricManager::inc_remove_by_prefix_failures(int64_t val) {
+    remove_by_prefix_failures_.inc(val);
+}
 void MasterMetricManager::inc_remove_all_requests(int64_t val) {
     remove_all_requests_.inc(val);
 }
@@ -479,6 +584,14 @@ int64_t MasterMetricManager::get_get_replica_list_by_regex_failures() {
     return get_replica_list_by_regex_failures_.value();
 }
 
+int64_t MasterMetricManager::get_get_replica_list_by_prefix_requests() {
+    return get_replica_list_by_prefix_requests_.value();
+}
+
+int64_t MasterMetricManager::get_get_replica_list_by_prefix_failures() {
+    return get_replica_list_by_prefix_failures_.value();
+}
+
 int64_t MasterMetricManager::get_exist_key_requests() {
     return exist_key_requests_.value();
 }
@@ -495,6 +608,14 @@ int64_t MasterMetricManager::get_remove_by_regex_failures() {
     return remove_by_regex_failures_.value();
 }
 
+int64_t MasterMetricManager::get_remove_by_prefix_requests() {
+    return remove_by_prefix_requests_.value();
+}
+
+int64_t MasterMetricManager::get_remove_by_prefix_failures() {
+    return remove_by_prefix_failures_.value();
+}
+
 int64_t MasterMetricManager::get_remove_requests() {
     return remove_requests_.value();
 }
@@ -670,6 +791,132 @@ int64_t MasterMetricManager::get_evicted_size() {
     return evicted_size_.value();
 }
 
+// Admission Metrics
+void MasterMetricManager::inc_put_admission_rejections() {
+    put_admission_rejections_.inc();
+}
+
+int64_t MasterMetricManager::get_put_admission_rejections() {
+    return put_admission_rejections_.value();
+}
+
+// Dedup Metrics
+void MasterMetricManager::inc_dedup_puts(int64_t saved_size) {
+    dedup_puts_.inc();
+    dedup_saved_size_.inc(saved_size);
+}
+
+int64_t MasterMetricManager::get_dedup_puts() {
+    return dedup_puts_.value();
+}
+
+int64_t MasterMetricManager::get_dedup_saved_size() {
+    return dedup_saved_size_.value();
+}
+
+// Hot Key Metrics
+void MasterMetricManager::inc_hot_key_replicas_added(int64_t count) {
+    hot_key_replicas_added_.inc(count);
+}
+
+void MasterMetricManager::inc_hot_key_replicas_dropped(int64_t count) {
+    hot_key_replicas_dropped_.inc(count);
+}
+
+int64_t MasterMetricManager::get_hot_key_replicas_added() {
+    return hot_key_replicas_added_.value();
+}
+
+int64_t MasterMetricManager::get_hot_key_replicas_dropped() {
+    return hot_key_replicas_dropped_.value();
+}
+
+// Compaction Metrics
+void MasterMetricManager::inc_compaction_success(int64_t size) {
+    compacted_size_.inc(size);
+    compaction_success_.inc();
+    compaction_attempts_.inc();
+}
+
+void MasterMetricManager::inc_compaction_fail() { compaction_attempts_.inc(); }
+
+int64_t MasterMetricManager::get_compaction_success() {
+    return compaction_success_.value();
+}
+
+int64_t MasterMetricManager::get_compaction_attempts() {
+    return compaction_attempts_.value();
+}
+
+int64_t MasterMetricManager::get_compacted_size() {
+    return compacted_size_.value();
+}
+
+// Namespace Metrics
+void MasterMetricManager::set_namespace_usage(const std::string& name,
+                                              int64_t used_size, int64_t quota,
+                                              int64_t key_count) {
+    namespace_used_size_.update({name}, used_size);
+    namespace_quota_.update({name}, quota);
+    namespace_key_count_.update({name}, key_count);
+}
+
+void MasterMetricManager::inc_namespace_evicted_keys(const std::string& name,
+                                                     int64_t val) {
+    namespace_evicted_key_count_.inc({name}, val);
+}
+
+void MasterMetricManager::inc_namespace_quota_rejections(
+    const std::string& name, int64_t val) {
+    namespace_quota_rejections_.inc({name}, val);
+}
+
+// Metadata Shard Metrics
+void MasterMetricManager::observe_shard_lock_wait(size_t shard,
+                                                  int64_t wait_us) {
+    shard_lock_wait_us_.observe(wait_us);
+    shard_lock_wait_sum_us_[shard % kMaxTrackedShards].fetch_add(
+        wait_us, std::memory_order_relaxed);
+}
+
+void MasterMetricManager::observe_shard_lock_hold(size_t shard,
+                                                  int64_t hold_us) {
+    shard_lock_hold_us_.observe(hold_us);
+}
+
+void MasterMetricManager::update_max_shard_lock_wait() {
+    int64_t max_wait_us = 0;
+    size_t max_shard = 0;
+    for (size_t i = 0; i < kMaxTrackedShards; ++i) {
+        int64_t wait_us =
+            shard_lock_wait_sum_us_[i].exchange(0, std::memory_order_relaxed);
+        if (wait_us > max_wait_us) {
+            max_wait_us = wait_us;
+            max_shard = i;
+        }
+    }
+    shard_lock_wait_max_us_.update(max_wait_us);
+    shard_lock_wait_max_shard_.update(static_cast<int64_t>(max_shard));
+}
+
+int64_t MasterMetricManager::get_namespace_used_size(const std::string& name) {
+    return namespace_used_size_.value({name});
+}
+
+int64_t MasterMetricManager::get_namespace_key_count(const std::string& name) {
+    return namespace_key_count_.value({name});
+}
+
+int64_t MasterMetricManager::get_namespace_evicted_keys(
+    const std::string& name) {
+    return namespace_evicted_key_count_.value({name});
+}
+
+int64_t MasterMetricManager::get_namespace_quota_rejections(
+    const std::string& name) {
+    return namespace_quota_rejections_.value({name});
+}
+
 // --- Setters ---
 void MasterMetricManager::set_enable_ha(bool enable_ha) {
     enable_ha_ = enable_ha;
@@ -692,6 +939,7 @@ std::string MasterMetricManager::serialize_metrics() {
     // Serialize Gauges
     serialize_metric(mem_allocated_size_);
     serialize_metric(mem_total_capacity_);
+    serialize_metric(mem_fragmented_size_);
     serialize_metric(file_allocated_size_);
     serialize_metric(file_total_capacity_);
     serialize_metric(key_count_);
@@ -716,10 +964,14 @@ std::string MasterMetricManager::serialize_metrics() {
     serialize_metric(get_replica_list_failures_);
     serialize_metric(get_replica_list_by_regex_requests_);
     serialize_metric(get_replica_list_by_regex_failures_);
+    serialize_metric(get_replica_list_by_prefix_requests_);
+    serialize_metric(get_replica_list_by_prefix_failures_);
     serialize_metric(remove_requests_);
     serialize_metric(remove_failures_);
     serialize_metric(remove_by_regex_requests_);
     serialize_metric(remove_by_regex_failures_);
+    serialize_metric(remove_by_prefix_requests_);
+    serialize_metric(remove_by_prefix_failures_);
     serialize_metric(remove_all_requests_);
     serialize_metric(remove_all_failures_);
     serialize_metric(mount_segment_requests_);
@@ -750,6 +1002,34 @@ std::string MasterMetricManager::serialize_metrics() {
     serialize_metric(eviction_attempts_);
     serialize_metric(evicted_key_count_);
     serialize_metric(evicted_size_);
+    serialize_metric(put_admission_rejections_);
+
+    // Serialize Dedup Counters
+    serialize_metric(dedup_puts_);
+    serialize_metric(dedup_saved_size_);
+
+    // Serialize Hot Key Counters
+    serialize_metric(hot_key_replicas_added_);
+    serialize_metric(hot_key_replicas_dropped_);
+
+    // Serialize Compaction Counters
+    serialize_metric(compaction_success_);
+    serialize_metric(compaction_attempts_);
+    serialize_metric(compacted_size_);
+
+    // Serialize Namespace Metrics
+    serialize_metric(namespace_used_size_);
+    serialize_metric(namespace_quota_);
+    serialize_metric(namespace_key_count_);
+    serialize_metric(namespace_evicted_key_count_);
+    serialize_metric(namespace_quota_rejections_);
+
+    // Serialize Metadata Shard Metrics
+    update_max_shard_lock_wait();
+    serialize_metric(shard_lock_wait_us_);
+    serialize_metric(shard_lock_hold_us_);
+    serialize_metric(shard_lock_wait_max_us_);
+    serialize_metric(shard_lock_wait_max_shard_);
 
     return ss.str();
 }
@@ -761,6 +1041,7 @@ std::string MasterMetricManager::get_summary_string() {
     // --- Get current values ---
     int64_t mem_allocated = mem_allocated_size_.value();
     int64_t mem_capacity = mem_total_capacity_.value();
+    int64_t mem_fragmented = mem_fragmented_size_.value();
     int64_t file_allocated = file_allocated_size_.value();
     int64_t file_capacity = file_total_capacity_.value();
     int64_t keys = key_count_.value();
@@ -828,6 +1109,11 @@ std::string MasterMetricManager::get_summary_string() {
     int64_t evicted_key_count = evicted_key_count_.value();
     int64_t evicted_size = evicted_size_.value();
 
+    // Compaction counters
+    int64_t compaction_success = compaction_success_.value();
+    int64_t compaction_attempts = compaction_attempts_.value();
+    int64_t compacted_size = compacted_size_.value();
+
     // Ping counters
     int64_t ping = ping_requests_.value();
     int64_t ping_fails = ping_failures_.value();
@@ -839,6 +1125,7 @@ std::string MasterMetricManager::get_summary_string() {
         ss << " (" << std::fixed << std::setprecision(1)
            << ((double)mem_allocated / (double)mem_capacity * 100.0) << "%)";
     }
+    ss << " | Mem Fragmented: " << byte_size_to_string(mem_fragmented);
     ss << " | SSD Storage: " << byte_size_to_string(file_allocated) << " / "
        << byte_size_to_string(file_capacity);
     ss << " | Keys: " << keys << " (soft-pinned: " << soft_pin_keys << ")";
@@ -907,6 +1194,11 @@ std::string MasterMetricManager::get_summary_string() {
        << eviction_attempts << ", " << "keys=" << evicted_key_count << ", "
        << "size=" << byte_size_to_string(evicted_size);
 
+    // Compaction summary
+    ss << " | Compaction: " << "Success/Attempts=" << compaction_success
+       << "/" << compaction_attempts << ", "
+       << "size=" << byte_size_to_string(compacted_size);
+
     return ss.str();
 }
 
@@ -1,7 +1,9 @@
 #include "master_service.h"
 
 #include <cassert>
+#include <charconv>
 #include <cstdint>
+#include <queue>
 #include <shared_mutex>
 #include <regex>
 #include <ylt/util/tl/expected.hpp>
@@ -9,17 +11,34 @@
 #include "master_metric_manager.h"
 #include "segment.h"
 #include "types.h"
+#include "utils.h"
 
 namespace mooncake {
 
+static std::shared_ptr<AdmissionPolicy> CreateAdmissionPolicy(
+    PutAdmissionPolicy policy) {
+    if (policy == PutAdmissionPolicy::TINY_LFU) {
+        return std::make_shared<TinyLFUAdmissionPolicy>();
+    }
+    return std::make_shared<AlwaysAdmissionPolicy>();
+}
+
 MasterService::MasterService() : MasterService(MasterServiceConfig()) {}
 
 MasterService::MasterService(const MasterServiceConfig& config)
-    : default_kv_lease_ttl_(config.default_kv_lease_ttl),
+    : hex_key_shard_hash_(config.hex_key_shard_hash),
+      metadata_shards_(config.num_metadata_shards),
+      default_kv_lease_ttl_(config.default_kv_lease_ttl),
       default_kv_soft_pin_ttl_(config.default_kv_soft_pin_ttl),
       allow_evict_soft_pinned_objects_(config.allow_evict_soft_pinned_objects),
+      lease_clock_start_(std::chrono::steady_clock::now()),
       eviction_ratio_(config.eviction_ratio),
       eviction_high_watermark_ratio_(config.eviction_high_watermark_ratio),
+      enable_inline_eviction_(config.enable_inline_eviction),
+      admission_policy_(CreateAdmissionPolicy(config.put_admission_policy)),
+      compaction_fragmentation_ratio_(config.compaction_fragmentation_ratio),
+      hot_key_read_threshold_(config.hot_key_read_threshold),
+      hot_key_extra_replicas_(config.hot_key_extra_replicas),
       client_live_ttl_sec_(config.client_live_ttl_sec),
       enable_ha_(config.enable_ha),
       cluster_id_(config.cluster_id),
@@ -40,11 +59,35 @@ MasterService::MasterService(const MasterServiceConfig& config)
             << "current value: " << eviction_high_watermark_ratio_;
         throw std::invalid_argument("Invalid eviction high watermark ratio");
     }
+    if (compaction_fragmentation_ratio_ < 0.0 ||
+        compaction_fragmentation_ratio_ > 1.0) {
+        LOG(ERROR)
+            << "Compaction fragmentation ratio must be between 0.0 and 1.0, "
+            << "current value: " << compaction_fragmentation_ratio_;
+        throw std::invalid_argument("Invalid compaction fragmentation ratio");
+    }
+    if (metadata_shards_.empty()) {
+        LOG(ERROR) << "Number of metadata shards must be positive";
+        throw std::invalid_argument("Invalid number of metadata shards");
+    }
+    for (size_t i = 0; i < metadata_shards_.size(); ++i) {
+        metadata_shards_[i].index = i;
+    }
+    if (hot_key_read_threshold_ > 0) {
+        read_sketch_ = std::make_unique<FrequencySketch>();
+    }
+
+    default_namespace_ = GetNamespace("");
 
     eviction_running_ = true;
     eviction_thread_ = std::thread(&MasterService::EvictionThreadFunc, this);
     VLOG(1) << "action=start_eviction_thread";
 
+    compaction_running_ = true;
+    compaction_thread_ =
+        std::thread(&MasterService::CompactionThreadFunc, this);
+    VLOG(1) << "action=start_compaction_thread";
+
     // Start client monitor thread in all modes so TTL/heartbeat works
     client_monitor_running_ = true;
     client_monitor_thread_ =
@@ -61,10 +104,14 @@ MasterService::MasterService(const MasterServiceConfig& config)
 MasterService::~MasterService() {
     // Stop and join the threads
     eviction_running_ = false;
+    compaction_running_ = false;
     client_monitor_running_ = false;
     if (eviction_thread_.joinable()) {
         eviction_thread_.join();
     }
+    if (compaction_thread_.joinable()) {
+        compaction_thread_.join();
+    }
     if (client_monitor_thread_.joinable()) {
         client_monitor_thread_.join();
     }
@@ -151,18 +198,43 @@ auto MasterService::ReMountSegment(const std::vector<Segment>& segments,
     return {};
 }
 
-void MasterService::ClearInvalidHandles() {
+void MasterService::ClearInvalidHandles(const UUID& segment_id) {
+    std::vector<std::string> keys;
     for (auto& shard : metadata_shards_) {
-        MutexLocker lock(&shard.mutex);
-        auto it = shard.metadata.begin();
-        while (it != shard.metadata.end()) {
-            if (CleanupStaleHandles(it->second)) {
-                // If the object is empty, we need to erase the iterator
-                it = shard.metadata.erase(it);
-            } else {
-                ++it;
+        {
+            ShardLocker lock(&shard);
+            auto entry = shard.segment_keys.find(segment_id);
+            if (entry == shard.segment_keys.end()) {
+                continue;
+            }
+            keys.assign(entry->second.begin(), entry->second.end());
+        }
+
+        // Release the shard lock between batches so that requests to the
+        // shard are not stalled by a large segment
+        for (size_t begin = 0; begin < keys.size();
+             begin += kUnmountBatchSize) {
+            size_t end = std::min(keys.size(), begin + kUnmountBatchSize);
+            ShardLocker lock(&shard);
+            for (size_t i = begin; i < end; ++i) {
+                auto it = shard.metadata.find(keys[i]);
+                if (it == shard.metadata.end()) {
+                    continue;
+                }
+                // Unindexed along with the stale replicas, the segments of
+                // the remaining ones are indexed again
+                shard.UnindexSegments(it->first, it->second);
+                if (CleanupStaleHandles(it->second)) {
+                    shard.Erase(it);
+                } else {
+                    shard.IndexSegments(it->first, it->second);
+                }
             }
         }
+
+        // No object can have buffers in the segment any more
+        ShardLocker lock(&shard);
+        shard.segment_keys.erase(segment_id);
     }
 }
 
@@ -188,7 +260,7 @@ auto MasterService::UnmountSegment(const UUID& segment_id,
        // deadlocks
 
     // 2. Remove the metadata of the related objects
-    ClearInvalidHandles();
+    ClearInvalidHandles(segment_id);
 
     // 3. Commit the unmount operation
     ScopedSegmentAccess segment_access = segment_manager_.getSegmentAccess();
@@ -202,19 +274,19 @@ auto MasterService::UnmountSegment(const UUID& segment_id,
 
 auto MasterService::ExistKey(const std::string& key)
     -> tl::expected<bool, ErrorCode> {
-    MetadataAccessor accessor(this, key);
-    if (!accessor.Exists()) {
+    MetadataReader reader(this, key);
+    if (!reader.Exists()) {
         VLOG(1) << "key=" << key << ", info=object_not_found";
         return false;
     }
 
-    auto& metadata = accessor.Get();
+    const auto& metadata = reader.Get();
     for (const auto& replica : metadata.replicas) {
-        if (replica.status() == ReplicaStatus::COMPLETE) {
+        if (replica.status() == ReplicaStatus::COMPLETE &&
+            !replica.has_invalid_mem_handle()) {
             // Grant a lease to the object as it may be further used by the
             // client.
-            metadata.GrantLease(default_kv_lease_ttl_,
-                                default_kv_soft_pin_ttl_);
+            GrantReadLease(metadata);
             return true;
         }
     }
@@ -235,15 +307,67 @@ std::vector<tl::expected<bool, ErrorCode>> MasterService::BatchExistKey(
 auto MasterService::GetAllKeys()
     -> tl::expected<std::vector<std::string>, ErrorCode> {
     std::vector<std::string> all_keys;
-    for (size_t i = 0; i < kNumShards; i++) {
-        MutexLocker lock(&metadata_shards_[i].mutex);
-        for (const auto& item : metadata_shards_[i].metadata) {
-            all_keys.push_back(item.first);
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard, shared_lock);
+        for (const auto& item : shard.metadata) {
+            if (!item.second.IsDropped()) {
+                all_keys.push_back(item.first);
+            }
         }
     }
     return all_keys;
 }
 
+auto MasterService::ScanKeys(const std::string& cursor, size_t limit,
+                             const std::string& prefix)
+    -> tl::expected<ScanKeysResponse, ErrorCode> {
+    // The cursor is the shard and the last key of the previous page
+    size_t shard_idx = 0;
+    std::optional<std::string_view> last_key;
+    if (!cursor.empty()) {
+        auto separator = std::min(cursor.find(':'), cursor.size());
+        const char* separator_ptr = cursor.data() + separator;
+        auto [end, ec] =
+            std::from_chars(cursor.data(), separator_ptr, shard_idx);
+        if (separator == cursor.size() || ec != std::errc() ||
+            end != separator_ptr || shard_idx >= metadata_shards_.size()) {
+            LOG(ERROR) << "cursor=" << cursor << ", error=invalid_cursor";
+            return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        last_key = std::string_view(cursor).substr(separator + 1);
+    }
+    if (limit == 0) {
+        LOG(ERROR) << "limit=" << limit << ", error=invalid_params";
+        return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
+    }
+
+    ScanKeysResponse response;
+    size_t last_shard_idx = shard_idx;
+    for (; shard_idx < metadata_shards_.size(); ++shard_idx) {
+        auto& shard = metadata_shards_[shard_idx];
+        ShardLocker lock(&shard, shared_lock);
+        auto it = last_key && *last_key >= prefix
+                      ? shard.ordered_keys.upper_bound(*last_key)
+                      : shard.ordered_keys.lower_bound(prefix);
+        for (; it != shard.ordered_keys.end() && it->first.starts_with(prefix);
+             ++it) {
+            if (it->second->IsDropped()) {
+                continue;
+            }
+            if (response.keys.size() == limit) {
+                response.next_cursor = std::to_string(last_shard_idx) + ":" +
+                                       response.keys.back();
+                return response;
+            }
+            response.keys.emplace_back(it->first);
+            last_shard_idx = shard_idx;
+        }
+        // Later shards are scanned from their first key
+        last_key.reset();
+    }
+    return response;
+}
+
 auto MasterService::GetAllSegments()
     -> tl::expected<std::vector<std::string>, ErrorCode> {
     ScopedSegmentAccess segment_access = segment_manager_.getSegmentAccess();
@@ -266,11 +390,71 @@ auto MasterService::QuerySegments(const std::string& segment)
     return std::make_pair(used, capacity);
 }
 
+auto MasterService::GetNamespace(const std::string& name) -> Namespace* {
+    {
+        std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+        auto it = namespaces_.find(name);
+        if (it != namespaces_.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(namespace_mutex_);
+    auto& ns = namespaces_[name];
+    if (!ns) {
+        ns = std::make_unique<Namespace>(name);
+    }
+    return ns.get();
+}
+
+auto MasterService::SetNamespaceQuota(const std::string& name, uint64_t quota)
+    -> tl::expected<void, ErrorCode> {
+    Namespace* ns = GetNamespace(name);
+    ns->quota = quota;
+    if (!ns->HasRoom(0)) {
+        ns->need_eviction = true;
+        need_namespace_eviction_ = true;
+    }
+    LOG(INFO) << "namespace=" << name << ", quota=" << quota
+              << ", action=set_namespace_quota";
+    return {};
+}
+
+auto MasterService::DropNamespace(const std::string& name)
+    -> tl::expected<void, ErrorCode> {
+    if (name.empty()) {
+        LOG(ERROR) << "The default namespace cannot be dropped";
+        return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
+    }
+
+    std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+    auto it = namespaces_.find(name);
+    if (it == namespaces_.end()) {
+        return {};
+    }
+    // The objects of the previous generations are hidden from now on
+    it->second->generation.fetch_add(1, std::memory_order_relaxed);
+    it->second->need_reclaim = true;
+    need_reclaim_dropped_ = true;
+    LOG(INFO) << "namespace=" << name << ", key_count="
+              << it->second->key_count << ", action=drop_namespace";
+    return {};
+}
+
+auto MasterService::QueryNamespace(const std::string& name)
+    -> tl::expected<std::pair<size_t, size_t>, ErrorCode> {
+    std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+    auto it = namespaces_.find(name);
+    if (it == namespaces_.end()) {
+        return std::make_pair(size_t{0}, size_t{0});
+    }
+    return std::make_pair(size_t{it->second->used_size},
+                          size_t{it->second->quota});
+}
+
 auto MasterService::GetReplicaListByRegex(const std::string& regex_pattern)
     -> tl::expected<
         std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
         ErrorCode> {
-    std::unordered_map<std::string, std::vector<Replica::Descriptor>> results;
     std::regex pattern;
 
     try {
@@ -281,29 +465,52 @@ auto MasterService::GetReplicaListByRegex(const std::string& regex_pattern)
         return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
     }
 
-    for (size_t i = 0; i < kNumShards; ++i) {
-        MutexLocker lock(&metadata_shards_[i].mutex);
+    // Only the keys with the literal prefix of the pattern can match
+    return GetReplicaListMatching(regexLiteralPrefix(regex_pattern), &pattern);
+}
 
-        for (auto& [key, metadata] : metadata_shards_[i].metadata) {
-            if (std::regex_search(key, pattern)) {
-                std::vector<Replica::Descriptor> replica_list;
-                replica_list.reserve(metadata.replicas.size());
-                for (const auto& replica : metadata.replicas) {
-                    if (replica.status() == ReplicaStatus::COMPLETE) {
-                        replica_list.emplace_back(replica.get_descriptor());
-                    }
-                }
-                if (replica_list.empty()) {
-                    LOG(WARNING)
-                        << "key=" << key
-                        << " matched by regex, but has no complete replicas.";
-                    continue;
-                }
+auto MasterService::GetReplicaListByPrefix(const std::string& prefix)
+    -> tl::expected<
+        std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+        ErrorCode> {
+    return GetReplicaListMatching(prefix, nullptr);
+}
+
+auto MasterService::GetReplicaListMatching(const std::string& prefix,
+                                           const std::regex* pattern)
+    -> std::unordered_map<std::string, std::vector<Replica::Descriptor>> {
+    std::unordered_map<std::string, std::vector<Replica::Descriptor>> results;
+
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard, shared_lock);
+
+        for (auto it = shard.ordered_keys.lower_bound(prefix);
+             it != shard.ordered_keys.end() && it->first.starts_with(prefix);
+             ++it) {
+            std::string_view key = it->first;
+            const ObjectMetadata& metadata = *it->second;
+            if (metadata.IsDropped() ||
+                (pattern &&
+                 !std::regex_search(key.begin(), key.end(), *pattern))) {
+                continue;
+            }
 
-                results.emplace(key, std::move(replica_list));
-                metadata.GrantLease(default_kv_lease_ttl_,
-                                    default_kv_soft_pin_ttl_);
+            std::vector<Replica::Descriptor> replica_list;
+            replica_list.reserve(metadata.replicas.size());
+            for (const auto& replica : metadata.replicas) {
+                if (replica.status() == ReplicaStatus::COMPLETE &&
+                    !replica.has_invalid_mem_handle()) {
+                    replica_list.emplace_back(replica.get_descriptor());
+                }
             }
+            if (replica_list.empty()) {
+                LOG(WARNING) << "key=" << key
+                             << " matched, but has no complete replicas.";
+                continue;
+            }
+
+            results.emplace(key, std::move(replica_list));
+            GrantReadLease(metadata);
         }
     }
 
@@ -312,17 +519,26 @@ auto MasterService::GetReplicaListByRegex(const std::string& regex_pattern)
 
 auto MasterService::GetReplicaList(std::string_view key)
     -> tl::expected<GetReplicaListResponse, ErrorCode> {
-    MetadataAccessor accessor(this, std::string(key));
-    if (!accessor.Exists()) {
+    admission_policy_->RecordAccess(key);
+    MetadataReader reader(this, std::string(key));
+    if (!reader.Exists()) {
         VLOG(1) << "key=" << key << ", info=object_not_found";
         return tl::make_unexpected(ErrorCode::OBJECT_NOT_FOUND);
     }
-    auto& metadata = accessor.Get();
+    const auto& metadata = reader.Get();
+    // The estimate grows by one per read, so a key reaching the threshold
+    // is queued once until its count decays below it again
+    if (read_sketch_ &&
+        read_sketch_->Increment(key) == hot_key_read_threshold_) {
+        MutexLocker lock(&hot_key_mutex_);
+        hot_key_candidates_.emplace(key);
+    }
 
     std::vector<Replica::Descriptor> replica_list;
     replica_list.reserve(metadata.replicas.size());
     for (const auto& replica : metadata.replicas) {
-        if (replica.status() == ReplicaStatus::COMPLETE) {
+        if (replica.status() == ReplicaStatus::COMPLETE &&
+            !replica.has_invalid_mem_handle()) {
             replica_list.emplace_back(replica.get_descriptor());
         }
     }
@@ -332,9 +548,28 @@ auto MasterService::GetReplicaList(std::string_view key)
         return tl::make_unexpected(ErrorCode::REPLICA_IS_NOT_READY);
     }
 
+    // The clients read the first replica, rotate the memory replicas of a
+    // hot key so that its readers spread over them
+    if (static_cast<size_t>(metadata.GetMemReplicaCount()) >
+        metadata.put_replica_num) {
+        auto mem_end = std::partition(
+            replica_list.begin(), replica_list.end(),
+            [](const Replica::Descriptor& descriptor) {
+                return descriptor.is_memory_replica();
+            });
+        size_t mem_count = mem_end - replica_list.begin();
+        if (mem_count > 1) {
+            size_t shift =
+                replica_rotation_.fetch_add(1, std::memory_order_relaxed) %
+                mem_count;
+            std::rotate(replica_list.begin(), replica_list.begin() + shift,
+                        mem_end);
+        }
+    }
+
     // Grant a lease to the object so it will not be removed
     // when the client is reading it.
-    metadata.GrantLease(default_kv_lease_ttl_, default_kv_soft_pin_ttl_);
+    GrantReadLease(metadata);
 
     return GetReplicaListResponse(std::move(replica_list),
                                   default_kv_lease_ttl_);
@@ -368,40 +603,151 @@ auto MasterService::PutStart(const std::string& key,
     VLOG(1) << "key=" << key << ", value_length=" << total_length
             << ", slice_count=" << slice_lengths.size() << ", config=" << config
             << ", action=put_start_begin";
+    admission_policy_->RecordAccess(key);
+
+    // A namespace at its quota makes room by evicting its own objects
+    Namespace* ns = config.namespace_name.empty()
+                        ? default_namespace_
+                        : GetNamespace(config.namespace_name);
+    if (!ns->HasRoom(total_length * config.replica_num)) {
+        VLOG(1) << "key=" << key << ", namespace=" << ns->name
+                << ", error=namespace_quota_exceeded";
+        ns->rejected_puts.fetch_add(1, std::memory_order_relaxed);
+        ns->need_eviction = true;
+        need_namespace_eviction_ = true;
+        put_retry_after_ms_.store(kEvictionThreadSleepMs,
+                                  std::memory_order_relaxed);
+        return tl::make_unexpected(ErrorCode::NO_AVAILABLE_HANDLE);
+    }
 
-    // Lock the shard and check if object already exists
-    size_t shard_idx = getShardIndex(key);
-    MutexLocker lock(&metadata_shards_[shard_idx].mutex);
+    // Reserve the key, so that the replicas can be allocated without holding
+    // the shard lock
+    auto& shard = metadata_shards_[getShardIndex(key)];
+    {
+        ShardLocker lock(&shard);
+        if (shard.pending_puts.count(key)) {
+            LOG(INFO) << "key=" << key << ", info=put_in_progress";
+            return tl::make_unexpected(ErrorCode::OBJECT_ALREADY_EXISTS);
+        }
 
-    auto it = metadata_shards_[shard_idx].metadata.find(key);
-    if (it != metadata_shards_[shard_idx].metadata.end() &&
-        !CleanupStaleHandles(it->second)) {
-        LOG(INFO) << "key=" << key << ", info=object_already_exists";
-        return tl::make_unexpected(ErrorCode::OBJECT_ALREADY_EXISTS);
+        auto it = shard.metadata.find(key);
+        if (it != shard.metadata.end()) {
+            if (!it->second.HasOnlyStaleHandles()) {
+                if (!it->second.IsDropped()) {
+                    LOG(INFO) << "key=" << key
+                              << ", info=object_already_exists";
+                    return tl::make_unexpected(
+                        ErrorCode::OBJECT_ALREADY_EXISTS);
+                }
+                // The object of a dropped namespace may still be read
+                if (!it->second.IsLeaseExpired(CurrentLeaseEpoch())) {
+                    LOG(INFO) << "key=" << key
+                              << ", info=dropped_object_has_lease";
+                    return tl::make_unexpected(ErrorCode::OBJECT_HAS_LEASE);
+                }
+            }
+            // All the replicas of the existing object were stale, or its
+            // namespace was dropped
+            shard.Erase(it);
+        }
+        shard.pending_puts.insert(key);
     }
 
-    // Allocate replicas
-    std::vector<Replica> replicas;
-    {
+    // Content already stored is shared rather than transferred again
+    if (!config.content_hash.empty()) {
+        auto shared = FindContent(config.content_hash, total_length,
+                                  config.replica_num);
+        if (shared.has_value()) {
+            ShardLocker lock(&shard);
+            shard.pending_puts.erase(key);
+            for (const auto& replica : shared.value()) {
+                if (replica.has_invalid_mem_handle()) {
+                    LOG(INFO) << "key=" << key << ", info=segment_unmounted";
+                    put_retry_after_ms_.store(kEvictionThreadSleepMs,
+                                              std::memory_order_relaxed);
+                    return tl::make_unexpected(
+                        ErrorCode::NO_AVAILABLE_HANDLE);
+                }
+            }
+            size_t replica_num = shared->size();
+            auto new_it =
+                shard.metadata
+                    .emplace(std::piecewise_construct,
+                             std::forward_as_tuple(key),
+                             std::forward_as_tuple(total_length,
+                                                   std::move(shared.value()),
+                                                   config.with_soft_pin, ns))
+                    .first;
+            new_it->second.content_hash = config.content_hash;
+            new_it->second.GrantLease(CurrentLeaseEpoch(), 0,
+                                      LeaseEpochs(default_kv_soft_pin_ttl_));
+            shard.Index(new_it);
+            MasterMetricManager::instance().inc_dedup_puts(total_length *
+                                                           replica_num);
+            VLOG(1) << "key=" << key << ", content_hash=" << config.content_hash
+                    << ", info=content_already_exists";
+            return tl::make_unexpected(ErrorCode::CONTENT_ALREADY_EXISTS);
+        }
+    }
+
+    // Allocate replicas. Allocators lock their segments themselves.
+    auto allocate = [&] {
         ScopedAllocatorAccess allocator_access =
             segment_manager_.getAllocatorAccess();
-        auto& allocators = allocator_access.getAllocators();
-        auto& allocators_by_name = allocator_access.getAllocatorsByName();
-
-        auto allocation_result = allocation_strategy_->Allocate(
-            allocators, allocators_by_name, slice_lengths, config);
+        return allocation_strategy_->Allocate(
+            allocator_access.getAllocators(),
+            allocator_access.getAllocatorsByName(), slice_lengths, config);
+    };
+    auto allocation_result = allocate();
+
+    // Make room right away rather than failing until the eviction thread
+    // does. Unless leases block the eviction, the eviction thread makes room
+    // within its next pass, which is when a failed put should be retried.
+    uint64_t retry_after_ms = kEvictionThreadSleepMs;
+    bool admitted = true;
+    if (!allocation_result.has_value() &&
+        allocation_result.error() == ErrorCode::NO_AVAILABLE_HANDLE &&
+        enable_inline_eviction_) {
+        auto eviction_result = EvictForPut(
+            key, total_length * config.replica_num, retry_after_ms);
+        if (eviction_result == PutEvictionResult::FREED) {
+            allocation_result = allocate();
+        }
+        admitted = eviction_result != PutEvictionResult::NOT_ADMITTED;
+    }
 
-        if (!allocation_result.has_value()) {
-            VLOG(1) << "Failed to allocate all replicas for key=" << key
-                    << ", error: " << allocation_result.error();
-            if (allocation_result.error() == ErrorCode::INVALID_PARAMS) {
-                return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
-            }
+    // Commit the object. Until then, the key does not exist for the other
+    // requests, so a Remove racing with the allocation finds no object, as
+    // if it was served before this PutStart.
+    ShardLocker lock(&shard);
+    shard.pending_puts.erase(key);
+    if (!allocation_result.has_value()) {
+        VLOG(1) << "Failed to allocate all replicas for key=" << key
+                << ", error: " << allocation_result.error();
+        if (allocation_result.error() == ErrorCode::INVALID_PARAMS) {
+            return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        // A put turned away by the admission policy does not make the
+        // eviction thread evict the objects preferred over it
+        if (admitted) {
             need_eviction_ = true;
-            return tl::make_unexpected(ErrorCode::NO_AVAILABLE_HANDLE);
+        } else {
+            MasterMetricManager::instance().inc_put_admission_rejections();
         }
+        put_retry_after_ms_.store(retry_after_ms, std::memory_order_relaxed);
+        return tl::make_unexpected(ErrorCode::NO_AVAILABLE_HANDLE);
+    }
+    std::vector<Replica> replicas = std::move(allocation_result.value());
 
-        replicas = std::move(allocation_result.value());
+    // A segment unmounted during the allocation may have missed the object
+    // when dropping its buffers
+    for (const auto& replica : replicas) {
+        if (replica.has_invalid_mem_handle()) {
+            LOG(INFO) << "key=" << key << ", info=segment_unmounted";
+            put_retry_after_ms_.store(kEvictionThreadSleepMs,
+                                      std::memory_order_relaxed);
+            return tl::make_unexpected(ErrorCode::NO_AVAILABLE_HANDLE);
+        }
     }
 
     // If disk replica is enabled, allocate a disk replica
@@ -420,10 +766,18 @@ auto MasterService::PutStart(const std::string& key,
 
     // No need to set lease here. The object will not be evicted until
     // PutEnd is called.
-    metadata_shards_[shard_idx].metadata.emplace(
-        std::piecewise_construct, std::forward_as_tuple(key),
-        std::forward_as_tuple(total_length, std::move(replicas),
-                              config.with_soft_pin));
+    auto new_it = shard.metadata
+                      .emplace(std::piecewise_construct,
+                               std::forward_as_tuple(key),
+                               std::forward_as_tuple(total_length,
+                                                     std::move(replicas),
+                                                     config.with_soft_pin, ns))
+                      .first;
+    new_it->second.content_hash = config.content_hash;
+    shard.Index(new_it);
+    if (put_retry_after_ms_.load(std::memory_order_relaxed) != 0) {
+        put_retry_after_ms_.store(0, std::memory_order_relaxed);
+    }
     return replica_list;
 }
 
@@ -441,10 +795,15 @@ auto MasterService::PutEnd(const std::string& key, ReplicaType replica_type)
             replica.mark_complete();
         }
     }
+    if (replica_type == ReplicaType::MEMORY &&
+        !metadata.content_hash.empty()) {
+        IndexContent(metadata);
+    }
     // 1. Set lease timeout to now, indicating that the object has no lease
     // at beginning. 2. If this object has soft pin enabled, set it to be soft
     // pinned.
-    metadata.GrantLease(0, default_kv_soft_pin_ttl_);
+    metadata.GrantLease(CurrentLeaseEpoch(), 0,
+                        LeaseEpochs(default_kv_soft_pin_ttl_));
     return {};
 }
 
@@ -464,9 +823,12 @@ auto MasterService::PutRevoke(const std::string& key, ReplicaType replica_type)
         return tl::make_unexpected(ErrorCode::INVALID_WRITE);
     }
 
+    accessor.UnindexSegments();
     metadata.EraseReplica(replica_type);
     if (metadata.IsValid() == false) {
         accessor.Erase();
+    } else {
+        accessor.IndexSegments();
     }
     return {};
 }
@@ -481,6 +843,89 @@ std::vector<tl::expected<void, ErrorCode>> MasterService::BatchPutEnd(
     return results;
 }
 
+auto MasterService::FindContent(const std::string& content_hash,
+                                uint64_t size, size_t replica_num)
+    -> std::optional<std::vector<Replica>> {
+    auto& content_shard = getContentShard(content_hash);
+    MutexLocker lock(&content_shard.mutex);
+    auto it = content_shard.contents.find(content_hash);
+    if (it == content_shard.contents.end()) {
+        return std::nullopt;
+    }
+
+    std::vector<Replica> replicas;
+    bool stored = false;
+    for (const auto& weak_buffers : it->second) {
+        if (replicas.size() == replica_num) {
+            break;
+        }
+        std::vector<std::shared_ptr<AllocatedBuffer>> buffers;
+        uint64_t replica_size = 0;
+        for (const auto& weak_buffer : weak_buffers) {
+            auto buffer = weak_buffer.lock();
+            if (!buffer || !buffer->isAllocatorValid()) {
+                break;
+            }
+            replica_size += buffer->size();
+            buffers.push_back(std::move(buffer));
+        }
+        // Replicas freed or relocated since are skipped
+        if (buffers.size() != weak_buffers.size()) {
+            continue;
+        }
+        stored = true;
+        if (replica_size == size) {
+            replicas.emplace_back(std::move(buffers), ReplicaStatus::COMPLETE);
+        }
+    }
+    if (!stored) {
+        content_shard.contents.erase(it);
+    }
+    if (replicas.empty()) {
+        return std::nullopt;
+    }
+    return replicas;
+}
+
+void MasterService::IndexContent(const ObjectMetadata& metadata) {
+    ContentBuffers content;
+    for (const auto& replica : metadata.replicas) {
+        if (!replica.is_memory_replica() ||
+            replica.status() != ReplicaStatus::COMPLETE) {
+            continue;
+        }
+        const auto& buffers = replica.get_shared_buffers();
+        content.emplace_back(buffers.begin(), buffers.end());
+    }
+    if (content.empty()) {
+        return;
+    }
+    // The latest put of the content replaces the replicas indexed before,
+    // which are stale if the put did not share them
+    auto& content_shard = getContentShard(metadata.content_hash);
+    MutexLocker lock(&content_shard.mutex);
+    content_shard.contents[metadata.content_hash] = std::move(content);
+}
+
+void MasterService::PurgeContentIndex() {
+    for (auto& content_shard : content_shards_) {
+        MutexLocker lock(&content_shard.mutex);
+        for (auto it = content_shard.contents.begin();
+             it != content_shard.contents.end();) {
+            bool stored = std::any_of(
+                it->second.begin(), it->second.end(),
+                [](const std::vector<std::weak_ptr<AllocatedBuffer>>& buffers) {
+                    return std::none_of(
+                        buffers.begin(), buffers.end(),
+                        [](const std::weak_ptr<AllocatedBuffer>& buffer) {
+                            return buffer.expired();
+                        });
+                });
+            it = stored ? std::next(it) : content_shard.contents.erase(it);
+        }
+    }
+}
+
 std::vector<tl::expected<void, ErrorCode>> MasterService::BatchPutRevoke(
     const std::vector<std::string>& keys) {
     std::vector<tl::expected<void, ErrorCode>> results;
@@ -501,7 +946,7 @@ auto MasterService::Remove(const std::string& key)
 
     auto& metadata = accessor.Get();
 
-    if (!metadata.IsLeaseExpired()) {
+    if (!metadata.IsLeaseExpired(CurrentLeaseEpoch())) {
         VLOG(1) << "key=" << key << ", error=object_has_lease";
         return tl::make_unexpected(ErrorCode::OBJECT_HAS_LEASE);
     }
@@ -518,7 +963,6 @@ auto MasterService::Remove(const std::string& key)
 
 auto MasterService::RemoveByRegex(const std::string& regex_pattern)
     -> tl::expected<long, ErrorCode> {
-    long removed_count = 0;
     std::regex pattern;
 
     try {
@@ -529,51 +973,74 @@ auto MasterService::RemoveByRegex(const std::string& regex_pattern)
         return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
     }
 
-    for (size_t i = 0; i < kNumShards; ++i) {
-        MutexLocker lock(&metadata_shards_[i].mutex);
+    long removed_count =
+        RemoveMatching(regexLiteralPrefix(regex_pattern), &pattern);
+    VLOG(1) << "action=remove_by_regex, pattern=" << regex_pattern
+            << ", removed_count=" << removed_count;
+    return removed_count;
+}
+
+auto MasterService::RemoveByPrefix(const std::string& prefix)
+    -> tl::expected<long, ErrorCode> {
+    long removed_count = RemoveMatching(prefix, nullptr);
+    VLOG(1) << "action=remove_by_prefix, prefix=" << prefix
+            << ", removed_count=" << removed_count;
+    return removed_count;
+}
 
-        for (auto it = metadata_shards_[i].metadata.begin();
-             it != metadata_shards_[i].metadata.end();) {
-            if (std::regex_search(it->first, pattern)) {
-                if (!it->second.IsLeaseExpired()) {
-                    VLOG(1) << "key=" << it->first
-                            << " matched by regex, but has lease. Skipping "
-                            << "removal.";
-                    ++it;
-                    continue;
-                }
-                if (!it->second.IsAllReplicasComplete()) {
-                    LOG(WARNING) << "key=" << it->first
-                                 << " matched by regex, but not all replicas "
-                                    "are complete. Skipping removal.";
-                    ++it;
-                    continue;
-                }
+long MasterService::RemoveMatching(const std::string& prefix,
+                                   const std::regex* pattern) {
+    long removed_count = 0;
 
-                VLOG(1) << "key=" << it->first
-                        << " matched by regex. Removing.";
-                it = metadata_shards_[i].metadata.erase(it);
-                removed_count++;
-            } else {
-                ++it;
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard);
+
+        auto it = shard.ordered_keys.lower_bound(prefix);
+        while (it != shard.ordered_keys.end() &&
+               it->first.starts_with(prefix)) {
+            // Erasing the object only invalidates its own entry
+            auto next = std::next(it);
+            std::string_view key = it->first;
+            const ObjectMetadata& metadata = *it->second;
+            if (metadata.IsDropped() ||
+                (pattern &&
+                 !std::regex_search(key.begin(), key.end(), *pattern))) {
+                it = next;
+                continue;
+            }
+            if (!metadata.IsLeaseExpired(CurrentLeaseEpoch())) {
+                VLOG(1) << "key=" << key
+                        << " matched, but has lease. Skipping removal.";
+                it = next;
+                continue;
+            }
+            if (!metadata.IsAllReplicasComplete()) {
+                LOG(WARNING) << "key=" << key
+                             << " matched, but not all replicas are "
+                                "complete. Skipping removal.";
+                it = next;
+                continue;
             }
+
+            VLOG(1) << "key=" << key << " matched. Removing.";
+            shard.Erase(shard.metadata.find(std::string(key)));
+            removed_count++;
+            it = next;
         }
     }
 
-    VLOG(1) << "action=remove_by_regex, pattern=" << regex_pattern
-            << ", removed_count=" << removed_count;
     return removed_count;
 }
 
 long MasterService::RemoveAll() {
     long removed_count = 0;
     uint64_t total_freed_size = 0;
-    // Store the current time to avoid repeatedly
+    // Store the current lease epoch to avoid repeatedly
     // calling std::chrono::steady_clock::now()
-    auto now = std::chrono::steady_clock::now();
+    const uint64_t now = CurrentLeaseEpoch();
 
     for (auto& shard : metadata_shards_) {
-        MutexLocker lock(&shard.mutex);
+        ShardLocker lock(&shard);
         if (shard.metadata.empty()) {
             continue;
         }
@@ -584,7 +1051,7 @@ long MasterService::RemoveAll() {
             if (it->second.IsLeaseExpired(now)) {
                 total_freed_size +=
                     it->second.size * it->second.GetMemReplicaCount();
-                it = shard.metadata.erase(it);
+                it = shard.Erase(it);
                 removed_count++;
             } else {
                 ++it;
@@ -598,6 +1065,73 @@ long MasterService::RemoveAll() {
     return removed_count;
 }
 
+size_t MasterService::getShardIndex(const std::string& key) const {
+    // Hex digests are uniformly distributed already, their leading 64 bits
+    // serve as the hash
+    if (hex_key_shard_hash_ && key.size() >= 16) {
+        uint64_t hash = 0;
+        auto [ptr, ec] = std::from_chars(key.data(), key.data() + 16, hash, 16);
+        if (ec == std::errc() && ptr == key.data() + 16) {
+            return hash % metadata_shards_.size();
+        }
+    }
+    return std::hash<std::string>{}(key) % metadata_shards_.size();
+}
+
+MasterService::ShardLocker::ShardLocker(const MetadataShard* shard)
+    : shard_(shard), shared_(false) {
+    Lock();
+}
+
+MasterService::ShardLocker::ShardLocker(const MetadataShard* shard,
+                                        const shared_lock_t&)
+    : shard_(shard), shared_(true) {
+    Lock();
+}
+
+void MasterService::ShardLocker::Lock() NO_THREAD_SAFETY_ANALYSIS {
+    thread_local uint64_t acquisitions = 0;
+    sampled_ = ++acquisitions % kShardLockSampleInterval == 0;
+    std::chrono::steady_clock::time_point start;
+    if (sampled_) {
+        start = std::chrono::steady_clock::now();
+    }
+    if (shared_) {
+        shard_->mutex.lock_shared();
+    } else {
+        shard_->mutex.lock();
+    }
+    if (sampled_) {
+        locked_at_ = std::chrono::steady_clock::now();
+        wait_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                       locked_at_ - start)
+                       .count();
+    }
+}
+
+void MasterService::ShardLocker::Unlock() NO_THREAD_SAFETY_ANALYSIS {
+    if (shared_) {
+        shard_->mutex.unlock_shared();
+    } else {
+        shard_->mutex.unlock();
+    }
+}
+
+MasterService::ShardLocker::~ShardLocker() {
+    if (!sampled_) {
+        Unlock();
+        return;
+    }
+    int64_t hold_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - locked_at_)
+                          .count();
+    Unlock();
+    // Recorded after the unlock, so that the metrics do not extend the hold
+    auto& metrics = MasterMetricManager::instance();
+    metrics.observe_shard_lock_wait(shard_->index, wait_us_);
+    metrics.observe_shard_lock_hold(shard_->index, hold_us);
+}
+
 bool MasterService::CleanupStaleHandles(ObjectMetadata& metadata) {
     // Iterate through replicas and remove those with invalid allocators
     auto replica_it = metadata.replicas.begin();
@@ -613,6 +1147,8 @@ bool MasterService::CleanupStaleHandles(ObjectMetadata& metadata) {
         }
     }
 
+    metadata.ChargeNamespace();
+
     // Return true if no valid replicas remain after cleanup
     return metadata.replicas.empty();
 }
@@ -620,7 +1156,7 @@ bool MasterService::CleanupStaleHandles(ObjectMetadata& metadata) {
 size_t MasterService::GetKeyCount() const {
     size_t total = 0;
     for (const auto& shard : metadata_shards_) {
-        MutexLocker lock(&shard.mutex);
+        ShardLocker lock(&shard, shared_lock);
         total += shard.metadata.size();
     }
     return total;
@@ -643,7 +1179,58 @@ auto MasterService::Ping(const UUID& client_id)
                    << ", error=client_ping_queue_full";
         return tl::make_unexpected(ErrorCode::INTERNAL_ERROR);
     }
-    return PingResponse(view_version_, client_status);
+    PingResponse response(view_version_, client_status);
+    response.put_retry_after_ms = GetPutRetryAfterMs();
+    {
+        MutexLocker compaction_lock(&compaction_mutex_);
+        auto task_it = compaction_tasks_.find(client_id);
+        if (task_it != compaction_tasks_.end()) {
+            for (const auto& task : task_it->second) {
+                auto move_it = compaction_moves_.find(task.task_id);
+                if (move_it != compaction_moves_.end()) {
+                    move_it->second.delivered = true;
+                }
+            }
+            response.compaction_tasks = std::move(task_it->second);
+            compaction_tasks_.erase(task_it);
+        }
+    }
+    return response;
+}
+
+auto MasterService::MoveEnd(const UUID& client_id, uint64_t task_id,
+                            bool success) -> tl::expected<void, ErrorCode> {
+    CompactionMove move;
+    {
+        MutexLocker lock(&compaction_mutex_);
+        auto it = compaction_moves_.find(task_id);
+        if (it == compaction_moves_.end() || it->second.copied ||
+            it->second.client_id != client_id) {
+            LOG(ERROR) << "client_id=" << client_id << ", task_id=" << task_id
+                       << ", error=compaction_task_not_found";
+            return tl::make_unexpected(ErrorCode::INVALID_PARAMS);
+        }
+        move = std::move(it->second);
+        compaction_moves_.erase(it);
+    }
+
+    if (!success) {
+        // The target buffers are freed with the move
+        VLOG(1) << "key=" << move.key << ", task_id=" << task_id
+                << ", info=compaction_copy_failed";
+        if (!move.add_replica) {
+            MasterMetricManager::instance().inc_compaction_fail();
+        }
+        return {};
+    }
+
+    if (CommitMove(task_id, move) == MoveResult::WAIT_FOR_LEASE) {
+        // Committed by the compaction thread once the leases expire
+        move.copied = true;
+        MutexLocker lock(&compaction_mutex_);
+        compaction_moves_.emplace(task_id, std::move(move));
+    }
+    return {};
 }
 
 tl::expected<std::string, ErrorCode> MasterService::GetFsdir() const {
@@ -659,7 +1246,26 @@ tl::expected<std::string, ErrorCode> MasterService::GetFsdir() const {
 void MasterService::EvictionThreadFunc() {
     VLOG(1) << "action=eviction_thread_started";
 
+    auto next_reclaim_time = std::chrono::steady_clock::now();
+    auto next_content_purge_time = next_reclaim_time;
     while (eviction_running_) {
+        // Dropped objects still leased are retried less often, as every
+        // attempt visits all objects of their namespaces
+        auto now = std::chrono::steady_clock::now();
+        if (need_reclaim_dropped_ && now >= next_reclaim_time) {
+            ReclaimDroppedObjects();
+            next_reclaim_time =
+                now + std::chrono::milliseconds(kReclaimDroppedRetryMs);
+        }
+        if (now >= next_content_purge_time) {
+            PurgeContentIndex();
+            next_content_purge_time =
+                now + std::chrono::milliseconds(kContentIndexPurgeMs);
+        }
+        if (need_namespace_eviction_) {
+            BatchEvictNamespaces();
+        }
+
         double used_ratio =
             MasterMetricManager::instance().get_global_mem_used_ratio();
         if (used_ratio > eviction_high_watermark_ratio_ ||
@@ -672,6 +1278,7 @@ void MasterService::EvictionThreadFunc() {
                          used_ratio - eviction_high_watermark_ratio_);
             BatchEvict(evict_ratio_target, evict_ratio_lowerbound);
         }
+        UpdateNamespaceMetrics();
 
         std::this_thread::sleep_for(
             std::chrono::milliseconds(kEvictionThreadSleepMs));
@@ -680,6 +1287,526 @@ void MasterService::EvictionThreadFunc() {
     VLOG(1) << "action=eviction_thread_stopped";
 }
 
+void MasterService::CompactionThreadFunc() {
+    VLOG(1) << "action=compaction_thread_started";
+
+    while (compaction_running_) {
+        CommitCopiedMoves();
+
+        std::vector<std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>
+            allocators;
+        {
+            ScopedSegmentAccess segment_access =
+                segment_manager_.getSegmentAccess();
+            segment_access.GetClientAllocators(allocators);
+        }
+        if (read_sketch_) {
+            ReplicateHotKeys(allocators);
+        }
+
+        uint64_t fragmented_size = 0;
+        auto now = std::chrono::steady_clock::now();
+        std::unordered_map<const BufferAllocatorBase*, FruitlessCompaction>
+            fruitless_compactions;
+        for (const auto& [client_id, allocator] : allocators) {
+            size_t largest_free = allocator->getLargestFreeRegion();
+            size_t free = allocator->capacity() - allocator->size();
+            // Free space of CacheLib allocators is unknown
+            if (largest_free == kAllocatorUnknownFreeSpace ||
+                largest_free >= free) {
+                continue;
+            }
+            fragmented_size += free - largest_free;
+
+            double fragmentation =
+                1.0 - static_cast<double>(largest_free) / free;
+            if (compaction_fragmentation_ratio_ <= 0.0 ||
+                fragmentation < compaction_fragmentation_ratio_) {
+                continue;
+            }
+            // A segment whose last scan found nothing to move is only
+            // scanned again once its free space changed, or after a while
+            auto last = fruitless_compactions_.find(allocator.get());
+            if (last != fruitless_compactions_.end() &&
+                last->second.free == free &&
+                last->second.largest_free == largest_free &&
+                now - last->second.time <
+                    std::chrono::milliseconds(kCompactionRescanMs)) {
+                fruitless_compactions.emplace(last->first, last->second);
+                continue;
+            }
+            VLOG(1) << "segment_name=" << allocator->getSegmentName()
+                    << ", free=" << free << ", largest_free=" << largest_free
+                    << ", action=compact_segment";
+            if (!CompactSegment(client_id, allocator)) {
+                fruitless_compactions.emplace(
+                    allocator.get(),
+                    FruitlessCompaction{free, largest_free, now});
+            }
+        }
+        // Segments unmounted or no longer fragmented are forgotten
+        fruitless_compactions_ = std::move(fruitless_compactions);
+        MasterMetricManager::instance().set_fragmented_mem_size(
+            fragmented_size);
+        // Holding the allocators would keep unmounted segments alive
+        allocators.clear();
+
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kCompactionThreadSleepMs));
+    }
+
+    VLOG(1) << "action=compaction_thread_stopped";
+}
+
+bool MasterService::CompactSegment(
+    const UUID& client_id,
+    const std::shared_ptr<BufferAllocatorBase>& allocator) {
+    // Moving objects only helps after the previous moves freed their sources
+    {
+        MutexLocker lock(&compaction_mutex_);
+        for (const auto& [task_id, move] : compaction_moves_) {
+            if (move.allocator == allocator.get()) {
+                return true;
+            }
+        }
+    }
+
+    // Pick the smallest objects on the segment, they are the cheapest to
+    // copy and the most likely to fit the holes elsewhere in the segment.
+    // The heap keeps the largest of the picked objects on top.
+    std::priority_queue<std::pair<size_t, std::string>> candidates;
+    auto now = std::chrono::steady_clock::now();
+    const uint64_t lease_epoch = CurrentLeaseEpoch();
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard);
+        for (const auto& [key, metadata] : shard.metadata) {
+            if (!metadata.IsLeaseExpired(lease_epoch) ||
+                metadata.HasDiffRepStatus(ReplicaStatus::COMPLETE,
+                                          ReplicaType::MEMORY) ||
+                (candidates.size() == kMaxMovesPerSegment &&
+                 metadata.size >= candidates.top().first)) {
+                continue;
+            }
+            // Buffers shared by objects with the same content stay, moving
+            // one of the objects would not free them
+            bool on_segment = std::any_of(
+                metadata.replicas.begin(), metadata.replicas.end(),
+                [&allocator](const Replica& replica) {
+                    return !replica.get_buffer_indexes(allocator.get())
+                                .empty() &&
+                           !replica.has_shared_buffers();
+                });
+            if (!on_segment) {
+                continue;
+            }
+            candidates.emplace(metadata.size, key);
+            if (candidates.size() > kMaxMovesPerSegment) {
+                candidates.pop();
+            }
+        }
+    }
+
+    std::vector<std::pair<uint64_t, CompactionMove>> moves;
+    // Objects only slide towards the start of the segment, so the free space
+    // gathers at its end
+    for (; !candidates.empty(); candidates.pop()) {
+        const std::string& key = candidates.top().second;
+        MetadataAccessor accessor(this, key);
+        if (!accessor.Exists()) {
+            continue;
+        }
+        auto& metadata = accessor.Get();
+        if (!metadata.IsLeaseExpired(CurrentLeaseEpoch()) ||
+            metadata.HasDiffRepStatus(ReplicaStatus::COMPLETE,
+                                      ReplicaType::MEMORY)) {
+            continue;
+        }
+
+        for (const auto& replica : metadata.replicas) {
+            auto indexes = replica.get_buffer_indexes(allocator.get());
+            // A put of the same content may have shared the buffers since
+            // the scan. The readers of the other objects hold no lease on
+            // this one, and moving it would not free the buffers anyway.
+            if (indexes.empty() || replica.has_shared_buffers()) {
+                continue;
+            }
+            auto descriptor = replica.get_descriptor();
+            const auto& buffers =
+                descriptor.get_memory_descriptor().buffer_descriptors;
+
+            CompactionMove move;
+            move.key = key;
+            move.client_id = client_id;
+            move.allocator = allocator.get();
+            move.deadline =
+                now + std::chrono::milliseconds(kCompactionMoveTimeoutMs);
+            for (size_t index : indexes) {
+                // Holes above the source are held while looking for one
+                // below it, so that the allocator hands out another one.
+                // They are freed right after, not to starve the puts.
+                std::vector<std::unique_ptr<AllocatedBuffer>> skipped_holes;
+                auto target = allocator->allocate(buffers[index].size_);
+                while (target && reinterpret_cast<uintptr_t>(target->data()) >
+                                     buffers[index].buffer_address_) {
+                    if (skipped_holes.size() == kMaxSkippedHoles) {
+                        target.reset();
+                        break;
+                    }
+                    skipped_holes.push_back(std::move(target));
+                    target = allocator->allocate(buffers[index].size_);
+                }
+                if (!target) {
+                    break;
+                }
+                move.sources.push_back(buffers[index]);
+                move.targets.push_back(std::move(target));
+            }
+            if (move.targets.size() == indexes.size()) {
+                uint64_t task_id = next_compaction_task_id_.fetch_add(1);
+                metadata.compaction_task_id = task_id;
+                moves.emplace_back(task_id, std::move(move));
+            }
+            break;
+        }
+    }
+
+    if (moves.empty()) {
+        return false;
+    }
+    VLOG(1) << "segment_name=" << allocator->getSegmentName()
+            << ", move_count=" << moves.size()
+            << ", action=issue_compaction_moves";
+    IssueMoves(moves);
+    return true;
+}
+
+void MasterService::IssueMoves(
+    std::vector<std::pair<uint64_t, CompactionMove>>& moves) {
+    MutexLocker lock(&compaction_mutex_);
+    for (auto& [task_id, move] : moves) {
+        CompactionTask task;
+        task.task_id = task_id;
+        task.key = move.key;
+        task.sources = move.sources;
+        for (const auto& target : move.targets) {
+            task.targets.push_back(target->get_descriptor());
+        }
+        compaction_tasks_[move.client_id].push_back(std::move(task));
+        compaction_moves_.emplace(task_id, std::move(move));
+    }
+}
+
+MasterService::MoveResult MasterService::CommitMove(uint64_t task_id,
+                                                    CompactionMove& move) {
+    MetadataAccessor accessor(this, move.key);
+    if (move.add_replica) {
+        // Nobody reads the new replica before it is added, so there are no
+        // leases to wait for
+        bool targets_valid = std::all_of(
+            move.targets.begin(), move.targets.end(),
+            [](const std::unique_ptr<AllocatedBuffer>& target) {
+                return target->isAllocatorValid();
+            });
+        if (accessor.Exists() &&
+            accessor.Get().compaction_task_id == task_id && targets_valid &&
+            accessor.Get().HasMemReplica() && !accessor.Get().IsDropped()) {
+            auto& metadata = accessor.Get();
+            metadata.replicas.emplace_back(std::move(move.targets),
+                                           ReplicaStatus::COMPLETE);
+            metadata.ChargeNamespace();
+            metadata.compaction_task_id = 0;
+            accessor.IndexSegments();
+            MasterMetricManager::instance().inc_hot_key_replicas_added(1);
+            return MoveResult::COMMITTED;
+        }
+        VLOG(1) << "key=" << move.key << ", task_id=" << task_id
+                << ", info=hot_key_replica_aborted";
+        return MoveResult::ABORTED;
+    }
+    if (accessor.Exists() &&
+        accessor.Get().compaction_task_id == task_id) {
+        auto& metadata = accessor.Get();
+        for (auto& replica : metadata.replicas) {
+            // A put of the same content may have shared the sources since
+            if (replica.status() != ReplicaStatus::COMPLETE ||
+                !replica.is_memory_replica() || replica.has_shared_buffers()) {
+                continue;
+            }
+            auto descriptor = replica.get_descriptor();
+            const auto& buffers =
+                descriptor.get_memory_descriptor().buffer_descriptors;
+            std::vector<size_t> indexes;
+            for (const auto& source : move.sources) {
+                auto it = std::find_if(
+                    buffers.begin(), buffers.end(),
+                    [&source](const AllocatedBuffer::Descriptor& buffer) {
+                        return buffer.buffer_address_ ==
+                                   source.buffer_address_ &&
+                               buffer.transport_endpoint_ ==
+                                   source.transport_endpoint_;
+                    });
+                if (it == buffers.end()) {
+                    break;
+                }
+                indexes.push_back(it - buffers.begin());
+            }
+            if (indexes.size() != move.sources.size()) {
+                continue;
+            }
+
+            // Readers holding a lease may still be reading the sources
+            if (!metadata.IsLeaseExpired(CurrentLeaseEpoch())) {
+                return MoveResult::WAIT_FOR_LEASE;
+            }
+            uint64_t moved_size = 0;
+            for (size_t i = 0; i < indexes.size(); ++i) {
+                moved_size += move.targets[i]->size();
+                replica.replace_buffer(indexes[i], std::move(move.targets[i]));
+            }
+            metadata.compaction_task_id = 0;
+            MasterMetricManager::instance().inc_compaction_success(moved_size);
+            return MoveResult::COMMITTED;
+        }
+    }
+
+    // The object was removed, re-put or moved by another task meanwhile
+    VLOG(1) << "key=" << move.key << ", task_id=" << task_id
+            << ", info=compaction_move_aborted";
+    MasterMetricManager::instance().inc_compaction_fail();
+    return MoveResult::ABORTED;
+}
+
+void MasterService::CommitCopiedMoves() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<uint64_t, CompactionMove>> copied_moves;
+    {
+        MutexLocker lock(&compaction_mutex_);
+        for (auto it = compaction_moves_.begin();
+             it != compaction_moves_.end();) {
+            if (it->second.copied) {
+                copied_moves.emplace_back(it->first, std::move(it->second));
+                it = compaction_moves_.erase(it);
+            } else if (it->second.delivered) {
+                // The client may still be writing the targets, the move is
+                // only dropped by MoveEnd or once the client expired
+                ++it;
+            } else if (it->second.deadline < now) {
+                // The client did not fetch the move in time
+                LOG(WARNING) << "key=" << it->second.key
+                             << ", task_id=" << it->first
+                             << ", warn=compaction_move_timeout";
+                if (!it->second.add_replica) {
+                    MasterMetricManager::instance().inc_compaction_fail();
+                }
+                auto tasks_it = compaction_tasks_.find(it->second.client_id);
+                if (tasks_it != compaction_tasks_.end()) {
+                    std::erase_if(tasks_it->second,
+                                  [task_id = it->first](
+                                      const CompactionTask& task) {
+                                      return task.task_id == task_id;
+                                  });
+                    if (tasks_it->second.empty()) {
+                        compaction_tasks_.erase(tasks_it);
+                    }
+                }
+                it = compaction_moves_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& [task_id, move] : copied_moves) {
+        if (CommitMove(task_id, move) != MoveResult::WAIT_FOR_LEASE) {
+            continue;
+        }
+        if (move.deadline < now) {
+            MasterMetricManager::instance().inc_compaction_fail();
+            continue;
+        }
+        MutexLocker lock(&compaction_mutex_);
+        compaction_moves_.emplace(task_id, std::move(move));
+    }
+}
+
+void MasterService::DropClientMoves(const std::vector<UUID>& client_ids) {
+    MutexLocker lock(&compaction_mutex_);
+    for (const auto& client_id : client_ids) {
+        compaction_tasks_.erase(client_id);
+    }
+    std::erase_if(compaction_moves_, [&client_ids](const auto& entry) {
+        const CompactionMove& move = entry.second;
+        if (move.copied || std::find(client_ids.begin(), client_ids.end(),
+                                     move.client_id) == client_ids.end()) {
+            return false;
+        }
+        LOG(WARNING) << "key=" << move.key << ", task_id=" << entry.first
+                     << ", warn=compaction_client_expired";
+        if (!move.add_replica) {
+            MasterMetricManager::instance().inc_compaction_fail();
+        }
+        return true;
+    });
+}
+
+void MasterService::ReplicateHotKeys(
+    const std::vector<std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>&
+        allocators) {
+    {
+        MutexLocker lock(&hot_key_mutex_);
+        replicated_hot_keys_.insert(hot_key_candidates_.begin(),
+                                    hot_key_candidates_.end());
+        hot_key_candidates_.clear();
+    }
+
+    std::vector<std::pair<uint64_t, CompactionMove>> moves;
+    for (auto it = replicated_hot_keys_.begin();
+         it != replicated_hot_keys_.end();) {
+        if (ReplicateHotKey(*it, allocators, moves)) {
+            ++it;
+        } else {
+            it = replicated_hot_keys_.erase(it);
+        }
+    }
+    if (!moves.empty()) {
+        VLOG(1) << "move_count=" << moves.size()
+                << ", action=issue_hot_key_replicas";
+        IssueMoves(moves);
+    }
+
+    // Keeps the counts at about twice the reads per pass
+    read_sketch_->Decay();
+}
+
+bool MasterService::ReplicateHotKey(
+    const std::string& key,
+    const std::vector<std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>&
+        allocators,
+    std::vector<std::pair<uint64_t, CompactionMove>>& moves) {
+    MetadataAccessor accessor(this, key);
+    if (!accessor.Exists()) {
+        return false;
+    }
+    auto& metadata = accessor.Get();
+    if (metadata.compaction_task_id != 0) {
+        MutexLocker lock(&compaction_mutex_);
+        if (compaction_moves_.count(metadata.compaction_task_id) > 0) {
+            // Wait for the move in flight, its replica is dropped later on
+            return true;
+        }
+    }
+
+    size_t mem_replicas = metadata.GetMemReplicaCount();
+    if (read_sketch_->Estimate(key) * 2 < hot_key_read_threshold_) {
+        if (mem_replicas <= metadata.put_replica_num) {
+            return false;
+        }
+        // Readers holding a lease may still be reading the extra replicas
+        if (!metadata.IsLeaseExpired(CurrentLeaseEpoch())) {
+            return true;
+        }
+        accessor.UnindexSegments();
+        size_t dropped = 0;
+        for (auto it = metadata.replicas.end();
+             it != metadata.replicas.begin() &&
+             mem_replicas - dropped > metadata.put_replica_num;) {
+            --it;
+            // Shared buffers stay with the objects of the same content, and
+            // their readers hold no lease on this object
+            if (it->is_memory_replica() && !it->has_shared_buffers()) {
+                it = metadata.replicas.erase(it);
+                ++dropped;
+            }
+        }
+        metadata.ChargeNamespace();
+        accessor.IndexSegments();
+        MasterMetricManager::instance().inc_hot_key_replicas_dropped(dropped);
+        VLOG(1) << "key=" << key << ", dropped=" << dropped
+                << ", action=drop_hot_key_replicas";
+        return false;
+    }
+
+    if (mem_replicas == 0 ||
+        mem_replicas >= metadata.put_replica_num + hot_key_extra_replicas_ ||
+        metadata.IsDropped() ||
+        metadata.HasDiffRepStatus(ReplicaStatus::COMPLETE,
+                                  ReplicaType::MEMORY)) {
+        return true;
+    }
+    // The extra replica is charged to the namespace of the object, which
+    // must not be pushed over its quota for it
+    if (!metadata.name_space->HasRoom(metadata.size)) {
+        VLOG(1) << "key=" << key << ", namespace=" << metadata.name_space->name
+                << ", info=hot_key_replica_exceeds_quota";
+        return true;
+    }
+
+    // Copy from a replica held by one client to the emptiest segment
+    // without a replica of the object, unless that would push it over the
+    // eviction watermark
+    std::unordered_set<std::string> used_segments;
+    for (const auto& replica : metadata.replicas) {
+        for (const auto& name : replica.get_segment_names()) {
+            if (name) {
+                used_segments.insert(*name);
+            }
+        }
+    }
+    std::optional<Replica::Descriptor> source;
+    UUID source_client;
+    const std::shared_ptr<BufferAllocatorBase>* target_allocator = nullptr;
+    for (const auto& [client_id, allocator] : allocators) {
+        if (!source) {
+            for (const auto& replica : metadata.replicas) {
+                if (!replica.is_memory_replica()) {
+                    continue;
+                }
+                auto descriptor = replica.get_descriptor();
+                if (replica.get_buffer_indexes(allocator.get()).size() ==
+                    descriptor.get_memory_descriptor()
+                        .buffer_descriptors.size()) {
+                    source = std::move(descriptor);
+                    source_client = client_id;
+                    break;
+                }
+            }
+        }
+        if (used_segments.contains(allocator->getSegmentName()) ||
+            allocator->size() + metadata.size >
+                eviction_high_watermark_ratio_ * allocator->capacity()) {
+            continue;
+        }
+        if (!target_allocator ||
+            allocator->capacity() - allocator->size() >
+                (*target_allocator)->capacity() -
+                    (*target_allocator)->size()) {
+            target_allocator = &allocator;
+        }
+    }
+    if (!source || !target_allocator) {
+        return true;
+    }
+
+    CompactionMove move;
+    move.key = key;
+    move.client_id = source_client;
+    move.deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(kCompactionMoveTimeoutMs);
+    move.add_replica = true;
+    move.sources = source->get_memory_descriptor().buffer_descriptors;
+    for (const auto& buffer : move.sources) {
+        auto target = (*target_allocator)->allocate(buffer.size_);
+        if (!target) {
+            return true;
+        }
+        move.targets.push_back(std::move(target));
+    }
+    uint64_t task_id = next_compaction_task_id_.fetch_add(1);
+    metadata.compaction_task_id = task_id;
+    moves.emplace_back(task_id, std::move(move));
+    return true;
+}
+
 void MasterService::BatchEvict(double evict_ratio_target,
                                double evict_ratio_lowerbound) {
     if (evict_ratio_target < evict_ratio_lowerbound) {
@@ -689,14 +1816,14 @@ void MasterService::BatchEvict(double evict_ratio_target,
         evict_ratio_lowerbound = evict_ratio_target;
     }
 
-    auto now = std::chrono::steady_clock::now();
+    const uint64_t now = CurrentLeaseEpoch();
     long evicted_count = 0;
     long object_count = 0;
     uint64_t total_freed_size = 0;
 
     // Candidates for second pass eviction
-    std::vector<std::chrono::steady_clock::time_point> no_pin_objects;
-    std::vector<std::chrono::steady_clock::time_point> soft_pin_objects;
+    std::vector<uint64_t> no_pin_objects;
+    std::vector<uint64_t> soft_pin_objects;
 
     // Randomly select a starting shard to avoid imbalance eviction between
     // shards. No need to use expensive random_device here.
@@ -706,7 +1833,7 @@ void MasterService::BatchEvict(double evict_ratio_target,
     for (size_t i = 0; i < metadata_shards_.size(); i++) {
         auto& shard =
             metadata_shards_[(start_idx + i) % metadata_shards_.size()];
-        MutexLocker lock(&shard.mutex);
+        ShardLocker lock(&shard);
 
         // object_count must be updated at beginning as it will be used later
         // to compute ideal_evict_num
@@ -717,8 +1844,7 @@ void MasterService::BatchEvict(double evict_ratio_target,
         const long ideal_evict_num =
             std::ceil(object_count * evict_ratio_target) - evicted_count;
 
-        std::vector<std::chrono::steady_clock::time_point>
-            candidates;  // can be removed
+        std::vector<uint64_t> candidates;  // can be removed
         for (auto it = shard.metadata.begin(); it != shard.metadata.end();
              it++) {
             // Skip objects that are not expired or have incomplete replicas
@@ -730,16 +1856,16 @@ void MasterService::BatchEvict(double evict_ratio_target,
             if (!it->second.IsSoftPinned(now)) {
                 if (ideal_evict_num > 0) {
                     // first pass candidates
-                    candidates.push_back(it->second.lease_timeout);
+                    candidates.push_back(it->second.LeaseExpiry());
                 } else {
                     // No need to evict any object in this shard, put to
                     // second pass candidates
-                    no_pin_objects.push_back(it->second.lease_timeout);
+                    no_pin_objects.push_back(it->second.LeaseExpiry());
                 }
             } else if (allow_evict_soft_pinned_objects_) {
                 // second pass candidates, only if
                 // allow_evict_soft_pinned_objects_ is true
-                soft_pin_objects.push_back(it->second.lease_timeout);
+                soft_pin_objects.push_back(it->second.LeaseExpiry());
             }
         }
 
@@ -764,21 +1890,15 @@ void MasterService::BatchEvict(double evict_ratio_target,
                     ++it;
                     continue;
                 }
-                if (it->second.lease_timeout <= target_timeout) {
+                if (it->second.LeaseExpiry() <= target_timeout) {
                     // Evict this object
                     total_freed_size +=
                         it->second.size * it->second.GetMemReplicaCount();
-                    it->second.EraseReplica(
-                        ReplicaType::MEMORY);  // Erase memory replicas
-                    if (it->second.IsValid() == false) {
-                        it = shard.metadata.erase(it);
-                    } else {
-                        ++it;
-                    }
+                    it = shard.EvictMemReplicas(it);
                     shard_evicted_count++;
                 } else {
                     // second pass candidates
-                    no_pin_objects.push_back(it->second.lease_timeout);
+                    no_pin_objects.push_back(it->second.LeaseExpiry());
                     ++it;
                 }
             }
@@ -817,10 +1937,10 @@ void MasterService::BatchEvict(double evict_ratio_target,
                  i < metadata_shards_.size() && target_evict_num > 0; i++) {
                 auto& shard =
                     metadata_shards_[(start_idx + i) % metadata_shards_.size()];
-                MutexLocker lock(&shard.mutex);
+                ShardLocker lock(&shard);
                 auto it = shard.metadata.begin();
                 while (it != shard.metadata.end() && target_evict_num > 0) {
-                    if (it->second.lease_timeout <= target_timeout &&
+                    if (it->second.LeaseExpiry() <= target_timeout &&
                         !it->second.IsSoftPinned(now) &&
                         !it->second.HasDiffRepStatus(ReplicaStatus::COMPLETE,
                                                      ReplicaType::MEMORY) &&
@@ -828,13 +1948,7 @@ void MasterService::BatchEvict(double evict_ratio_target,
                         // Evict this object
                         total_freed_size +=
                             it->second.size * it->second.GetMemReplicaCount();
-                        it->second.EraseReplica(
-                            ReplicaType::MEMORY);  // Erase memory replicas
-                        if (it->second.IsValid() == false) {
-                            it = shard.metadata.erase(it);
-                        } else {
-                            ++it;
-                        }
+                        it = shard.EvictMemReplicas(it);
                         evicted_count++;
                         target_evict_num--;
                     } else {
@@ -862,7 +1976,7 @@ void MasterService::BatchEvict(double evict_ratio_target,
                  i < metadata_shards_.size() && target_evict_num > 0; i++) {
                 auto& shard =
                     metadata_shards_[(start_idx + i) % metadata_shards_.size()];
-                MutexLocker lock(&shard.mutex);
+                ShardLocker lock(&shard);
 
                 auto it = shard.metadata.begin();
                 while (it != shard.metadata.end() && target_evict_num > 0) {
@@ -878,16 +1992,10 @@ void MasterService::BatchEvict(double evict_ratio_target,
                     // Evict objects with 1). no soft pin OR 2). with soft pin
                     // and lease timeout less than or equal to target.
                     if (!it->second.IsSoftPinned(now) ||
-                        it->second.lease_timeout <= soft_target_timeout) {
+                        it->second.LeaseExpiry() <= soft_target_timeout) {
                         total_freed_size +=
                             it->second.size * it->second.GetMemReplicaCount();
-                        it->second.EraseReplica(
-                            ReplicaType::MEMORY);  // Erase memory replicas
-                        if (it->second.IsValid() == false) {
-                            it = shard.metadata.erase(it);
-                        } else {
-                            ++it;
-                        }
+                        it = shard.EvictMemReplicas(it);
                         evicted_count++;
                         target_evict_num--;
                     } else {
@@ -924,6 +2032,279 @@ void MasterService::BatchEvict(double evict_ratio_target,
             << ", total_freed_size=" << total_freed_size;
 }
 
+auto MasterService::EvictForPut(const std::string& key, uint64_t size,
+                                uint64_t& retry_after_ms)
+    -> PutEvictionResult {
+    using MetadataIterator =
+        std::unordered_map<std::string, ObjectMetadata>::iterator;
+
+    const uint64_t now = CurrentLeaseEpoch();
+    long evicted_count = 0;
+    uint64_t freed_size = 0;
+    bool has_candidates = false;
+    bool not_admitted = false;
+    // The earliest lease expiry of the objects being read
+    uint64_t min_lease_expiry = UINT64_MAX;
+
+    size_t start_idx = rand() % metadata_shards_.size();
+    size_t num_shards =
+        std::min(kInlineEvictionMaxShards, metadata_shards_.size());
+    for (size_t i = 0; i < num_shards && freed_size < size; i++) {
+        auto& shard =
+            metadata_shards_[(start_idx + i) % metadata_shards_.size()];
+        ShardLocker lock(&shard);
+
+        // Ordered by soft pin, then lease expiry, so that soft pinned objects
+        // go last
+        std::vector<std::pair<std::pair<bool, uint64_t>, MetadataIterator>>
+            candidates;
+        for (auto it = shard.metadata.begin(); it != shard.metadata.end();
+             ++it) {
+            const auto& metadata = it->second;
+            if (metadata.HasDiffRepStatus(ReplicaStatus::COMPLETE,
+                                          ReplicaType::MEMORY) ||
+                !metadata.HasMemReplica()) {
+                continue;
+            }
+            if (!metadata.IsLeaseExpired(now)) {
+                min_lease_expiry =
+                    std::min(min_lease_expiry, metadata.LeaseExpiry());
+                continue;
+            }
+            bool soft_pinned = metadata.IsSoftPinned(now);
+            if (!soft_pinned || allow_evict_soft_pinned_objects_) {
+                candidates.push_back(
+                    {{soft_pinned, metadata.LeaseExpiry()}, it});
+            }
+        }
+        has_candidates |= !candidates.empty();
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto& lhs, const auto& rhs) {
+                      return lhs.first < rhs.first;
+                  });
+
+        for (const auto& [order, it] : candidates) {
+            if (freed_size >= size) {
+                break;
+            }
+            if (!admission_policy_->Admit(key, it->first)) {
+                not_admitted = true;
+                continue;
+            }
+            // Buffers shared with other objects are only freed along with
+            // the last of them
+            freed_size += it->second.GetUnsharedMemSize();
+            shard.EvictMemReplicas(it);
+            evicted_count++;
+        }
+    }
+
+    if (evicted_count > 0) {
+        MasterMetricManager::instance().inc_eviction_success(evicted_count,
+                                                             freed_size);
+    } else {
+        MasterMetricManager::instance().inc_eviction_fail();
+    }
+    VLOG(1) << "action=evict_objects_for_put, key=" << key
+            << ", size=" << size << ", evicted_count=" << evicted_count
+            << ", freed_size=" << freed_size
+            << ", not_admitted=" << not_admitted;
+
+    if (freed_size >= size) {
+        return PutEvictionResult::FREED;
+    }
+    if (!has_candidates && min_lease_expiry != UINT64_MAX) {
+        retry_after_ms = std::max(retry_after_ms,
+                                  (min_lease_expiry - now) * kLeaseEpochMs);
+    }
+    return not_admitted ? PutEvictionResult::NOT_ADMITTED
+                        : PutEvictionResult::NO_VICTIMS;
+}
+
+void MasterService::BatchEvictNamespaces() {
+    need_namespace_eviction_ = false;
+
+    // Bytes to free in each namespace above its quota
+    std::unordered_map<Namespace*, uint64_t> to_free;
+    {
+        std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+        for (const auto& [name, ns] : namespaces_) {
+            uint64_t quota = ns->quota;
+            if (!ns->need_eviction.exchange(false) || quota == 0) {
+                continue;
+            }
+            uint64_t target_size =
+                static_cast<uint64_t>(quota * (1.0 - eviction_ratio_));
+            uint64_t used_size = ns->used_size;
+            if (used_size > target_size) {
+                to_free.emplace(ns.get(), used_size - target_size);
+            }
+        }
+    }
+    if (to_free.empty()) {
+        return;
+    }
+
+    const uint64_t now = CurrentLeaseEpoch();
+    auto can_evict = [&](const ObjectMetadata& metadata) {
+        return metadata.IsLeaseExpired(now) &&
+               !metadata.HasDiffRepStatus(ReplicaStatus::COMPLETE,
+                                          ReplicaType::MEMORY) &&
+               metadata.HasMemReplica() &&
+               (allow_evict_soft_pinned_objects_ ||
+                !metadata.IsSoftPinned(now));
+    };
+
+    // First pass: collect the lease expiries and sizes of the candidates
+    std::unordered_map<Namespace*, std::vector<std::pair<uint64_t, uint64_t>>>
+        candidates;
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard);
+        for (const auto& entry : to_free) {
+            Namespace* ns = entry.first;
+            auto keys = shard.namespace_keys.find(ns);
+            if (keys == shard.namespace_keys.end()) {
+                continue;
+            }
+            for (const auto& key : keys->second) {
+                const auto& metadata = shard.metadata.at(key);
+                if (can_evict(metadata)) {
+                    candidates[ns].emplace_back(metadata.LeaseExpiry(),
+                                                metadata.charged_size);
+                }
+            }
+        }
+    }
+
+    // The lease expiry up to which the oldest objects free enough bytes
+    std::unordered_map<Namespace*, uint64_t> target_timeouts;
+    for (auto& [ns, objects] : candidates) {
+        std::sort(objects.begin(), objects.end());
+        uint64_t freed_size = 0;
+        for (const auto& [lease_expiry, size] : objects) {
+            target_timeouts[ns] = lease_expiry;
+            freed_size += size;
+            if (freed_size >= to_free[ns]) {
+                break;
+            }
+        }
+    }
+
+    // Second pass: evict the objects up to the target timeouts
+    long evicted_count = 0;
+    uint64_t total_freed_size = 0;
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard);
+        for (const auto& [ns, target_timeout] : target_timeouts) {
+            auto keys = shard.namespace_keys.find(ns);
+            if (keys == shard.namespace_keys.end()) {
+                continue;
+            }
+            // Chosen before evicting, as evicting updates the key set
+            std::vector<std::string> victims;
+            for (const auto& key : keys->second) {
+                if (to_free[ns] == 0) {
+                    break;
+                }
+                const auto& metadata = shard.metadata.at(key);
+                if (metadata.LeaseExpiry() > target_timeout ||
+                    !can_evict(metadata)) {
+                    continue;
+                }
+                to_free[ns] -= std::min(to_free[ns], metadata.charged_size);
+                total_freed_size += metadata.charged_size;
+                victims.push_back(key);
+            }
+            for (const auto& key : victims) {
+                shard.EvictMemReplicas(shard.metadata.find(key));
+                evicted_count++;
+            }
+        }
+    }
+
+    if (evicted_count > 0) {
+        MasterMetricManager::instance().inc_eviction_success(evicted_count,
+                                                             total_freed_size);
+    } else {
+        MasterMetricManager::instance().inc_eviction_fail();
+    }
+    VLOG(1) << "action=evict_namespace_objects"
+            << ", evicted_count=" << evicted_count
+            << ", total_freed_size=" << total_freed_size;
+}
+
+void MasterService::ReclaimDroppedObjects() {
+    // Cleared first, so that a drop during the pass is not missed
+    need_reclaim_dropped_ = false;
+
+    std::vector<Namespace*> dropped;
+    {
+        std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+        for (const auto& [name, ns] : namespaces_) {
+            if (ns->need_reclaim.exchange(false)) {
+                dropped.push_back(ns.get());
+            }
+        }
+    }
+
+    const uint64_t now = CurrentLeaseEpoch();
+    long reclaimed_count = 0;
+    std::unordered_set<Namespace*> pending;
+    for (auto& shard : metadata_shards_) {
+        ShardLocker lock(&shard);
+        for (Namespace* ns : dropped) {
+            auto keys = shard.namespace_keys.find(ns);
+            if (keys == shard.namespace_keys.end()) {
+                continue;
+            }
+            // Chosen before erasing, as erasing updates the key set
+            std::vector<std::string> reclaimed;
+            for (const auto& key : keys->second) {
+                const auto& metadata = shard.metadata.at(key);
+                if (!metadata.IsDropped()) {
+                    continue;
+                }
+                // Objects being read or written are reclaimed later
+                if (!metadata.IsLeaseExpired(now) ||
+                    !metadata.IsAllReplicasComplete()) {
+                    pending.insert(ns);
+                    continue;
+                }
+                reclaimed.push_back(key);
+            }
+            for (const auto& key : reclaimed) {
+                shard.Erase(shard.metadata.find(key));
+                reclaimed_count++;
+            }
+        }
+    }
+
+    for (Namespace* ns : pending) {
+        ns->need_reclaim = true;
+    }
+    if (!pending.empty()) {
+        need_reclaim_dropped_ = true;
+    }
+    VLOG(1) << "action=reclaim_dropped_objects"
+            << ", reclaimed_count=" << reclaimed_count
+            << ", pending_namespaces=" << pending.size();
+}
+
+void MasterService::UpdateNamespaceMetrics() {
+    auto& metrics = MasterMetricManager::instance();
+    std::shared_lock<std::shared_mutex> lock(namespace_mutex_);
+    for (const auto& [name, ns] : namespaces_) {
+        metrics.set_namespace_usage(name, ns->used_size, ns->quota,
+                                    ns->key_count);
+        if (int64_t evicted = ns->evicted_count.exchange(0)) {
+            metrics.inc_namespace_evicted_keys(name, evicted);
+        }
+        if (int64_t rejected = ns->rejected_puts.exchange(0)) {
+            metrics.inc_namespace_quota_rejections(name, rejected);
+        }
+    }
+}
+
 void MasterService::ClientMonitorFunc() {
     std::unordered_map<UUID, std::chrono::steady_clock::time_point,
                        boost::hash<UUID>>
@@ -954,6 +2335,9 @@ void MasterService::ClientMonitorFunc() {
 
         // Update the client status to NEED_REMOUNT
         if (!expired_clients.empty()) {
+            // The expired clients no longer write the targets of their moves
+            DropClientMoves(expired_clients);
+
             // Record which segments are unmounted, will be used in the commit
             // phase.
             std::vector<UUID> unmount_segments;
@@ -998,7 +2382,9 @@ void MasterService::ClientMonitorFunc() {
                // avoid deadlocks
 
             if (!unmount_segments.empty()) {
-                ClearInvalidHandles();
+                for (const auto& segment_id : unmount_segments) {
+                    ClearInvalidHandles(segment_id);
+                }
 
                 ScopedSegmentAccess segment_access =
                     segment_manager_.getSegmentAccess();
@@ -3,6 +3,8 @@
 
 #include "offset_allocator/offset_allocator.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -658,6 +660,100 @@ void OffsetAllocator::freeAllocation(const OffsetAllocation& allocation,
     }
 }
 
+// ShardedOffsetAllocator implementation
+std::shared_ptr<ShardedOffsetAllocator> ShardedOffsetAllocator::create(
+    uint64_t base, size_t size, uint32 num_shards, uint32 init_capacity,
+    uint32 max_capacity) {
+    return std::shared_ptr<ShardedOffsetAllocator>(new ShardedOffsetAllocator(
+        base, size, num_shards, init_capacity, max_capacity));
+}
+
+ShardedOffsetAllocator::ShardedOffsetAllocator(uint64_t base, size_t size,
+                                               uint32 num_shards,
+                                               uint32 init_capacity,
+                                               uint32 max_capacity)
+    : m_capacity(size) {
+    uint64_t shards = num_shards;
+    if (shards == 0) {
+        shards = std::min<uint64_t>(
+            kDefaultNumShards, std::max<uint64_t>(1, size / kMinShardSize));
+    }
+    shards = std::max<uint64_t>(shards,
+                                (size + kMaxShardSize - 1) / kMaxShardSize);
+    shards = std::max<uint64_t>(shards, 1);
+
+    // Page aligned arenas, the last one takes the remainder
+    constexpr uint64_t kShardAlignment = 4096;
+    m_shard_size = (size + shards - 1) / shards;
+    m_shard_size = (m_shard_size + kShardAlignment - 1) / kShardAlignment *
+                   kShardAlignment;
+    m_shard_size = std::min<uint64_t>(m_shard_size, kMaxShardSize);
+    m_shard_size = std::max<uint64_t>(m_shard_size, 1);
+    shards = (size + m_shard_size - 1) / m_shard_size;
+
+    uint32 shard_init_capacity =
+        std::max<uint32>(init_capacity / std::max<uint64_t>(shards, 1), 1024);
+    uint32 shard_max_capacity =
+        std::max<uint32>(max_capacity / std::max<uint64_t>(shards, 1), 4096);
+    m_shards.reserve(shards);
+    for (uint64_t offset = 0; offset < size; offset += m_shard_size) {
+        m_shards.push_back(OffsetAllocator::create(
+            base + offset, std::min<uint64_t>(m_shard_size, size - offset),
+            shard_init_capacity, shard_max_capacity));
+    }
+}
+
+std::optional<OffsetAllocationHandle> ShardedOffsetAllocator::allocate(
+    size_t size) {
+    if (size == 0 || size > m_shard_size || m_shards.empty()) {
+        return std::nullopt;
+    }
+
+    // Threads are numbered in the order they first allocate, which spreads
+    // them evenly over the arenas
+    static std::atomic<uint32> next_thread_index{0};
+    thread_local const uint32 thread_index =
+        next_thread_index.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t num_shards = m_shards.size();
+    const size_t home = thread_index % num_shards;
+    for (size_t i = 0; i < num_shards; i++) {
+        auto handle = m_shards[(home + i) % num_shards]->allocate(size);
+        if (handle) {
+            return handle;
+        }
+    }
+    return std::nullopt;
+}
+
+OffsetAllocStorageReport ShardedOffsetAllocator::storageReport() const {
+    OffsetAllocStorageReport report{0, 0};
+    for (const auto& shard : m_shards) {
+        auto shard_report = shard->storageReport();
+        report.totalFreeSpace += shard_report.totalFreeSpace;
+        report.largestFreeRegion = std::max(report.largestFreeRegion,
+                                            shard_report.largestFreeRegion);
+    }
+    return report;
+}
+
+OffsetAllocatorMetrics ShardedOffsetAllocator::get_metrics() const {
+    uint64_t allocated_size = 0;
+    uint64_t allocated_num = 0;
+    uint64_t largest_free_region = 0;
+    uint64_t total_free_space = 0;
+    for (const auto& shard : m_shards) {
+        auto metrics = shard->get_metrics();
+        allocated_size += metrics.allocated_size_;
+        allocated_num += metrics.allocated_num_;
+        largest_free_region =
+            std::max(largest_free_region, metrics.largest_free_region_);
+        total_free_space += metrics.total_free_space_;
+    }
+    return {allocated_size, allocated_num, largest_free_region,
+            total_free_space, m_capacity};
+}
+
 // Stream output operator implementation
 std::ostream& operator<<(std::ostream& os,
                          const OffsetAllocatorMetrics& metrics) {
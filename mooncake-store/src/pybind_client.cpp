@@ -274,6 +274,66 @@ int PyClient::initAll(const std::string &protocol_,
         initAll_internal(protocol_, device_name, mount_segment_size));
 }
 
+tl::expected<void, ErrorCode> PyClient::mount_segments_internal(
+    size_t size_per_node, size_t page_size, const std::vector<int> &numa_nodes,
+    size_t prefault_threads) {
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return tl::unexpected(ErrorCode::INVALID_PARAMS);
+    }
+    std::vector<int> nodes = numa_nodes;
+    if (nodes.empty()) {
+        if (numa_available() < 0) {
+            nodes.push_back(-1);
+        } else {
+            for (int node = 0; node <= numa_max_node(); ++node) {
+                if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+                    nodes.push_back(node);
+                }
+            }
+        }
+    }
+
+    // Segments larger than max_mr_size are split like in setup, on page
+    // boundaries
+    size_t max_segment_size = globalConfig().max_mr_size;
+    if (page_size != 0) {
+        max_segment_size -= max_segment_size % page_size;
+    }
+    for (int node : nodes) {
+        for (size_t mounted_size = 0; mounted_size < size_per_node;) {
+            size_t segment_size =
+                std::min(size_per_node - mounted_size, max_segment_size);
+            LOG(INFO) << "Mounting segment: " << segment_size
+                      << " bytes, page_size=" << page_size
+                      << ", numa_node=" << node;
+            void *ptr = map_segment_memory(segment_size, page_size, node,
+                                           prefault_threads);
+            if (!ptr) {
+                LOG(ERROR) << "Failed to map segment memory";
+                return tl::unexpected(ErrorCode::INVALID_PARAMS);
+            }
+            mapped_segment_ptrs_.emplace_back(
+                ptr, MappedSegmentDeleter{segment_size});
+            auto mount_result = client_->MountSegment(ptr, segment_size);
+            if (!mount_result.has_value()) {
+                LOG(ERROR) << "Failed to mount segment: "
+                           << toString(mount_result.error());
+                return tl::unexpected(mount_result.error());
+            }
+            mounted_size += segment_size;
+        }
+    }
+    return {};
+}
+
+int PyClient::mount_segments(size_t size_per_node, size_t page_size,
+                             const std::vector<int> &numa_nodes,
+                             size_t prefault_threads) {
+    return to_py_ret(mount_segments_internal(size_per_node, page_size,
+                                             numa_nodes, prefault_threads));
+}
+
 tl::expected<void, ErrorCode> PyClient::tearDownAll_internal() {
     // Ensure cleanup executes once across destructor/close/signal paths
     bool expected = false;
@@ -290,6 +350,7 @@ tl::expected<void, ErrorCode> PyClient::tearDownAll_internal() {
     client_buffer_allocator_.reset();
     port_binder_.reset();
     segment_ptrs_.clear();
+    mapped_segment_ptrs_.clear();
     local_hostname = "";
     device_name = "";
     protocol = "";
@@ -462,6 +523,95 @@ int PyClient::put_parts(const std::string &key,
     return to_py_ret(put_parts_internal(key, values, config));
 }
 
+std::vector<tl::expected<void, ErrorCode>> PyClient::batch_put_parts_internal(
+    const std::vector<std::string> &keys,
+    const std::vector<std::vector<std::span<const char>>> &all_values,
+    const ReplicateConfig &config) {
+    if (config.prefer_alloc_in_same_node) {
+        LOG(ERROR) << "prefer_alloc_in_same_node is not supported.";
+        return std::vector<tl::expected<void, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return std::vector<tl::expected<void, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+    if (keys.size() != all_values.size()) {
+        LOG(ERROR) << "Key and value size mismatch";
+        return std::vector<tl::expected<void, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+
+    std::vector<tl::expected<void, ErrorCode>> results(keys.size());
+    std::vector<BufferHandle> buffer_handles;
+    std::vector<std::string> batch_keys;
+    std::vector<std::vector<Slice>> batched_slices;
+    std::vector<size_t> batch_indices;
+    buffer_handles.reserve(keys.size());
+    batch_keys.reserve(keys.size());
+    batched_slices.reserve(keys.size());
+    batch_indices.reserve(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        size_t total_size = 0;
+        for (const auto &value : all_values[i]) {
+            total_size += value.size_bytes();
+        }
+        if (total_size == 0) {
+            LOG(ERROR) << "Attempting to put empty data for key: " << keys[i];
+            results[i] = tl::unexpected(ErrorCode::INVALID_PARAMS);
+            continue;
+        }
+        auto alloc_result = client_buffer_allocator_->allocate(total_size);
+        if (!alloc_result) {
+            LOG(ERROR) << "Failed to allocate buffer for batch_put_parts "
+                          "operation, key: "
+                       << keys[i] << ", total size: " << total_size;
+            results[i] = tl::unexpected(ErrorCode::INVALID_PARAMS);
+            continue;
+        }
+
+        auto &buffer_handle = *alloc_result;
+        size_t offset = 0;
+        for (const auto &value : all_values[i]) {
+            memcpy(static_cast<char *>(buffer_handle.ptr()) + offset,
+                   value.data(), value.size_bytes());
+            offset += value.size_bytes();
+        }
+        batched_slices.emplace_back(split_into_slices(buffer_handle));
+        buffer_handles.emplace_back(std::move(buffer_handle));
+        batch_keys.push_back(keys[i]);
+        batch_indices.push_back(i);
+    }
+
+    if (batch_keys.empty()) {
+        return results;
+    }
+
+    // buffer_handles keep the staged data alive until BatchPut returns
+    auto batch_results = client_->BatchPut(batch_keys, batched_slices, config);
+    for (size_t j = 0; j < batch_results.size(); ++j) {
+        results[batch_indices[j]] = std::move(batch_results[j]);
+    }
+    return results;
+}
+
+std::vector<int> PyClient::batch_put_parts(
+    const std::vector<std::string> &keys,
+    const std::vector<std::vector<std::span<const char>>> &all_values,
+    const ReplicateConfig &config) {
+    auto internal_results = batch_put_parts_internal(keys, all_values, config);
+    std::vector<int> results;
+    results.reserve(internal_results.size());
+
+    for (const auto &result : internal_results) {
+        results.push_back(to_py_ret(result));
+    }
+
+    return results;
+}
+
 tl::expected<void, ErrorCode> PyClient::remove_internal(
     const std::string &key) {
     if (!client_) {
@@ -492,6 +642,19 @@ long PyClient::removeByRegex(const std::string &str) {
     return to_py_ret(removeByRegex_internal(str));
 }
 
+tl::expected<long, ErrorCode> PyClient::removeByPrefix_internal(
+    const std::string &prefix) {
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return tl::unexpected(ErrorCode::INVALID_PARAMS);
+    }
+    return client_->RemoveByPrefix(prefix);
+}
+
+long PyClient::removeByPrefix(const std::string &prefix) {
+    return to_py_ret(removeByPrefix_internal(prefix));
+}
+
 tl::expected<int64_t, ErrorCode> PyClient::removeAll_internal() {
     if (!client_) {
         LOG(ERROR) << "Client is not initialized";
@@ -502,6 +665,32 @@ tl::expected<int64_t, ErrorCode> PyClient::removeAll_internal() {
 
 long PyClient::removeAll() { return to_py_ret(removeAll_internal()); }
 
+tl::expected<void, ErrorCode> PyClient::setNamespaceQuota_internal(
+    const std::string &name, uint64_t quota) {
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return tl::unexpected(ErrorCode::INVALID_PARAMS);
+    }
+    return client_->SetNamespaceQuota(name, quota);
+}
+
+int PyClient::setNamespaceQuota(const std::string &name, uint64_t quota) {
+    return to_py_ret(setNamespaceQuota_internal(name, quota));
+}
+
+tl::expected<void, ErrorCode> PyClient::dropNamespace_internal(
+    const std::string &name) {
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return tl::unexpected(ErrorCode::INVALID_PARAMS);
+    }
+    return client_->DropNamespace(name);
+}
+
+int PyClient::dropNamespace(const std::string &name) {
+    return to_py_ret(dropNamespace_internal(name));
+}
+
 tl::expected<bool, ErrorCode> PyClient::isExist_internal(
     const std::string &key) {
     if (!client_) {
@@ -852,6 +1041,97 @@ int64_t PyClient::get_into(const std::string &key, void *buffer, size_t size) {
     return to_py_ret(get_into_internal(key, buffer, size));
 }
 
+int64_t PyClient::get_range_into(const std::string &key, void *buffer,
+                                 uint64_t offset, size_t size) {
+    return batch_get_range_into({key}, {buffer}, {offset}, {size})[0];
+}
+
+std::vector<int64_t> PyClient::batch_get_range_into(
+    const std::vector<std::string> &keys, const std::vector<void *> &buffers,
+    const std::vector<uint64_t> &offsets, const std::vector<size_t> &sizes) {
+    auto internal_results =
+        batch_get_range_into_internal(keys, buffers, offsets, sizes);
+    std::vector<int64_t> results;
+    results.reserve(internal_results.size());
+
+    for (const auto &result : internal_results) {
+        results.push_back(to_py_ret(result));
+    }
+
+    return results;
+}
+
+std::vector<tl::expected<int64_t, ErrorCode>>
+PyClient::batch_get_range_into_internal(const std::vector<std::string> &keys,
+                                        const std::vector<void *> &buffers,
+                                        const std::vector<uint64_t> &offsets,
+                                        const std::vector<size_t> &sizes) {
+    // NOTE: The buffer addresses must be previously registered with
+    // register_buffer() for zero-copy RDMA operations to work correctly
+    if (!client_) {
+        LOG(ERROR) << "Client is not initialized";
+        return std::vector<tl::expected<int64_t, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+    if (keys.size() != buffers.size() || keys.size() != offsets.size() ||
+        keys.size() != sizes.size()) {
+        LOG(ERROR) << "Input vector sizes mismatch: keys=" << keys.size()
+                   << ", buffers=" << buffers.size()
+                   << ", offsets=" << offsets.size()
+                   << ", sizes=" << sizes.size();
+        return std::vector<tl::expected<int64_t, ErrorCode>>(
+            keys.size(), tl::unexpected(ErrorCode::INVALID_PARAMS));
+    }
+
+    std::vector<tl::expected<int64_t, ErrorCode>> results(keys.size());
+    const auto query_results = client_->BatchQuery(keys);
+
+    std::vector<std::string> valid_keys;
+    std::vector<QueryResult> valid_query_results;
+    std::vector<uint64_t> valid_offsets;
+    std::vector<std::vector<Slice>> valid_slices;
+    std::vector<size_t> valid_indices;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!query_results[i]) {
+            const auto error = query_results[i].error();
+            results[i] = tl::unexpected(error);
+            if (error != ErrorCode::OBJECT_NOT_FOUND &&
+                error != ErrorCode::REPLICA_IS_NOT_READY) {
+                LOG(ERROR) << "Query failed for key '" << keys[i]
+                           << "': " << toString(error);
+            }
+            continue;
+        }
+
+        // The range is split at the replica buffer boundaries by the client
+        std::vector<Slice> slices;
+        for (uint64_t offset = 0; offset < sizes[i]; offset += kMaxSliceSize) {
+            slices.emplace_back(
+                Slice{static_cast<char *>(buffers[i]) + offset,
+                      std::min<uint64_t>(sizes[i] - offset, kMaxSliceSize)});
+        }
+        valid_keys.push_back(keys[i]);
+        valid_query_results.push_back(query_results[i].value());
+        valid_offsets.push_back(offsets[i]);
+        valid_slices.push_back(std::move(slices));
+        valid_indices.push_back(i);
+    }
+
+    if (!valid_keys.empty()) {
+        auto range_results = client_->BatchGetRange(
+            valid_keys, valid_query_results, valid_offsets, valid_slices);
+        for (size_t j = 0; j < valid_indices.size(); ++j) {
+            size_t i = valid_indices[j];
+            if (range_results[j]) {
+                results[i] = static_cast<int64_t>(sizes[i]);
+            } else {
+                results[i] = tl::unexpected(range_results[j].error());
+            }
+        }
+    }
+    return results;
+}
+
 std::string PyClient::get_hostname() const { return local_hostname; }
 
 std::vector<int> PyClient::batch_put_from(const std::vector<std::string> &keys,
@@ -22,6 +22,8 @@
 namespace mooncake {
 
 const uint64_t kMetricReportIntervalSeconds = 10;
+// Keys per chunk of the /get_all_keys response
+const uint64_t kHttpScanKeysPageSize = 1000;
 
 WrappedMasterService::WrappedMasterService(
     const WrappedMasterServiceConfig& config)
@@ -102,23 +104,40 @@ void WrappedMasterService::init_http_server() {
             }
         });
 
+    // Streamed a page of keys per chunk, so that the master never holds all
+    // keys at once. Takes an optional prefix.
     http_server_.set_http_handler<GET>(
-        "/get_all_keys", [&](coro_http_request& req, coro_http_response& resp) {
+        "/get_all_keys",
+        [&](coro_http_request& req,
+            coro_http_response& resp) -> async_simple::coro::Lazy<void> {
+            std::string prefix(req.get_query_value("prefix"));
             resp.add_header("Content-Type", "text/plain; version=0.0.4");
+            resp.set_format_type(format_type::chunked);
+            if (!co_await resp.get_conn()->begin_chunked()) {
+                co_return;
+            }
 
-            auto result = master_service_.GetAllKeys();
-            if (result) {
+            std::string cursor;
+            do {
+                auto result = master_service_.ScanKeys(
+                    cursor, kHttpScanKeysPageSize, prefix);
+                if (!result) {
+                    LOG(ERROR) << "Failed to scan keys: "
+                               << toString(result.error());
+                    break;
+                }
                 std::string ss = "";
-                auto keys = result.value();
-                for (const auto& key : keys) {
+                for (const auto& key : result->keys) {
                     ss += key;
                     ss += "\n";
                 }
-                resp.set_status_and_content(status_type::ok, std::move(ss));
-            } else {
-                resp.set_status_and_content(status_type::internal_server_error,
-                                            "Failed to get all keys");
-            }
+                if (!ss.empty() &&
+                    !co_await resp.get_conn()->write_chunked(ss)) {
+                    co_return;
+                }
+                cursor = std::move(result->next_cursor);
+            } while (!cursor.empty());
+            co_await resp.get_conn()->end_chunked();
         });
 
     http_server_.set_http_handler<GET>(
@@ -233,6 +252,35 @@ WrappedMasterService::GetReplicaListByRegex(const std::string& str) {
         });
 }
 
+tl::expected<std::unordered_map<std::string, std::vector<Replica::Descriptor>>,
+             ErrorCode>
+WrappedMasterService::GetReplicaListByPrefix(const std::string& prefix) {
+    return execute_rpc(
+        "GetReplicaListByPrefix",
+        [&] { return master_service_.GetReplicaListByPrefix(prefix); },
+        [&](auto& timer) { timer.LogRequest("prefix=", prefix); },
+        [] {
+            MasterMetricManager::instance()
+                .inc_get_replica_list_by_prefix_requests();
+        },
+        [] {
+            MasterMetricManager::instance()
+                .inc_get_replica_list_by_prefix_failures();
+        });
+}
+
+tl::expected<ScanKeysResponse, ErrorCode> WrappedMasterService::ScanKeys(
+    const std::string& cursor, uint64_t limit, const std::string& prefix) {
+    ScopedVLogTimer timer(1, "ScanKeys");
+    timer.LogRequest("cursor=", cursor, ", limit=", limit,
+                     ", prefix=", prefix);
+
+    auto result = master_service_.ScanKeys(cursor, limit, prefix);
+
+    timer.LogResponseExpected(result);
+    return result;
+}
+
 tl::expected<GetReplicaListResponse, ErrorCode>
 WrappedMasterService::GetReplicaList(const std::string& key) {
     return execute_rpc(
@@ -342,6 +390,16 @@ WrappedMasterService::BatchPutStart(
         results;
     results.reserve(keys.size());
 
+    // A content hash is the hash of a single value
+    if (!config.content_hash.empty()) {
+        LOG(ERROR) << "BatchPutStart does not take a content_hash";
+        results.assign(keys.size(),
+                       tl::make_unexpected(ErrorCode::INVALID_PARAMS));
+        MasterMetricManager::instance().inc_batch_put_start_failures(
+            keys.size());
+        return results;
+    }
+
     if (config.prefer_alloc_in_same_node) {
         ReplicateConfig new_config = config;
         for (size_t i = 0; i < keys.size(); ++i) {
@@ -510,6 +568,18 @@ tl::expected<long, ErrorCode> WrappedMasterService::RemoveByRegex(
         [] { MasterMetricManager::instance().inc_remove_by_regex_failures(); });
 }
 
+tl::expected<long, ErrorCode> WrappedMasterService::RemoveByPrefix(
+    const std::string& prefix) {
+    return execute_rpc(
+        "RemoveByPrefix",
+        [&] { return master_service_.RemoveByPrefix(prefix); },
+        [&](auto& timer) { timer.LogRequest("prefix=", prefix); },
+        [] { MasterMetricManager::instance().inc_remove_by_prefix_requests(); },
+        [] {
+            MasterMetricManager::instance().inc_remove_by_prefix_failures();
+        });
+}
+
 long WrappedMasterService::RemoveAll() {
     ScopedVLogTimer timer(1, "RemoveAll");
     timer.LogRequest("action=remove_all_objects");
@@ -582,6 +652,40 @@ tl::expected<PingResponse, ErrorCode> WrappedMasterService::Ping(
     return result;
 }
 
+tl::expected<void, ErrorCode> WrappedMasterService::MoveEnd(
+    const UUID& client_id, uint64_t task_id, bool success) {
+    ScopedVLogTimer timer(1, "MoveEnd");
+    timer.LogRequest("client_id=", client_id, ", task_id=", task_id,
+                     ", success=", success);
+
+    auto result = master_service_.MoveEnd(client_id, task_id, success);
+
+    timer.LogResponseExpected(result);
+    return result;
+}
+
+tl::expected<void, ErrorCode> WrappedMasterService::SetNamespaceQuota(
+    const std::string& name, uint64_t quota) {
+    ScopedVLogTimer timer(1, "SetNamespaceQuota");
+    timer.LogRequest("name=", name, ", quota=", quota);
+
+    auto result = master_service_.SetNamespaceQuota(name, quota);
+
+    timer.LogResponseExpected(result);
+    return result;
+}
+
+tl::expected<void, ErrorCode> WrappedMasterService::DropNamespace(
+    const std::string& name) {
+    ScopedVLogTimer timer(1, "DropNamespace");
+    timer.LogRequest("name=", name);
+
+    auto result = master_service_.DropNamespace(name);
+
+    timer.LogResponseExpected(result);
+    return result;
+}
+
 tl::expected<void, ErrorCode> WrappedMasterService::ServiceReady() {
     return {};
 }
@@ -594,6 +698,11 @@ void RegisterRpcService(
     server.register_handler<
         &mooncake::WrappedMasterService::GetReplicaListByRegex>(
         &wrapped_master_service);
+    server.register_handler<
+        &mooncake::WrappedMasterService::GetReplicaListByPrefix>(
+        &wrapped_master_service);
+    server.register_handler<&mooncake::WrappedMasterService::ScanKeys>(
+        &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::GetReplicaList>(
         &wrapped_master_service);
     server
@@ -615,6 +724,8 @@ void RegisterRpcService(
         &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::RemoveByRegex>(
         &wrapped_master_service);
+    server.register_handler<&mooncake::WrappedMasterService::RemoveByPrefix>(
+        &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::RemoveAll>(
         &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::MountSegment>(
@@ -625,6 +736,13 @@ void RegisterRpcService(
         &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::Ping>(
         &wrapped_master_service);
+    server.register_handler<&mooncake::WrappedMasterService::MoveEnd>(
+        &wrapped_master_service);
+    server.register_handler<
+        &mooncake::WrappedMasterService::SetNamespaceQuota>(
+        &wrapped_master_service);
+    server.register_handler<&mooncake::WrappedMasterService::DropNamespace>(
+        &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::GetFsdir>(
         &wrapped_master_service);
     server.register_handler<&mooncake::WrappedMasterService::BatchExistKey>(
@@ -56,6 +56,10 @@ ErrorCode ScopedSegmentAccess::MountSegment(const Segment& segment,
                 allocator = std::make_shared<OffsetBufferAllocator>(
                     segment.name, buffer, size, segment.te_endpoint);
                 break;
+            case BufferAllocatorType::SHARDED_OFFSET:
+                allocator = std::make_shared<ShardedOffsetBufferAllocator>(
+                    segment.name, buffer, size, segment.te_endpoint);
+                break;
             default:
                 LOG(ERROR) << "segment_name=" << segment.name
                            << ", error=unknown_memory_allocator="
@@ -75,6 +79,7 @@ ErrorCode ScopedSegmentAccess::MountSegment(const Segment& segment,
         return ErrorCode::INVALID_PARAMS;
     }
 
+    allocator->setSegmentId(segment.id);
     segment_manager_->allocators_.push_back(allocator);
     segment_manager_->allocators_by_name_[segment.name].push_back(allocator);
     segment_manager_->client_segments_[client_id].push_back(segment.id);
@@ -236,6 +241,23 @@ ErrorCode ScopedSegmentAccess::GetAllSegments(
     return ErrorCode::OK;
 }
 
+ErrorCode ScopedSegmentAccess::GetClientAllocators(
+    std::vector<std::pair<UUID, std::shared_ptr<BufferAllocatorBase>>>&
+        allocators) const {
+    allocators.clear();
+    for (const auto& [client_id, segment_ids] :
+         segment_manager_->client_segments_) {
+        for (const auto& segment_id : segment_ids) {
+            auto it = segment_manager_->mounted_segments_.find(segment_id);
+            if (it != segment_manager_->mounted_segments_.end() &&
+                it->second.status == SegmentStatus::OK) {
+                allocators.emplace_back(client_id, it->second.buf_allocator);
+            }
+        }
+    }
+    return ErrorCode::OK;
+}
+
 ErrorCode ScopedSegmentAccess::QuerySegments(const std::string& segment,
                                              size_t& used, size_t& capacity) {
     const auto& allocators =
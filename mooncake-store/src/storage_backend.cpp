@@ -220,12 +220,16 @@ void StorageBackend::RemoveByRegex(const std::string& regex_pattern) {
     }
 
     std::vector<fs::path> paths_to_remove;
+    // Files are spread by hash, but the regex only has to run on the names
+    // with its literal prefix
+    const std::string prefix = regexLiteralPrefix(regex_pattern);
 
     for (const auto& entry : fs::recursive_directory_iterator(storage_root)) {
         if (fs::is_regular_file(entry.status())) {
             std::string filename = entry.path().filename().string();
 
-            if (std::regex_search(filename, pattern)) {
+            if (filename.starts_with(prefix) &&
+                std::regex_search(filename, pattern)) {
                 paths_to_remove.push_back(entry.path());
             }
         }
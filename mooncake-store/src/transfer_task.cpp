@@ -1,9 +1,12 @@
 #include "transfer_task.h"
 
+#include <async_simple/coro/FutureAwaiter.h>
 #include <glog/logging.h>
 
 #include <algorithm>
 #include <cstdlib>
+#include <tuple>
+#include <unordered_map>
 #include "transfer_engine.h"
 
 namespace mooncake {
@@ -294,21 +297,25 @@ void TransferEngineOperationState::wait_for_completion() {
     }
 
     VLOG(1) << "Starting transfer engine polling for batch " << batch_id_;
-    constexpr int64_t timeout_seconds = 60;
     constexpr int64_t kOneSecondInNano = 1000 * 1000 * 1000;
 
     const int64_t start_ts = getCurrentTimeInNano();
 
     while (true) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // The operation may have been failed by fail() meanwhile
+        if (result_.has_value()) {
+            break;
+        }
         if (getCurrentTimeInNano() - start_ts >
-            timeout_seconds * kOneSecondInNano) {
+            kTransferTimeoutSeconds * kOneSecondInNano) {
             LOG(ERROR) << "Failed to complete transfers after "
-                       << timeout_seconds << " seconds for batch " << batch_id_;
-            set_result_internal(ErrorCode::TRANSFER_FAIL);
+                       << kTransferTimeoutSeconds << " seconds for batch "
+                       << batch_id_;
+            set_result_internal(ErrorCode::TRANSFER_TIMEOUT);
             return;
         }
 
-        std::unique_lock<std::mutex> lock(mutex_);
         check_task_status();
         if (result_.has_value()) {
             VLOG(1) << "Transfer engine operation completed for batch "
@@ -349,6 +356,109 @@ TransferStrategy TransferFuture::strategy() const {
     return state_->get_strategy();
 }
 
+void TransferFuture::fail(ErrorCode error_code) const {
+    state_->fail(error_code);
+}
+
+// ============================================================================
+// TransferPoller Implementation
+// ============================================================================
+
+TransferPoller::TransferPoller() {
+    poller_ = std::thread(&TransferPoller::pollerThread, this);
+}
+
+TransferPoller::~TransferPoller() {
+    shutdown();
+    if (poller_.joinable()) {
+        poller_.join();
+    }
+}
+
+void TransferPoller::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(waiters_mutex_);
+        shutdown_ = true;
+    }
+    waiters_cv_.notify_all();
+}
+
+async_simple::coro::Lazy<void> TransferPoller::waitReady(
+    const TransferFuture& future) {
+    if (future.isReady()) {
+        co_return;
+    }
+    async_simple::Promise<bool> promise;
+    auto ready = promise.getFuture();
+    {
+        std::lock_guard<std::mutex> lock(waiters_mutex_);
+        if (shutdown_) {
+            future.fail(ErrorCode::TRANSFER_FAIL);
+            co_return;
+        }
+        waiters_.push_back(
+            {&future, std::move(promise),
+             std::chrono::steady_clock::now() +
+                 std::chrono::seconds(kTransferTimeoutSeconds)});
+    }
+    waiters_cv_.notify_one();
+    co_await std::move(ready);
+}
+
+void TransferPoller::pollerThread() {
+    std::vector<Waiter> polling;
+    auto poll_interval = kMinPollInterval;
+    auto has_news = [this] { return shutdown_ || !waiters_.empty(); };
+    while (true) {
+        bool shutdown;
+        {
+            std::unique_lock<std::mutex> lock(waiters_mutex_);
+            if (polling.empty()) {
+                waiters_cv_.wait(lock, has_news);
+            } else {
+                waiters_cv_.wait_for(lock, poll_interval, has_news);
+            }
+            std::move(waiters_.begin(), waiters_.end(),
+                      std::back_inserter(polling));
+            waiters_.clear();
+            shutdown = shutdown_;
+        }
+
+        // Resume the waiters whose transfers are done. The transfers still
+        // pending on shutdown or past their deadline are failed first, so
+        // that get() returns at once and no coroutine stays suspended.
+        auto now = std::chrono::steady_clock::now();
+        bool completed = false;
+        size_t pending = 0;
+        for (size_t i = 0; i < polling.size(); ++i) {
+            auto& waiter = polling[i];
+            if (waiter.future->isReady()) {
+                completed = true;
+            } else if (shutdown) {
+                waiter.future->fail(ErrorCode::TRANSFER_FAIL);
+            } else if (now >= waiter.deadline) {
+                LOG(ERROR) << "Failed to complete transfer after "
+                           << kTransferTimeoutSeconds << " seconds";
+                waiter.future->fail(ErrorCode::TRANSFER_TIMEOUT);
+            } else {
+                if (pending != i) {
+                    polling[pending] = std::move(waiter);
+                }
+                ++pending;
+                continue;
+            }
+            waiter.promise.setValue(true);
+        }
+        polling.erase(polling.begin() + pending, polling.end());
+        if (shutdown) {
+            return;
+        }
+        poll_interval = completed
+                            ? kMinPollInterval
+                            : std::min(poll_interval * 2, kMaxPollInterval);
+    }
+}
+
 // ============================================================================
 // TransferSubmitter Implementation
 // ============================================================================
@@ -469,6 +579,48 @@ std::optional<TransferFuture> TransferSubmitter::submit_batch(
     return future;
 }
 
+std::vector<std::optional<TransferFuture>> TransferSubmitter::submit_all(
+    const std::vector<const Replica::Descriptor*>& replicas,
+    const std::vector<std::vector<Slice>*>& all_slices,
+    TransferRequest::OpCode op_code) {
+    std::vector<std::optional<TransferFuture>> futures(replicas.size());
+    std::vector<TransferRequest> requests;
+    std::vector<size_t> batched;
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        const auto& replica = *replicas[i];
+        auto& slices = *all_slices[i];
+        if (replica.is_memory_replica()) {
+            const auto& handles =
+                replica.get_memory_descriptor().buffer_descriptors;
+            if (!validateTransferParams(handles, slices)) {
+                continue;
+            }
+            if (selectStrategy(handles, slices) ==
+                TransferStrategy::TRANSFER_ENGINE) {
+                if (appendTransferRequests(handles, slices, op_code,
+                                           requests)) {
+                    batched.push_back(i);
+                }
+                continue;
+            }
+        }
+        futures[i] = submit(replica, slices, op_code);
+    }
+    if (batched.empty()) {
+        return futures;
+    }
+
+    auto state = submitTransferState(requests);
+    if (!state) {
+        return futures;
+    }
+    for (size_t i : batched) {
+        futures[i].emplace(state);
+        updateTransferMetrics(*all_slices[i], op_code);
+    }
+    return futures;
+}
+
 std::optional<TransferFuture> TransferSubmitter::submitMemcpyOperation(
     const std::vector<AllocatedBuffer::Descriptor>& handles,
     std::vector<Slice>& slices, TransferRequest::OpCode op_code) {
@@ -512,14 +664,81 @@ std::optional<TransferFuture> TransferSubmitter::submitMemcpyOperation(
     return TransferFuture(state);
 }
 
+void coalesceTransferRequests(std::vector<TransferRequest>& requests,
+                              const RegisteredRangeCheck& in_one_buffer) {
+    if (requests.size() < 2) {
+        return;
+    }
+    std::sort(requests.begin(), requests.end(),
+              [](const TransferRequest& a, const TransferRequest& b) {
+                  return std::tie(a.target_id, a.target_offset) <
+                         std::tie(b.target_id, b.target_offset);
+              });
+    size_t merged = 0;
+    for (size_t i = 1; i < requests.size(); ++i) {
+        auto& last = requests[merged];
+        const auto& request = requests[i];
+        if (request.opcode == last.opcode &&
+            request.target_id == last.target_id &&
+            request.target_offset == last.target_offset + last.length &&
+            request.source == static_cast<char*>(last.source) + last.length &&
+            in_one_buffer(LOCAL_SEGMENT_ID,
+                          reinterpret_cast<uint64_t>(last.source),
+                          last.length + request.length) &&
+            in_one_buffer(last.target_id, last.target_offset,
+                          last.length + request.length)) {
+            last.length += request.length;
+        } else {
+            requests[++merged] = request;
+        }
+    }
+    requests.resize(merged + 1);
+}
+
 std::optional<TransferFuture> TransferSubmitter::submitTransfer(
     std::vector<TransferRequest>& requests) {
+    auto state = submitTransferState(requests);
+    if (!state) {
+        return std::nullopt;
+    }
+    return TransferFuture(state);
+}
+
+std::shared_ptr<OperationState> TransferSubmitter::submitTransferState(
+    std::vector<TransferRequest>& requests) {
+    // Requests may only be merged within a buffer, as a registered buffer
+    // is the unit of memory a transport can address
+    auto metadata = engine_.getMetadata();
+    std::unordered_map<SegmentID,
+                       std::shared_ptr<TransferMetadata::SegmentDesc>>
+        segment_descs;
+    coalesceTransferRequests(requests, [&](SegmentID segment_id,
+                                           uint64_t addr, uint64_t length) {
+        auto it = segment_descs.find(segment_id);
+        if (it == segment_descs.end()) {
+            it = segment_descs
+                     .emplace(segment_id,
+                              metadata->getSegmentDescByID(segment_id))
+                     .first;
+        }
+        if (!it->second) {
+            return false;
+        }
+        for (const auto& buffer : it->second->buffers) {
+            if (buffer.addr <= addr && addr + length <= buffer.addr +
+                                                          buffer.length) {
+                return true;
+            }
+        }
+        return false;
+    });
+
     // Allocate batch ID
     const size_t batch_size = requests.size();
     BatchID batch_id = engine_.allocateBatchID(batch_size);
     if (batch_id == INVALID_BATCH_ID) {
         LOG(ERROR) << "Failed to allocate batch ID";
-        return std::nullopt;
+        return nullptr;
     }
 
     // Submit transfer
@@ -531,20 +750,18 @@ std::optional<TransferFuture> TransferSubmitter::submitTransfer(
         // destructor if we create the state object, otherwise we need to free
         // it here
         engine_.freeBatchID(batch_id);
-        return std::nullopt;
+        return nullptr;
     }
 
     if (batch_id == INVALID_BATCH_ID) {  // INVALID_BATCH_ID
         LOG(ERROR) << "Invalid batch ID for transfer engine operation";
-        return std::nullopt;
+        return nullptr;
     }
 
     // Create state with transfer engine context - no polling thread
     // needed
-    auto state = std::make_shared<TransferEngineOperationState>(
-        engine_, batch_id, batch_size);
-
-    return TransferFuture(state);
+    return std::make_shared<TransferEngineOperationState>(engine_, batch_id,
+                                                          batch_size);
 }
 
 std::optional<TransferFuture> TransferSubmitter::submitTransferEngineOperation(
@@ -553,7 +770,16 @@ std::optional<TransferFuture> TransferSubmitter::submitTransferEngineOperation(
     // Create transfer requests
     std::vector<TransferRequest> requests;
     requests.reserve(handles.size());
+    if (!appendTransferRequests(handles, slices, op_code, requests)) {
+        return std::nullopt;
+    }
+    return submitTransfer(requests);
+}
 
+bool TransferSubmitter::appendTransferRequests(
+    const std::vector<AllocatedBuffer::Descriptor>& handles,
+    const std::vector<Slice>& slices, TransferRequest::OpCode op_code,
+    std::vector<TransferRequest>& requests) {
     for (size_t i = 0; i < handles.size(); ++i) {
         const auto& handle = handles[i];
         const auto& slice = slices[i];
@@ -563,7 +789,7 @@ std::optional<TransferFuture> TransferSubmitter::submitTransferEngineOperation(
         if (handle.transport_endpoint_.empty()) {
             LOG(ERROR) << "Transport endpoint is empty for handle with address "
                        << handle.buffer_address_;
-            return std::nullopt;
+            return false;
         }
 
         SegmentHandle seg = engine_.openSegment(handle.transport_endpoint_);
@@ -571,7 +797,7 @@ std::optional<TransferFuture> TransferSubmitter::submitTransferEngineOperation(
         if (seg == static_cast<uint64_t>(ERR_INVALID_ARGUMENT)) {
             LOG(ERROR) << "Failed to open segment for endpoint='"
                        << handle.transport_endpoint_ << "'";
-            return std::nullopt;
+            return false;
         }
 
         TransferRequest request;
@@ -583,7 +809,7 @@ std::optional<TransferFuture> TransferSubmitter::submitTransferEngineOperation(
 
         requests.emplace_back(request);
     }
-    return submitTransfer(requests);
+    return true;
 }
 
 std::optional<TransferFuture> TransferSubmitter::submitFileReadOperation(
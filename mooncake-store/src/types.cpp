@@ -27,7 +27,9 @@ const std::string& toString(ErrorCode errorCode) noexcept {
         {ErrorCode::OBJECT_ALREADY_EXISTS, "OBJECT_ALREADY_EXISTS"},
         {ErrorCode::OBJECT_HAS_LEASE, "OBJECT_HAS_LEASE"},
         {ErrorCode::LEASE_EXPIRED, "LEASE_EXPIRED"},
+        {ErrorCode::CONTENT_ALREADY_EXISTS, "CONTENT_ALREADY_EXISTS"},
         {ErrorCode::TRANSFER_FAIL, "TRANSFER_FAIL"},
+        {ErrorCode::TRANSFER_TIMEOUT, "TRANSFER_TIMEOUT"},
         {ErrorCode::RPC_FAIL, "RPC_FAIL"},
         {ErrorCode::ETCD_OPERATION_ERROR, "ETCD_OPERATION_ERROR"},
         {ErrorCode::ETCD_KEY_NOT_EXIST, "ETCD_KEY_NOT_EXIST"},
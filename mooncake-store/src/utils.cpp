@@ -3,11 +3,18 @@
 #include <Slab.h>
 #include <glog/logging.h>
 #include <netinet/in.h>
+#include <numa.h>
+#include <numaif.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <random>
+#include <string_view>
+#include <thread>
 #ifdef USE_ASCEND_DIRECT
 #include "acl/acl.h"
 #endif
@@ -102,6 +109,81 @@ void free_memory(const std::string &protocol, void *ptr) {
     free(ptr);
 }
 
+void *map_segment_memory(size_t total_size, size_t page_size, int numa_node,
+                         size_t prefault_threads) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (page_size != 0) {
+        if (page_size != (2ull << 20) && page_size != (1ull << 30)) {
+            LOG(ERROR) << "Unsupported huge page size: " << page_size;
+            return nullptr;
+        }
+        // MAP_HUGE_2MB and MAP_HUGE_1GB
+        flags |= MAP_HUGETLB | (__builtin_ctzll(page_size) << MAP_HUGE_SHIFT);
+    } else {
+        page_size = getpagesize();
+    }
+    if (total_size == 0 || total_size % page_size != 0) {
+        LOG(ERROR) << "Segment size " << total_size
+                   << " is not a multiple of the page size " << page_size;
+        return nullptr;
+    }
+
+    void *ptr =
+        mmap(nullptr, total_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+        PLOG(ERROR) << "Failed to map " << total_size << " bytes of "
+                    << page_size << " byte pages";
+        return nullptr;
+    }
+
+    // The binding applies to pages faulted in afterwards, whichever CPU
+    // touches them
+    if (numa_node >= 0) {
+        if (numa_available() < 0 || numa_node > numa_max_node()) {
+            LOG(ERROR) << "NUMA node " << numa_node << " is not available";
+            munmap(ptr, total_size);
+            return nullptr;
+        }
+        std::vector<unsigned long> nodemask(
+            numa_node / (8 * sizeof(unsigned long)) + 1);
+        nodemask[numa_node / (8 * sizeof(unsigned long))] =
+            1ul << (numa_node % (8 * sizeof(unsigned long)));
+        if (mbind(ptr, total_size, MPOL_BIND, nodemask.data(),
+                  nodemask.size() * 8 * sizeof(unsigned long), 0) != 0) {
+            PLOG(ERROR) << "Failed to bind segment to NUMA node "
+                        << numa_node;
+            munmap(ptr, total_size);
+            return nullptr;
+        }
+    }
+
+    // Fault the pages in up front so the first transfers do not pay for it,
+    // the threads take contiguous ranges of whole pages
+    size_t num_pages = total_size / page_size;
+    size_t num_threads = std::clamp<size_t>(prefault_threads, 1, num_pages);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([=]() {
+            auto *base = static_cast<volatile char *>(ptr);
+            for (size_t page = num_pages * t / num_threads;
+                 page < num_pages * (t + 1) / num_threads; ++page) {
+                base[page * page_size] = 0;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return ptr;
+}
+
+void unmap_segment_memory(void *ptr, size_t total_size) {
+    if (munmap(ptr, total_size) != 0) {
+        PLOG(ERROR) << "Failed to unmap segment memory";
+    }
+}
+
 std::string formatDeviceNames(const std::string &device_names) {
     std::stringstream ss(device_names);
     std::string item;
@@ -137,6 +219,44 @@ std::vector<std::string> splitString(const std::string &str, char delimiter,
     return result;
 }
 
+std::string regexLiteralPrefix(const std::string &regex) {
+    // An alternation may match strings without the prefix
+    if (regex.empty() || regex[0] != '^' ||
+        regex.find('|') != std::string::npos) {
+        return std::string();
+    }
+
+    constexpr std::string_view kSpecialChars = "\\^$.|?*+()[]{}";
+    std::string prefix;
+    size_t i = 1;
+    while (i < regex.size()) {
+        char c = regex[i];
+        size_t next = i + 1;
+        if (c == '\\') {
+            // Escaped letters and digits are classes or backreferences
+            if (next == regex.size() ||
+                std::isalnum(static_cast<unsigned char>(regex[next]))) {
+                break;
+            }
+            c = regex[next++];
+        } else if (kSpecialChars.find(c) != std::string_view::npos) {
+            break;
+        }
+
+        // The character is optional under these quantifiers
+        if (next < regex.size() &&
+            (regex[next] == '?' || regex[next] == '*' || regex[next] == '{')) {
+            break;
+        }
+        prefix.push_back(c);
+        if (next < regex.size() && regex[next] == '+') {
+            break;
+        }
+        i = next;
+    }
+    return prefix;
+}
+
 tl::expected<std::string, int> httpGet(const std::string &url) {
     coro_http::coro_http_client client;
     auto res = client.get(url);
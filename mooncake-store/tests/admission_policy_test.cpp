@@ -0,0 +1,78 @@
+// admission_policy_test.cpp
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "admission_policy.h"
+
+namespace mooncake {
+
+// Test fixture for AdmissionPolicy tests
+class AdmissionPolicyTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        // Initialize glog for logging
+        google::InitGoogleLogging("AdmissionPolicyTest");
+        FLAGS_logtostderr = 1;  // Output logs to stderr
+    }
+
+    void TearDown() override {
+        // Cleanup glog
+        google::ShutdownGoogleLogging();
+    }
+};
+
+// Test AlwaysAdmissionPolicy admits any put
+TEST_F(AdmissionPolicyTest, AlwaysAdmit) {
+    AlwaysAdmissionPolicy policy;
+    for (int i = 0; i < 10; ++i) {
+        policy.RecordAccess("hot");
+    }
+    EXPECT_TRUE(policy.Admit("cold", "hot"));
+}
+
+// Test TinyLFUAdmissionPolicy keeps the objects accessed more often
+TEST_F(AdmissionPolicyTest, TinyLFUAdmit) {
+    TinyLFUAdmissionPolicy policy(1024);
+    // A block put and read twice, and a block put once
+    policy.RecordAccess("hot");
+    policy.RecordAccess("hot");
+    policy.RecordAccess("hot");
+    policy.RecordAccess("once");
+
+    policy.RecordAccess("new");
+    EXPECT_EQ(policy.Estimate("hot"), 3);
+    EXPECT_EQ(policy.Estimate("new"), 1);
+    EXPECT_FALSE(policy.Admit("new", "hot"));
+    // Ties go to the put
+    EXPECT_TRUE(policy.Admit("new", "once"));
+    // A put read before, e.g. a miss recomputed, wins over the block put once
+    policy.RecordAccess("new");
+    EXPECT_TRUE(policy.Admit("new", "once"));
+    EXPECT_FALSE(policy.Admit("once", "new"));
+}
+
+// Test the counters of TinyLFUAdmissionPolicy saturate and age
+TEST_F(AdmissionPolicyTest, TinyLFUAging) {
+    TinyLFUAdmissionPolicy policy(64);
+    for (int i = 0; i < 100; ++i) {
+        policy.RecordAccess("hot");
+    }
+    EXPECT_EQ(policy.Estimate("hot"), 15);
+
+    // The counters are halved every 10 * width accesses, popularity which is
+    // not renewed fades
+    for (int i = 0; i < 10 * 64 * 4; ++i) {
+        policy.RecordAccess("other_" + std::to_string(i % 4));
+    }
+    EXPECT_LT(policy.Estimate("hot"), 4);
+    EXPECT_TRUE(policy.Admit("other_0", "hot"));
+}
+
+}  // namespace mooncake
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
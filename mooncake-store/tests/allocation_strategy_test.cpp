@@ -47,6 +47,9 @@ class AllocationStrategyParameterizedTest
             case BufferAllocatorType::OFFSET:
                 return std::make_shared<OffsetBufferAllocator>(
                     segment_name, base, size, segment_name);
+            case BufferAllocatorType::SHARDED_OFFSET:
+                return std::make_shared<ShardedOffsetBufferAllocator>(
+                    segment_name, base, size, segment_name);
             default:
                 throw std::invalid_argument("Invalid allocator type");
         }
@@ -60,13 +63,16 @@ class AllocationStrategyParameterizedTest
 INSTANTIATE_TEST_SUITE_P(
     AllAllocatorTypes, AllocationStrategyParameterizedTest,
     ::testing::Values(BufferAllocatorType::CACHELIB,
-                      BufferAllocatorType::OFFSET),
+                      BufferAllocatorType::OFFSET,
+                      BufferAllocatorType::SHARDED_OFFSET),
     [](const ::testing::TestParamInfo<BufferAllocatorType>& info) {
         switch (info.param) {
             case BufferAllocatorType::CACHELIB:
                 return "Cachelib";
             case BufferAllocatorType::OFFSET:
                 return "Offset";
+            case BufferAllocatorType::SHARDED_OFFSET:
+                return "ShardedOffset";
             default:
                 return "Unknown";
         }
@@ -91,6 +97,9 @@ class AllocationStrategyUnitTest : public ::testing::Test {
             case BufferAllocatorType::OFFSET:
                 return std::make_shared<OffsetBufferAllocator>(
                     segment_name, base, size, segment_name);
+            case BufferAllocatorType::SHARDED_OFFSET:
+                return std::make_shared<ShardedOffsetBufferAllocator>(
+                    segment_name, base, size, segment_name);
             default:
                 throw std::invalid_argument("Invalid allocator type");
         }
@@ -40,6 +40,9 @@ class BufferAllocatorTest : public ::testing::Test {
             case BufferAllocatorType::OFFSET:
                 return std::make_shared<OffsetBufferAllocator>(
                     segment_name, base, size, segment_name);
+            case BufferAllocatorType::SHARDED_OFFSET:
+                return std::make_shared<ShardedOffsetBufferAllocator>(
+                    segment_name, base, size, segment_name);
             default:
                 throw std::invalid_argument("Invalid allocator type");
         }
@@ -57,7 +60,8 @@ class BufferAllocatorTest : public ::testing::Test {
     }
 
     std::vector<BufferAllocatorType> allocator_types_ = {
-        BufferAllocatorType::CACHELIB, BufferAllocatorType::OFFSET};
+        BufferAllocatorType::CACHELIB, BufferAllocatorType::OFFSET,
+        BufferAllocatorType::SHARDED_OFFSET};
 };
 
 // Test basic allocation and deallocation functionality
@@ -184,9 +188,7 @@ TEST_F(BufferAllocatorTest, ParallelAllocation) {
         }
 
         LOG(INFO) << "Completed parallel allocation/deallocation test for "
-                  << (allocator_type == BufferAllocatorType::CACHELIB
-                          ? "CACHELIB"
-                          : "OFFSET");
+                  << allocator_type;
     }
 }
 
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <thread>
@@ -431,6 +432,245 @@ TEST_F(ClientBufferTest, AllocateSlicesEmptyMemoryReplica) {
     EXPECT_EQ(slices.size(), 0);
 }
 
+// Builds a memory replica of buffers with the given sizes at consecutive
+// addresses starting at `base`
+static Replica::Descriptor MakeMemoryReplica(
+    uintptr_t base, const std::vector<uint64_t>& sizes) {
+    Replica::Descriptor replica;
+    MemoryDescriptor mem_desc;
+    for (auto size : sizes) {
+        AllocatedBuffer::Descriptor buf;
+        buf.size_ = size;
+        buf.buffer_address_ = base;
+        buf.transport_endpoint_ = "localhost:12345";
+        mem_desc.buffer_descriptors.push_back(buf);
+        base += size;
+    }
+    replica.descriptor_variant = mem_desc;
+    replica.status = ReplicaStatus::COMPLETE;
+    return replica;
+}
+
+// Test restricting a replica to a range within a single buffer
+TEST_F(ClientBufferTest, RestrictReplicaToRangeWithinBuffer) {
+    auto replica = MakeMemoryReplica(0x10000, {1024, 2048, 512});
+    char dest[100];
+    std::vector<Slice> slices{{dest, 100}};
+
+    EXPECT_EQ(restrictReplicaToRange(replica, 1100, slices), ErrorCode::OK);
+
+    auto& buffers = replica.get_memory_descriptor().buffer_descriptors;
+    ASSERT_EQ(buffers.size(), 1);
+    EXPECT_EQ(buffers[0].buffer_address_, 0x10000 + 1100);
+    EXPECT_EQ(buffers[0].size_, 100);
+    EXPECT_EQ(buffers[0].transport_endpoint_, "localhost:12345");
+    ASSERT_EQ(slices.size(), 1);
+    EXPECT_EQ(slices[0].ptr, dest);
+    EXPECT_EQ(slices[0].size, 100);
+}
+
+// Test a range spanning buffer and slice boundaries
+TEST_F(ClientBufferTest, RestrictReplicaToRangeSpanningBoundaries) {
+    auto replica = MakeMemoryReplica(0x10000, {1024, 2048, 512});
+    std::vector<char> dest(2500);
+    // Slice boundary at 1500, buffer boundaries at 1024 and 3072
+    std::vector<Slice> slices{{dest.data(), 1500},
+                              {dest.data() + 1500, 1000}};
+
+    EXPECT_EQ(restrictReplicaToRange(replica, 1000, slices), ErrorCode::OK);
+
+    // [1000, 1024) [1024, 2500) [2500, 3072) [3072, 3500)
+    auto& buffers = replica.get_memory_descriptor().buffer_descriptors;
+    std::vector<uint64_t> expected_sizes{24, 1476, 572, 428};
+    std::vector<uintptr_t> expected_addresses{0x10000 + 1000, 0x10000 + 1024,
+                                              0x10000 + 2500, 0x10000 + 3072};
+    std::vector<size_t> expected_offsets{0, 24, 1500, 2072};
+    ASSERT_EQ(buffers.size(), expected_sizes.size());
+    ASSERT_EQ(slices.size(), expected_sizes.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        EXPECT_EQ(buffers[i].size_, expected_sizes[i]) << i;
+        EXPECT_EQ(buffers[i].buffer_address_, expected_addresses[i]) << i;
+        EXPECT_EQ(slices[i].size, expected_sizes[i]) << i;
+        EXPECT_EQ(slices[i].ptr, dest.data() + expected_offsets[i]) << i;
+    }
+}
+
+// Test ranges at the ends of the object and out of it
+TEST_F(ClientBufferTest, RestrictReplicaToRangeBounds) {
+    char dest[512];
+
+    auto replica = MakeMemoryReplica(0x10000, {1024, 2048, 512});
+    std::vector<Slice> slices{{dest, 512}};
+    EXPECT_EQ(restrictReplicaToRange(replica, 3072, slices), ErrorCode::OK);
+    ASSERT_EQ(replica.get_memory_descriptor().buffer_descriptors.size(), 1);
+    EXPECT_EQ(replica.get_memory_descriptor().buffer_descriptors[0].size_,
+              512);
+
+    replica = MakeMemoryReplica(0x10000, {1024, 2048, 512});
+    slices = {{dest, 512}};
+    EXPECT_EQ(restrictReplicaToRange(replica, 3073, slices),
+              ErrorCode::INVALID_PARAMS);
+
+    replica = MakeMemoryReplica(0x10000, {1024});
+    slices = {};
+    EXPECT_EQ(restrictReplicaToRange(replica, 1024, slices), ErrorCode::OK);
+    EXPECT_TRUE(replica.get_memory_descriptor().buffer_descriptors.empty());
+    EXPECT_TRUE(slices.empty());
+
+    DiskDescriptor disk_desc;
+    disk_desc.object_size = 4096;
+    replica.descriptor_variant = disk_desc;
+    slices = {{dest, 512}};
+    EXPECT_EQ(restrictReplicaToRange(replica, 0, slices),
+              ErrorCode::INVALID_PARAMS);
+}
+
+// Test a freed size class chunk is reused by its thread
+TEST_F(ClientBufferTest, ThreadCacheReusesChunk) {
+    auto allocator = ClientBufferAllocator::create(16 * 1024 * 1024);
+    ASSERT_NE(allocator, nullptr);
+
+    void* ptr = nullptr;
+    {
+        auto handle_opt = allocator->allocate(300 * 1024);
+        ASSERT_TRUE(handle_opt.has_value());
+        VerifyBufferHandle(handle_opt.value(), 300 * 1024);
+        ptr = handle_opt->ptr();
+    }
+
+    // A smaller size of the same class gets the same chunk
+    auto handle_opt = allocator->allocate(290 * 1024);
+    ASSERT_TRUE(handle_opt.has_value());
+    EXPECT_EQ(handle_opt->ptr(), ptr);
+    EXPECT_EQ(handle_opt->size(), 290 * 1024);
+}
+
+// Test a chunk freed by another thread returns to the allocating thread
+TEST_F(ClientBufferTest, ThreadCacheCrossThreadFree) {
+    auto allocator = ClientBufferAllocator::create(16 * 1024 * 1024);
+    ASSERT_NE(allocator, nullptr);
+
+    auto handle_opt = allocator->allocate(1024 * 1024);
+    ASSERT_TRUE(handle_opt.has_value());
+    void* ptr = handle_opt->ptr();
+
+    std::thread([&handle_opt]() { handle_opt.reset(); }).join();
+
+    auto reused_opt = allocator->allocate(1024 * 1024);
+    ASSERT_TRUE(reused_opt.has_value());
+    EXPECT_EQ(reused_opt->ptr(), ptr);
+
+    // Handles of an exited thread are freed to the buffer
+    std::thread([&allocator, &handle_opt]() {
+        handle_opt = allocator->allocate(1024 * 1024);
+    }).join();
+    ASSERT_TRUE(handle_opt.has_value());
+    VerifyBufferHandle(handle_opt.value(), 1024 * 1024);
+    handle_opt.reset();
+}
+
+// Test chunks cached by other threads are reclaimed when the buffer is full
+TEST_F(ClientBufferTest, ThreadCacheTrimmedWhenExhausted) {
+    const size_t buffer_size = 16 * 1024 * 1024;  // 16MB
+    const size_t alloc_size = 1024 * 1024;        // 1MB
+
+    auto allocator = ClientBufferAllocator::create(buffer_size);
+    ASSERT_NE(allocator, nullptr);
+
+    // Leave a cached chunk in the magazine of a running thread
+    std::atomic<bool> cached{false};
+    std::atomic<bool> done{false};
+    std::thread worker([&]() {
+        allocator->allocate(alloc_size);
+        cached = true;
+        while (!done) {
+            std::this_thread::yield();
+        }
+    });
+    while (!cached) {
+        std::this_thread::yield();
+    }
+
+    std::vector<BufferHandle> handles;
+    while (auto handle_opt = allocator->allocate(alloc_size)) {
+        handles.push_back(std::move(handle_opt.value()));
+    }
+    EXPECT_EQ(handles.size(), buffer_size / alloc_size);
+
+    done = true;
+    worker.join();
+}
+
+// Test the thread cache can be disabled
+TEST_F(ClientBufferTest, ThreadCacheDisabled) {
+    const size_t buffer_size = 16 * 1024 * 1024;   // 16MB
+    const size_t alloc_size = 1024 * 1024 + 4096;  // Just over 1MB
+
+    auto allocator = ClientBufferAllocator::create(buffer_size, "", false);
+    ASSERT_NE(allocator, nullptr);
+
+    // Without rounding up to the 1.25MB size class more buffers fit
+    std::vector<BufferHandle> handles;
+    while (auto handle_opt = allocator->allocate(alloc_size)) {
+        EXPECT_EQ(handle_opt->size(), alloc_size);
+        handles.push_back(std::move(handle_opt.value()));
+    }
+    EXPECT_GT(handles.size(), buffer_size / (alloc_size / 4 * 5));
+}
+
+// Allocation throughput of 1 to 64 threads allocating and freeing 256KB to
+// 2MB buffers, with and without the thread cache. Disabled as it takes long,
+// run it with --gtest_also_run_disabled_tests
+TEST_F(ClientBufferTest, DISABLED_AllocationContentionBenchmark) {
+    const size_t buffer_size = 512 * 1024 * 1024;  // 512MB
+    const int ops_per_thread = 20000;
+    const size_t sizes[] = {256 * 1024, 384 * 1024, 1024 * 1024,
+                            2 * 1024 * 1024};
+
+    for (bool use_thread_cache : {false, true}) {
+        auto allocator =
+            ClientBufferAllocator::create(buffer_size, "", use_thread_cache);
+        ASSERT_NE(allocator, nullptr);
+
+        for (int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+            std::atomic<int> failures{0};
+            std::vector<std::thread> threads;
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&, t]() {
+                    // Keep a few buffers in flight like a batched read
+                    std::vector<BufferHandle> in_flight;
+                    for (int i = 0; i < ops_per_thread; ++i) {
+                        auto handle_opt =
+                            allocator->allocate(sizes[(i + t) % 4]);
+                        if (!handle_opt) {
+                            failures++;
+                            in_flight.clear();
+                            continue;
+                        }
+                        in_flight.push_back(std::move(handle_opt.value()));
+                        if (in_flight.size() == 2) {
+                            in_flight.clear();
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            double seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+            EXPECT_EQ(failures, 0);
+            LOG(INFO) << "thread_cache=" << use_thread_cache
+                      << " threads=" << num_threads << " ops/s="
+                      << static_cast<uint64_t>(num_threads * ops_per_thread /
+                                               seconds);
+        }
+    }
+}
+
 }  // namespace mooncake
 
 int main(int argc, char** argv) {
@@ -554,6 +554,183 @@ TEST_F(ClientIntegrationTest, BatchPutGetOperations) {
     }
 }
 
+// Test the non-blocking operations completing into a completion queue
+TEST_F(ClientIntegrationTest, AsyncPutGetOperations) {
+    const int batch_sz = 16;
+    const size_t value_size = 1024;
+    std::vector<std::string> keys;
+    std::vector<void*> buffers;
+    for (int i = 0; i < batch_sz; i++) {
+        keys.push_back("test_key_async_" + std::to_string(i));
+        buffers.push_back(client_buffer_allocator_->allocate(value_size));
+        memset(buffers[i], 'a' + i, value_size);
+    }
+    CompletionQueue queue;
+    ReplicateConfig config;
+    config.replica_num = 1;
+
+    // Waits for the completion of each handle and returns it by handle
+    auto wait_all = [&](const std::vector<AsyncHandle>& handles) {
+        std::unordered_map<AsyncHandle, AsyncCompletion> by_handle;
+        std::vector<AsyncCompletion> completions;
+        while (by_handle.size() < handles.size()) {
+            completions.clear();
+            if (queue.Wait(completions, std::chrono::seconds(10)) == 0) {
+                break;
+            }
+            for (auto& completion : completions) {
+                by_handle.emplace(completion.handle, std::move(completion));
+            }
+        }
+        return by_handle;
+    };
+
+    // Half of the keys put one by one, the rest as one batch
+    std::vector<AsyncHandle> handles;
+    for (int i = 0; i < batch_sz / 2; i++) {
+        handles.push_back(test_client_->AsyncPut(
+            queue, keys[i], {Slice{buffers[i], value_size}}, config));
+    }
+    std::vector<std::string> batch_keys(keys.begin() + batch_sz / 2,
+                                        keys.end());
+    std::vector<std::vector<Slice>> batched_slices;
+    for (int i = batch_sz / 2; i < batch_sz; i++) {
+        batched_slices.push_back({Slice{buffers[i], value_size}});
+    }
+    handles.push_back(test_client_->AsyncBatchPut(queue, batch_keys,
+                                                  batched_slices, config));
+    auto put_completions = wait_all(handles);
+    ASSERT_EQ(put_completions.size(), handles.size());
+    for (auto handle : handles) {
+        for (const auto& result : put_completions[handle].results) {
+            ASSERT_TRUE(result.has_value())
+                << "Async put failed: " << toString(result.error());
+        }
+    }
+    EXPECT_EQ(put_completions[handles.back()].results.size(),
+              batch_keys.size());
+
+    // Read all keys back, one by one and as a batch
+    for (int i = 0; i < batch_sz; i++) {
+        memset(buffers[i], 0, value_size);
+    }
+    handles.clear();
+    for (int i = 0; i < batch_sz / 2; i++) {
+        handles.push_back(test_client_->AsyncGet(
+            queue, keys[i], {Slice{buffers[i], value_size}}));
+    }
+    std::unordered_map<std::string, std::vector<Slice>> target_slices;
+    for (int i = batch_sz / 2; i < batch_sz; i++) {
+        target_slices[keys[i]] = {Slice{buffers[i], value_size}};
+    }
+    handles.push_back(
+        test_client_->AsyncBatchGet(queue, batch_keys, target_slices));
+    handles.push_back(test_client_->AsyncGet(
+        queue, "test_key_async_missing", {Slice{buffers[0], value_size}}));
+    auto get_completions = wait_all(handles);
+    ASSERT_EQ(get_completions.size(), handles.size());
+    for (size_t i = 0; i + 1 < handles.size(); i++) {
+        for (const auto& result : get_completions[handles[i]].results) {
+            ASSERT_TRUE(result.has_value())
+                << "Async get failed: " << toString(result.error());
+        }
+    }
+    ASSERT_FALSE(get_completions[handles.back()].results[0].has_value());
+    for (int i = 0; i < batch_sz; i++) {
+        EXPECT_EQ(static_cast<char*>(buffers[i])[value_size - 1], 'a' + i);
+    }
+    EXPECT_EQ(queue.Size(), 0);
+
+    for (int i = 0; i < batch_sz; i++) {
+        client_buffer_allocator_->deallocate(buffers[i], value_size);
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(default_kv_lease_ttl_));
+    for (const auto& key : keys) {
+        ASSERT_TRUE(test_client_->Remove(key).has_value());
+    }
+}
+
+// Test ranged Get operations across the buffers of an object
+TEST_F(ClientIntegrationTest, GetRangeOperations) {
+    const std::string key = "test_key_get_range";
+    // Every put slice is stored in a buffer of its own
+    const std::vector<size_t> part_sizes = {1000, 3000, 500};
+    std::string test_data;
+    for (size_t i = 0; i < 4500; ++i) {
+        test_data.push_back(static_cast<char>('a' + i % 26));
+    }
+
+    void* buffer = client_buffer_allocator_->allocate(test_data.size());
+    memcpy(buffer, test_data.data(), test_data.size());
+    std::vector<Slice> slices;
+    size_t offset = 0;
+    for (auto size : part_sizes) {
+        slices.emplace_back(Slice{static_cast<char*>(buffer) + offset, size});
+        offset += size;
+    }
+    ReplicateConfig config;
+    config.replica_num = 1;
+    auto put_result = test_client_->Put(key, slices, config);
+    ASSERT_TRUE(put_result.has_value())
+        << "Put operation failed: " << toString(put_result.error());
+    client_buffer_allocator_->deallocate(buffer, test_data.size());
+
+    auto query_result = test_client_->Query(key);
+    ASSERT_TRUE(query_result.has_value());
+
+    // Ranges within a buffer, across one and two buffer boundaries, the
+    // whole object, with destinations split at other points
+    const std::vector<std::pair<uint64_t, size_t>> ranges = {
+        {10, 100}, {900, 200}, {500, 3800}, {0, 4500}, {4499, 1}};
+    void* target = client_buffer_allocator_->allocate(test_data.size());
+    for (const auto& [range_offset, range_size] : ranges) {
+        memset(target, 0, test_data.size());
+        size_t split = range_size / 3;
+        std::vector<Slice> range_slices{
+            {target, split},
+            {static_cast<char*>(target) + split, range_size - split}};
+        auto get_result = test_client_->GetRange(key, query_result.value(),
+                                                 range_offset, range_slices);
+        ASSERT_TRUE(get_result.has_value())
+            << "GetRange failed for offset " << range_offset << ": "
+            << toString(get_result.error());
+        EXPECT_EQ(memcmp(target, test_data.data() + range_offset, range_size),
+                  0)
+            << "Mismatch for range at " << range_offset;
+    }
+
+    // Out of range
+    std::vector<Slice> out_of_range{{target, 100}};
+    auto get_result = test_client_->GetRange(key, query_result.value(), 4450,
+                                             out_of_range);
+    ASSERT_FALSE(get_result.has_value());
+    EXPECT_EQ(get_result.error(), ErrorCode::INVALID_PARAMS);
+
+    // Batch of ranges of the same object, e.g. two layers
+    std::vector<std::string> keys = {key, key, key};
+    std::vector<QueryResult> query_results(3, query_result.value());
+    std::vector<uint64_t> offsets = {0, 1000, 4000};
+    std::vector<std::vector<Slice>> batched_slices = {
+        {{target, 1000}},
+        {{static_cast<char*>(target) + 1000, 3000}},
+        {{static_cast<char*>(target) + 4000, 1000}}};
+    memset(target, 0, test_data.size());
+    auto batch_results = test_client_->BatchGetRange(keys, query_results,
+                                                     offsets, batched_slices);
+    ASSERT_EQ(batch_results.size(), 3);
+    EXPECT_TRUE(batch_results[0].has_value());
+    EXPECT_TRUE(batch_results[1].has_value());
+    ASSERT_FALSE(batch_results[2].has_value());
+    EXPECT_EQ(batch_results[2].error(), ErrorCode::INVALID_PARAMS);
+    EXPECT_EQ(memcmp(target, test_data.data(), 4000), 0);
+    client_buffer_allocator_->deallocate(target, test_data.size());
+
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(default_kv_lease_ttl_));
+    ASSERT_TRUE(test_client_->Remove(key).has_value());
+}
+
 // Test batch IsExist operations through the client
 TEST_F(ClientIntegrationTest, BatchIsExistOperations) {
     int batch_size = 50;
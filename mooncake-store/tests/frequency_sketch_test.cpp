@@ -0,0 +1,55 @@
+// frequency_sketch_test.cpp
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "frequency_sketch.h"
+
+namespace mooncake {
+
+TEST(FrequencySketchTest, IncrementAndEstimate) {
+    FrequencySketch sketch(1024);
+    EXPECT_EQ(0u, sketch.Estimate("key"));
+    for (uint32_t i = 1; i <= 100; ++i) {
+        EXPECT_EQ(i, sketch.Increment("key"));
+    }
+    EXPECT_EQ(100u, sketch.Estimate("key"));
+    EXPECT_EQ(0u, sketch.Estimate("other_key"));
+}
+
+TEST(FrequencySketchTest, NeverUnderestimates) {
+    FrequencySketch sketch(4096);
+    constexpr int num_keys = 1000;
+    for (int i = 0; i < num_keys; ++i) {
+        for (int j = 0; j <= i % 10; ++j) {
+            sketch.Increment("key_" + std::to_string(i));
+        }
+    }
+    int exact = 0;
+    for (int i = 0; i < num_keys; ++i) {
+        uint32_t estimate = sketch.Estimate("key_" + std::to_string(i));
+        EXPECT_GE(estimate, static_cast<uint32_t>(i % 10 + 1));
+        exact += estimate == static_cast<uint32_t>(i % 10 + 1);
+    }
+    // Most keys do not collide in every row
+    EXPECT_GT(exact, num_keys / 2);
+}
+
+TEST(FrequencySketchTest, DecayHalvesCounts) {
+    FrequencySketch sketch;
+    for (int i = 0; i < 100; ++i) {
+        sketch.Increment("key");
+    }
+    sketch.Decay();
+    EXPECT_EQ(50u, sketch.Estimate("key"));
+    sketch.Decay();
+    EXPECT_EQ(25u, sketch.Estimate("key"));
+    EXPECT_EQ(26u, sketch.Increment("key"));
+}
+
+}  // namespace mooncake
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
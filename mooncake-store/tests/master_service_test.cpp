@@ -3,7 +3,9 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <random>
 #include <thread>
@@ -27,6 +29,10 @@ class MasterServiceTest : public ::testing::Test {
         UUID client_id;
     };
 
+    // Leases granted by the master may last up to two lease epochs longer
+    // than their ttl, the tests waiting for a lease to expire add this
+    static constexpr uint64_t kLeaseSlackMs = 20;
+
     static constexpr size_t kDefaultSegmentBase = 0x300000000;
     static constexpr size_t kDefaultSegmentSize = 1024 * 1024 * 16;
 
@@ -359,6 +365,45 @@ TEST_F(MasterServiceTest, PutStartEndFlow) {
     EXPECT_EQ(ReplicaStatus::COMPLETE, replica_list[0].status);
 }
 
+TEST_F(MasterServiceTest, ConfigurableMetadataShards) {
+    EXPECT_THROW(
+        MasterService(
+            MasterServiceConfig::builder().set_num_metadata_shards(0).build()),
+        std::invalid_argument);
+
+    for (uint64_t num_shards : {1, 7, 4096}) {
+        std::unique_ptr<MasterService> service_(
+            new MasterService(MasterServiceConfig::builder()
+                                  .set_num_metadata_shards(num_shards)
+                                  .set_hex_key_shard_hash(true)
+                                  .build()));
+        [[maybe_unused]] const auto context =
+            PrepareSimpleSegment(*service_);
+        ReplicateConfig config;
+        config.replica_num = 1;
+
+        // Hex digests sharing their leading digits, and keys of other forms
+        std::vector<std::string> keys;
+        for (int i = 0; i < 32; ++i) {
+            keys.push_back("0123456789abcdef" + std::to_string(i));
+            keys.push_back(std::to_string(i) + "_not_a_digest");
+        }
+        keys.push_back("0123456789ABCDEF");
+        keys.push_back("0123456789abcdeg");
+        for (const auto& key : keys) {
+            ASSERT_TRUE(service_->PutStart(key, {1024}, config).has_value());
+            ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+        }
+        EXPECT_EQ(keys.size(), service_->GetKeyCount());
+        for (const auto& key : keys) {
+            EXPECT_TRUE(service_->GetReplicaList(key).has_value()) << key;
+        }
+        auto by_prefix = service_->GetReplicaListByPrefix("0123456789abcdef");
+        ASSERT_TRUE(by_prefix.has_value());
+        EXPECT_EQ(32u, by_prefix->size());
+    }
+}
+
 TEST_F(MasterServiceTest, RandomPutStartEndFlow) {
     std::unique_ptr<MasterService> service_(new MasterService());
 
@@ -433,7 +478,8 @@ TEST_F(MasterServiceTest, GetReplicaListByRegex) {
         ASSERT_TRUE(exist_result.has_value());
     }
     // wait for all the lease to expire
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
 
     // Test getting existing key
     auto get_result2 = service_->GetReplicaListByRegex("^test_key");
@@ -490,7 +536,8 @@ TEST_F(MasterServiceTest, GetReplicaListByRegexComplex) {
     // Wait for all leases to be written to the underlying KV store.
     // In a real system, you might not need this if PutEnd is synchronous.
     // For this test, let's assume it's needed for consistency.
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
 
     // 3. Run a series of regex tests
 
@@ -678,7 +725,8 @@ TEST_F(MasterServiceTest, RemoveByRegex) {
         ASSERT_TRUE(exist_result.has_value());
     }
     // wait for all the lease to expire
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto res = service_->RemoveByRegex("^test_key");
     ASSERT_TRUE(res.has_value());
     ASSERT_EQ(10, res.value());
@@ -722,7 +770,8 @@ TEST_F(MasterServiceTest, RemoveByRegexComplex) {
             put_object(*service_, key);
         }
         // Wait for potential lease propagation
-        std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     };
 
     // --- Test Case 1: Remove a specific subset and verify ---
@@ -866,6 +915,65 @@ TEST_F(MasterServiceTest, RemoveByRegexComplex) {
     }
 }
 
+TEST_F(MasterServiceTest, GetReplicaListAndRemoveByPrefix) {
+    const uint64_t kv_lease_ttl = 50;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .build();
+    auto service_ = std::make_unique<MasterService>(service_config);
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+
+    for (const auto& key :
+         {"req_1/a", "req_1/b", "req_10/a", "req_2/a", "other"}) {
+        put_object(*service_, key);
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+
+    auto get_result = service_->GetReplicaListByPrefix("req_1/");
+    ASSERT_TRUE(get_result.has_value());
+    EXPECT_EQ(2, get_result.value().size());
+    EXPECT_TRUE(get_result.value().contains("req_1/a"));
+    EXPECT_TRUE(get_result.value().contains("req_1/b"));
+
+    // The literal prefix of the pattern narrows the scan, the pattern still
+    // decides which of those keys match
+    get_result = service_->GetReplicaListByRegex("^req_1.*a$");
+    ASSERT_TRUE(get_result.has_value());
+    EXPECT_EQ(2, get_result.value().size());
+    EXPECT_TRUE(get_result.value().contains("req_10/a"));
+    // Unanchored patterns still see all keys
+    get_result = service_->GetReplicaListByRegex("/a");
+    ASSERT_TRUE(get_result.has_value());
+    EXPECT_EQ(3, get_result.value().size());
+    get_result = service_->GetReplicaListByPrefix("");
+    ASSERT_TRUE(get_result.has_value());
+    EXPECT_EQ(5, get_result.value().size());
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+
+    auto remove_result = service_->RemoveByPrefix("req_1");
+    ASSERT_TRUE(remove_result.has_value());
+    EXPECT_EQ(3, remove_result.value());
+    remove_result = service_->RemoveByPrefix("req_1");
+    ASSERT_TRUE(remove_result.has_value());
+    EXPECT_EQ(0, remove_result.value());
+    for (const auto& key : {"req_2/a", "other"}) {
+        auto exist_result = service_->ExistKey(key);
+        ASSERT_TRUE(exist_result.has_value());
+        EXPECT_TRUE(exist_result.value()) << key;
+    }
+
+    // Removed keys can be put again and are found through the index
+    put_object(*service_, "req_1/a");
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    remove_result = service_->RemoveByRegex("^req_");
+    ASSERT_TRUE(remove_result.has_value());
+    EXPECT_EQ(2, remove_result.value());
+    EXPECT_EQ(1, service_->GetKeyCount());
+}
+
 TEST_F(MasterServiceTest, RemoveAll) {
     const uint64_t kv_lease_ttl = 50;
     auto service_config = MasterServiceConfig::builder()
@@ -887,7 +995,8 @@ TEST_F(MasterServiceTest, RemoveAll) {
         ASSERT_TRUE(exist_result.has_value());
     }
     // wait for all the lease to expire
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     ASSERT_EQ(10, service_->RemoveAll());
     times = 10;
     while (times--) {
@@ -1054,6 +1163,68 @@ TEST_F(MasterServiceTest, CleanupStaleHandlesTest) {
     EXPECT_EQ(ErrorCode::OBJECT_NOT_FOUND, remove_result.error());
 }
 
+TEST_F(MasterServiceTest, ConcurrentPutStartSameKey) {
+    std::unique_ptr<MasterService> service_(new MasterService());
+    constexpr size_t buffer = 0x300000000;
+    constexpr size_t size = 1024 * 1024 * 256;
+    auto segment = MakeSegment("concurrent_segment", buffer, size);
+    UUID client_id = generate_uuid();
+    ASSERT_TRUE(service_->MountSegment(segment, client_id).has_value());
+
+    constexpr int num_threads = 8;
+    constexpr int num_keys = 100;
+    std::vector<std::atomic<int>> successes(num_keys);
+    std::atomic<int> removed(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            ReplicateConfig config;
+            config.replica_num = 1;
+            for (int j = 0; j < num_keys; ++j) {
+                std::string key = "key_" + std::to_string(j);
+                if (service_->PutStart(key, {1024}, config).has_value()) {
+                    successes[j]++;
+                    service_->PutEnd(key, ReplicaType::MEMORY);
+                }
+            }
+        });
+    }
+    // Removes racing with the allocations of the puts, which either find
+    // no object or remove a committed one
+    threads.emplace_back([&]() {
+        for (int j = 0; j < num_keys; ++j) {
+            auto result = service_->Remove("key_" + std::to_string(j));
+            if (result.has_value()) {
+                removed++;
+            } else {
+                EXPECT_TRUE(result.error() == ErrorCode::OBJECT_NOT_FOUND ||
+                            result.error() == ErrorCode::REPLICA_IS_NOT_READY)
+                    << result.error();
+            }
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // A key is put again only after its object is removed
+    int total_successes = 0;
+    for (int j = 0; j < num_keys; ++j) {
+        EXPECT_GE(successes[j], 1);
+        total_successes += successes[j];
+    }
+    EXPECT_EQ(total_successes, service_->GetKeyCount() + removed);
+
+    // No reservation is left behind
+    ReplicateConfig config;
+    config.replica_num = 1;
+    for (int j = 0; j < num_keys; ++j) {
+        std::string key = "key_" + std::to_string(j);
+        service_->Remove(key);
+        EXPECT_TRUE(service_->PutStart(key, {1024}, config).has_value());
+    }
+}
+
 TEST_F(MasterServiceTest, ConcurrentWriteAndRemoveAll) {
     std::unique_ptr<MasterService> service_(new MasterService());
     constexpr size_t buffer = 0x300000000;
@@ -1199,7 +1370,8 @@ TEST_F(MasterServiceTest, ConcurrentReadAndRemoveAll) {
     EXPECT_NE(success_reads, num_objects);
 
     // wait for all the lease to expire
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     long removed = service_->RemoveAll();
     LOG(INFO) << "Removed " << removed << " objects after kv lease expired";
 
@@ -1428,6 +1600,97 @@ TEST_F(MasterServiceTest, UnmountSegmentPerformance) {
               << "Unmount time: " << unmount_duration.count() << "ms\n";
 }
 
+TEST_F(MasterServiceTest, UnmountSegmentsSharingName) {
+    std::unique_ptr<MasterService> service_(new MasterService());
+    // The segments of a client are mounted under the same name
+    constexpr size_t buffer1 = 0x300000000;
+    constexpr size_t buffer2 = 0x400000000;
+    auto segment1 = MakeSegment("shared_segment", buffer1);
+    auto segment2 = MakeSegment("shared_segment", buffer2);
+    UUID client_id = generate_uuid();
+    ASSERT_TRUE(service_->MountSegment(segment1, client_id).has_value());
+    ASSERT_TRUE(service_->MountSegment(segment2, client_id).has_value());
+
+    constexpr int kNumKeys = 100;
+    std::vector<std::string> keys1, keys2;
+    for (int i = 0; i < kNumKeys; ++i) {
+        std::string key = "shared_key_" + std::to_string(i);
+        auto put_start_result =
+            service_->PutStart(key, {1024}, {.replica_num = 1});
+        ASSERT_TRUE(put_start_result.has_value());
+        ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+        auto address = put_start_result.value()[0]
+                           .get_memory_descriptor()
+                           .buffer_descriptors[0]
+                           .buffer_address_;
+        (address < buffer2 ? keys1 : keys2).push_back(key);
+    }
+    ASSERT_FALSE(keys1.empty());
+    ASSERT_FALSE(keys2.empty());
+
+    // Only the objects in segment1 are removed
+    ASSERT_TRUE(service_->UnmountSegment(segment1.id, client_id).has_value());
+    ASSERT_EQ(keys2.size(), service_->GetKeyCount());
+
+    // Removed objects are dropped from the index, the others are still
+    // found when segment2 is unmounted
+    ASSERT_TRUE(service_->Remove(keys2[0]).has_value());
+    for (size_t i = 1; i < keys2.size(); ++i) {
+        EXPECT_TRUE(service_->GetReplicaList(keys2[i]).has_value());
+    }
+    ASSERT_TRUE(service_->UnmountSegment(segment2.id, client_id).has_value());
+    ASSERT_EQ(0, service_->GetKeyCount());
+}
+
+TEST_F(MasterServiceTest, UnmountChunksOfSegment) {
+    std::unique_ptr<MasterService> service_(new MasterService());
+    // A client mounts a large buffer as contiguous chunks named after its
+    // host, and unmounts them one by one
+    constexpr size_t kNumChunks = 4;
+    constexpr size_t chunk_size = kDefaultSegmentSize;
+    UUID client_id = generate_uuid();
+    std::vector<Segment> chunks;
+    for (size_t i = 0; i < kNumChunks; ++i) {
+        chunks.push_back(MakeSegment("chunked_host",
+                                     kDefaultSegmentBase + i * chunk_size,
+                                     chunk_size));
+        ASSERT_TRUE(service_->MountSegment(chunks.back(), client_id));
+    }
+
+    constexpr int kNumKeys = 200;
+    std::vector<std::vector<std::string>> chunk_keys(kNumChunks);
+    for (int i = 0; i < kNumKeys; ++i) {
+        std::string key = "chunk_key_" + std::to_string(i);
+        auto put_start_result =
+            service_->PutStart(key, {1024}, {.replica_num = 1});
+        ASSERT_TRUE(put_start_result.has_value());
+        ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+        auto address = put_start_result.value()[0]
+                           .get_memory_descriptor()
+                           .buffer_descriptors[0]
+                           .buffer_address_;
+        chunk_keys[(address - kDefaultSegmentBase) / chunk_size].push_back(
+            key);
+    }
+
+    // Each unmount removes the objects of its chunk only, the objects of
+    // the chunks left stay readable
+    size_t key_count = kNumKeys;
+    for (size_t i = 0; i < kNumChunks; ++i) {
+        ASSERT_TRUE(service_->UnmountSegment(chunks[i].id, client_id));
+        key_count -= chunk_keys[i].size();
+        ASSERT_EQ(key_count, service_->GetKeyCount());
+        for (const auto& key : chunk_keys[i]) {
+            EXPECT_FALSE(service_->GetReplicaList(key).has_value());
+        }
+        for (size_t j = i + 1; j < kNumChunks; ++j) {
+            for (const auto& key : chunk_keys[j]) {
+                EXPECT_TRUE(service_->GetReplicaList(key).has_value());
+            }
+        }
+    }
+}
+
 TEST_F(MasterServiceTest, RemoveLeasedObject) {
     const uint64_t kv_lease_ttl = 50;
     auto service_config = MasterServiceConfig::builder()
@@ -1451,7 +1714,8 @@ TEST_F(MasterServiceTest, RemoveLeasedObject) {
     auto remove_result = service_->Remove(key);
     EXPECT_FALSE(remove_result.has_value());
     EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result.error());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto remove_result2 = service_->Remove(key);
     EXPECT_TRUE(remove_result2.has_value());
 
@@ -1462,13 +1726,15 @@ TEST_F(MasterServiceTest, RemoveLeasedObject) {
     ASSERT_TRUE(put_end_result2.has_value());
     auto exist_result2 = service_->ExistKey(key);
     ASSERT_TRUE(exist_result2.has_value());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto exist_result3 = service_->ExistKey(key);
     ASSERT_TRUE(exist_result3.has_value());
     auto remove_result3 = service_->Remove(key);
     EXPECT_FALSE(remove_result3.has_value());
     EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result3.error());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto remove_result4 = service_->Remove(key);
     EXPECT_TRUE(remove_result4.has_value());
 
@@ -1482,7 +1748,8 @@ TEST_F(MasterServiceTest, RemoveLeasedObject) {
     auto remove_result5 = service_->Remove(key);
     EXPECT_FALSE(remove_result5.has_value());
     EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result5.error());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto remove_result6 = service_->Remove(key);
     EXPECT_TRUE(remove_result6.has_value());
 
@@ -1493,13 +1760,15 @@ TEST_F(MasterServiceTest, RemoveLeasedObject) {
     ASSERT_TRUE(put_end_result4.has_value());
     auto get_result2 = service_->GetReplicaList(key);
     ASSERT_TRUE(get_result2.has_value());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto get_result3 = service_->GetReplicaList(key);
     ASSERT_TRUE(get_result3.has_value());
     auto remove_result7 = service_->Remove(key);
     EXPECT_FALSE(remove_result7.has_value());
     EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result7.error());
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     auto remove_result8 = service_->Remove(key);
     EXPECT_TRUE(remove_result8.has_value());
 
@@ -1509,6 +1778,35 @@ TEST_F(MasterServiceTest, RemoveLeasedObject) {
     EXPECT_EQ(ErrorCode::OBJECT_NOT_FOUND, get_result4.error());
 }
 
+TEST_F(MasterServiceTest, LeaseShorterThanEpochOutlivesTtl) {
+    // Below one lease epoch, the lease must still cover the clients' ttl
+    const uint64_t kv_lease_ttl = 5;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+
+    std::string key = "test_key";
+    ReplicateConfig config;
+    config.replica_num = 1;
+    ASSERT_TRUE(service_->PutStart(key, {1024}, config).has_value());
+    ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+
+    ASSERT_TRUE(service_->GetReplicaList(key).has_value());
+    auto remove_result = service_->Remove(key);
+    ASSERT_FALSE(remove_result.has_value());
+    EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result.error());
+    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl - 1));
+    remove_result = service_->Remove(key);
+    ASSERT_FALSE(remove_result.has_value());
+    EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE, remove_result.error());
+
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    EXPECT_TRUE(service_->Remove(key).has_value());
+}
+
 TEST_F(MasterServiceTest, RemoveAllLeasedObject) {
     const uint64_t kv_lease_ttl = 50;
     auto service_config = MasterServiceConfig::builder()
@@ -1537,7 +1835,8 @@ TEST_F(MasterServiceTest, RemoveAllLeasedObject) {
         ASSERT_FALSE(exist_result.value());
     }
     // wait for all the lease to expire
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     ASSERT_EQ(5, service_->RemoveAll());
     for (int i = 5; i < 10; ++i) {
         std::string key = "test_key" + std::to_string(i);
@@ -1581,10 +1880,178 @@ TEST_F(MasterServiceTest, EvictObject) {
         }
     }
     ASSERT_GT(success_puts, 1024 * 16);
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     service_->RemoveAll();
 }
 
+TEST_F(MasterServiceTest, EvictLeastRecentlyReadObjectsFirst) {
+    const uint64_t kv_lease_ttl = 50;
+    // A single shard, so that the eviction order is global, evicting only
+    // when a put finds the segment full
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .set_num_metadata_shards(1)
+                              .set_eviction_high_watermark_ratio(1.0)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    constexpr size_t object_size = 1024 * 1024;
+    constexpr size_t num_objects = 64;
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(
+        *service_, "test_segment", 0x300000000, object_size * num_objects);
+    ReplicateConfig config;
+    config.replica_num = 1;
+    auto put = [&](const std::string& key) {
+        return service_->PutStart(key, {object_size}, config).has_value() &&
+               service_->PutEnd(key, ReplicaType::MEMORY).has_value();
+    };
+
+    // Half of the objects are read after being put, renewing their leases
+    constexpr size_t num_old_objects = num_objects / 2;
+    for (size_t i = 0; i < num_old_objects; ++i) {
+        ASSERT_TRUE(put("old_" + std::to_string(i)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    for (size_t i = 0; i < num_old_objects / 2; ++i) {
+        ASSERT_TRUE(service_->GetReplicaList("old_" + std::to_string(i)));
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+
+    // Filling the segment evicts a few objects, those put but never read go
+    // first
+    for (size_t i = 0; put("new_" + std::to_string(i)); ++i) {
+        ASSERT_LT(i, num_objects);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    size_t evicted = 0;
+    for (size_t i = 0; i < num_old_objects; ++i) {
+        bool exists =
+            service_->ExistKey("old_" + std::to_string(i)).value_or(false);
+        if (i < num_old_objects / 2) {
+            EXPECT_TRUE(exists) << "old_" << i;
+        } else if (!exists) {
+            evicted++;
+        }
+    }
+    EXPECT_GT(evicted, 0u);
+}
+
+TEST_F(MasterServiceTest, InlineEvictionAdmitsPuts) {
+    const uint64_t kv_lease_ttl = 50;
+    // A single shard, so that a put sees all objects when evicting inline,
+    // and no eviction by the eviction thread unless a put fails
+    auto service_config =
+        MasterServiceConfig::builder()
+            .set_default_kv_lease_ttl(kv_lease_ttl)
+            .set_num_metadata_shards(1)
+            .set_eviction_high_watermark_ratio(1.0)
+            .set_enable_inline_eviction(true)
+            .set_put_admission_policy(PutAdmissionPolicy::TINY_LFU)
+            .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    constexpr size_t object_size = 1024 * 1024;
+    constexpr size_t num_objects = 16;
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(
+        *service_, "test_segment", 0x300000000, object_size * num_objects);
+    ReplicateConfig config;
+    config.replica_num = 1;
+    auto put = [&](const std::string& key) {
+        return service_->PutStart(key, {object_size}, config).has_value() &&
+               service_->PutEnd(key, ReplicaType::MEMORY).has_value();
+    };
+
+    // Puts into the full segment evict the objects nobody read, right away
+    for (size_t i = 0; i < 2 * num_objects; ++i) {
+        ASSERT_TRUE(put("once_" + std::to_string(i))) << i;
+    }
+    EXPECT_EQ(num_objects, service_->GetKeyCount());
+    EXPECT_EQ(0u, service_->GetPutRetryAfterMs());
+
+    // Objects read since their put are kept from a put seen for the first
+    // time, the put fails without making the eviction thread evict them
+    std::vector<std::string> read_keys;
+    for (size_t i = 0; i < 2 * num_objects; ++i) {
+        std::string key = "once_" + std::to_string(i);
+        if (service_->GetReplicaList(key).has_value()) {
+            read_keys.push_back(key);
+        }
+    }
+    ASSERT_EQ(num_objects, read_keys.size());
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    auto put_start_result = service_->PutStart("new", {object_size}, config);
+    ASSERT_FALSE(put_start_result.has_value());
+    EXPECT_EQ(ErrorCode::NO_AVAILABLE_HANDLE, put_start_result.error());
+    EXPECT_GT(service_->GetPutRetryAfterMs(), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (const auto& key : read_keys) {
+        EXPECT_TRUE(service_->ExistKey(key).value_or(false)) << key;
+    }
+
+    // A key read before, e.g. a miss computed since, evicts one of them once
+    // the leases granted by ExistKey expire
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    EXPECT_FALSE(service_->GetReplicaList("missed").has_value());
+    EXPECT_FALSE(service_->GetReplicaList("missed").has_value());
+    EXPECT_TRUE(put("missed"));
+    EXPECT_EQ(0u, service_->GetPutRetryAfterMs());
+    EXPECT_EQ(num_objects, service_->GetKeyCount());
+
+    // Leased objects cannot be evicted, the hint is when the leases expire
+    for (const auto& key : read_keys) {
+        service_->GetReplicaList(key);
+    }
+    EXPECT_TRUE(service_->GetReplicaList("missed").has_value());
+    EXPECT_FALSE(put("new"));
+    EXPECT_GT(service_->GetPutRetryAfterMs(), 10u);
+    EXPECT_LE(service_->GetPutRetryAfterMs(), kv_lease_ttl + kLeaseSlackMs);
+}
+
+TEST_F(MasterServiceTest, InlineEvictionCountsSharedBuffersOnce) {
+    auto service_config = MasterServiceConfig::builder()
+                              .set_num_metadata_shards(1)
+                              .set_eviction_high_watermark_ratio(1.0)
+                              .set_enable_inline_eviction(true)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    constexpr size_t object_size = 1024 * 1024;
+    constexpr size_t num_objects = 4;
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(
+        *service_, "test_segment", 0x300000000, object_size * num_objects);
+    ReplicateConfig config;
+    config.replica_num = 1;
+    auto put = [&](const std::string& key) {
+        return service_->PutStart(key, {object_size}, config).has_value() &&
+               service_->PutEnd(key, ReplicaType::MEMORY).has_value();
+    };
+
+    // Three keys share one buffer, and are evicted first
+    config.content_hash = "block_hash";
+    ASSERT_TRUE(put("shared_0"));
+    for (const std::string key : {"shared_1", "shared_2"}) {
+        auto put_start_result = service_->PutStart(key, {object_size}, config);
+        ASSERT_FALSE(put_start_result.has_value());
+        EXPECT_EQ(ErrorCode::CONTENT_ALREADY_EXISTS, put_start_result.error());
+    }
+    config.content_hash.clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (size_t i = 1; i < num_objects; ++i) {
+        ASSERT_TRUE(put("unique_" + std::to_string(i))) << i;
+    }
+
+    // Evicting one of the keys sharing the buffer frees nothing, the put
+    // evicts all of them
+    EXPECT_TRUE(put("new"));
+    EXPECT_EQ(0u, service_->GetPutRetryAfterMs());
+    EXPECT_EQ(num_objects, service_->GetKeyCount());
+    for (size_t i = 1; i < num_objects; ++i) {
+        std::string key = "unique_" + std::to_string(i);
+        EXPECT_TRUE(service_->GetReplicaList(key).has_value()) << key;
+    }
+}
+
 TEST_F(MasterServiceTest, TryEvictLeasedObject) {
     // set a large kv_lease_ttl so the granted lease will not quickly expire
     const uint64_t kv_lease_ttl = 500;
@@ -1629,7 +2096,8 @@ TEST_F(MasterServiceTest, TryEvictLeasedObject) {
         auto get_result = service_->GetReplicaList(key);
         ASSERT_TRUE(get_result.has_value());
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     service_->RemoveAll();
 }
 
@@ -1732,7 +2200,8 @@ TEST_F(MasterServiceTest, SoftPinObjectsNotEvictedBeforeOtherObjects) {
         }
 
         // wait for the lease to expire
-        std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
         // remove all objects before the next turn
         service_->RemoveAll();
     }
@@ -1775,7 +2244,8 @@ TEST_F(MasterServiceTest, SoftPinObjectsCanBeEvicted) {
         }
     }
     ASSERT_GT(success_puts, 16);
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     service_->RemoveAll();
 }
 
@@ -1822,7 +2292,8 @@ TEST_F(MasterServiceTest, SoftPinExtendedOnGet) {
         }
 
         // Wait for the soft pin to expire
-        std::this_thread::sleep_for(std::chrono::milliseconds(kv_soft_pin_ttl));
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kv_soft_pin_ttl + kLeaseSlackMs));
 
         // Get the pin_key to extend the soft pin
         for (int i = 0; i < 2; i++) {
@@ -1847,7 +2318,8 @@ TEST_F(MasterServiceTest, SoftPinExtendedOnGet) {
         ASSERT_GT(failed_puts, 0);
 
         // wait for eviction
-        std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
 
         // pin_key should still be accessible
         for (int i = 0; i < 2; i++) {
@@ -1856,7 +2328,8 @@ TEST_F(MasterServiceTest, SoftPinExtendedOnGet) {
         }
 
         // wait for the lease to expire
-        std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
         // remove all objects before the next turn
         service_->RemoveAll();
     }
@@ -1905,10 +2378,127 @@ TEST_F(MasterServiceTest, SoftPinObjectsNotAllowEvict) {
     for (const auto& key : success_keys) {
         ASSERT_TRUE(service_->GetReplicaList(key).has_value());
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(kv_lease_ttl));
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
     service_->RemoveAll();
 }
 
+TEST_F(MasterServiceTest, NamespaceQuotaEvictsOwnObjects) {
+    std::unique_ptr<MasterService> service_(new MasterService());
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+    constexpr size_t object_size = 64 * 1024;
+    constexpr size_t quota = 32 * object_size;
+
+    auto put = [&](const std::string& key, const std::string& name_space) {
+        ReplicateConfig config;
+        config.replica_num = 1;
+        config.namespace_name = name_space;
+        // Retry while the eviction makes room
+        for (int attempt = 0; attempt < 20; ++attempt) {
+            if (service_->PutStart(key, {object_size}, config)) {
+                return service_->PutEnd(key, ReplicaType::MEMORY).has_value();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return false;
+    };
+
+    // A tenant without quota fills a quarter of the segment
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(put("tenant_b_" + std::to_string(i), "tenant_b"));
+    }
+    // A tenant with a quota writes three times its quota
+    ASSERT_TRUE(service_->SetNamespaceQuota("tenant_a", quota).has_value());
+    for (int i = 0; i < 96; ++i) {
+        ASSERT_TRUE(put("tenant_a_" + std::to_string(i), "tenant_a"));
+    }
+
+    // Only the oldest objects of the tenant with the quota were evicted
+    auto usage = service_->QueryNamespace("tenant_a");
+    ASSERT_TRUE(usage.has_value());
+    EXPECT_LE(usage->first, quota);
+    EXPECT_EQ(quota, usage->second);
+    auto exist_result = service_->ExistKey("tenant_a_95");
+    ASSERT_TRUE(exist_result.has_value());
+    EXPECT_TRUE(exist_result.value());
+    exist_result = service_->ExistKey("tenant_a_0");
+    ASSERT_TRUE(exist_result.has_value());
+    EXPECT_FALSE(exist_result.value());
+    for (int i = 0; i < 64; ++i) {
+        exist_result = service_->ExistKey("tenant_b_" + std::to_string(i));
+        ASSERT_TRUE(exist_result.has_value());
+        EXPECT_TRUE(exist_result.value());
+    }
+    usage = service_->QueryNamespace("tenant_b");
+    ASSERT_TRUE(usage.has_value());
+    EXPECT_EQ(64 * object_size, usage->first);
+    EXPECT_EQ(0, usage->second);
+
+    // The per-namespace metrics are published by the eviction thread
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto& metrics = MasterMetricManager::instance();
+    EXPECT_GT(metrics.get_namespace_evicted_keys("tenant_a"), 0);
+    EXPECT_GT(metrics.get_namespace_quota_rejections("tenant_a"), 0);
+    EXPECT_EQ(0, metrics.get_namespace_evicted_keys("tenant_b"));
+    EXPECT_EQ(64, metrics.get_namespace_key_count("tenant_b"));
+}
+
+TEST_F(MasterServiceTest, DropNamespace) {
+    const uint64_t kv_lease_ttl = 200;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+
+    ReplicateConfig config;
+    config.replica_num = 1;
+    for (int i = 0; i < 10; ++i) {
+        for (const std::string name_space : {"", "model_a"}) {
+            config.namespace_name = name_space;
+            std::string key = name_space + "key_" + std::to_string(i);
+            ASSERT_TRUE(service_->PutStart(key, {1024}, config));
+            ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY));
+        }
+    }
+    auto usage = service_->QueryNamespace("model_a");
+    ASSERT_TRUE(usage.has_value());
+    EXPECT_EQ(10 * 1024, usage->first);
+
+    // A reader holds a lease on one of the objects
+    ASSERT_TRUE(service_->GetReplicaList("model_akey_0").has_value());
+    ASSERT_TRUE(service_->DropNamespace("model_a").has_value());
+    EXPECT_EQ(ErrorCode::INVALID_PARAMS, service_->DropNamespace("").error());
+    EXPECT_EQ(ErrorCode::OBJECT_NOT_FOUND,
+              service_->GetReplicaList("model_akey_1").error());
+    auto all_keys = service_->GetAllKeys();
+    ASSERT_TRUE(all_keys.has_value());
+    EXPECT_EQ(10, all_keys->size());
+    auto exist_result = service_->ExistKey("key_1");
+    ASSERT_TRUE(exist_result.has_value());
+    EXPECT_TRUE(exist_result.value());
+
+    // The keys can be put again, once no reader holds a lease on them
+    config.namespace_name = "model_a";
+    EXPECT_EQ(ErrorCode::OBJECT_HAS_LEASE,
+              service_->PutStart("model_akey_0", {1024}, config).error());
+    ASSERT_TRUE(service_->PutStart("model_akey_1", {1024}, config));
+    ASSERT_TRUE(service_->PutEnd("model_akey_1", ReplicaType::MEMORY));
+
+    // The other dropped objects are reclaimed in the background, the leased
+    // one once its lease expired
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(12, service_->GetKeyCount());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    EXPECT_EQ(11, service_->GetKeyCount());
+    usage = service_->QueryNamespace("model_a");
+    ASSERT_TRUE(usage.has_value());
+    EXPECT_EQ(1024, usage->first);
+    exist_result = service_->ExistKey("model_akey_1");
+    ASSERT_TRUE(exist_result.has_value());
+    EXPECT_TRUE(exist_result.value());
+}
+
 TEST_F(MasterServiceTest, PerSliceReplicaSegmentsAreUnique) {
     std::unique_ptr<MasterService> service_(new MasterService());
 
@@ -2021,6 +2611,508 @@ TEST_F(MasterServiceTest, BatchExistKeyTest) {
     ASSERT_FALSE(exist_resp[test_object_num].value());
 }
 
+// Fills a 16MB segment with 1MB objects and removes every other one, so the
+// free space is split into 1MB holes.
+std::vector<std::string> FragmentSegment(MasterService& service) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 15; ++i) {
+        std::string key = "fragment_key_" + std::to_string(i);
+        auto put_start_result =
+            service.PutStart(key, {1024 * 1024}, {.replica_num = 1});
+        EXPECT_TRUE(put_start_result.has_value());
+        EXPECT_TRUE(service.PutEnd(key, ReplicaType::MEMORY).has_value());
+        keys.push_back(key);
+    }
+    std::vector<std::string> kept_keys;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i % 2 == 0) {
+            EXPECT_TRUE(service.Remove(keys[i]).has_value());
+        } else {
+            kept_keys.push_back(keys[i]);
+        }
+    }
+    return kept_keys;
+}
+
+// Pings until the master hands out compaction tasks
+std::vector<CompactionTask> WaitForCompactionTasks(MasterService& service,
+                                                   const UUID& client_id) {
+    for (int i = 0; i < 50; ++i) {
+        auto ping_result = service.Ping(client_id);
+        EXPECT_TRUE(ping_result.has_value());
+        if (!ping_result.value().compaction_tasks.empty()) {
+            return std::move(ping_result.value().compaction_tasks);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return {};
+}
+
+uintptr_t GetBufferAddress(MasterService& service, const std::string& key) {
+    auto get_result = service.GetReplicaList(key);
+    EXPECT_TRUE(get_result.has_value());
+    return get_result.value()
+        .replicas[0]
+        .get_memory_descriptor()
+        .buffer_descriptors[0]
+        .buffer_address_;
+}
+
+TEST_F(MasterServiceTest, CompactionMovesObjects) {
+    const uint64_t kv_lease_ttl = 200;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .set_compaction_fragmentation_ratio(0.5)
+                              .set_eviction_ratio(0.0)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const auto context = PrepareSimpleSegment(*service_);
+    auto keys = FragmentSegment(*service_);
+
+    // The holes are too small for a 4MB object
+    std::string large_key = "large_key";
+    EXPECT_FALSE(service_->PutStart(large_key, {4 * 1024 * 1024},
+                                    {.replica_num = 1})
+                     .has_value());
+
+    auto tasks = WaitForCompactionTasks(*service_, context.client_id);
+    ASSERT_FALSE(tasks.empty());
+
+    // Only the owner of the segment can complete the tasks
+    auto move_result = service_->MoveEnd(generate_uuid(), tasks[0].task_id,
+                                         true);
+    EXPECT_FALSE(move_result.has_value());
+    EXPECT_EQ(ErrorCode::INVALID_PARAMS, move_result.error());
+
+    for (const auto& task : tasks) {
+        EXPECT_NE(keys.end(), std::find(keys.begin(), keys.end(), task.key));
+        ASSERT_EQ(1u, task.sources.size());
+        ASSERT_EQ(1u, task.targets.size());
+        EXPECT_EQ(task.sources[0].size_, task.targets[0].size_);
+        EXPECT_NE(task.sources[0].buffer_address_,
+                  task.targets[0].buffer_address_);
+        EXPECT_TRUE(
+            service_->MoveEnd(context.client_id, task.task_id, true)
+                .has_value());
+        // The object is readable from its new location
+        EXPECT_EQ(task.targets[0].buffer_address_,
+                  GetBufferAddress(*service_, task.key));
+    }
+    // A task completes only once
+    EXPECT_FALSE(service_->MoveEnd(context.client_id, tasks[0].task_id, true)
+                     .has_value());
+
+    // Keep compacting until the free space is contiguous enough
+    bool large_put_succeeded = false;
+    for (int round = 0; round < 10 && !large_put_succeeded; ++round) {
+        large_put_succeeded =
+            service_
+                ->PutStart(large_key, {4 * 1024 * 1024}, {.replica_num = 1})
+                .has_value();
+        if (!large_put_succeeded) {
+            // Objects read above must be unleased before being moved again
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+            for (const auto& task :
+                 WaitForCompactionTasks(*service_, context.client_id)) {
+                EXPECT_TRUE(
+                    service_->MoveEnd(context.client_id, task.task_id, true)
+                        .has_value());
+            }
+        }
+    }
+    EXPECT_TRUE(large_put_succeeded);
+    for (const auto& key : keys) {
+        EXPECT_TRUE(service_->ExistKey(key).value());
+    }
+}
+
+TEST_F(MasterServiceTest, CompactionWaitsForLeases) {
+    const uint64_t kv_lease_ttl = 500;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .set_compaction_fragmentation_ratio(0.5)
+                              .set_eviction_ratio(0.0)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const auto context = PrepareSimpleSegment(*service_);
+    FragmentSegment(*service_);
+
+    auto tasks = WaitForCompactionTasks(*service_, context.client_id);
+    ASSERT_GE(tasks.size(), 2u);
+
+    // A reader got the source buffers, the move waits for its lease
+    const auto& read_task = tasks[0];
+    EXPECT_EQ(read_task.sources[0].buffer_address_,
+              GetBufferAddress(*service_, read_task.key));
+    EXPECT_TRUE(
+        service_->MoveEnd(context.client_id, read_task.task_id, true)
+            .has_value());
+    EXPECT_EQ(read_task.sources[0].buffer_address_,
+              GetBufferAddress(*service_, read_task.key));
+
+    // A failed copy leaves the object in place
+    const auto& failed_task = tasks[1];
+    EXPECT_TRUE(
+        service_->MoveEnd(context.client_id, failed_task.task_id, false)
+            .has_value());
+
+    // A removed object is not moved
+    for (size_t i = 2; i < tasks.size(); ++i) {
+        EXPECT_TRUE(service_->Remove(tasks[i].key).has_value());
+        EXPECT_TRUE(
+            service_->MoveEnd(context.client_id, tasks[i].task_id, true)
+                .has_value());
+        EXPECT_FALSE(service_->ExistKey(tasks[i].key).value());
+    }
+
+    // The lease expires and the compaction thread commits the move
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+        kv_lease_ttl * 2 + 1500));
+    EXPECT_EQ(read_task.targets[0].buffer_address_,
+              GetBufferAddress(*service_, read_task.key));
+    EXPECT_EQ(failed_task.sources[0].buffer_address_,
+              GetBufferAddress(*service_, failed_task.key));
+}
+
+TEST_F(MasterServiceTest, CompactionSkipsUnchangedSegments) {
+    auto service_config = MasterServiceConfig::builder()
+                              .set_compaction_fragmentation_ratio(0.5)
+                              .set_eviction_ratio(0.0)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const auto context = PrepareSimpleSegment(*service_);
+
+    // Fragment the segment with objects still being put, which cannot be
+    // moved
+    std::vector<std::string> keys;
+    for (int i = 0; i < 15; ++i) {
+        std::string key = "fragment_key_" + std::to_string(i);
+        ASSERT_TRUE(service_->PutStart(key, {1024 * 1024}, {.replica_num = 1})
+                        .has_value());
+        keys.push_back(key);
+    }
+    std::vector<std::string> kept_keys;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i % 2 == 0) {
+            EXPECT_TRUE(
+                service_->PutRevoke(keys[i], ReplicaType::MEMORY).has_value());
+        } else {
+            kept_keys.push_back(keys[i]);
+        }
+    }
+    keys = std::move(kept_keys);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    // The objects become movable, but the segment is not scanned again as
+    // long as its free space is unchanged
+    for (const auto& key : keys) {
+        EXPECT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+    }
+    for (int i = 0; i < 20; ++i) {
+        auto ping_result = service_->Ping(context.client_id);
+        ASSERT_TRUE(ping_result.has_value());
+        EXPECT_TRUE(ping_result.value().compaction_tasks.empty());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    // Freeing space makes it scanned again
+    EXPECT_TRUE(service_->Remove(keys.back()).has_value());
+    EXPECT_FALSE(WaitForCompactionTasks(*service_, context.client_id).empty());
+}
+
+TEST_F(MasterServiceTest, CompactionSkipsDeduplicatedObjects) {
+    const uint64_t kv_lease_ttl = 50;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .set_compaction_fragmentation_ratio(0.5)
+                              .set_eviction_ratio(0.0)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const auto context = PrepareSimpleSegment(*service_);
+
+    // Fragment the segment with objects whose buffers are shared with a
+    // copy put with the same content
+    std::vector<ReplicateConfig> configs(15);
+    for (size_t i = 0; i < configs.size(); ++i) {
+        std::string key = "dedup_key_" + std::to_string(i);
+        configs[i].replica_num = 1;
+        configs[i].content_hash = "dedup_hash_" + std::to_string(i);
+        ASSERT_TRUE(
+            service_->PutStart(key, {1024 * 1024}, configs[i]).has_value());
+        ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+    }
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        std::string key = "dedup_key_" + std::to_string(i);
+        if (i % 2 == 0) {
+            EXPECT_TRUE(service_->Remove(key).has_value());
+            continue;
+        }
+        auto put_start_result =
+            service_->PutStart("copy_of_" + key, {1024 * 1024}, configs[i]);
+        ASSERT_FALSE(put_start_result.has_value());
+        EXPECT_EQ(ErrorCode::CONTENT_ALREADY_EXISTS, put_start_result.error());
+        keys.push_back(key);
+    }
+
+    // The shared buffers are not moved
+    for (int i = 0; i < 20; ++i) {
+        auto ping_result = service_->Ping(context.client_id);
+        ASSERT_TRUE(ping_result.has_value());
+        EXPECT_TRUE(ping_result.value().compaction_tasks.empty());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    // Without their copies the objects are moved, except the one still
+    // shared. Removing an object frees space, so the segment is scanned
+    // again.
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    const std::string& shared_key = keys.front();
+    uintptr_t shared_address = GetBufferAddress(*service_, shared_key);
+    for (size_t i = 1; i < keys.size(); ++i) {
+        EXPECT_TRUE(service_->Remove("copy_of_" + keys[i]).has_value());
+    }
+    EXPECT_TRUE(service_->Remove(keys.back()).has_value());
+    keys.pop_back();
+    auto tasks = WaitForCompactionTasks(*service_, context.client_id);
+    ASSERT_FALSE(tasks.empty());
+    for (const auto& task : tasks) {
+        EXPECT_NE(shared_key, task.key);
+        EXPECT_TRUE(service_->MoveEnd(context.client_id, task.task_id, true)
+                        .has_value());
+    }
+    EXPECT_EQ(shared_address, GetBufferAddress(*service_, shared_key));
+    EXPECT_EQ(shared_address,
+              GetBufferAddress(*service_, "copy_of_" + shared_key));
+}
+
+TEST_F(MasterServiceTest, ContentHashSharesReplicas) {
+    const uint64_t kv_lease_ttl = 50;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+    constexpr size_t object_size = 1024 * 1024;
+    ReplicateConfig config;
+    config.replica_num = 1;
+    config.content_hash = "block_hash";
+
+    // The first put of the content transfers the data
+    ASSERT_TRUE(service_->PutStart("key_1", {object_size}, config).has_value());
+    ASSERT_TRUE(service_->PutEnd("key_1", ReplicaType::MEMORY).has_value());
+    size_t used_size = service_->QuerySegments("test_segment").value().first;
+
+    // The next puts share its replicas and need no PutEnd
+    for (const std::string key : {"key_2", "key_3"}) {
+        auto put_start_result =
+            service_->PutStart(key, {object_size / 2, object_size / 2}, config);
+        ASSERT_FALSE(put_start_result.has_value());
+        EXPECT_EQ(ErrorCode::CONTENT_ALREADY_EXISTS, put_start_result.error());
+        EXPECT_EQ(GetBufferAddress(*service_, "key_1"),
+                  GetBufferAddress(*service_, key));
+    }
+    EXPECT_EQ(used_size, service_->QuerySegments("test_segment").value().first);
+    EXPECT_EQ(3u, service_->GetKeyCount());
+
+    // A value of another size with the same hash is stored as is
+    auto put_start_result =
+        service_->PutStart("key_4", {object_size * 2}, config);
+    ASSERT_TRUE(put_start_result.has_value());
+    EXPECT_TRUE(service_->PutRevoke("key_4", ReplicaType::MEMORY).has_value());
+
+    // The memory is freed along with the last key referencing it
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    EXPECT_TRUE(service_->Remove("key_1").has_value());
+    EXPECT_TRUE(service_->Remove("key_2").has_value());
+    EXPECT_EQ(used_size, service_->QuerySegments("test_segment").value().first);
+    EXPECT_TRUE(service_->GetReplicaList("key_3").has_value());
+    put_start_result = service_->PutStart("key_5", {object_size}, config);
+    ASSERT_FALSE(put_start_result.has_value());
+    EXPECT_EQ(ErrorCode::CONTENT_ALREADY_EXISTS, put_start_result.error());
+
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(kv_lease_ttl + kLeaseSlackMs));
+    EXPECT_TRUE(service_->Remove("key_3").has_value());
+    EXPECT_TRUE(service_->Remove("key_5").has_value());
+    EXPECT_EQ(0u, service_->QuerySegments("test_segment").value().first);
+
+    // Once freed, the content is put again
+    ASSERT_TRUE(service_->PutStart("key_6", {object_size}, config).has_value());
+}
+
+TEST_F(MasterServiceTest, ScanKeys) {
+    auto service_config =
+        MasterServiceConfig::builder().set_num_metadata_shards(8).build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    [[maybe_unused]] const auto context = PrepareSimpleSegment(*service_);
+    ReplicateConfig config;
+    config.replica_num = 1;
+    constexpr int num_keys = 100;
+    for (int i = 0; i < num_keys; ++i) {
+        for (const std::string prefix : {"a_", "b_"}) {
+            std::string key = prefix + std::to_string(i);
+            ASSERT_TRUE(service_->PutStart(key, {1024}, config));
+            ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY));
+        }
+    }
+
+    // Pages of at most `limit` keys, each key returned once, also while
+    // keys are removed during the scan
+    auto scan = [&](const std::string& prefix, size_t limit) {
+        std::vector<std::string> keys;
+        std::string cursor;
+        do {
+            auto page = service_->ScanKeys(cursor, limit, prefix);
+            EXPECT_TRUE(page.has_value());
+            if (!page.has_value()) {
+                break;
+            }
+            EXPECT_LE(page->keys.size(), limit);
+            keys.insert(keys.end(), page->keys.begin(), page->keys.end());
+            cursor = page->next_cursor;
+            if (prefix == "a_" && !page->keys.empty()) {
+                EXPECT_TRUE(service_->Remove(page->keys.back()).has_value());
+            }
+        } while (!cursor.empty());
+        return keys;
+    };
+    auto keys = scan("", 7);
+    EXPECT_EQ(2 * num_keys, keys.size());
+    EXPECT_EQ(keys.size(),
+              std::unordered_set<std::string>(keys.begin(), keys.end()).size());
+    keys = scan("a_", 3);
+    EXPECT_EQ(num_keys, keys.size());
+    for (const auto& key : keys) {
+        EXPECT_TRUE(key.starts_with("a_")) << key;
+    }
+    keys = scan("b_", 1000);
+    EXPECT_EQ(num_keys, keys.size());
+
+    EXPECT_EQ(ErrorCode::INVALID_PARAMS,
+              service_->ScanKeys("", 0, "").error());
+    EXPECT_EQ(ErrorCode::INVALID_PARAMS,
+              service_->ScanKeys("a_1", 10, "").error());
+    EXPECT_EQ(ErrorCode::INVALID_PARAMS,
+              service_->ScanKeys("8:a_1", 10, "").error());
+}
+
+TEST_F(MasterServiceTest, HotKeyReplicatedToOtherSegment) {
+    const uint64_t kv_lease_ttl = 200;
+    const uint64_t read_threshold = 100;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_default_kv_lease_ttl(kv_lease_ttl)
+                              .set_hot_key_read_threshold(read_threshold)
+                              .set_hot_key_extra_replicas(1)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const std::vector<MountedSegmentContext> contexts = {
+        PrepareSimpleSegment(*service_, "segment_a", kDefaultSegmentBase),
+        PrepareSimpleSegment(*service_, "segment_b",
+                             kDefaultSegmentBase + kDefaultSegmentSize)};
+    constexpr size_t object_size = 1024 * 1024;
+    for (const std::string key : {"hot_key", "cold_key"}) {
+        ASSERT_TRUE(service_->PutStart(key, {object_size}, {.replica_num = 1})
+                        .has_value());
+        ASSERT_TRUE(service_->PutEnd(key, ReplicaType::MEMORY).has_value());
+    }
+    auto used_size = [&service_]() {
+        return service_->QuerySegments("segment_a").value().first +
+               service_->QuerySegments("segment_b").value().first;
+    };
+
+    // Skewed reads, only the hot key is copied to the other segment by the
+    // client holding its replica
+    for (uint64_t i = 0; i < read_threshold * 2; ++i) {
+        ASSERT_TRUE(service_->GetReplicaList("hot_key").has_value());
+        if (i % 20 == 0) {
+            ASSERT_TRUE(service_->GetReplicaList("cold_key").has_value());
+        }
+    }
+    std::vector<CompactionTask> tasks;
+    UUID owner;
+    for (int i = 0; i < 50 && tasks.empty(); ++i) {
+        for (const auto& context : contexts) {
+            auto ping_result = service_->Ping(context.client_id);
+            ASSERT_TRUE(ping_result.has_value());
+            if (!ping_result.value().compaction_tasks.empty()) {
+                tasks = std::move(ping_result.value().compaction_tasks);
+                owner = context.client_id;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(1u, tasks.size());
+    EXPECT_EQ("hot_key", tasks[0].key);
+    ASSERT_EQ(1u, tasks[0].targets.size());
+    EXPECT_NE(tasks[0].sources[0].transport_endpoint_,
+              tasks[0].targets[0].transport_endpoint_);
+    EXPECT_EQ(3 * object_size, used_size());
+    EXPECT_TRUE(
+        service_->MoveEnd(owner, tasks[0].task_id, true).has_value());
+
+    // The readers are spread over both replicas
+    auto first = service_->GetReplicaList("hot_key");
+    auto second = service_->GetReplicaList("hot_key");
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    ASSERT_EQ(2u, first->replicas.size());
+    EXPECT_NE(first->replicas[0]
+                  .get_memory_descriptor()
+                  .buffer_descriptors[0]
+                  .transport_endpoint_,
+              second->replicas[0]
+                  .get_memory_descriptor()
+                  .buffer_descriptors[0]
+                  .transport_endpoint_);
+    EXPECT_EQ(1u, service_->GetReplicaList("cold_key")->replicas.size());
+
+    // Once the reads stop, the decayed count drops and so does the replica
+    for (int i = 0; i < 100 && used_size() > 2 * object_size; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(2 * object_size, used_size());
+    EXPECT_EQ(1u, service_->GetReplicaList("hot_key")->replicas.size());
+}
+
+TEST_F(MasterServiceTest, HotKeyNotReplicatedOverQuota) {
+    const uint64_t read_threshold = 100;
+    auto service_config = MasterServiceConfig::builder()
+                              .set_hot_key_read_threshold(read_threshold)
+                              .set_hot_key_extra_replicas(1)
+                              .build();
+    std::unique_ptr<MasterService> service_(new MasterService(service_config));
+    const std::vector<MountedSegmentContext> contexts = {
+        PrepareSimpleSegment(*service_, "segment_a", kDefaultSegmentBase),
+        PrepareSimpleSegment(*service_, "segment_b",
+                             kDefaultSegmentBase + kDefaultSegmentSize)};
+    constexpr size_t object_size = 1024 * 1024;
+    ASSERT_TRUE(
+        service_->SetNamespaceQuota("tenant", object_size * 3 / 2).has_value());
+    ReplicateConfig config;
+    config.replica_num = 1;
+    config.namespace_name = "tenant";
+    ASSERT_TRUE(
+        service_->PutStart("hot_key", {object_size}, config).has_value());
+    ASSERT_TRUE(service_->PutEnd("hot_key", ReplicaType::MEMORY).has_value());
+
+    // A second replica would not fit the quota of the namespace
+    for (uint64_t i = 0; i < read_threshold * 2; ++i) {
+        ASSERT_TRUE(service_->GetReplicaList("hot_key").has_value());
+    }
+    for (int i = 0; i < 20; ++i) {
+        for (const auto& context : contexts) {
+            auto ping_result = service_->Ping(context.client_id);
+            ASSERT_TRUE(ping_result.has_value());
+            EXPECT_TRUE(ping_result.value().compaction_tasks.empty());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(object_size, service_->QueryNamespace("tenant").value().first);
+}
+
 }  // namespace mooncake::test
 
 int main(int argc, char** argv) {
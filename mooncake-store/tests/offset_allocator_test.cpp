@@ -8,6 +8,9 @@
 #include <map>
 #include <memory>
 #include <random>
+#include <set>
+#include <thread>
+#include <vector>
 
 namespace mooncake::offset_allocator {
 
@@ -1601,6 +1604,126 @@ TEST_F(OffsetAllocatorTest, ChainedAllocationAndDeserialization) {
     }
 }
 
+// Test the arena layout of the sharded allocator
+TEST(ShardedOffsetAllocatorTest, ShardLayout) {
+    // Small segments are not split
+    auto small = ShardedOffsetAllocator::create(0x1000, 64 * 1024 * 1024);
+    EXPECT_EQ(small->num_shards(), 1);
+    EXPECT_EQ(small->storageReport().totalFreeSpace, 64 * 1024 * 1024);
+
+    auto medium = ShardedOffsetAllocator::create(0x1000, 1ull << 32);
+    EXPECT_EQ(medium->num_shards(), ShardedOffsetAllocator::kDefaultNumShards);
+
+    // Large segments use as many arenas as needed to keep each below the
+    // maximum bin size
+    const size_t large_size = (1ull << 40) + 12345;
+    auto large = ShardedOffsetAllocator::create(0x1000, large_size);
+    EXPECT_LE(large->shard_size(), ShardedOffsetAllocator::kMaxShardSize);
+    EXPECT_GE(large->num_shards() * large->shard_size(), large_size);
+    EXPECT_EQ(large->storageReport().totalFreeSpace, large_size);
+    EXPECT_EQ(large->get_metrics().capacity, large_size);
+}
+
+// Test small allocations on a large segment are not rounded to a multiplier
+TEST(ShardedOffsetAllocatorTest, ExactOffsetsOnLargeSegment) {
+    const size_t buffer_size = 1ull << 40;
+    // A single allocator of this size rounds to 512 bytes
+    auto single = OffsetAllocator::create(0, buffer_size);
+    auto sharded = ShardedOffsetAllocator::create(0, buffer_size);
+
+    auto single_first = single->allocate(100);
+    auto single_second = single->allocate(100);
+    auto sharded_first = sharded->allocate(100);
+    auto sharded_second = sharded->allocate(100);
+    ASSERT_TRUE(single_first && single_second && sharded_first &&
+                sharded_second);
+    EXPECT_GE(single_second->address() - single_first->address(), 512);
+    EXPECT_LT(sharded_second->address() - sharded_first->address(), 512);
+    EXPECT_EQ(sharded_first->size(), 100);
+
+    // Allocations of a whole arena still fit
+    auto whole = sharded->allocate(sharded->shard_size());
+    ASSERT_TRUE(whole.has_value());
+    EXPECT_FALSE(sharded->allocate(sharded->shard_size() + 1).has_value());
+}
+
+// Test a full arena steals from the others
+TEST(ShardedOffsetAllocatorTest, StealsWhenArenaFull) {
+    const size_t shard_size = 1024 * 1024;
+    auto allocator = ShardedOffsetAllocator::create(0x1000, 4 * shard_size, 4);
+    ASSERT_EQ(allocator->num_shards(), 4);
+
+    std::vector<OffsetAllocationHandle> handles;
+    std::set<uint64_t> addresses;
+    for (int i = 0; i < 4; ++i) {
+        auto handle = allocator->allocate(shard_size);
+        ASSERT_TRUE(handle.has_value()) << "Failed to allocate arena " << i;
+        addresses.insert(handle->address());
+        handles.push_back(std::move(*handle));
+    }
+    EXPECT_EQ(addresses.size(), 4);
+    EXPECT_FALSE(allocator->allocate(1).has_value());
+
+    // A freed arena is found again from any thread
+    uint64_t freed_address = handles[2].address();
+    handles.erase(handles.begin() + 2);
+    std::thread([&]() {
+        auto handle = allocator->allocate(shard_size);
+        ASSERT_TRUE(handle.has_value());
+        EXPECT_EQ(handle->address(), freed_address);
+    }).join();
+    EXPECT_EQ(allocator->get_metrics().allocated_num_, 3);
+}
+
+// Test concurrent allocations from many threads do not overlap
+TEST(ShardedOffsetAllocatorTest, ConcurrentAllocations) {
+    auto allocator = ShardedOffsetAllocator::create(0, 1ull << 30, 8);
+    constexpr int kNumThreads = 16;
+    constexpr int kAllocsPerThread = 1000;
+
+    std::vector<std::vector<OffsetAllocationHandle>> handles(kNumThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<size_t> dist(1, 64 * 1024);
+            for (int i = 0; i < kAllocsPerThread; ++i) {
+                auto handle = allocator->allocate(dist(gen));
+                if (handle) {
+                    handles[t].push_back(std::move(*handle));
+                }
+                // Free every third allocation again
+                if (i % 3 == 2 && !handles[t].empty()) {
+                    size_t index = gen() % handles[t].size();
+                    handles[t].erase(handles[t].begin() + index);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::map<uint64_t, uint64_t> ranges;
+    size_t num_handles = 0;
+    for (const auto& thread_handles : handles) {
+        for (const auto& handle : thread_handles) {
+            ranges.emplace(handle.address(), handle.size());
+            num_handles++;
+        }
+    }
+    ASSERT_EQ(ranges.size(), num_handles);
+    uint64_t end = 0;
+    for (const auto& [address, size] : ranges) {
+        EXPECT_GE(address, end) << "Overlapping allocation at " << address;
+        end = address + size;
+    }
+    EXPECT_EQ(allocator->get_metrics().allocated_num_, num_handles);
+
+    handles.clear();
+    EXPECT_EQ(allocator->get_metrics().allocated_num_, 0);
+}
+
 }  // namespace mooncake::offset_allocator
 
 int main(int argc, char** argv) {
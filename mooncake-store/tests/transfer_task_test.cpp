@@ -160,6 +160,87 @@ TEST_F(TransferTaskTest, TransferStrategyEnum) {
     EXPECT_EQ(oss.str(), "TRANSFER_ENGINE");
 }
 
+// Test merging of adjacent transfer requests
+TEST_F(TransferTaskTest, CoalesceTransferRequests) {
+    std::vector<char> source(4096);
+    auto in_one_buffer = [](SegmentID, uint64_t, uint64_t) { return true; };
+    auto request = [&](size_t source_offset, SegmentID target_id,
+                       uint64_t target_offset, size_t length) {
+        TransferRequest request;
+        request.opcode = TransferRequest::WRITE;
+        request.source = source.data() + source_offset;
+        request.target_id = target_id;
+        request.target_offset = target_offset;
+        request.length = length;
+        return request;
+    };
+
+    std::vector<TransferRequest> requests = {
+        // Out of order, merged into [0, 1024) -> [0x10000, 0x10400)
+        request(512, 1, 0x10200, 512),
+        request(0, 1, 0x10000, 512),
+        // Adjacent target, but not adjacent source
+        request(2048, 1, 0x10400, 256),
+        // Adjacent source and target offset, but another segment
+        request(1024, 2, 0x10400, 256),
+    };
+    coalesceTransferRequests(requests, in_one_buffer);
+    ASSERT_EQ(3u, requests.size());
+    EXPECT_EQ(source.data(), requests[0].source);
+    EXPECT_EQ(0x10000u, requests[0].target_offset);
+    EXPECT_EQ(1024u, requests[0].length);
+    EXPECT_EQ(source.data() + 2048, requests[1].source);
+    EXPECT_EQ(256u, requests[1].length);
+    EXPECT_EQ(2u, requests[2].target_id);
+
+    // Reads are only merged with reads
+    requests = {request(0, 1, 0x10000, 512), request(512, 1, 0x10200, 512)};
+    requests[1].opcode = TransferRequest::READ;
+    coalesceTransferRequests(requests, in_one_buffer);
+    EXPECT_EQ(2u, requests.size());
+}
+
+// Test that requests are not merged across registered buffers
+TEST_F(TransferTaskTest, CoalesceTransferRequestsWithinBuffers) {
+    std::vector<char> source(4096);
+    const uint64_t source_addr = reinterpret_cast<uint64_t>(source.data());
+    // The source and the target are both registered as two buffers of 2048
+    // bytes, e.g. the chunks of a segment mounted in chunks
+    auto in_one_buffer = [&](SegmentID segment_id, uint64_t addr,
+                             uint64_t length) {
+        uint64_t base = segment_id == LOCAL_SEGMENT_ID ? source_addr : 0x10000;
+        uint64_t offset = addr - base;
+        return offset / 2048 == (offset + length - 1) / 2048;
+    };
+    auto request = [&](size_t offset, size_t length) {
+        TransferRequest request;
+        request.opcode = TransferRequest::WRITE;
+        request.source = source.data() + offset;
+        request.target_id = 1;
+        request.target_offset = 0x10000 + offset;
+        request.length = length;
+        return request;
+    };
+
+    // Adjacent on both sides, but the boundary of the buffers lies between
+    // the second and the third request
+    std::vector<TransferRequest> requests = {
+        request(0, 1024), request(1024, 1024), request(2048, 1024),
+        request(3072, 1024)};
+    coalesceTransferRequests(requests, in_one_buffer);
+    ASSERT_EQ(2u, requests.size());
+    EXPECT_EQ(source.data(), requests[0].source);
+    EXPECT_EQ(2048u, requests[0].length);
+    EXPECT_EQ(source.data() + 2048, requests[1].source);
+    EXPECT_EQ(0x10800u, requests[1].target_offset);
+    EXPECT_EQ(2048u, requests[1].length);
+
+    // A request straddling the boundary is left as is
+    requests = {request(1024, 1536), request(2560, 512)};
+    coalesceTransferRequests(requests, in_one_buffer);
+    EXPECT_EQ(2u, requests.size());
+}
+
 }  // namespace mooncake
 
 int main(int argc, char** argv) {
@@ -132,6 +132,22 @@ TEST(UtilsTest, SplitStringBasic) {
     EXPECT_EQ(tokens[3], "d");
 }
 
+TEST(UtilsTest, RegexLiteralPrefix) {
+    EXPECT_EQ("test_key", regexLiteralPrefix("^test_key"));
+    EXPECT_EQ("model_1/layer_", regexLiteralPrefix("^model_1/layer_\\d+"));
+    EXPECT_EQ("a.b", regexLiteralPrefix("^a\\.b"));
+    // A quantified character is optional, unless it is repeated with +
+    EXPECT_EQ("ab", regexLiteralPrefix("^abc?"));
+    EXPECT_EQ("ab", regexLiteralPrefix("^abc*"));
+    EXPECT_EQ("ab", regexLiteralPrefix("^abc{0,2}"));
+    EXPECT_EQ("abc", regexLiteralPrefix("^abc+d"));
+    EXPECT_EQ("ab", regexLiteralPrefix("^ab(cd)"));
+    // Patterns that can match anywhere in the key
+    EXPECT_EQ("", regexLiteralPrefix("test_key"));
+    EXPECT_EQ("", regexLiteralPrefix("^ab(c|d)"));
+    EXPECT_EQ("", regexLiteralPrefix("^\\w+"));
+}
+
 TEST(UtilsTest, AutoPortBinderRAII) {
     // Test RAII behavior - port should be released when binder is destroyed
     int port;
@@ -0,0 +1,167 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the shm transport with TCP loopback for two processes on the same
+// host. The target process is forked by the benchmark itself, so no metadata
+// server is required.
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+
+#include "common.h"
+#include "transfer_engine.h"
+#include "transport/transport.h"
+
+DEFINE_string(operation, "read", "Operation type: read or write");
+DEFINE_uint64(min_block_size, 4096, "Smallest block size to test");
+DEFINE_uint64(max_block_size, 64ull << 20, "Largest block size to test");
+DEFINE_uint64(bytes_per_round, 1ull << 30,
+              "Bytes transferred for each block size and transport");
+DEFINE_int32(batch_size, 32, "Number of requests per batch");
+
+using namespace mooncake;
+
+static std::unique_ptr<TransferEngine> createEngine(bool enable_shm) {
+    auto engine = std::make_unique<TransferEngine>(false);
+    int rc = engine->init(P2PHANDSHAKE, "127.0.0.1:12345", "127.0.0.1", 12345);
+    LOG_ASSERT(!rc);
+    LOG_ASSERT(engine->installTransport("tcp", nullptr));
+    if (enable_shm) LOG_ASSERT(engine->installTransport("shm", nullptr));
+    return engine;
+}
+
+static size_t bufferSize() {
+    return FLAGS_max_block_size * FLAGS_batch_size;
+}
+
+static int target(int notify_fd, int wait_fd) {
+    auto engine = createEngine(true);
+    void *addr = numa_alloc_onnode(bufferSize(), 0);
+    memset(addr, 1, bufferSize());
+    int rc = engine->registerLocalMemory(addr, bufferSize(), "cpu:0");
+    LOG_ASSERT(!rc);
+    std::string name = engine->getLocalIpAndPort();
+    uint64_t base = (uint64_t)addr;
+    uint32_t name_len = name.size();
+    writeFully(notify_fd, &base, sizeof(base));
+    writeFully(notify_fd, &name_len, sizeof(name_len));
+    writeFully(notify_fd, name.data(), name_len);
+    char done;
+    readFully(wait_fd, &done, 1);
+    engine->unregisterLocalMemory(addr);
+    numa_free(addr, bufferSize());
+    return 0;
+}
+
+static double runRound(TransferEngine *engine, SegmentID segment_id,
+                       void *local, uint64_t remote_base, size_t block_size) {
+    auto opcode = FLAGS_operation == "write" ? TransferRequest::WRITE
+                                             : TransferRequest::READ;
+    size_t total_bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (total_bytes < FLAGS_bytes_per_round) {
+        std::vector<TransferRequest> requests;
+        for (int i = 0; i < FLAGS_batch_size; ++i) {
+            TransferRequest entry;
+            entry.opcode = opcode;
+            entry.length = block_size;
+            entry.source = (char *)local + block_size * i;
+            entry.target_id = segment_id;
+            entry.target_offset = remote_base + block_size * i;
+            requests.push_back(entry);
+        }
+        auto batch_id = engine->allocateBatchID(FLAGS_batch_size);
+        Status s = engine->submitTransfer(batch_id, requests);
+        LOG_ASSERT(s.ok());
+        for (int task_id = 0; task_id < FLAGS_batch_size; ++task_id) {
+            TransferStatus status;
+            do {
+                s = engine->getTransferStatus(batch_id, task_id, status);
+                LOG_ASSERT(s.ok());
+                LOG_ASSERT(status.s != TransferStatusEnum::FAILED);
+            } while (status.s != TransferStatusEnum::COMPLETED);
+        }
+        engine->freeBatchID(batch_id);
+        total_bytes += block_size * FLAGS_batch_size;
+    }
+    double duration = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    return total_bytes / duration / 1e9;
+}
+
+static int initiator(int wait_fd, int notify_fd) {
+    uint64_t remote_base;
+    uint32_t name_len;
+    readFully(wait_fd, &remote_base, sizeof(remote_base));
+    readFully(wait_fd, &name_len, sizeof(name_len));
+    std::string remote_name(name_len, '\0');
+    readFully(wait_fd, remote_name.data(), name_len);
+
+    void *local = numa_alloc_onnode(bufferSize(), 0);
+    memset(local, 0, bufferSize());
+    auto tcp_engine = createEngine(false);
+    auto shm_engine = createEngine(true);
+    LOG_ASSERT(!tcp_engine->registerLocalMemory(local, bufferSize(), "cpu:0"));
+    LOG_ASSERT(!shm_engine->registerLocalMemory(local, bufferSize(), "cpu:0"));
+    auto tcp_segment = tcp_engine->openSegment(remote_name);
+    auto shm_segment = shm_engine->openSegment(remote_name);
+
+    std::cout << std::setw(12) << "block_size" << std::setw(16) << "tcp(GB/s)"
+              << std::setw(16) << "shm(GB/s)" << std::setw(10) << "speedup"
+              << std::endl;
+    for (size_t block_size = FLAGS_min_block_size;
+         block_size <= FLAGS_max_block_size; block_size *= 4) {
+        double tcp = runRound(tcp_engine.get(), tcp_segment, local,
+                              remote_base, block_size);
+        double shm = runRound(shm_engine.get(), shm_segment, local,
+                              remote_base, block_size);
+        std::cout << std::setw(12) << block_size << std::setw(16)
+                  << std::fixed << std::setprecision(3) << tcp
+                  << std::setw(16) << shm << std::setw(9)
+                  << std::setprecision(2) << shm / tcp << "x" << std::endl;
+    }
+
+    char done = 1;
+    writeFully(notify_fd, &done, 1);
+    tcp_engine->unregisterLocalMemory(local);
+    shm_engine->unregisterLocalMemory(local);
+    numa_free(local, bufferSize());
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, false);
+    int to_initiator[2], to_target[2];
+    if (pipe(to_initiator) || pipe(to_target)) {
+        PLOG(ERROR) << "pipe";
+        return EXIT_FAILURE;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        PLOG(ERROR) << "fork";
+        return EXIT_FAILURE;
+    }
+    if (pid == 0) _exit(target(to_initiator[1], to_target[0]));
+    int ret = initiator(to_initiator[0], to_target[1]);
+    waitpid(pid, nullptr, 0);
+    return ret;
+}
@@ -82,6 +82,11 @@ DEFINE_int32(threads, 12, "Task submission threads");
 DEFINE_bool(auto_discovery, false, "Enable auto discovery");
 DEFINE_string(report_unit, "GB", "Report unit: GB|GiB|Gb|MB|MiB|Mb|KB|KiB|Kb");
 DEFINE_uint32(report_precision, 2, "Report precision");
+DEFINE_bool(trace, false,
+            "Enable slice tracing (MC_TE_TRACE), compare the throughput with "
+            "and without it to measure the tracing overhead");
+DEFINE_string(trace_dump, "",
+              "Dump the most recent slices to this file, implies --trace");
 
 #if defined(USE_CUDA) || defined(USE_MUSA) || defined(USE_HIP)
 DEFINE_bool(use_vram, true, "Allocate memory from GPU VRAM");
@@ -285,7 +290,33 @@ std::string loadNicPriorityMatrix() {
            device_names + "], []]}";
 }
 
+static void reportTrace(TransferEngine *engine) {
+    for (auto &path : engine->getTraceStats()) {
+        LOG(INFO) << "Trace " << path.transport << " peer " << path.peer
+                  << (path.peer_nic.empty() ? "" : " nic " + path.peer_nic)
+                  << ": slices " << path.slices << ", failed "
+                  << path.failed_slices << ", retries " << path.retries
+                  << ", queue p50/p99 " << path.queue_us.percentile(0.5)
+                  << "/" << path.queue_us.percentile(0.99)
+                  << " us, completion p50/p99 "
+                  << path.completion_us.percentile(0.5) << "/"
+                  << path.completion_us.percentile(0.99) << " us";
+    }
+    if (!FLAGS_trace_dump.empty()) {
+        if (engine->dumpSliceTrace(FLAGS_trace_dump))
+            LOG(ERROR) << "Failed to dump slice trace";
+        else
+            LOG(INFO) << "Slice trace dumped to " << FLAGS_trace_dump;
+    }
+}
+
 int initiator() {
+    if (FLAGS_trace || !FLAGS_trace_dump.empty()) {
+        setenv("MC_TE_TRACE", "1", 1);
+        if (!FLAGS_trace_dump.empty())
+            setenv("MC_TE_TRACE_RING_SIZE", "65536", 0);
+    }
+
     // disable topology auto discovery for testing.
     auto engine = std::make_unique<TransferEngine>(FLAGS_auto_discovery);
 
@@ -386,7 +417,10 @@ int initiator() {
               << batch_count << ", throughput "
               << calculateRate(
                      batch_count * FLAGS_batch_size * FLAGS_block_size,
-                     duration);
+                     duration)
+              << (FLAGS_trace || !FLAGS_trace_dump.empty() ? ", tracing on"
+                                                           : "");
+    if (FLAGS_trace || !FLAGS_trace_dump.empty()) reportTrace(engine.get());
 
     for (int i = 0; i < buffer_num; ++i) {
         engine->unregisterLocalMemory(addr[i]);
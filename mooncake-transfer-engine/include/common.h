@@ -18,6 +18,7 @@
 #include <glog/logging.h>
 #include <numa.h>
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/mman.h>
 #include <sys/time.h>
@@ -27,6 +28,8 @@
 #include <charconv>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <iomanip>
@@ -69,6 +72,48 @@ static inline std::string getHostname() {
     return hostname;
 }
 
+// Identifies the set of processes that can address each other's memory
+// directly: the kernel boot id tells hosts apart and the pid namespace tells
+// apart containers whose process ids are not mutually visible.
+static inline std::string getIntraHostId() {
+    char boot_id[64] = {0};
+    int fd = open("/proc/sys/kernel/random/boot_id", O_RDONLY);
+    if (fd < 0) {
+        PLOG(WARNING) << "Failed to read kernel boot id";
+        return "";
+    }
+    ssize_t len = read(fd, boot_id, sizeof(boot_id) - 1);
+    close(fd);
+    if (len <= 0) return "";
+    while (len > 0 && (boot_id[len - 1] == '\n' || boot_id[len - 1] == ' '))
+        boot_id[--len] = '\0';
+
+    char pid_ns[64] = {0};
+    ssize_t ns_len = readlink("/proc/self/ns/pid", pid_ns, sizeof(pid_ns) - 1);
+    if (ns_len < 0) ns_len = 0;
+    return std::string(boot_id, len) + "/" + std::string(pid_ns, ns_len);
+}
+
+// Start time of a process in clock ticks after boot (field 22 of
+// /proc/<pid>/stat). Together with the pid it tells a process apart from a
+// later one that reuses the pid. Returns 0 if the process does not exist.
+static inline uint64_t getProcessStartTime(pid_t pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    char stat[1024];
+    ssize_t len = read(fd, stat, sizeof(stat) - 1);
+    close(fd);
+    if (len <= 0) return 0;
+    stat[len] = '\0';
+    // The command name may contain spaces, so count fields after it.
+    char *pos = strrchr(stat, ')');
+    for (int field = 2; pos && field < 22; ++field) pos = strchr(pos + 1, ' ');
+    if (!pos) return 0;
+    return strtoull(pos + 1, nullptr, 10);
+}
+
 static inline int bindToSocket(int socket_id) {
     if (unlikely(numa_available() < 0)) {
         LOG(WARNING) << "The platform does not support NUMA";
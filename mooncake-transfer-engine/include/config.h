@@ -39,6 +39,9 @@ struct GlobalConfig {
     uint16_t handshake_port = 12001;
     int workers_per_ctx = 2;
     size_t slice_size = 65536;
+    // Upper bound of the slice sizes chosen from the observed bandwidth and
+    // latency, slice_size disables the adaptive sizing
+    size_t max_slice_size = 1ull << 20;
     int retry_cnt = 9;
     int handshake_listen_backlog = 128;
     bool metacache = true;
@@ -50,6 +53,9 @@ struct GlobalConfig {
     bool use_ipv6 = false;
     size_t fragment_limit = 16384;
     bool enable_dest_device_affinity = false;
+    size_t stripe_min_size = 4ull << 20;
+    bool slice_trace = false;
+    size_t slice_trace_ring_size = 0;
 };
 
 void loadGlobalConfig(GlobalConfig &config);
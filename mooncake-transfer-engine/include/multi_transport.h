@@ -15,8 +15,10 @@
 #ifndef MULTI_TRANSPORT_H_
 #define MULTI_TRANSPORT_H_
 
+#include <atomic>
 #include <unordered_map>
 
+#include "transfer_tracer.h"
 #include "transport/transport.h"
 
 namespace mooncake {
@@ -26,6 +28,8 @@ class MultiTransport {
     using TransferRequest = Transport::TransferRequest;
     using TransferStatus = Transport::TransferStatus;
     using BatchDesc = Transport::BatchDesc;
+    using TransferTask = Transport::TransferTask;
+    using SegmentID = Transport::SegmentID;
 
     MultiTransport(std::shared_ptr<TransferMetadata> metadata,
                    std::string &local_server_name);
@@ -51,13 +55,59 @@ class MultiTransport {
 
     std::vector<Transport *> listTransports();
 
+    // Install an additional path for an installed protocol, sending from
+    // `local_address`. Requests of at least `stripe_min_size` bytes are split
+    // across all paths of the protocol, in proportion to the throughput each
+    // path has achieved so far.
+    Transport *installStripePath(const std::string &proto,
+                                 const std::string &local_address);
+
+    // Observed throughput of every path of `proto` in bytes/s, the primary
+    // transport first. Paths that have not carried data yet report 0.
+    std::vector<double> getStripeThroughput(const std::string &proto);
+
+    // Slice tracing, see MC_TE_TRACE. The results are empty if tracing is
+    // disabled.
+    std::vector<TransferTracer::PathSnapshot> getTraceStats();
+
+    std::string getTraceMetrics();
+
+    std::vector<TransferTracer::SliceRecord> getSliceTrace();
+
    private:
+    struct StripePath {
+        std::shared_ptr<Transport> transport;
+        std::string local_address;
+        // exponentially weighted moving average, in bytes per nanosecond
+        std::atomic<double> throughput{0};
+    };
+
     Status selectTransport(const TransferRequest &entry, Transport *&transport);
 
+    void stripeTask(
+        TransferTask &task,
+        const std::vector<std::shared_ptr<StripePath>> &paths,
+        std::unordered_map<Transport *, std::vector<Transport::TransferTask *>>
+            &submit_tasks);
+
+    Status getStripedTransferStatus(TransferTask &task,
+                                    TransferStatus &status);
+
+    // Check if a slice of the task has been in flight for longer than the
+    // configured slice timeout
+    bool hasSliceTimeout(const TransferTask &task);
+
+    std::string getSegmentName(SegmentID target_id);
+
    private:
     std::shared_ptr<TransferMetadata> metadata_;
     std::string local_server_name_;
+    std::string local_host_id_;
     std::map<std::string, std::shared_ptr<Transport>> transport_map_;
+    // primary transport -> all of its paths, the primary one included
+    std::unordered_map<Transport *, std::vector<std::shared_ptr<StripePath>>>
+        stripe_paths_;
+    std::unique_ptr<TransferTracer> tracer_;
     RWSpinlock batch_desc_lock_;
     std::unordered_map<BatchID, std::shared_ptr<BatchDesc>> batch_desc_set_;
 };
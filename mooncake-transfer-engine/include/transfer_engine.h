@@ -89,6 +89,35 @@ class TransferEngine {
 
     int uninstallTransport(const std::string &proto);
 
+    // Add a path for `proto` sending from `local_address`, large requests
+    // are then striped across all paths of the protocol.
+    Transport *installStripePath(const std::string &proto,
+                                 const std::string &local_address) {
+        return multi_transports_->installStripePath(proto, local_address);
+    }
+
+    std::vector<double> getStripeThroughput(const std::string &proto) {
+        return multi_transports_->getStripeThroughput(proto);
+    }
+
+    // Per-peer slice statistics collected when MC_TE_TRACE is set.
+    std::vector<TransferTracer::PathSnapshot> getTraceStats() {
+        return multi_transports_->getTraceStats();
+    }
+
+    // The statistics above in Prometheus text format.
+    std::string getTraceMetrics() {
+        return multi_transports_->getTraceMetrics();
+    }
+
+    // Most recent slices, requires MC_TE_TRACE_RING_SIZE.
+    std::vector<TransferTracer::SliceRecord> getSliceTrace() {
+        return multi_transports_->getSliceTrace();
+    }
+
+    // Write getSliceTrace() to `path`, one slice per line.
+    int dumpSliceTrace(const std::string &path);
+
     std::string getLocalIpAndPort();
 
     int getRpcPort();
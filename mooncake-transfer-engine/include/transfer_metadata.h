@@ -97,6 +97,15 @@ class TransferMetadata {
 
         int tcp_data_port;
 
+        // this is for shm (intra-host transfers between processes)
+        std::string host_id;
+        uint64_t pid = 0;
+        // start time of the process, guards against pid reuse
+        uint64_t pid_start_time = 0;
+        // addresses of the buffers that reside in device memory, which
+        // cannot be accessed with process_vm_readv(2)
+        std::vector<uint64_t> device_buffers;
+
         void dump() const;
     };
 
@@ -148,11 +157,22 @@ class TransferMetadata {
 
     int removeLocalMemoryBuffer(void *addr, bool update_metadata);
 
+    // Record that the local buffer at addr resides in device memory, so that
+    // peers on the same host do not access it through the shm transport.
+    int addLocalDeviceBuffer(void *addr, bool update_metadata);
+
+    int removeLocalDeviceBuffer(void *addr, bool update_metadata);
+
     int addLocalSegment(SegmentID segment_id, const std::string &segment_name,
                         std::shared_ptr<SegmentDesc> &&desc);
 
     int removeLocalSegment(const std::string &segment_name);
 
+    // Publish the host identity and process id of this process in the local
+    // segment descriptor, so that peers on the same host can access the
+    // registered buffers without going through the network.
+    int enableIntraHostAccess();
+
     int addRpcMetaEntry(const std::string &server_name, RpcMetaDesc &desc);
 
     int removeRpcMetaEntry(const std::string &server_name);
@@ -206,6 +226,10 @@ class TransferMetadata {
 
     std::atomic<SegmentID> next_segment_id_;
 
+    std::string intra_host_id_;
+    uint64_t intra_host_pid_ = 0;
+    uint64_t intra_host_pid_start_time_ = 0;
+
     std::shared_ptr<HandShakePlugin> handshake_plugin_;
     std::shared_ptr<MetadataStoragePlugin> storage_plugin_;
 };
@@ -0,0 +1,149 @@
+// Copyright 2025 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRANSFER_TRACER_H_
+#define TRANSFER_TRACER_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "transport/transport.h"
+
+namespace mooncake {
+// Collects per-slice timing of finished transfer tasks, aggregated per
+// (transport, peer segment, peer NIC). Enabled by MC_TE_TRACE. When it is
+// disabled, slices skip all timestamping and nothing is recorded.
+//
+// Every slice contributes three samples:
+//   queue:      submission -> (last) post to the device, RDMA only
+//   completion: post -> completion, or submission -> completion if the
+//               transport has no separate post step
+//   size:       slice length in bytes
+// plus counters of slices, failures, retries and bytes.
+//
+// An optional ring buffer (MC_TE_TRACE_RING_SIZE) keeps the most recent raw
+// slice records, which can be dumped on demand.
+class TransferTracer {
+   public:
+    using SegmentID = Transport::SegmentID;
+    using Slice = Transport::Slice;
+    using TransferTask = Transport::TransferTask;
+
+    // Bucket i > 0 holds values in [2^(i-1), 2^i), bucket 0 holds 0.
+    static const size_t kNumBuckets = 40;
+
+    struct HistogramSnapshot {
+        uint64_t buckets[kNumBuckets] = {};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+
+        // Upper bound of the bucket containing the given quantile (0..1).
+        uint64_t percentile(double quantile) const;
+    };
+
+    struct PathSnapshot {
+        std::string transport;
+        std::string peer;
+        std::string peer_nic;
+        HistogramSnapshot queue_us;
+        HistogramSnapshot completion_us;
+        HistogramSnapshot slice_bytes;
+        uint64_t slices = 0;
+        uint64_t failed_slices = 0;
+        uint64_t retries = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct SliceRecord {
+        uint64_t seq;  // 0 while the slot is being written
+        int64_t submit_ts;  // ns, monotonic
+        int64_t post_ts;    // 0 if the transport has no post step
+        int64_t complete_ts;
+        SegmentID target_id;
+        uint64_t length;
+        uint32_t retries;
+        bool success;
+        const char *transport;
+    };
+
+    using SegmentNameResolver = std::function<std::string(SegmentID)>;
+
+    explicit TransferTracer(size_t ring_capacity);
+
+    ~TransferTracer();
+
+    // Records all slices of a finished task, which was handled by the
+    // transport named `transport`.
+    void recordTask(const TransferTask &task, const char *transport);
+
+    std::vector<PathSnapshot> snapshot(const SegmentNameResolver &resolver);
+
+    // Prometheus text exposition format, latencies in microseconds.
+    std::string toPrometheus(const SegmentNameResolver &resolver);
+
+    // Oldest first, at most `ring_capacity` records.
+    std::vector<SliceRecord> dumpSlices();
+
+    void reset();
+
+   private:
+    struct Histogram {
+        std::atomic<uint64_t> buckets[kNumBuckets] = {};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+
+        void observe(uint64_t value);
+        void load(HistogramSnapshot &snapshot) const;
+        void clear();
+    };
+
+    struct PathStats {
+        std::string transport;
+        SegmentID target_id;
+        std::string peer_nic;
+        Histogram queue_us;
+        Histogram completion_us;
+        Histogram slice_bytes;
+        std::atomic<uint64_t> slices{0};
+        std::atomic<uint64_t> failed_slices{0};
+        std::atomic<uint64_t> retries{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    PathStats *getPathStats(const char *transport, SegmentID target_id,
+                            const std::string &peer_nic);
+
+    // Retries are only tracked for RDMA slices.
+    void recordSlice(PathStats *stats, const Slice *slice, bool is_rdma);
+
+   private:
+    RWSpinlock path_lock_;
+    std::unordered_map<std::string, std::unique_ptr<PathStats>> path_map_;
+
+    const size_t ring_capacity_;
+    std::unique_ptr<SliceRecord[]> ring_;
+    std::atomic<uint64_t> ring_head_{0};
+};
+
+std::ostream &operator<<(std::ostream &os,
+                         const TransferTracer::SliceRecord &record);
+}  // namespace mooncake
+
+#endif  // TRANSFER_TRACER_H_
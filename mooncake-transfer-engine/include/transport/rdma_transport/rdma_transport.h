@@ -87,6 +87,15 @@ class RdmaTransport : public Transport {
 
     SegmentID getSegmentID(const std::string &segment_name);
 
+    // Called by the workers for every completed slice
+    void recordSliceCompletion(size_t length, int64_t latency_ns);
+
+    // Slice size for a request of `length` bytes, large enough that the
+    // fixed per-slice latency is a small part of the slice transfer time at
+    // the observed bandwidth, and small enough to spread the request over the
+    // devices. Between slice_size and max_slice_size.
+    size_t sliceSizeFor(size_t length) const;
+
    private:
     int allocateLocalSegmentID();
 
@@ -118,6 +127,13 @@ class RdmaTransport : public Transport {
    private:
     std::vector<std::shared_ptr<RdmaContext>> context_list_;
     std::shared_ptr<Topology> local_topology_;
+    // Exponentially weighted moving averages over sampled slices of the
+    // length, the latency in nanoseconds, the squared length and the length
+    // times the latency, for a linear fit of the latency to the length
+    std::atomic<double> slice_length_avg_{0};
+    std::atomic<double> slice_latency_avg_{0};
+    std::atomic<double> slice_length_sq_avg_{0};
+    std::atomic<double> slice_length_latency_avg_{0};
 };
 
 using TransferRequest = Transport::TransferRequest;
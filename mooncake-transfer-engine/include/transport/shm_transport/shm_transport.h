@@ -0,0 +1,115 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHM_TRANSPORT_H_
+#define SHM_TRANSPORT_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "transfer_metadata.h"
+#include "transport/transport.h"
+
+namespace mooncake {
+class TransferMetadata;
+
+// Transport for peers running as separate processes on the same host. It does
+// not publish a segment of its own: the buffers registered by the primary
+// transport (tcp or rdma) are addressed by virtual address, and the data is
+// copied directly between the two address spaces with process_vm_readv(2) /
+// process_vm_writev(2), or with memcpy when the peer is this process.
+//
+// MultiTransport selects this transport automatically when it is installed,
+// the target segment advertises the same host id as the local process and
+// both buffers reside in host memory. Device memory is not accessible with
+// process_vm_readv(2), so such transfers go through the primary transport.
+class ShmTransport : public Transport {
+   public:
+    using BufferDesc = TransferMetadata::BufferDesc;
+    using SegmentDesc = TransferMetadata::SegmentDesc;
+
+   public:
+    ShmTransport();
+
+    ~ShmTransport();
+
+    Status submitTransfer(BatchID batch_id,
+                          const std::vector<TransferRequest> &entries) override;
+
+    Status submitTransferTask(
+        const std::vector<TransferTask *> &task_list) override;
+
+    Status getTransferStatus(BatchID batch_id, size_t task_id,
+                             TransferStatus &status) override;
+
+    // Returns true if the segment can be reached through this transport. The
+    // identity of the peer process is verified right before each copy.
+    static bool isReachable(const SegmentDesc &desc,
+                            const std::string &local_host_id);
+
+    // Returns true if the buffer of the segment containing addr resides in
+    // host memory of its owner.
+    static bool isHostMemory(const SegmentDesc &desc, uint64_t addr);
+
+    // Returns true if addr points to device memory of this process.
+    static bool isDeviceMemory(void *addr);
+
+   private:
+    int install(std::string &local_server_name,
+                std::shared_ptr<TransferMetadata> meta,
+                std::shared_ptr<Topology> topo);
+
+    int registerLocalMemory(void *addr, size_t length,
+                            const std::string &location, bool remote_accessible,
+                            bool update_metadata);
+
+    int unregisterLocalMemory(void *addr, bool update_metadata = false);
+
+    int registerLocalMemoryBatch(
+        const std::vector<Transport::BufferEntry> &buffer_list,
+        const std::string &location);
+
+    int unregisterLocalMemoryBatch(
+        const std::vector<void *> &addr_list) override;
+
+    const char *getName() const override { return "shm"; }
+
+    void startTransfer(Slice *slice);
+
+    // Returns false if the pid of the segment no longer belongs to the process
+    // that published it.
+    bool checkPeer(const SegmentDesc &desc);
+
+    int copyWithPeer(pid_t peer_pid, void *local_addr, uint64_t remote_addr,
+                     size_t length, TransferRequest::OpCode opcode);
+
+   private:
+    struct PeerProcess {
+        uint64_t start_time;
+        // Keeps referring to the checked process even if its pid is reused,
+        // or -1 if pidfds are not supported by the kernel.
+        int pidfd;
+    };
+
+    pid_t local_pid_;
+    std::mutex peer_mutex_;
+    std::unordered_map<pid_t, PeerProcess> peers_;
+};
+}  // namespace mooncake
+
+#endif
@@ -44,6 +44,11 @@ class TcpTransport : public Transport {
    public:
     TcpTransport();
 
+    // Creates an outgoing-only transport whose connections originate from
+    // `local_address`. It does not publish a segment and is used as an
+    // additional stripe path next to the primary tcp transport.
+    explicit TcpTransport(const std::string &local_address);
+
     ~TcpTransport();
 
     Status submitTransfer(BatchID batch_id,
@@ -83,6 +88,7 @@ class TcpTransport : public Transport {
 
    private:
     TcpContext *context_;
+    std::string local_address_;
     std::atomic_bool running_;
     std::thread thread_;
 };
@@ -77,6 +77,7 @@ class Transport {
     };
 
     struct TransferTask;
+    struct StripedSubTask;
 
     // Slice must be allocated on heap, as it will delete self on markSuccess
     // or markFailed.
@@ -108,6 +109,9 @@ class Transport {
             struct {
                 uint64_t dest_addr;
             } tcp;
+            struct {
+                uint64_t dest_addr;
+            } shm;
             struct {
                 uint64_t offset;
                 int cufile_desc;
@@ -127,17 +131,31 @@ class Transport {
 
        public:
         void markSuccess() {
+            if (slice_trace_enabled) complete_ts = getCurrentTimeInNano();
             status = Slice::SUCCESS;
+            stampTask();
             __sync_fetch_and_add(&task->transferred_bytes, length);
             __sync_fetch_and_add(&task->success_slice_count, 1);
         }
 
         void markFailed() {
+            if (slice_trace_enabled) complete_ts = getCurrentTimeInNano();
             status = Slice::FAILED;
+            stampTask();
             __sync_fetch_and_add(&task->failed_slice_count, 1);
         }
 
+        // Done before counting the slice, as the task may be freed once all
+        // slices are counted. The last slice to finish stamps it last.
+        void stampTask() {
+            if (task->record_complete_ts)
+                task->complete_ts = getCurrentTimeInNano();
+        }
+
         volatile int64_t ts;
+        // only filled in when slice tracing is enabled
+        int64_t submit_ts;
+        int64_t complete_ts;
     };
 
     struct ThreadLocalSliceCache {
@@ -170,6 +188,8 @@ class Transport {
                 slice->from_cache = true;
             }
 
+            slice->submit_ts = slice_trace_enabled ? getCurrentTimeInNano() : 0;
+            slice->complete_ts = 0;
             return slice;
         }
 
@@ -196,7 +216,12 @@ class Transport {
         volatile uint64_t transferred_bytes = 0;
         volatile bool is_finished = false;
         uint64_t total_bytes = 0;
+        // when the last slice finished, stamped if record_complete_ts is set
+        bool record_complete_ts = false;
+        volatile int64_t complete_ts = 0;
         BatchID batch_id = 0;
+        // the transport that handles the task, set only if tracing
+        Transport *transport = nullptr;
 
         // record the origin request
 #ifdef USE_ASCEND_HETEROGENEOUS
@@ -208,12 +233,24 @@ class Transport {
 #endif
         // record the slice list for freeing objects
         std::vector<Slice *> slice_list;
+        // non-empty if the request is striped across multiple paths, the
+        // status of the task is then aggregated from these sub-tasks
+        std::vector<std::shared_ptr<StripedSubTask>> stripe_list;
         ~TransferTask() {
             for (auto &slice : slice_list)
                 Transport::getSliceCache().deallocate(slice);
         }
     };
 
+    // The portion of a striped request carried by one path.
+    struct StripedSubTask {
+        TransferRequest request;
+        TransferTask task;
+        void *path = nullptr;  // owned by MultiTransport
+        int64_t submit_ts = 0;
+        bool accounted = false;
+    };
+
     struct BatchDesc {
         BatchID id;
         size_t batch_size;
@@ -270,6 +307,9 @@ class Transport {
 
     static ThreadLocalSliceCache &getSliceCache();
 
+    // Set by MultiTransport when MC_TE_TRACE is enabled
+    static inline bool slice_trace_enabled = false;
+
    private:
     virtual int registerLocalMemory(void *addr, size_t length,
                                     const std::string &location,
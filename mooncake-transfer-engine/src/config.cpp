@@ -17,6 +17,8 @@
 #include <dirent.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 namespace mooncake {
 void loadGlobalConfig(GlobalConfig &config) {
     const char *num_cq_per_ctx_env = std::getenv("MC_NUM_CQ_PER_CTX");
@@ -167,6 +169,17 @@ void loadGlobalConfig(GlobalConfig &config) {
                 << "Ignore value from environment variable MC_SLICE_SIZE";
     }
 
+    const char *max_slice_size_env = std::getenv("MC_MAX_SLICE_SIZE");
+    if (max_slice_size_env) {
+        size_t val = atoll(max_slice_size_env);
+        if (val > 0)
+            config.max_slice_size = val;
+        else
+            LOG(WARNING)
+                << "Ignore value from environment variable MC_MAX_SLICE_SIZE";
+    }
+    config.max_slice_size = std::max(config.max_slice_size, config.slice_size);
+
     const char *retry_cnt_env = std::getenv("MC_RETRY_CNT");
     if (retry_cnt_env) {
         size_t val = atoi(retry_cnt_env);
@@ -278,6 +291,30 @@ void loadGlobalConfig(GlobalConfig &config) {
     if (std::getenv("MC_ENABLE_DEST_DEVICE_AFFINITY")) {
         config.enable_dest_device_affinity = true;
     }
+
+    const char *stripe_min_size_env = std::getenv("MC_STRIPE_MIN_SIZE");
+    if (stripe_min_size_env) {
+        size_t val = atoll(stripe_min_size_env);
+        if (val >= config.slice_size)
+            config.stripe_min_size = val;
+        else
+            LOG(WARNING)
+                << "Ignore value from environment variable MC_STRIPE_MIN_SIZE";
+    }
+
+    if (std::getenv("MC_TE_TRACE")) {
+        config.slice_trace = true;
+    }
+
+    const char *trace_ring_size_env = std::getenv("MC_TE_TRACE_RING_SIZE");
+    if (trace_ring_size_env) {
+        size_t val = atoll(trace_ring_size_env);
+        if (val > 0 && val <= (1ull << 24))
+            config.slice_trace_ring_size = val;
+        else
+            LOG(WARNING) << "Ignore value from environment variable "
+                            "MC_TE_TRACE_RING_SIZE";
+    }
 }
 
 std::string mtuLengthToString(ibv_mtu mtu) {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "multi_transport.h"
+#include <algorithm>
 #include <string>
 
 #include "config.h"
@@ -20,6 +21,9 @@
 #ifdef USE_TCP
 #include "transport/tcp_transport/tcp_transport.h"
 #endif
+#ifdef USE_SHM
+#include "transport/shm_transport/shm_transport.h"
+#endif
 #include "transport/transport.h"
 #ifdef USE_NVMEOF
 #include "transport/nvmeof_transport/nvmeof_transport.h"
@@ -45,7 +49,16 @@
 namespace mooncake {
 MultiTransport::MultiTransport(std::shared_ptr<TransferMetadata> metadata,
                                std::string &local_server_name)
-    : metadata_(metadata), local_server_name_(local_server_name) {}
+    : metadata_(metadata), local_server_name_(local_server_name) {
+#ifdef USE_SHM
+    local_host_id_ = getIntraHostId();
+#endif
+    if (globalConfig().slice_trace) {
+        Transport::slice_trace_enabled = true;
+        tracer_ = std::make_unique<TransferTracer>(
+            globalConfig().slice_trace_ring_size);
+    }
+}
 
 MultiTransport::~MultiTransport() {}
 
@@ -101,13 +114,20 @@ Status MultiTransport::submitTransfer(
         assert(transport);
         auto &task = batch_desc.task_list[task_id];
         task.batch_id = batch_id;
+        if (tracer_) task.transport = transport;
 #ifdef USE_ASCEND_HETEROGENEOUS
         task.request = const_cast<Transport::TransferRequest *>(&request);
 #else
         task.request = &request;
 #endif
         ++task_id;
-        submit_tasks[transport].push_back(&task);
+        auto stripe_iter = stripe_paths_.find(transport);
+        if (stripe_iter != stripe_paths_.end() &&
+            request.length >= globalConfig().stripe_min_size) {
+            stripeTask(task, stripe_iter->second, submit_tasks);
+        } else {
+            submit_tasks[transport].push_back(&task);
+        }
     }
     Status overall_status = Status::OK();
     for (auto &entry : submit_tasks) {
@@ -129,6 +149,7 @@ Status MultiTransport::getTransferStatus(BatchID batch_id, size_t task_id,
         return Status::InvalidArgument("Task ID out of range");
     }
     auto &task = batch_desc.task_list[task_id];
+    if (!task.stripe_list.empty()) return getStripedTransferStatus(task, status);
     status.transferred_bytes = task.transferred_bytes;
     uint64_t success_slice_count = task.success_slice_count;
     uint64_t failed_slice_count = task.failed_slice_count;
@@ -139,22 +160,134 @@ Status MultiTransport::getTransferStatus(BatchID batch_id, size_t task_id,
         } else {
             status.s = Transport::TransferStatusEnum::COMPLETED;
         }
+        if (tracer_ && task.transport && !task.is_finished)
+            tracer_->recordTask(task, task.transport->getName());
         task.is_finished = true;
+    } else if (hasSliceTimeout(task)) {
+        status.s = Transport::TransferStatusEnum::TIMEOUT;
     } else {
-        if (globalConfig().slice_timeout > 0) {
-            auto current_ts = getCurrentTimeInNano();
-            const int64_t kPacketDeliveryTimeout =
-                globalConfig().slice_timeout * 1000000000;
-            for (auto &slice : task.slice_list) {
-                auto ts = slice->ts;
-                if (ts > 0 && current_ts > ts &&
-                    current_ts - ts > kPacketDeliveryTimeout) {
-                    LOG(INFO) << "Slice timeout detected";
-                    status.s = Transport::TransferStatusEnum::TIMEOUT;
-                    return Status::OK();
-                }
+        status.s = Transport::TransferStatusEnum::WAITING;
+    }
+    return Status::OK();
+}
+
+bool MultiTransport::hasSliceTimeout(const TransferTask &task) {
+    if (globalConfig().slice_timeout <= 0) return false;
+    auto current_ts = getCurrentTimeInNano();
+    const int64_t kPacketDeliveryTimeout =
+        globalConfig().slice_timeout * 1000000000;
+    for (auto &slice : task.slice_list) {
+        auto ts = slice->ts;
+        if (ts > 0 && current_ts > ts &&
+            current_ts - ts > kPacketDeliveryTimeout) {
+            LOG(INFO) << "Slice timeout detected";
+            return true;
+        }
+    }
+    return false;
+}
+
+void MultiTransport::stripeTask(
+    TransferTask &task, const std::vector<std::shared_ptr<StripePath>> &paths,
+    std::unordered_map<Transport *, std::vector<Transport::TransferTask *>>
+        &submit_tasks) {
+    const auto &request = *task.request;
+    task.total_bytes = request.length;
+
+    // Paths without measurements yet get the average weight, so that they
+    // are probed with a fair share of the traffic.
+    double measured_sum = 0;
+    size_t measured_count = 0;
+    std::vector<double> weights;
+    for (auto &path : paths) {
+        double throughput = path->throughput.load(std::memory_order_relaxed);
+        weights.push_back(throughput);
+        if (throughput > 0) {
+            measured_sum += throughput;
+            measured_count++;
+        }
+    }
+    double default_weight = measured_count ? measured_sum / measured_count : 1;
+    double total_weight = 0;
+    for (auto &weight : weights) {
+        if (weight <= 0) weight = default_weight;
+        total_weight += weight;
+    }
+
+    const size_t kAlignment = globalConfig().slice_size;
+    const int64_t submit_ts = getCurrentTimeInNano();
+    uint64_t offset = 0;
+    for (size_t i = 0; i < paths.size() && offset < request.length; ++i) {
+        uint64_t length = request.length - offset;
+        if (i + 1 < paths.size()) {
+            length = (uint64_t)(request.length * weights[i] / total_weight);
+            length = std::min(length / kAlignment * kAlignment,
+                              request.length - offset);
+        }
+        if (length == 0) continue;
+        auto stripe = std::make_shared<Transport::StripedSubTask>();
+        stripe->request = request;
+        stripe->request.source = (char *)request.source + offset;
+        stripe->request.target_offset = request.target_offset + offset;
+        stripe->request.length = length;
+        stripe->task.batch_id = task.batch_id;
+        stripe->task.request = &stripe->request;
+        stripe->task.record_complete_ts = true;
+        if (tracer_) stripe->task.transport = paths[i]->transport.get();
+        stripe->path = paths[i].get();
+        stripe->submit_ts = submit_ts;
+        task.stripe_list.push_back(stripe);
+        submit_tasks[paths[i]->transport.get()].push_back(&stripe->task);
+        offset += length;
+    }
+}
+
+Status MultiTransport::getStripedTransferStatus(TransferTask &task,
+                                                TransferStatus &status) {
+    const double kAlpha = 0.2;
+    bool all_finished = true, has_failure = false, has_timeout = false;
+    status.transferred_bytes = 0;
+    for (auto &stripe : task.stripe_list) {
+        auto &sub_task = stripe->task;
+        status.transferred_bytes += sub_task.transferred_bytes;
+        uint64_t success_slice_count = sub_task.success_slice_count;
+        uint64_t failed_slice_count = sub_task.failed_slice_count;
+        if (!sub_task.slice_count ||
+            success_slice_count + failed_slice_count != sub_task.slice_count) {
+            all_finished = false;
+            if (!has_timeout) has_timeout = hasSliceTimeout(sub_task);
+            continue;
+        }
+        if (tracer_ && sub_task.transport && !sub_task.is_finished)
+            tracer_->recordTask(sub_task, sub_task.transport->getName());
+        sub_task.is_finished = true;
+        if (failed_slice_count) {
+            has_failure = true;
+        } else if (!stripe->accounted) {
+            stripe->accounted = true;
+            auto path = (StripePath *)stripe->path;
+            // Timed from the completion of the last slice rather than from
+            // now, as the stripes finishing between two polls would
+            // otherwise all look as slow as the slowest of them
+            int64_t complete_ts = sub_task.complete_ts;
+            if (!complete_ts) complete_ts = getCurrentTimeInNano();
+            int64_t elapsed = complete_ts - stripe->submit_ts;
+            if (elapsed > 0) {
+                double sample = (double)stripe->request.length / elapsed;
+                double prev = path->throughput.load(std::memory_order_relaxed);
+                path->throughput.store(
+                    prev > 0 ? (1 - kAlpha) * prev + kAlpha * sample : sample,
+                    std::memory_order_relaxed);
             }
         }
+    }
+    if (all_finished) {
+        status.s = has_failure ? Transport::TransferStatusEnum::FAILED
+                               : Transport::TransferStatusEnum::COMPLETED;
+        task.is_finished = true;
+    } else if (has_timeout) {
+        status.s = Transport::TransferStatusEnum::TIMEOUT;
+    } else {
         status.s = Transport::TransferStatusEnum::WAITING;
     }
     return Status::OK();
@@ -207,6 +340,11 @@ Transport *MultiTransport::installTransport(const std::string &proto,
         transport = new TcpTransport();
     }
 #endif
+#ifdef USE_SHM
+    else if (std::string(proto) == "shm") {
+        transport = new ShmTransport();
+    }
+#endif
 #ifdef USE_NVMEOF
     else if (std::string(proto) == "nvmeof") {
         transport = new NVMeoFTransport();
@@ -260,6 +398,18 @@ Status MultiTransport::selectTransport(const TransferRequest &entry,
                                        std::to_string(entry.target_id));
     }
     auto proto = target_segment_desc->protocol;
+#ifdef USE_SHM
+    // Peers on the same host are accessed directly instead of looping back
+    // through the network stack, as long as neither side is device memory.
+    if (!local_host_id_.empty() && transport_map_.count("shm") &&
+        ShmTransport::isReachable(*target_segment_desc, local_host_id_) &&
+        ShmTransport::isHostMemory(*target_segment_desc,
+                                   entry.target_offset) &&
+        !ShmTransport::isDeviceMemory(entry.source)) {
+        transport = transport_map_["shm"].get();
+        return Status::OK();
+    }
+#endif
 #ifdef USE_ASCEND_HETEROGENEOUS
     // When USE_ASCEND_HETEROGENEOUS is enabled:
     // - Target side directly reuses RDMA Transport
@@ -281,6 +431,81 @@ Transport *MultiTransport::getTransport(const std::string &proto) {
     return transport_map_[proto].get();
 }
 
+Transport *MultiTransport::installStripePath(const std::string &proto,
+                                             const std::string &local_address) {
+    auto iter = transport_map_.find(proto);
+    if (iter == transport_map_.end()) {
+        LOG(ERROR) << "Transport " << proto
+                   << " must be installed before adding stripe paths";
+        return nullptr;
+    }
+
+    Transport *transport = nullptr;
+#ifdef USE_TCP
+    if (proto == "tcp") {
+        transport = new TcpTransport(local_address);
+    }
+#endif
+    if (!transport) {
+        LOG(ERROR) << "Transport " << proto << " does not support striping";
+        return nullptr;
+    }
+
+    if (transport->install(local_server_name_, metadata_, nullptr)) {
+        delete transport;
+        return nullptr;
+    }
+
+    auto &paths = stripe_paths_[iter->second.get()];
+    if (paths.empty()) {
+        auto primary = std::make_shared<StripePath>();
+        primary->transport = iter->second;
+        paths.push_back(primary);
+    }
+    auto path = std::make_shared<StripePath>();
+    path->transport = std::shared_ptr<Transport>(transport);
+    path->local_address = local_address;
+    paths.push_back(path);
+    LOG(INFO) << "Installed " << proto << " stripe path from " << local_address
+              << ", " << paths.size() << " paths in total";
+    return transport;
+}
+
+std::vector<double> MultiTransport::getStripeThroughput(
+    const std::string &proto) {
+    std::vector<double> result;
+    auto iter = transport_map_.find(proto);
+    if (iter == transport_map_.end()) return result;
+    auto path_iter = stripe_paths_.find(iter->second.get());
+    if (path_iter == stripe_paths_.end()) return result;
+    for (auto &path : path_iter->second)
+        result.push_back(path->throughput.load(std::memory_order_relaxed) *
+                         1e9);
+    return result;
+}
+
+std::string MultiTransport::getSegmentName(SegmentID target_id) {
+    auto desc = metadata_->getSegmentDescByID(target_id);
+    return desc ? desc->name : std::to_string(target_id);
+}
+
+std::vector<TransferTracer::PathSnapshot> MultiTransport::getTraceStats() {
+    if (!tracer_) return {};
+    return tracer_->snapshot(
+        [this](SegmentID target_id) { return getSegmentName(target_id); });
+}
+
+std::string MultiTransport::getTraceMetrics() {
+    if (!tracer_) return "";
+    return tracer_->toPrometheus(
+        [this](SegmentID target_id) { return getSegmentName(target_id); });
+}
+
+std::vector<TransferTracer::SliceRecord> MultiTransport::getSliceTrace() {
+    if (!tracer_) return {};
+    return tracer_->dumpSlices();
+}
+
 std::vector<Transport *> MultiTransport::listTransports() {
     std::vector<Transport *> transport_list;
     for (auto &entry : transport_map_)
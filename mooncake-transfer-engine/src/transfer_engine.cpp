@@ -20,6 +20,7 @@
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <sstream>
 #include <sys/resource.h>
 #include <unistd.h>
 
@@ -241,6 +242,29 @@ int TransferEngine::init(const std::string &metadata_conn_string,
                 LOG(ERROR) << "Failed to install TCP transport";
                 return -1;
             }
+            if (getenv("MC_TCP_STRIPE_ADDRESSES")) {
+                std::stringstream ss(getenv("MC_TCP_STRIPE_ADDRESSES"));
+                std::string address;
+                while (std::getline(ss, address, ',')) {
+                    if (address.empty()) continue;
+                    if (!multi_transports_->installStripePath("tcp",
+                                                              address)) {
+                        LOG(ERROR) << "Failed to install TCP stripe path "
+                                   << address;
+                        return -1;
+                    }
+                }
+            }
+        }
+#endif
+#ifdef USE_SHM
+        if (getenv("MC_ENABLE_SHM_TRANSPORT")) {
+            Transport *shm_transport =
+                multi_transports_->installTransport("shm", nullptr);
+            if (!shm_transport) {
+                LOG(ERROR) << "Failed to install SHM transport";
+                return -1;
+            }
         }
 #endif
         // TODO: install other transports automatically
@@ -301,6 +325,16 @@ std::string TransferEngine::getLocalIpAndPort() {
            std::to_string(metadata_->localRpcMeta().rpc_port);
 }
 
+int TransferEngine::dumpSliceTrace(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        PLOG(ERROR) << "Failed to open " << path;
+        return ERR_INVALID_ARGUMENT;
+    }
+    for (auto &record : getSliceTrace()) file << record << "\n";
+    return 0;
+}
+
 int TransferEngine::getNotifies(
     std::vector<TransferMetadata::NotifyDesc> &notifies) {
     return metadata_->getNotifies(notifies);
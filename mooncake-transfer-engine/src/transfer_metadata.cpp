@@ -16,6 +16,7 @@
 
 #include <json/value.h>
 
+#include <algorithm>
 #include <cassert>
 #include <set>
 
@@ -156,6 +157,16 @@ int TransferMetadata::encodeSegmentDesc(const SegmentDesc &desc,
     segmentJSON["protocol"] = desc.protocol;
     segmentJSON["tcp_data_port"] = desc.tcp_data_port;
     segmentJSON["timestamp"] = getCurrentDateTime();
+    if (desc.pid) {
+        segmentJSON["host_id"] = desc.host_id;
+        segmentJSON["pid"] = static_cast<Json::UInt64>(desc.pid);
+        segmentJSON["pid_start_time"] =
+            static_cast<Json::UInt64>(desc.pid_start_time);
+        Json::Value deviceBuffersJSON(Json::arrayValue);
+        for (auto addr : desc.device_buffers)
+            deviceBuffersJSON.append(static_cast<Json::UInt64>(addr));
+        segmentJSON["device_buffers"] = deviceBuffersJSON;
+    }
 
     if (segmentJSON["protocol"] == "rdma") {
         Json::Value devicesJSON(Json::arrayValue);
@@ -305,6 +316,13 @@ TransferMetadata::decodeSegmentDesc(Json::Value &segmentJSON,
     desc->tcp_data_port = segmentJSON["tcp_data_port"].asInt();
     if (segmentJSON.isMember("timestamp"))
         desc->timestamp = segmentJSON["timestamp"].asString();
+    if (segmentJSON.isMember("pid")) {
+        desc->host_id = segmentJSON["host_id"].asString();
+        desc->pid = segmentJSON["pid"].asUInt64();
+        desc->pid_start_time = segmentJSON["pid_start_time"].asUInt64();
+        for (const auto &addrJSON : segmentJSON["device_buffers"])
+            desc->device_buffers.push_back(addrJSON.asUInt64());
+    }
 
     if (desc->protocol == "rdma") {
         for (const auto &deviceJSON : segmentJSON["devices"]) {
@@ -575,11 +593,42 @@ int TransferMetadata::addLocalSegment(SegmentID segment_id,
                                       const std::string &segment_name,
                                       std::shared_ptr<SegmentDesc> &&desc) {
     RWSpinlock::WriteGuard guard(segment_lock_);
+    if (segment_id == LOCAL_SEGMENT_ID && intra_host_pid_) {
+        desc->host_id = intra_host_id_;
+        desc->pid = intra_host_pid_;
+        desc->pid_start_time = intra_host_pid_start_time_;
+    }
     segment_id_to_desc_map_[segment_id] = desc;
     segment_name_to_id_map_[segment_name] = segment_id;
     return 0;
 }
 
+int TransferMetadata::enableIntraHostAccess() {
+    bool has_local_segment = false;
+    {
+        RWSpinlock::WriteGuard guard(segment_lock_);
+        intra_host_id_ = getIntraHostId();
+        intra_host_pid_ = (uint64_t)getpid();
+        intra_host_pid_start_time_ = getProcessStartTime(getpid());
+        if (intra_host_id_.empty() || !intra_host_pid_start_time_) {
+            intra_host_pid_ = 0;
+            return ERR_METADATA;
+        }
+        auto iter = segment_id_to_desc_map_.find(LOCAL_SEGMENT_ID);
+        if (iter != segment_id_to_desc_map_.end() && iter->second) {
+            auto new_segment_desc = std::make_shared<SegmentDesc>();
+            *new_segment_desc = *iter->second;
+            new_segment_desc->host_id = intra_host_id_;
+            new_segment_desc->pid = intra_host_pid_;
+            new_segment_desc->pid_start_time = intra_host_pid_start_time_;
+            iter->second = new_segment_desc;
+            has_local_segment = true;
+        }
+    }
+    if (has_local_segment) return updateLocalSegmentDesc();
+    return 0;
+}
+
 int TransferMetadata::removeLocalSegment(const std::string &segment_name) {
     RWSpinlock::WriteGuard guard(segment_lock_);
     if (segment_name_to_id_map_.count(segment_name)) {
@@ -634,6 +683,40 @@ int TransferMetadata::removeLocalMemoryBuffer(void *addr,
     return ERR_ADDRESS_NOT_REGISTERED;
 }
 
+int TransferMetadata::addLocalDeviceBuffer(void *addr, bool update_metadata) {
+    {
+        RWSpinlock::WriteGuard guard(segment_lock_);
+        auto new_segment_desc = std::make_shared<SegmentDesc>();
+        auto &segment_desc = segment_id_to_desc_map_[LOCAL_SEGMENT_ID];
+        *new_segment_desc = *segment_desc;
+        segment_desc = new_segment_desc;
+        segment_desc->device_buffers.push_back((uint64_t)addr);
+    }
+    if (update_metadata) return updateLocalSegmentDesc();
+    return 0;
+}
+
+int TransferMetadata::removeLocalDeviceBuffer(void *addr,
+                                              bool update_metadata) {
+    {
+        RWSpinlock::WriteGuard guard(segment_lock_);
+        auto &segment_desc = segment_id_to_desc_map_[LOCAL_SEGMENT_ID];
+        auto &device_buffers = segment_desc->device_buffers;
+        auto iter = std::find(device_buffers.begin(), device_buffers.end(),
+                              (uint64_t)addr);
+        // Most buffers are host memory, there is nothing to remove then.
+        if (iter == device_buffers.end()) return 0;
+        auto new_segment_desc = std::make_shared<SegmentDesc>();
+        *new_segment_desc = *segment_desc;
+        new_segment_desc->device_buffers.erase(
+            new_segment_desc->device_buffers.begin() +
+            (iter - device_buffers.begin()));
+        segment_desc = new_segment_desc;
+    }
+    if (update_metadata) return updateLocalSegmentDesc();
+    return 0;
+}
+
 int TransferMetadata::addRpcMetaEntry(const std::string &server_name,
                                       RpcMetaDesc &desc) {
     local_rpc_meta_ = desc;
@@ -0,0 +1,285 @@
+// Copyright 2025 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transfer_tracer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+
+namespace mooncake {
+static inline size_t bucketOf(uint64_t value) {
+    if (!value) return 0;
+    size_t bucket = 64 - __builtin_clzll(value);
+    return std::min(bucket, TransferTracer::kNumBuckets - 1);
+}
+
+static inline uint64_t bucketUpperBound(size_t bucket) {
+    return bucket ? (1ull << bucket) - 1 : 0;
+}
+
+uint64_t TransferTracer::HistogramSnapshot::percentile(double quantile) const {
+    if (!count) return 0;
+    uint64_t target = (uint64_t)(quantile * count);
+    if (target >= count) target = count - 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        seen += buckets[i];
+        if (seen > target) return bucketUpperBound(i);
+    }
+    return bucketUpperBound(kNumBuckets - 1);
+}
+
+void TransferTracer::Histogram::observe(uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void TransferTracer::Histogram::load(HistogramSnapshot &snapshot) const {
+    for (size_t i = 0; i < kNumBuckets; ++i)
+        snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    snapshot.count = count.load(std::memory_order_relaxed);
+    snapshot.sum = sum.load(std::memory_order_relaxed);
+}
+
+void TransferTracer::Histogram::clear() {
+    for (size_t i = 0; i < kNumBuckets; ++i)
+        buckets[i].store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+}
+
+TransferTracer::TransferTracer(size_t ring_capacity)
+    : ring_capacity_(ring_capacity) {
+    if (ring_capacity_) ring_.reset(new SliceRecord[ring_capacity_]());
+}
+
+TransferTracer::~TransferTracer() {}
+
+TransferTracer::PathStats *TransferTracer::getPathStats(
+    const char *transport, SegmentID target_id, const std::string &peer_nic) {
+    std::string key = transport;
+    key += '\0';
+    key += std::to_string(target_id);
+    key += '\0';
+    key += peer_nic;
+    {
+        RWSpinlock::ReadGuard guard(path_lock_);
+        auto iter = path_map_.find(key);
+        if (iter != path_map_.end()) return iter->second.get();
+    }
+    RWSpinlock::WriteGuard guard(path_lock_);
+    auto &stats = path_map_[key];
+    if (!stats) {
+        stats = std::make_unique<PathStats>();
+        stats->transport = transport;
+        stats->target_id = target_id;
+        stats->peer_nic = peer_nic;
+    }
+    return stats.get();
+}
+
+void TransferTracer::recordTask(const TransferTask &task,
+                                const char *transport) {
+    const bool is_rdma = strcmp(transport, "rdma") == 0;
+    PathStats *stats = nullptr;
+    for (auto slice : task.slice_list) {
+        if (!slice->submit_ts || !slice->complete_ts) continue;
+        if (!stats || stats->target_id != slice->target_id ||
+            stats->peer_nic != slice->peer_nic_path)
+            stats = getPathStats(transport, slice->target_id,
+                                 slice->peer_nic_path);
+        recordSlice(stats, slice, is_rdma);
+    }
+}
+
+void TransferTracer::recordSlice(PathStats *stats, const Slice *slice,
+                                 bool is_rdma) {
+    const int64_t post_ts = slice->ts;
+    const bool success = slice->status == Slice::SUCCESS;
+    const uint32_t retries = is_rdma ? slice->rdma.retry_cnt : 0;
+    int64_t queue_ns = 0, completion_ns = 0;
+    if (post_ts > 0 && post_ts >= slice->submit_ts) {
+        queue_ns = post_ts - slice->submit_ts;
+        completion_ns = slice->complete_ts - post_ts;
+    } else {
+        completion_ns = slice->complete_ts - slice->submit_ts;
+    }
+    stats->queue_us.observe(std::max<int64_t>(queue_ns, 0) / 1000);
+    stats->completion_us.observe(std::max<int64_t>(completion_ns, 0) / 1000);
+    stats->slice_bytes.observe(slice->length);
+    stats->slices.fetch_add(1, std::memory_order_relaxed);
+    if (success)
+        stats->bytes.fetch_add(slice->length, std::memory_order_relaxed);
+    else
+        stats->failed_slices.fetch_add(1, std::memory_order_relaxed);
+    if (retries) stats->retries.fetch_add(retries, std::memory_order_relaxed);
+
+    if (!ring_capacity_) return;
+    uint64_t seq = ring_head_.fetch_add(1, std::memory_order_relaxed);
+    auto &record = ring_[seq % ring_capacity_];
+    __atomic_store_n(&record.seq, 0, __ATOMIC_RELEASE);
+    record.submit_ts = slice->submit_ts;
+    record.post_ts = post_ts > 0 ? post_ts : 0;
+    record.complete_ts = slice->complete_ts;
+    record.target_id = slice->target_id;
+    record.length = slice->length;
+    record.retries = retries;
+    record.success = success;
+    record.transport = stats->transport.c_str();
+    // written last, readers drop records whose seq does not match the slot
+    __atomic_store_n(&record.seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+std::vector<TransferTracer::PathSnapshot> TransferTracer::snapshot(
+    const SegmentNameResolver &resolver) {
+    std::vector<PathSnapshot> result;
+    RWSpinlock::ReadGuard guard(path_lock_);
+    result.reserve(path_map_.size());
+    for (auto &entry : path_map_) {
+        auto &stats = *entry.second;
+        PathSnapshot item;
+        item.transport = stats.transport;
+        item.peer = resolver ? resolver(stats.target_id)
+                             : std::to_string(stats.target_id);
+        item.peer_nic = stats.peer_nic;
+        stats.queue_us.load(item.queue_us);
+        stats.completion_us.load(item.completion_us);
+        stats.slice_bytes.load(item.slice_bytes);
+        item.slices = stats.slices.load(std::memory_order_relaxed);
+        item.failed_slices = stats.failed_slices.load(std::memory_order_relaxed);
+        item.retries = stats.retries.load(std::memory_order_relaxed);
+        item.bytes = stats.bytes.load(std::memory_order_relaxed);
+        result.push_back(std::move(item));
+    }
+    return result;
+}
+
+static void writeHistogram(std::ostringstream &os, const std::string &name,
+                           const std::string &labels,
+                           const TransferTracer::HistogramSnapshot &hist) {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < TransferTracer::kNumBuckets; ++i) {
+        if (!hist.buckets[i]) continue;
+        cumulative += hist.buckets[i];
+        os << name << "_bucket{" << labels << ",le=\"" << bucketUpperBound(i)
+           << "\"} " << cumulative << "\n";
+    }
+    os << name << "_bucket{" << labels << ",le=\"+Inf\"} " << hist.count
+       << "\n";
+    os << name << "_sum{" << labels << "} " << hist.sum << "\n";
+    os << name << "_count{" << labels << "} " << hist.count << "\n";
+}
+
+std::string TransferTracer::toPrometheus(const SegmentNameResolver &resolver) {
+    auto paths = snapshot(resolver);
+    std::sort(paths.begin(), paths.end(),
+              [](const PathSnapshot &lhs, const PathSnapshot &rhs) {
+                  return std::tie(lhs.transport, lhs.peer, lhs.peer_nic) <
+                         std::tie(rhs.transport, rhs.peer, rhs.peer_nic);
+              });
+    std::vector<std::string> labels;
+    for (auto &path : paths)
+        labels.push_back("transport=\"" + path.transport + "\",peer=\"" +
+                         path.peer + "\",nic=\"" + path.peer_nic + "\"");
+
+    std::ostringstream os;
+    const struct {
+        const char *name;
+        const char *help;
+        HistogramSnapshot PathSnapshot::*member;
+    } histograms[] = {
+        {"mooncake_te_slice_queue_latency_us",
+         "Time from slice submission to posting to the device",
+         &PathSnapshot::queue_us},
+        {"mooncake_te_slice_completion_latency_us",
+         "Time from slice posting to completion",
+         &PathSnapshot::completion_us},
+        {"mooncake_te_slice_size_bytes", "Size of transferred slices",
+         &PathSnapshot::slice_bytes},
+    };
+    for (auto &hist : histograms) {
+        os << "# HELP " << hist.name << " " << hist.help << "\n";
+        os << "# TYPE " << hist.name << " histogram\n";
+        for (size_t i = 0; i < paths.size(); ++i)
+            writeHistogram(os, hist.name, labels[i], paths[i].*hist.member);
+    }
+
+    const struct {
+        const char *name;
+        const char *help;
+        uint64_t PathSnapshot::*member;
+    } counters[] = {
+        {"mooncake_te_slices_total", "Completed slices", &PathSnapshot::slices},
+        {"mooncake_te_slice_failures_total", "Failed slices",
+         &PathSnapshot::failed_slices},
+        {"mooncake_te_slice_retries_total", "Slice retries",
+         &PathSnapshot::retries},
+        {"mooncake_te_transferred_bytes_total", "Successfully transferred bytes",
+         &PathSnapshot::bytes},
+    };
+    for (auto &counter : counters) {
+        os << "# HELP " << counter.name << " " << counter.help << "\n";
+        os << "# TYPE " << counter.name << " counter\n";
+        for (size_t i = 0; i < paths.size(); ++i)
+            os << counter.name << "{" << labels[i] << "} "
+               << paths[i].*counter.member << "\n";
+    }
+    return os.str();
+}
+
+std::vector<TransferTracer::SliceRecord> TransferTracer::dumpSlices() {
+    std::vector<SliceRecord> result;
+    if (!ring_capacity_) return result;
+    uint64_t head = ring_head_.load(std::memory_order_acquire);
+    uint64_t begin = head > ring_capacity_ ? head - ring_capacity_ : 0;
+    result.reserve(head - begin);
+    for (uint64_t seq = begin; seq < head; ++seq) {
+        auto &slot = ring_[seq % ring_capacity_];
+        if (__atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE) != seq + 1) continue;
+        SliceRecord record = slot;
+        // overwritten while being copied
+        if (__atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE) != seq + 1) continue;
+        record.seq = seq;
+        result.push_back(record);
+    }
+    return result;
+}
+
+void TransferTracer::reset() {
+    RWSpinlock::WriteGuard guard(path_lock_);
+    for (auto &entry : path_map_) {
+        auto &stats = *entry.second;
+        stats.queue_us.clear();
+        stats.completion_us.clear();
+        stats.slice_bytes.clear();
+        stats.slices.store(0, std::memory_order_relaxed);
+        stats.failed_slices.store(0, std::memory_order_relaxed);
+        stats.retries.store(0, std::memory_order_relaxed);
+        stats.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::ostream &operator<<(std::ostream &os,
+                         const TransferTracer::SliceRecord &record) {
+    os << record.seq << " " << record.transport << " segment "
+       << record.target_id << " len " << record.length << " submit "
+       << record.submit_ts << " post " << record.post_ts << " complete "
+       << record.complete_ts << " retries " << record.retries << " "
+       << (record.success ? "ok" : "failed");
+    return os;
+}
+}  // namespace mooncake
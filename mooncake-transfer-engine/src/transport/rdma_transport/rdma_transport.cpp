@@ -19,6 +19,7 @@
 #include <sys/time.h>
 
 #include <cassert>
+#include <algorithm>
 #include <cstddef>
 #include <future>
 #include <set>
@@ -302,7 +303,6 @@ Status RdmaTransport::submitTransferTask(
         slices_to_post;
     auto local_segment_desc = metadata_->getSegmentDescByID(LOCAL_SEGMENT_ID);
     assert(local_segment_desc.get());
-    const size_t kBlockSize = globalConfig().slice_size;
     const int kMaxRetryCount = globalConfig().retry_cnt;
     const size_t kFragmentSize = globalConfig().fragment_limit;
     const size_t kSubmitWatermark =
@@ -314,6 +314,7 @@ Status RdmaTransport::submitTransferTask(
         nr_slices = 0;
         assert(task.request);
         auto &request = *task.request;
+        const size_t kBlockSize = sliceSizeFor(request.length);
 
         auto request_buffer_id = -1, request_device_id = -1;
         if (selectDevice(local_segment_desc.get(), (uint64_t)request.source,
@@ -416,6 +417,51 @@ Status RdmaTransport::submitTransferTask(
     return Status::OK();
 }
 
+void RdmaTransport::recordSliceCompletion(size_t length, int64_t latency_ns) {
+    // One in kSampleInterval completions per worker thread is enough, and
+    // keeps the averages off the hot path
+    const int kSampleInterval = 16;
+    const double kAlpha = 0.01;
+    thread_local int completions = 0;
+    if (latency_ns <= 0 || ++completions % kSampleInterval) return;
+    auto update = [kAlpha](std::atomic<double> &avg, double sample) {
+        double prev = avg.load(std::memory_order_relaxed);
+        avg.store(prev > 0 ? (1 - kAlpha) * prev + kAlpha * sample : sample,
+                  std::memory_order_relaxed);
+    };
+    double len = length, latency = latency_ns;
+    update(slice_length_avg_, len);
+    update(slice_latency_avg_, latency);
+    update(slice_length_sq_avg_, len * len);
+    update(slice_length_latency_avg_, len * latency);
+}
+
+size_t RdmaTransport::sliceSizeFor(size_t length) const {
+    // A slice should take this many times its fixed latency to transfer
+    const double kSliceCostRatio = 4;
+    const size_t kMinSize = globalConfig().slice_size;
+    const size_t kMaxSize = globalConfig().max_slice_size;
+    if (kMaxSize <= kMinSize) return kMinSize;
+
+    // latency = fixed latency + length / bandwidth, fitted by least squares
+    double len = slice_length_avg_.load(std::memory_order_relaxed);
+    double latency = slice_latency_avg_.load(std::memory_order_relaxed);
+    double variance =
+        slice_length_sq_avg_.load(std::memory_order_relaxed) - len * len;
+    double covariance =
+        slice_length_latency_avg_.load(std::memory_order_relaxed) -
+        len * latency;
+    if (variance <= 0 || covariance <= 0) return kMinSize;
+    double ns_per_byte = covariance / variance;
+    double fixed_latency = latency - ns_per_byte * len;
+    if (fixed_latency <= 0) return kMinSize;
+
+    size_t size = kSliceCostRatio * fixed_latency / ns_per_byte;
+    size = std::min(size, length / std::max<size_t>(context_list_.size(), 1));
+    size = std::clamp(size, kMinSize, kMaxSize);
+    return size / kMinSize * kMinSize;
+}
+
 Status RdmaTransport::getTransferStatus(BatchID batch_id,
                                         std::vector<TransferStatus> &status) {
     auto &batch_desc = *((BatchDesc *)(batch_id));
@@ -322,6 +322,10 @@ void WorkerPool::performPollCq(int thread_id) {
                     // redispatch(slice_list, thread_id);
                 }
             } else {
+                if (slice->ts > 0) {
+                    context_.engine().recordSliceCompletion(
+                        slice->length, getCurrentTimeInNano() - slice->ts);
+                }
                 slice->markSuccess();
                 processed_slice_count++;
                 success_nr_polls++;
@@ -0,0 +1,376 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transport/shm_transport/shm_transport.h"
+
+#include <glog/logging.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include "common.h"
+#include "transfer_metadata.h"
+#include "transport/transport.h"
+
+#if defined(USE_CUDA) || defined(USE_MUSA) || defined(USE_HIP)
+#include "cuda_alike.h"
+#endif
+
+namespace mooncake {
+// process_vm_{readv,writev} may transfer less than requested, and large
+// single-iovec transfers hold the peer's mmap lock for a long time.
+const static size_t kMaxCopyChunkSize = 4ull << 20;
+
+// Returns the Yama ptrace_scope, or 0 if the Yama LSM is not enabled.
+static int getPtraceScope() {
+    int fd = open("/proc/sys/kernel/yama/ptrace_scope", O_RDONLY);
+    if (fd < 0) return 0;
+    char scope[16] = {0};
+    ssize_t len = read(fd, scope, sizeof(scope) - 1);
+    close(fd);
+    if (len <= 0) return 0;
+    return atoi(scope);
+}
+
+ShmTransport::ShmTransport() : local_pid_(getpid()) {}
+
+ShmTransport::~ShmTransport() {
+    for (auto &entry : peers_)
+        if (entry.second.pidfd >= 0) close(entry.second.pidfd);
+}
+
+bool ShmTransport::isReachable(const SegmentDesc &desc,
+                               const std::string &local_host_id) {
+    if (!desc.pid || !desc.pid_start_time || desc.host_id.empty() ||
+        desc.host_id != local_host_id)
+        return false;
+    // Only these protocols publish buffers by virtual address.
+    return desc.protocol == "tcp" || desc.protocol == "rdma";
+}
+
+bool ShmTransport::isHostMemory(const SegmentDesc &desc, uint64_t addr) {
+    for (auto &buffer : desc.buffers) {
+        if (addr < buffer.addr || addr >= buffer.addr + buffer.length)
+            continue;
+        return std::find(desc.device_buffers.begin(),
+                         desc.device_buffers.end(),
+                         buffer.addr) == desc.device_buffers.end();
+    }
+    return false;
+}
+
+bool ShmTransport::isDeviceMemory(void *addr) {
+#if defined(USE_CUDA) || defined(USE_MUSA) || defined(USE_HIP)
+    cudaPointerAttributes attributes;
+    auto status = cudaPointerGetAttributes(&attributes, addr);
+    if (status != cudaSuccess) {
+        // Plain host memory is reported as an error by older runtimes.
+        cudaGetLastError();
+        return false;
+    }
+    return attributes.type == cudaMemoryTypeDevice;
+#else
+    return false;
+#endif
+}
+
+int ShmTransport::install(std::string &local_server_name,
+                          std::shared_ptr<TransferMetadata> meta,
+                          std::shared_ptr<Topology> topo) {
+    metadata_ = meta;
+    local_server_name_ = local_server_name;
+
+    // With Yama ptrace_scope=1, peers may only access our address space if we
+    // name them. Only one process can be named, and the exception extends to
+    // its descendants: by default the parent, so that the processes spawned
+    // by the same launcher reach each other, or MC_SHM_PTRACER_PID.
+    int ptrace_scope = getPtraceScope();
+    if (ptrace_scope == 1) {
+        const char *tracer_env = getenv("MC_SHM_PTRACER_PID");
+        pid_t tracer = tracer_env ? atoi(tracer_env) : getppid();
+        if (tracer <= 1) {
+            LOG(WARNING) << "ShmTransport: no launcher process to allow, "
+                            "set MC_SHM_PTRACER_PID so that peers can access "
+                            "local buffers";
+        } else if (prctl(PR_SET_PTRACER, tracer, 0, 0, 0)) {
+            PLOG(WARNING) << "ShmTransport: prctl(PR_SET_PTRACER) failed, "
+                             "peers may be unable to access local buffers";
+        }
+    } else if (ptrace_scope > 1) {
+        LOG(WARNING) << "ShmTransport: Yama ptrace_scope is " << ptrace_scope
+                     << ", peers without CAP_SYS_PTRACE cannot access local "
+                        "buffers";
+    }
+
+    int ret = metadata_->enableIntraHostAccess();
+    if (ret) {
+        LOG(ERROR) << "ShmTransport: cannot publish intra-host identity, "
+                      "check the availability of metadata storage";
+        return -1;
+    }
+    return 0;
+}
+
+// Buffers are published by the primary transport, only device memory has to
+// be flagged so that peers do not try to access it with process_vm_readv.
+int ShmTransport::registerLocalMemory(void *addr, size_t length,
+                                      const std::string &location,
+                                      bool remote_accessible,
+                                      bool update_metadata) {
+    if (!isDeviceMemory(addr)) return 0;
+    return metadata_->addLocalDeviceBuffer(addr, update_metadata);
+}
+
+int ShmTransport::unregisterLocalMemory(void *addr, bool update_metadata) {
+    return metadata_->removeLocalDeviceBuffer(addr, update_metadata);
+}
+
+int ShmTransport::registerLocalMemoryBatch(
+    const std::vector<Transport::BufferEntry> &buffer_list,
+    const std::string &location) {
+    bool has_device_buffer = false;
+    for (auto &buffer : buffer_list) {
+        if (!isDeviceMemory(buffer.addr)) continue;
+        int ret = metadata_->addLocalDeviceBuffer(buffer.addr, false);
+        if (ret) return ret;
+        has_device_buffer = true;
+    }
+    if (has_device_buffer) return metadata_->updateLocalSegmentDesc();
+    return 0;
+}
+
+int ShmTransport::unregisterLocalMemoryBatch(
+    const std::vector<void *> &addr_list) {
+    for (auto addr : addr_list) {
+        int ret = metadata_->removeLocalDeviceBuffer(addr, false);
+        if (ret) return ret;
+    }
+    return metadata_->updateLocalSegmentDesc();
+}
+
+Status ShmTransport::getTransferStatus(BatchID batch_id, size_t task_id,
+                                       TransferStatus &status) {
+    auto &batch_desc = *((BatchDesc *)(batch_id));
+    const size_t task_count = batch_desc.task_list.size();
+    if (task_id >= task_count) {
+        return Status::InvalidArgument(
+            "ShmTransport::getTransportStatus invalid argument, batch id: " +
+            std::to_string(batch_id));
+    }
+    auto &task = batch_desc.task_list[task_id];
+    status.transferred_bytes = task.transferred_bytes;
+    uint64_t success_slice_count = task.success_slice_count;
+    uint64_t failed_slice_count = task.failed_slice_count;
+    if (success_slice_count + failed_slice_count == task.slice_count) {
+        if (failed_slice_count) {
+            status.s = TransferStatusEnum::FAILED;
+        } else {
+            status.s = TransferStatusEnum::COMPLETED;
+        }
+        task.is_finished = true;
+    } else {
+        status.s = TransferStatusEnum::WAITING;
+    }
+    return Status::OK();
+}
+
+Status ShmTransport::submitTransfer(
+    BatchID batch_id, const std::vector<TransferRequest> &entries) {
+    auto &batch_desc = *((BatchDesc *)(batch_id));
+    if (batch_desc.task_list.size() + entries.size() > batch_desc.batch_size) {
+        LOG(ERROR) << "ShmTransport: Exceed the limitation of current batch's "
+                      "capacity";
+        return Status::InvalidArgument(
+            "ShmTransport: Exceed the limitation of capacity, batch id: " +
+            std::to_string(batch_id));
+    }
+
+    size_t task_id = batch_desc.task_list.size();
+    batch_desc.task_list.resize(task_id + entries.size());
+
+    for (auto &request : entries) {
+        TransferTask &task = batch_desc.task_list[task_id];
+        ++task_id;
+        task.total_bytes = request.length;
+        Slice *slice = getSliceCache().allocate();
+        slice->source_addr = (char *)request.source;
+        slice->length = request.length;
+        slice->opcode = request.opcode;
+        slice->shm.dest_addr = request.target_offset;
+        slice->task = &task;
+        slice->target_id = request.target_id;
+        slice->status = Slice::PENDING;
+        slice->ts = 0;
+        task.slice_list.push_back(slice);
+        __sync_fetch_and_add(&task.slice_count, 1);
+        startTransfer(slice);
+    }
+
+    return Status::OK();
+}
+
+Status ShmTransport::submitTransferTask(
+    const std::vector<TransferTask *> &task_list) {
+    for (size_t index = 0; index < task_list.size(); ++index) {
+        assert(task_list[index]);
+        auto &task = *task_list[index];
+        assert(task.request);
+        auto &request = *task.request;
+        task.total_bytes = request.length;
+        Slice *slice = getSliceCache().allocate();
+        slice->source_addr = (char *)request.source;
+        slice->length = request.length;
+        slice->opcode = request.opcode;
+        slice->shm.dest_addr = request.target_offset;
+        slice->task = &task;
+        slice->target_id = request.target_id;
+        slice->status = Slice::PENDING;
+        slice->ts = 0;
+        task.slice_list.push_back(slice);
+        __sync_fetch_and_add(&task.slice_count, 1);
+        startTransfer(slice);
+    }
+    return Status::OK();
+}
+
+void ShmTransport::startTransfer(Slice *slice) {
+    auto desc = metadata_->getSegmentDescByID(slice->target_id);
+    if (!desc || !desc->pid) {
+        LOG(ERROR) << "ShmTransport::startTransfer failed to get intra-host "
+                      "segment description for target_id: "
+                   << slice->target_id;
+        slice->markFailed();
+        return;
+    }
+
+    // The peer buffers are written without the peer's involvement, so make
+    // sure the destination range has actually been registered.
+    bool registered = false;
+    for (auto &buffer : desc->buffers) {
+        if (slice->shm.dest_addr >= buffer.addr &&
+            slice->shm.dest_addr + slice->length <=
+                buffer.addr + buffer.length) {
+            registered = true;
+            break;
+        }
+    }
+    if (!registered) {
+        LOG(ERROR) << "ShmTransport::startTransfer address range "
+                   << (void *)slice->shm.dest_addr << "+" << slice->length
+                   << " is not registered by segment " << desc->name;
+        slice->markFailed();
+        return;
+    }
+
+    if (!checkPeer(*desc)) {
+        LOG(ERROR) << "ShmTransport::startTransfer process " << desc->pid
+                   << " of segment " << desc->name << " has exited";
+        slice->markFailed();
+        return;
+    }
+
+    int ret = copyWithPeer((pid_t)desc->pid, slice->source_addr,
+                           slice->shm.dest_addr, slice->length, slice->opcode);
+    if (ret)
+        slice->markFailed();
+    else
+        slice->markSuccess();
+}
+
+bool ShmTransport::checkPeer(const SegmentDesc &desc) {
+    pid_t pid = (pid_t)desc.pid;
+    if (pid == local_pid_) return true;
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    auto iter = peers_.find(pid);
+    if (iter != peers_.end()) {
+        auto &peer = iter->second;
+        if (peer.start_time == desc.pid_start_time) {
+            if (peer.pidfd >= 0) {
+#ifdef SYS_pidfd_open
+                // Signal 0 only checks that the process is still alive.
+                if (!syscall(SYS_pidfd_send_signal, peer.pidfd, 0, nullptr, 0))
+                    return true;
+#endif
+            } else if (getProcessStartTime(pid) == peer.start_time) {
+                return true;
+            }
+        }
+        if (peer.pidfd >= 0) close(peer.pidfd);
+        peers_.erase(iter);
+    }
+
+    // Open the pidfd before checking the start time, so that the pidfd cannot
+    // refer to a process that reused the pid after the check.
+    int pidfd = -1;
+#ifdef SYS_pidfd_open
+    pidfd = syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd < 0 && errno != ENOSYS) return false;
+#endif
+    if (!desc.pid_start_time ||
+        getProcessStartTime(pid) != desc.pid_start_time) {
+        if (pidfd >= 0) close(pidfd);
+        return false;
+    }
+    peers_[pid] = {desc.pid_start_time, pidfd};
+    return true;
+}
+
+int ShmTransport::copyWithPeer(pid_t peer_pid, void *local_addr,
+                               uint64_t remote_addr, size_t length,
+                               TransferRequest::OpCode opcode) {
+    if (peer_pid == local_pid_) {
+        if (opcode == TransferRequest::READ)
+            memcpy(local_addr, (void *)remote_addr, length);
+        else
+            memcpy((void *)remote_addr, local_addr, length);
+        return 0;
+    }
+
+    size_t offset = 0;
+    while (offset < length) {
+        size_t chunk = std::min(length - offset, kMaxCopyChunkSize);
+        struct iovec local_iov = {(char *)local_addr + offset, chunk};
+        struct iovec remote_iov = {(void *)(remote_addr + offset), chunk};
+        ssize_t copied;
+        if (opcode == TransferRequest::READ)
+            copied = process_vm_readv(peer_pid, &local_iov, 1, &remote_iov, 1,
+                                      0);
+        else
+            copied = process_vm_writev(peer_pid, &local_iov, 1, &remote_iov,
+                                       1, 0);
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+            PLOG(ERROR) << "ShmTransport: failed to access memory of process "
+                        << peer_pid
+                        << ", both sides must install the shm transport "
+                           "(MC_ENABLE_SHM_TRANSPORT=1)";
+            return -1;
+        }
+        if (copied == 0) {
+            LOG(ERROR) << "ShmTransport: no progress when accessing memory of "
+                          "process "
+                       << peer_pid;
+            return -1;
+        }
+        offset += copied;
+    }
+    return 0;
+}
+}  // namespace mooncake
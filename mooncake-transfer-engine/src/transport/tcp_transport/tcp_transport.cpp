@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <random>
 
 #include "common.h"
@@ -235,25 +236,35 @@ struct Session : public std::enable_shared_from_this<Session> {
 };
 
 struct TcpContext {
-    TcpContext(short port)
-        : acceptor(io_context,
-                   asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port)) {}
+    TcpContext(short port) {
+        acceptor.emplace(io_context,
+                         asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port));
+    }
+
+    // Outgoing-only context, kept running without a pending accept.
+    TcpContext() { work_guard.emplace(asio::make_work_guard(io_context)); }
 
     void doAccept() {
-        acceptor.async_accept([this](asio::error_code ec, tcpsocket socket) {
+        if (!acceptor) return;
+        acceptor->async_accept([this](asio::error_code ec, tcpsocket socket) {
             if (!ec) std::make_shared<Session>(std::move(socket))->onAccept();
             doAccept();
         });
     }
 
     asio::io_context io_context;
-    asio::ip::tcp::acceptor acceptor;
+    std::optional<asio::ip::tcp::acceptor> acceptor;
+    std::optional<asio::executor_work_guard<asio::io_context::executor_type>>
+        work_guard;
 };
 
 TcpTransport::TcpTransport() : context_(nullptr), running_(false) {
     // TODO
 }
 
+TcpTransport::TcpTransport(const std::string &local_address)
+    : context_(nullptr), local_address_(local_address), running_(false) {}
+
 TcpTransport::~TcpTransport() {
     if (running_) {
         running_ = false;
@@ -266,7 +277,8 @@ TcpTransport::~TcpTransport() {
         context_ = nullptr;
     }
 
-    metadata_->removeSegmentDesc(local_server_name_);
+    if (local_address_.empty())
+        metadata_->removeSegmentDesc(local_server_name_);
 }
 
 int TcpTransport::install(std::string &local_server_name,
@@ -274,6 +286,13 @@ int TcpTransport::install(std::string &local_server_name,
                           std::shared_ptr<Topology> topo) {
     metadata_ = meta;
     local_server_name_ = local_server_name;
+    if (!local_address_.empty()) {
+        context_ = new TcpContext();
+        running_ = true;
+        thread_ = std::thread(&TcpTransport::worker, this);
+        return 0;
+    }
+
     int sockfd = -1;
     int tcp_port = findAvailableTcpPort(sockfd);
     if (tcp_port == 0) {
@@ -319,6 +338,7 @@ int TcpTransport::registerLocalMemory(void *addr, size_t length,
                                       bool remote_accessible,
                                       bool update_metadata) {
     (void)remote_accessible;
+    if (!local_address_.empty()) return 0;
     BufferDesc buffer_desc;
     buffer_desc.name = local_server_name_;
     buffer_desc.addr = (uint64_t)addr;
@@ -327,12 +347,14 @@ int TcpTransport::registerLocalMemory(void *addr, size_t length,
 }
 
 int TcpTransport::unregisterLocalMemory(void *addr, bool update_metadata) {
+    if (!local_address_.empty()) return 0;
     return metadata_->removeLocalMemoryBuffer(addr, update_metadata);
 }
 
 int TcpTransport::registerLocalMemoryBatch(
     const std::vector<Transport::BufferEntry> &buffer_list,
     const std::string &location) {
+    if (!local_address_.empty()) return 0;
     for (auto &buffer : buffer_list)
         registerLocalMemory(buffer.addr, buffer.length, location, true, false);
     return metadata_->updateLocalSegmentDesc();
@@ -340,6 +362,7 @@ int TcpTransport::registerLocalMemoryBatch(
 
 int TcpTransport::unregisterLocalMemoryBatch(
     const std::vector<void *> &addr_list) {
+    if (!local_address_.empty()) return 0;
     for (auto &addr : addr_list) unregisterLocalMemory(addr, false);
     return metadata_->updateLocalSegmentDesc();
 }
@@ -466,7 +489,16 @@ void TcpTransport::startTransfer(Slice *slice) {
         auto endpoint_iterator =
             resolver.resolve(asio::ip::tcp::v4(), meta_entry.ip_or_host_name,
                              std::to_string(desc->tcp_data_port));
-        asio::connect(socket, endpoint_iterator);
+        if (local_address_.empty()) {
+            asio::connect(socket, endpoint_iterator);
+        } else {
+            // asio::connect() reopens the socket, bind and connect by hand
+            // so that the connection leaves from the requested interface.
+            socket.open(asio::ip::tcp::v4());
+            socket.bind(asio::ip::tcp::endpoint(
+                asio::ip::make_address(local_address_), 0));
+            socket.connect(*endpoint_iterator.begin());
+        }
         auto session = std::make_shared<Session>(std::move(socket));
         session->on_finalize_ = [slice](TransferStatusEnum status) {
             if (status == TransferStatusEnum::COMPLETED)
@@ -0,0 +1,192 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "transfer_engine.h"
+#include "transport/transport.h"
+
+using namespace mooncake;
+
+namespace mooncake {
+
+class ShmTransportTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        google::InitGoogleLogging("ShmTransportTest");
+        FLAGS_logtostderr = 1;
+    }
+
+    void TearDown() override { google::ShutdownGoogleLogging(); }
+};
+
+static std::unique_ptr<TransferEngine> createEngine() {
+    auto engine = std::make_unique<TransferEngine>(false);
+    int rc = engine->init(P2PHANDSHAKE, "127.0.0.1:12345", "127.0.0.1", 12345);
+    if (rc) return nullptr;
+    if (!engine->installTransport("tcp", nullptr)) return nullptr;
+    if (!engine->installTransport("shm", nullptr)) return nullptr;
+    return engine;
+}
+
+// Returns true if every task of the batch completed successfully.
+static bool waitTransfer(TransferEngine *engine, BatchID batch_id,
+                         size_t task_count) {
+    bool success = true;
+    for (size_t task_id = 0; task_id < task_count; ++task_id) {
+        TransferStatus status;
+        while (true) {
+            Status s = engine->getTransferStatus(batch_id, task_id, status);
+            if (!s.ok()) return false;
+            if (status.s == TransferStatusEnum::COMPLETED) break;
+            if (status.s == TransferStatusEnum::FAILED) {
+                success = false;
+                break;
+            }
+        }
+    }
+    return engine->freeBatchID(batch_id).ok() && success;
+}
+
+TEST_F(ShmTransportTest, CrossProcessReadWrite) {
+    const size_t kBufferSize = 16ull << 20;
+    int to_parent[2], to_child[2];
+    ASSERT_EQ(pipe(to_parent), 0);
+    ASSERT_EQ(pipe(to_child), 0);
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // Target process: publish one buffer and wait until the parent has
+        // finished, then check what it wrote.
+        auto engine = createEngine();
+        if (!engine) _exit(1);
+        char *buffer = (char *)malloc(kBufferSize);
+        for (size_t i = 0; i < kBufferSize; ++i) buffer[i] = (char)(i % 251);
+        if (engine->registerLocalMemory(buffer, kBufferSize, "cpu:0"))
+            _exit(1);
+        std::string name = engine->getLocalIpAndPort();
+        uint64_t addr = (uint64_t)buffer;
+        uint32_t name_len = name.size();
+        writeFully(to_parent[1], &addr, sizeof(addr));
+        writeFully(to_parent[1], &name_len, sizeof(name_len));
+        writeFully(to_parent[1], name.data(), name_len);
+        char done;
+        readFully(to_child[0], &done, 1);
+        for (size_t i = 0; i < kBufferSize / 2; ++i)
+            if (buffer[i] != (char)('a' + i % 26)) _exit(2);
+        engine->unregisterLocalMemory(buffer);
+        _exit(0);
+    }
+
+    uint64_t remote_addr;
+    uint32_t name_len;
+    ASSERT_EQ(readFully(to_parent[0], &remote_addr, sizeof(remote_addr)),
+              (ssize_t)sizeof(remote_addr));
+    ASSERT_EQ(readFully(to_parent[0], &name_len, sizeof(name_len)),
+              (ssize_t)sizeof(name_len));
+    std::string remote_name(name_len, '\0');
+    ASSERT_EQ(readFully(to_parent[0], remote_name.data(), name_len),
+              (ssize_t)name_len);
+
+    auto engine = createEngine();
+    ASSERT_TRUE(engine);
+    char *local = (char *)malloc(kBufferSize);
+    ASSERT_EQ(engine->registerLocalMemory(local, kBufferSize, "cpu:0"), 0);
+    auto segment_id = engine->openSegment(remote_name);
+    auto desc = engine->getMetadata()->getSegmentDescByID(segment_id);
+    ASSERT_TRUE(desc);
+    EXPECT_EQ(desc->pid, (uint64_t)child);
+
+    TransferRequest entry;
+    entry.opcode = TransferRequest::READ;
+    entry.source = local;
+    entry.target_id = segment_id;
+    entry.target_offset = remote_addr;
+    entry.length = kBufferSize;
+    auto batch_id = engine->allocateBatchID(1);
+    ASSERT_TRUE(engine->submitTransfer(batch_id, {entry}).ok());
+    ASSERT_TRUE(waitTransfer(engine.get(), batch_id, 1));
+    for (size_t i = 0; i < kBufferSize; ++i)
+        ASSERT_EQ(local[i], (char)(i % 251));
+
+    for (size_t i = 0; i < kBufferSize / 2; ++i) local[i] = 'a' + i % 26;
+    entry.opcode = TransferRequest::WRITE;
+    entry.length = kBufferSize / 2;
+    batch_id = engine->allocateBatchID(1);
+    ASSERT_TRUE(engine->submitTransfer(batch_id, {entry}).ok());
+    ASSERT_TRUE(waitTransfer(engine.get(), batch_id, 1));
+
+    // Unregistered ranges of the peer must be rejected.
+    entry.target_offset = remote_addr + kBufferSize - 8;
+    entry.length = 4096;
+    batch_id = engine->allocateBatchID(1);
+    ASSERT_TRUE(engine->submitTransfer(batch_id, {entry}).ok());
+    EXPECT_FALSE(waitTransfer(engine.get(), batch_id, 1));
+
+    char done = 1;
+    writeFully(to_child[1], &done, 1);
+    int wstatus = 0;
+    waitpid(child, &wstatus, 0);
+    ASSERT_TRUE(WIFEXITED(wstatus));
+    EXPECT_EQ(WEXITSTATUS(wstatus), 0);
+    engine->unregisterLocalMemory(local);
+    free(local);
+}
+
+TEST_F(ShmTransportTest, LoopbackWriteAndRead) {
+    const size_t kDataLength = 4096000;
+    const size_t kBufferSize = kDataLength * 2;
+    auto engine = createEngine();
+    ASSERT_TRUE(engine);
+    char *addr = (char *)malloc(kBufferSize);
+    ASSERT_EQ(engine->registerLocalMemory(addr, kBufferSize, "cpu:0"), 0);
+    for (size_t i = 0; i < kDataLength; ++i) addr[i] = 'a' + lrand48() % 26;
+
+    auto segment_id = engine->openSegment(engine->getLocalIpAndPort());
+    TransferRequest entry;
+    entry.opcode = TransferRequest::WRITE;
+    entry.source = addr;
+    entry.target_id = segment_id;
+    entry.target_offset = (uint64_t)addr + kDataLength;
+    entry.length = kDataLength;
+    auto batch_id = engine->allocateBatchID(1);
+    ASSERT_TRUE(engine->submitTransfer(batch_id, {entry}).ok());
+    ASSERT_TRUE(waitTransfer(engine.get(), batch_id, 1));
+    EXPECT_EQ(memcmp(addr, addr + kDataLength, kDataLength), 0);
+
+    memset(addr, 0, kDataLength);
+    entry.opcode = TransferRequest::READ;
+    batch_id = engine->allocateBatchID(1);
+    ASSERT_TRUE(engine->submitTransfer(batch_id, {entry}).ok());
+    ASSERT_TRUE(waitTransfer(engine.get(), batch_id, 1));
+    EXPECT_EQ(memcmp(addr, addr + kDataLength, kDataLength), 0);
+
+    engine->unregisterLocalMemory(addr);
+    free(addr);
+}
+
+}  // namespace mooncake
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "transfer_engine.h"
+#include "transport/transport.h"
+
+using namespace mooncake;
+
+namespace mooncake {
+
+// Two TCP paths on one host: the primary transport connects from 127.0.0.1
+// and the stripe path from 127.0.0.2, both to the same loopback segment.
+class TcpStripeTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        google::InitGoogleLogging("TcpStripeTest");
+        FLAGS_logtostderr = 1;
+        engine_ = std::make_unique<TransferEngine>(false);
+        ASSERT_EQ(engine_->init(P2PHANDSHAKE, "127.0.0.1:12345", "127.0.0.1",
+                                12345),
+                  0);
+        ASSERT_NE(engine_->installTransport("tcp", nullptr), nullptr);
+        ASSERT_NE(engine_->installStripePath("tcp", "127.0.0.2"), nullptr);
+        buffer_ = (char *)malloc(kBufferSize);
+        ASSERT_EQ(engine_->registerLocalMemory(buffer_, kBufferSize, "cpu:0"),
+                  0);
+        segment_id_ = engine_->openSegment(engine_->getLocalIpAndPort());
+    }
+
+    void TearDown() override {
+        engine_->unregisterLocalMemory(buffer_);
+        engine_.reset();
+        free(buffer_);
+        google::ShutdownGoogleLogging();
+    }
+
+    bool transfer(TransferRequest::OpCode opcode, size_t source_offset,
+                  size_t target_offset, size_t length) {
+        TransferRequest entry;
+        entry.opcode = opcode;
+        entry.source = buffer_ + source_offset;
+        entry.target_id = segment_id_;
+        entry.target_offset = (uint64_t)buffer_ + target_offset;
+        entry.length = length;
+        auto batch_id = engine_->allocateBatchID(1);
+        if (!engine_->submitTransfer(batch_id, {entry}).ok()) return false;
+        TransferStatus status;
+        do {
+            if (!engine_->getTransferStatus(batch_id, 0, status).ok())
+                return false;
+        } while (status.s == TransferStatusEnum::WAITING);
+        bool ok = status.s == TransferStatusEnum::COMPLETED &&
+                  status.transferred_bytes == length;
+        return engine_->freeBatchID(batch_id).ok() && ok;
+    }
+
+    const size_t kBufferSize = 128ull << 20;
+    std::unique_ptr<TransferEngine> engine_;
+    char *buffer_ = nullptr;
+    SegmentID segment_id_;
+};
+
+TEST_F(TcpStripeTest, StripedWriteAndRead) {
+    const size_t kDataLength = kBufferSize / 2;
+    for (size_t i = 0; i < kDataLength; ++i) buffer_[i] = 'a' + lrand48() % 26;
+
+    ASSERT_TRUE(transfer(TransferRequest::WRITE, 0, kDataLength, kDataLength));
+    EXPECT_EQ(memcmp(buffer_, buffer_ + kDataLength, kDataLength), 0);
+
+    memset(buffer_, 0, kDataLength);
+    ASSERT_TRUE(transfer(TransferRequest::READ, 0, kDataLength, kDataLength));
+    EXPECT_EQ(memcmp(buffer_, buffer_ + kDataLength, kDataLength), 0);
+
+    // Both paths have carried a part of the striped requests.
+    auto throughput = engine_->getStripeThroughput("tcp");
+    ASSERT_EQ(throughput.size(), 2u);
+    EXPECT_GT(throughput[0], 0);
+    EXPECT_GT(throughput[1], 0);
+}
+
+TEST_F(TcpStripeTest, SmallRequestIsNotStriped) {
+    const size_t kDataLength = 64 * 1024;
+    for (size_t i = 0; i < kDataLength; ++i) buffer_[i] = 'a' + lrand48() % 26;
+    ASSERT_TRUE(transfer(TransferRequest::WRITE, 0, kDataLength, kDataLength));
+    EXPECT_EQ(memcmp(buffer_, buffer_ + kDataLength, kDataLength), 0);
+    auto throughput = engine_->getStripeThroughput("tcp");
+    ASSERT_EQ(throughput.size(), 2u);
+    EXPECT_EQ(throughput[0], 0);
+    EXPECT_EQ(throughput[1], 0);
+}
+
+}  // namespace mooncake
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
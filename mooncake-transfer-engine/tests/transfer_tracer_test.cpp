@@ -0,0 +1,122 @@
+// Copyright 2024 KVCache.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transfer_tracer.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+using namespace mooncake;
+
+namespace {
+Transport::Slice *makeSlice(Transport::SegmentID target_id, size_t length,
+                            int64_t submit_ts, int64_t post_ts,
+                            int64_t complete_ts, bool success) {
+    auto slice = new Transport::Slice();
+    slice->target_id = target_id;
+    slice->length = length;
+    slice->status = success ? Transport::Slice::SUCCESS
+                            : Transport::Slice::FAILED;
+    slice->submit_ts = submit_ts;
+    slice->ts = post_ts;
+    slice->complete_ts = complete_ts;
+    return slice;
+}
+
+void releaseSlices(Transport::TransferTask &task) {
+    for (auto slice : task.slice_list) delete slice;
+    task.slice_list.clear();
+}
+}  // namespace
+
+TEST(TransferTracerTest, AggregatesPerPeer) {
+    TransferTracer tracer(0);
+    Transport::TransferTask task;
+    // 10us to complete, no post step
+    task.slice_list.push_back(makeSlice(1, 4096, 1000, 0, 11000, true));
+    task.slice_list.push_back(makeSlice(1, 4096, 1000, 0, 11000, true));
+    task.slice_list.push_back(makeSlice(2, 8192, 1000, 0, 3000, false));
+    tracer.recordTask(task, "tcp");
+    releaseSlices(task);
+
+    auto stats = tracer.snapshot(nullptr);
+    ASSERT_EQ(stats.size(), 2u);
+    for (auto &path : stats) {
+        EXPECT_EQ(path.transport, "tcp");
+        if (path.peer == "1") {
+            EXPECT_EQ(path.slices, 2u);
+            EXPECT_EQ(path.bytes, 8192u);
+            EXPECT_EQ(path.failed_slices, 0u);
+            EXPECT_EQ(path.completion_us.count, 2u);
+            EXPECT_EQ(path.completion_us.sum, 20u);
+            // 10 falls into [8, 16)
+            EXPECT_EQ(path.completion_us.percentile(0.5), 15u);
+        } else {
+            EXPECT_EQ(path.peer, "2");
+            EXPECT_EQ(path.slices, 1u);
+            EXPECT_EQ(path.bytes, 0u);
+            EXPECT_EQ(path.failed_slices, 1u);
+        }
+    }
+}
+
+TEST(TransferTracerTest, SplitsQueueAndCompletion) {
+    TransferTracer tracer(0);
+    Transport::TransferTask task;
+    task.slice_list.push_back(makeSlice(1, 65536, 1000, 101000, 201000, true));
+    tracer.recordTask(task, "tcp");
+    releaseSlices(task);
+
+    auto stats = tracer.snapshot(nullptr);
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].queue_us.sum, 100u);
+    EXPECT_EQ(stats[0].completion_us.sum, 100u);
+
+    auto text = tracer.toPrometheus(
+        [](Transport::SegmentID id) { return "peer" + std::to_string(id); });
+    EXPECT_NE(text.find("mooncake_te_slices_total{transport=\"tcp\","
+                        "peer=\"peer1\",nic=\"\"} 1"),
+              std::string::npos);
+    EXPECT_NE(text.find("mooncake_te_slice_queue_latency_us_count"),
+              std::string::npos);
+}
+
+TEST(TransferTracerTest, SkipsUntracedSlices) {
+    TransferTracer tracer(0);
+    Transport::TransferTask task;
+    task.slice_list.push_back(makeSlice(1, 4096, 0, 0, 0, true));
+    tracer.recordTask(task, "tcp");
+    releaseSlices(task);
+    EXPECT_TRUE(tracer.snapshot(nullptr).empty());
+}
+
+TEST(TransferTracerTest, RingKeepsMostRecentSlices) {
+    TransferTracer tracer(4);
+    Transport::TransferTask task;
+    for (int i = 1; i <= 6; ++i)
+        task.slice_list.push_back(makeSlice(1, i, 1000, 0, 2000, true));
+    tracer.recordTask(task, "tcp");
+    releaseSlices(task);
+
+    auto records = tracer.dumpSlices();
+    ASSERT_EQ(records.size(), 4u);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].seq, i + 2);
+        EXPECT_EQ(records[i].length, i + 3);
+        EXPECT_STREQ(records[i].transport, "tcp");
+    }
+
+    tracer.reset();
+    EXPECT_EQ(tracer.snapshot(nullptr)[0].slices, 0u);
+}
@@ -5,7 +5,7 @@ Mooncake Configuration
 import json
 import os
 from dataclasses import dataclass
-from typing import Optional
+from typing import List, Optional
 
 DEFAULT_GLOBAL_SEGMENT_SIZE = 3355443200  # 3.125 GiB
 DEFAULT_LOCAL_BUFFER_SIZE = 1073741824  # 1.0 GiB
@@ -15,16 +15,26 @@ def _parse_global_segment_size(value) -> int:
         return value
     if isinstance(value, str):
         s = value.strip().lower()
-        if s.endswith("gb"):
-            num = s[:-2].strip()
-            if not num:
-                raise ValueError(
-                    "Invalid global_segment_size: missing number before 'gb'"
-                )
-            return int(num) * 1024 * 1024 * 1024
+        for suffix, unit in (("gb", 1024 * 1024 * 1024), ("mb", 1024 * 1024)):
+            if s.endswith(suffix):
+                num = s[:-2].strip()
+                if not num:
+                    raise ValueError(
+                        f"Invalid size: missing number before '{suffix}'"
+                    )
+                return int(num) * unit
         return int(s)
     return int(value)
 
+def _parse_numa_nodes(value) -> Optional[List[int]]:
+    """None keeps the segments unbound, "all" or [] binds one per node."""
+    if value is None or isinstance(value, list):
+        return value
+    s = str(value).strip().lower()
+    if s == "all":
+        return []
+    return [int(node) for node in s.split(",")]
+
 @dataclass
 class MooncakeConfig:
     """The configuration class for Mooncake.
@@ -37,6 +47,13 @@ class MooncakeConfig:
         protocol (str): The communication protocol to use.
         device_name (Optional[str]): The name of the device to use.
         master_server_address (str): The address of the master server.
+        segment_page_size (int): The huge page size backing the segments,
+            2MB or 1GB, or 0 for regular pages.
+        segment_numa_nodes (Optional[List[int]]): The NUMA nodes to mount a
+            segment of global_segment_size bytes on each, [] for all nodes.
+            None mounts global_segment_size bytes without binding.
+        prefault_threads (int): The number of threads faulting in each
+            segment with huge pages or NUMA binding.
 
     Example of configuration file:
         {
@@ -46,7 +63,9 @@ class MooncakeConfig:
             "local_buffer_size": 1073741824,
             "protocol": "tcp",
             "device_name": "",
-            "master_server_address": "localhost:8081"
+            "master_server_address": "localhost:8081",
+            "segment_page_size": "2mb",
+            "segment_numa_nodes": [0, 1]
         }
     """
     local_hostname: str
@@ -56,6 +75,9 @@ class MooncakeConfig:
     protocol: str
     device_name: Optional[str]
     master_server_address: str
+    segment_page_size: int = 0
+    segment_numa_nodes: Optional[List[int]] = None
+    prefault_threads: int = 8
 
     @staticmethod
     def from_file(file_path: str) -> 'MooncakeConfig':
@@ -81,6 +103,13 @@ class MooncakeConfig:
             protocol=config.get("protocol", "tcp"),
             device_name=config.get("device_name", ""),
             master_server_address=config.get("master_server_address"),
+            segment_page_size=_parse_global_segment_size(
+                config.get("segment_page_size", 0)
+            ),
+            segment_numa_nodes=_parse_numa_nodes(
+                config.get("segment_numa_nodes")
+            ),
+            prefault_threads=config.get("prefault_threads", 8),
         )
 
     @staticmethod
@@ -90,6 +119,8 @@ class MooncakeConfig:
         export MOONCAKE_PROTOCOL="rdma"
         export MOONCAKE_DEVICE=""
         export MOONCAKE_TE_META_DATA_SERVER="P2PHANDSHAKE"
+        export MOONCAKE_SEGMENT_PAGE_SIZE="2mb"
+        export MOONCAKE_SEGMENT_NUMA_NODES="all"
         """
         config_file_path = os.getenv('MOONCAKE_CONFIG_PATH')
         if config_file_path is None:
@@ -106,5 +137,12 @@ class MooncakeConfig:
                 protocol=os.getenv("MOONCAKE_PROTOCOL", "tcp"),
                 device_name=os.getenv("MOONCAKE_DEVICE", ""),
                 master_server_address=os.getenv("MOONCAKE_MASTER"),
+                segment_page_size=_parse_global_segment_size(
+                    os.getenv("MOONCAKE_SEGMENT_PAGE_SIZE", 0)
+                ),
+                segment_numa_nodes=_parse_numa_nodes(
+                    os.getenv("MOONCAKE_SEGMENT_NUMA_NODES")
+                ),
+                prefault_threads=int(os.getenv("MOONCAKE_PREFAULT_THREADS", 8)),
             )
         return MooncakeConfig.from_file(config_file_path)
\ No newline at end of file
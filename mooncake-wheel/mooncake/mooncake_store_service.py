@@ -9,7 +9,8 @@ import time
 
 from aiohttp import web
 from mooncake.store import MooncakeDistributedStore
-from mooncake.mooncake_config import MooncakeConfig
+from mooncake.mooncake_config import (MooncakeConfig, _parse_global_segment_size,
+                                      _parse_numa_nodes)
 
 
 def _timed_handler(operation_name, handler):
@@ -35,7 +36,9 @@ class MooncakeStoreService:
         "local_buffer_size": 1073741824,
         "protocol": "tcp",
         "device_name": "",
-        "master_server_address": "localhost:8081"
+        "master_server_address": "localhost:8081",
+        "segment_page_size": "2mb",
+        "segment_numa_nodes": "all"
     }
 
     Explanation of Key Fields:
@@ -46,6 +49,8 @@ class MooncakeStoreService:
     - protocol: Communication protocol (tcp or rdma).
     - device_name: The name of the device to use.
     - master_server_address: The address of the master server.
+    - segment_page_size: Huge page size backing the segments (2mb or 1gb), 0 for regular pages.
+    - segment_numa_nodes: NUMA nodes to mount a segment of global_segment_size on each, "all" or [] for every node.
     """
 
     def __init__(self, config_path: str = None, cli_config: dict = None):
@@ -79,10 +84,18 @@ class MooncakeStoreService:
     async def start_store_service(self):
         try:
             self.store = MooncakeDistributedStore()
+            # Huge page or NUMA bound segments are mounted after the setup,
+            # -D overrides arrive as strings
+            segment_size = _parse_global_segment_size(
+                self.config.global_segment_size)
+            page_size = _parse_global_segment_size(
+                self.config.segment_page_size)
+            numa_nodes = _parse_numa_nodes(self.config.segment_numa_nodes)
+            provision = page_size != 0 or numa_nodes is not None
             ret = self.store.setup(
                 self.config.local_hostname,
                 self.config.metadata_server,
-                self.config.global_segment_size,
+                0 if provision else self.config.global_segment_size,
                 self.config.local_buffer_size,
                 self.config.protocol,
                 self.config.device_name,
@@ -90,6 +103,18 @@ class MooncakeStoreService:
             )
             if ret != 0:
                 raise RuntimeError("Store initialization failed")
+            if provision and segment_size > 0:
+                start_time = time.perf_counter()
+                ret = self.store.mount_segments(
+                    segment_size,
+                    page_size,
+                    [-1] if numa_nodes is None else numa_nodes,
+                    int(self.config.prefault_threads)
+                )
+                if ret != 0:
+                    raise RuntimeError("Segment provisioning failed")
+                logging.info("Segments mounted in %.2f s",
+                             time.perf_counter() - start_time)
             logging.info(f"Store service started on {self.config.local_hostname}")
             return True
         except Exception as e:
@@ -224,6 +224,49 @@ class TestDistributedObjectStoreSingleStore(unittest.TestCase):
         self.assertEqual(self.store.unregister_buffer(small_buffer_ptr), 0)
         self.assertEqual(self.store.remove(key), 0)
 
+    def test_get_range_operations(self):
+        """Test get_range/get_range_into/batch_get_range_into."""
+        import ctypes
+
+        # Larger than two slices, so ranges cross buffer boundaries
+        test_data = bytes(random.getrandbits(8) for _ in range(1024)) * (10 * 1024)
+        key = "test_get_range_key"
+        self.assertEqual(self.store.put(key, test_data), 0)
+        slice_size = 4 * 1024 * 1024 - 16
+
+        ranges = [(0, 100), (slice_size - 10, 20), (slice_size - 1, slice_size + 2),
+                  (len(test_data) - 1, 1), (0, len(test_data))]
+        for offset, size in ranges:
+            self.assertEqual(self.store.get_range(key, offset, size),
+                             test_data[offset:offset + size], f"range at {offset}")
+        self.assertIsNone(self.store.get_range(key, len(test_data) - 10, 11))
+        self.assertIsNone(self.store.get_range("test_get_range_missing", 0, 10))
+
+        buffer_size = 2 * 1024 * 1024
+        buffer = (ctypes.c_ubyte * buffer_size)()
+        buffer_ptr = ctypes.addressof(buffer)
+        self.assertEqual(self.store.register_buffer(buffer_ptr, buffer_size), 0)
+
+        offset = slice_size - 1024
+        self.assertEqual(self.store.get_range_into(key, buffer_ptr, offset, 4096), 4096)
+        self.assertEqual(bytes(buffer[:4096]), test_data[offset:offset + 4096])
+
+        # The same key several times, as when streaming layers of one object
+        half = buffer_size // 2
+        offsets = [slice_size - half // 2, 2 * slice_size - 7, len(test_data)]
+        results = self.store.batch_get_range_into(
+            [key, key, key], [buffer_ptr, buffer_ptr + half, buffer_ptr],
+            offsets, [half, half, 1])
+        self.assertEqual(results[:2], [half, half])
+        self.assertLess(results[2], 0)
+        for i in range(2):
+            self.assertEqual(bytes(buffer[i * half:(i + 1) * half]),
+                             test_data[offsets[i]:offsets[i] + half])
+
+        time.sleep(default_kv_lease_ttl / 1000)
+        self.assertEqual(self.store.unregister_buffer(buffer_ptr), 0)
+        self.assertEqual(self.store.remove(key), 0)
+
     def test_batch_get_into_operations(self):
         """Test batch_get_into operations for multiple keys."""
         import ctypes
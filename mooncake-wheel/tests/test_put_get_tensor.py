@@ -152,6 +152,151 @@ class TestDistributedObjectStore(unittest.TestCase):
         self.store.remove(key_2d)
         self.store.remove(key_3d)
 
+    def test_batch_put_get_tensor(self):
+        """Test batch_put_tensor/batch_get_tensor, including missing keys."""
+        import torch
+
+        tensors = [
+            torch.rand(16, 32, dtype=torch.float32),
+            torch.arange(100, dtype=torch.int64),
+            torch.rand(4, 8, 2, dtype=torch.float32).to(torch.bfloat16),
+            torch.rand(3, 5, dtype=torch.float16),
+        ]
+        keys = [f"test_batch_tensor_{i}" for i in range(len(tensors))]
+        results = self.store.batch_put_tensor(keys, tensors)
+        self.assertEqual(results, [0] * len(tensors))
+
+        retrieved = self.store.batch_get_tensor(keys + ["test_batch_tensor_missing"])
+        self.assertEqual(len(retrieved), len(tensors) + 1)
+        self.assertIsNone(retrieved[-1])
+        for tensor, got in zip(tensors, retrieved):
+            self.assertIsNotNone(got)
+            self.assertEqual(got.shape, tensor.shape)
+            self.assertEqual(got.dtype, tensor.dtype)
+            self.assertTrue(torch.equal(tensor, got))
+
+        # Retrieved tensors view the client buffer and stay valid after other
+        # operations reuse it.
+        first = retrieved[0]
+        del retrieved
+        self.store.batch_get_tensor(keys)
+        self.assertTrue(torch.equal(tensors[0], first))
+
+        # Non-contiguous tensors are rejected.
+        results = self.store.batch_put_tensor(["test_batch_tensor_t"],
+                                              [tensors[0].t()])
+        self.assertLess(results[0], 0)
+
+        for key in keys:
+            self.store.remove(key)
+
+    def test_get_tensor_into(self):
+        """Test reading a tensor into a pre-allocated tensor."""
+        import torch
+
+        tensor = torch.rand(64, 128, dtype=torch.float32)
+        key = "test_tensor_into"
+        self.assertEqual(self.store.put_tensor(key, tensor), 0)
+
+        out = torch.empty_like(tensor)
+        self.assertEqual(self.store.get_tensor_into(key, out),
+                         tensor.numel() * tensor.element_size())
+        self.assertTrue(torch.equal(tensor, out))
+
+        # Size or dtype mismatches are errors.
+        self.assertLess(self.store.get_tensor_into(key, torch.empty(10)), 0)
+        mismatched = torch.zeros_like(tensor, dtype=torch.int32)
+        self.assertLess(self.store.get_tensor_into(key, mismatched), 0)
+        # A rejected destination is left untouched.
+        self.assertTrue(torch.equal(mismatched, torch.zeros_like(mismatched)))
+        # So are non-contiguous destinations.
+        transposed = torch.zeros(128, 64, dtype=torch.float32).t()
+        self.assertLess(self.store.get_tensor_into(key, transposed), 0)
+        self.assertTrue(torch.equal(transposed, torch.zeros_like(transposed)))
+        self.assertLess(self.store.get_tensor_into("test_tensor_into_missing", out), 0)
+
+        self.store.remove(key)
+
+    def test_put_get_tensor_any_layout(self):
+        """Test tensors the legacy metadata cannot describe."""
+        import torch
+
+        base = torch.rand(6, 8, dtype=torch.float32)
+        tensors = {
+            "test_tensor_layout_t": base.t(),
+            "test_tensor_layout_5d": torch.arange(2 * 3 * 2 * 2 * 4).reshape(2, 3, 2, 2, 4),
+            "test_tensor_layout_expand": torch.rand(1, 4).expand(3, 4),
+        }
+        for key, tensor in tensors.items():
+            self.assertEqual(self.store.put_tensor(key, tensor), 0)
+            retrieved = self.store.get_tensor(key)
+            self.assertIsNotNone(retrieved)
+            self.assertEqual(retrieved.shape, tensor.shape)
+            self.assertEqual(retrieved.stride(), tensor.stride())
+            self.assertEqual(retrieved.dtype, tensor.dtype)
+            self.assertTrue(torch.equal(tensor, retrieved))
+            self.store.remove(key)
+
+        # Views skipping elements of their storage only store their own
+        # elements, and come back contiguous.
+        big = torch.rand(1024, 1024, dtype=torch.float32)
+        for key, view in {"test_tensor_layout_slice": big[1:5, ::3],
+                          "test_tensor_layout_column": big[:, :4]}.items():
+            self.assertEqual(self.store.put_tensor(key, view), 0)
+            self.assertLess(self.store.get_size(key),
+                            view.numel() * view.element_size() + 4096)
+            retrieved = self.store.get_tensor(key)
+            self.assertIsNotNone(retrieved)
+            self.assertEqual(retrieved.shape, view.shape)
+            self.assertTrue(retrieved.is_contiguous())
+            self.assertTrue(torch.equal(view, retrieved))
+            self.store.remove(key)
+
+    def test_put_get_tensor_parts(self):
+        """Test multi-part objects and reading a subset of the parts."""
+        import torch
+
+        # Layers larger than a slice and an empty one
+        parts = [
+            torch.rand(3 * 1024 * 1024, dtype=torch.float32).to(torch.bfloat16).view(3, -1),
+            torch.rand(5, 7, dtype=torch.float16).t(),
+            torch.empty(0, 4, dtype=torch.int64),
+            torch.randint(0, 100, (2, 3, 4, 5, 6), dtype=torch.int32),
+            torch.rand(2 * 1024 * 1024, dtype=torch.float32),
+        ]
+        key = "test_tensor_parts"
+        self.assertEqual(self.store.put_tensor_parts(key, parts), 0)
+
+        retrieved = self.store.get_tensor_parts(key)
+        self.assertEqual(len(retrieved), len(parts))
+        for part, got in zip(parts, retrieved):
+            self.assertEqual(got.shape, part.shape)
+            self.assertEqual(got.dtype, part.dtype)
+            self.assertTrue(torch.equal(part, got))
+
+        # Selected parts come back in the requested order
+        for selection in ([3], [4, 1], [2], [0, 2, 4]):
+            retrieved = self.store.get_tensor_parts(key, selection)
+            self.assertEqual(len(retrieved), len(selection))
+            for index, got in zip(selection, retrieved):
+                self.assertEqual(got.shape, parts[index].shape)
+                self.assertTrue(torch.equal(parts[index], got))
+
+        # Invalid selections and reading as a single tensor fail
+        self.assertIsNone(self.store.get_tensor_parts(key, [len(parts)]))
+        self.assertIsNone(self.store.get_tensor_parts(key, [1, 1]))
+        self.assertIsNone(self.store.get_tensor(key))
+        self.assertIsNone(self.store.get_tensor_parts("test_tensor_parts_missing"))
+
+        # put_tensor objects read as a single part
+        tensor = torch.rand(4, 4)
+        self.assertEqual(self.store.put_tensor("test_tensor_parts_legacy", tensor), 0)
+        retrieved = self.store.get_tensor_parts("test_tensor_parts_legacy", [0])
+        self.assertTrue(torch.equal(tensor, retrieved[0]))
+
+        self.store.remove(key)
+        self.store.remove("test_tensor_parts_legacy")
+
              
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
@@ -0,0 +1,173 @@
+import os
+import time
+import unittest
+
+import torch
+
+from mooncake.store import MooncakeDistributedStore
+from test_put_get_tensor import get_client
+
+# Each round moves NUM_TENSORS tensors of TENSOR_MB megabytes, which has to
+# fit the 512 MB local buffer of the test client. Run against a master and
+# metadata server like test_put_get_tensor.py.
+TENSOR_MB = int(os.getenv("TENSOR_MB", "4"))
+NUM_TENSORS = int(os.getenv("NUM_TENSORS", "32"))
+NUM_ROUNDS = int(os.getenv("NUM_ROUNDS", "10"))
+
+
+def gbps(num_bytes, seconds):
+    return num_bytes / seconds / 1e9
+
+
+class TestPutGetTensorPerf(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.store = MooncakeDistributedStore()
+        get_client(cls.store)
+        numel = TENSOR_MB * 1024 * 1024 // 2
+        cls.tensors = [torch.rand(numel, dtype=torch.float32).to(torch.bfloat16)
+                       for _ in range(NUM_TENSORS)]
+        cls.round_bytes = NUM_TENSORS * numel * 2
+        # Objects read by the get benchmarks
+        cls.keys = [f"perf_tensor_{i}" for i in range(NUM_TENSORS)]
+        results = cls.store.batch_put_tensor(cls.keys, cls.tensors)
+        if any(results):
+            raise RuntimeError(f"Failed to put tensors: {results}")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.store.remove_by_regex("^perf_tensor_")
+
+    def report(self, name, seconds):
+        print(f"{name:>24}: {gbps(self.round_bytes * NUM_ROUNDS, seconds):6.2f} GB/s "
+              f"({NUM_TENSORS} x {TENSOR_MB} MB tensors)")
+
+    def round_keys(self, name, round):
+        return [f"perf_tensor_{name}_{round}_{i}" for i in range(NUM_TENSORS)]
+
+    def test_put_tensor(self):
+        start = time.perf_counter()
+        for round in range(NUM_ROUNDS):
+            for key, tensor in zip(self.round_keys("put", round), self.tensors):
+                self.assertEqual(self.store.put_tensor(key, tensor), 0)
+        self.report("put_tensor", time.perf_counter() - start)
+
+    def test_batch_put_tensor(self):
+        start = time.perf_counter()
+        for round in range(NUM_ROUNDS):
+            results = self.store.batch_put_tensor(
+                self.round_keys("batch_put", round), self.tensors)
+            self.assertEqual(results, [0] * NUM_TENSORS)
+        self.report("batch_put_tensor", time.perf_counter() - start)
+
+    def test_get_tensor(self):
+        start = time.perf_counter()
+        for _ in range(NUM_ROUNDS):
+            for key in self.keys:
+                tensor = self.store.get_tensor(key)
+                self.assertIsNotNone(tensor)
+                del tensor
+        self.report("get_tensor", time.perf_counter() - start)
+
+    def test_batch_get_tensor(self):
+        start = time.perf_counter()
+        for _ in range(NUM_ROUNDS):
+            tensors = self.store.batch_get_tensor(self.keys)
+            self.assertTrue(all(tensor is not None for tensor in tensors))
+            del tensors
+        self.report("batch_get_tensor", time.perf_counter() - start)
+
+    def test_get_tensor_into(self):
+        outs = [torch.empty_like(tensor) for tensor in self.tensors]
+        start = time.perf_counter()
+        for _ in range(NUM_ROUNDS):
+            for key, out in zip(self.keys, outs):
+                self.assertGreater(self.store.get_tensor_into(key, out), 0)
+        self.report("get_tensor_into", time.perf_counter() - start)
+        self.assertTrue(torch.equal(self.tensors[-1], outs[-1]))
+
+    def test_get_tensor_parts(self):
+        # The tensors as the layers of one object, reading a single layer
+        # only transfers its slices.
+        key = "perf_tensor_parts"
+        self.assertEqual(self.store.put_tensor_parts(key, self.tensors), 0)
+
+        def ms_per_read(parts):
+            start = time.perf_counter()
+            for round in range(NUM_ROUNDS):
+                selection = parts(round)
+                tensors = self.store.get_tensor_parts(key, selection)
+                self.assertIsNotNone(tensors)
+                del tensors
+            return (time.perf_counter() - start) / NUM_ROUNDS * 1e3
+
+        full = ms_per_read(lambda round: None)
+        one = ms_per_read(lambda round: [round % NUM_TENSORS])
+        print(f"{'get_tensor_parts':>24}: {full:8.2f} ms for all "
+              f"{NUM_TENSORS} layers, {one:8.2f} ms for one layer "
+              f"({TENSOR_MB} MB)")
+
+    def test_batch_put_small_objects(self):
+        # Many small KV pages in one batch. BatchPut submits the writes of the
+        # whole batch at once, so objects that are placed next to each other
+        # are written with one request. Run with PROTOCOL=rdma to compare
+        # transports.
+        for size_kb in (4, 16, 64):
+            size = size_kb * 1024
+            buffer = torch.zeros(NUM_TENSORS * 16 * size, dtype=torch.uint8)
+            self.assertEqual(self.store.register_buffer(
+                buffer.data_ptr(), buffer.numel()), 0)
+            num_objects = buffer.numel() // size
+            ptrs = [buffer.data_ptr() + i * size for i in range(num_objects)]
+            start = time.perf_counter()
+            for round in range(NUM_ROUNDS):
+                keys = [f"perf_tensor_small_{size_kb}_{round}_{i}"
+                        for i in range(num_objects)]
+                results = self.store.batch_put_from(
+                    keys, ptrs, [size] * num_objects)
+                self.assertEqual(results, [0] * num_objects)
+            seconds = time.perf_counter() - start
+            print(f"{'batch_put ' + str(size_kb) + ' KB':>24}: "
+                  f"{num_objects * NUM_ROUNDS / seconds / 1e3:8.1f} Kops/s, "
+                  f"{gbps(buffer.numel() * NUM_ROUNDS, seconds):6.2f} GB/s "
+                  f"({num_objects} objects per batch)")
+            self.store.unregister_buffer(buffer.data_ptr())
+
+
+    def test_time_to_first_layer(self):
+        # The tensors as the layers of one object. A layer-wise pipeline can
+        # start on the first layer once its range is read, instead of after
+        # the whole object.
+        key = "perf_tensor_layers"
+        layers = torch.cat(self.tensors).view(torch.uint8)
+        layer_bytes = layers.numel() // NUM_TENSORS
+        out = torch.empty_like(layers)
+        for tensor in (layers, out):
+            self.assertEqual(self.store.register_buffer(
+                tensor.data_ptr(), tensor.numel()), 0)
+        self.assertEqual(self.store.put_from(
+            key, layers.data_ptr(), layers.numel()), 0)
+
+        def ms_per_read(read):
+            start = time.perf_counter()
+            for _ in range(NUM_ROUNDS):
+                self.assertGreater(read(), 0)
+            return (time.perf_counter() - start) / NUM_ROUNDS * 1e3
+
+        full = ms_per_read(lambda: self.store.get_into(
+            key, out.data_ptr(), out.numel()))
+        first = ms_per_read(lambda: self.store.get_range_into(
+            key, out.data_ptr(), 0, layer_bytes))
+        last = ms_per_read(lambda: self.store.get_range_into(
+            key, out.data_ptr(), layers.numel() - layer_bytes, layer_bytes))
+        self.assertTrue(torch.equal(layers[-layer_bytes:], out[:layer_bytes]))
+        print(f"{'time to first layer':>24}: {full:8.2f} ms reading the "
+              f"object, {first:8.2f} ms reading layer 0, {last:8.2f} ms "
+              f"reading layer {NUM_TENSORS - 1} ({TENSOR_MB} MB layers)")
+
+        for tensor in (layers, out):
+            self.store.unregister_buffer(tensor.data_ptr())
+
+
+if __name__ == '__main__':
+    unittest.main()